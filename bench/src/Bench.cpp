@@ -0,0 +1,223 @@
+#include "Bench.hpp"
+
+#include <ProjectZvend/Stopwatch.hpp>
+
+#include <nlohmann/json.hpp>
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <chrono>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <unordered_map>
+
+
+
+namespace
+{
+    // Keeps the compiler from dropping the benchmarked work.
+    volatile uint64_t g_Sink = 0;
+
+
+
+    double RunOnce(Bench::Case& benchmark, size_t iterations)
+    {
+        PZvend::Stopwatch watch(0.0);
+        g_Sink = g_Sink + benchmark.Run(iterations);
+        return watch.GetElapsedTime() * 1e9;
+    }
+
+
+
+    // Doubles the iterations until one run takes MinTime, so fast and slow cases are both measured long enough.
+    size_t Calibrate(Bench::Case& benchmark, double min_time_ms)
+    {
+        size_t iterations = 1;
+
+        for (;;)
+        {
+            const double elapsed = RunOnce(benchmark, iterations);
+            if (elapsed >= min_time_ms * 1e6 || iterations >= (1ull << 32))
+                return iterations;
+
+            // Jump close to the target once the timing is meaningful, then keep doubling.
+            if (elapsed > 1e5)
+                iterations = std::max<size_t>(iterations * 2, static_cast<size_t>(static_cast<double>(iterations) * min_time_ms * 1e6 / elapsed));
+            else
+                iterations *= 2;
+        }
+    }
+}
+
+
+
+const std::string& Bench::GetScratchDirectory()
+{
+    static const std::string directory = []()
+    {
+        auto path = std::filesystem::temp_directory_path() / "ProjectZvend_bench";
+        std::filesystem::create_directories(path);
+        return path.string();
+    }();
+
+    return directory;
+}
+
+
+
+std::vector<Bench::Result> Bench::RunCases(std::vector<Case>& cases, const Options& options)
+{
+    std::vector<Result> results;
+
+    for (Case& benchmark : cases)
+    {
+        if (!options.Filter.empty() && benchmark.Name.find(options.Filter) == std::string::npos)
+            continue;
+
+        if (benchmark.Setup && !benchmark.Setup())
+        {
+            spdlog::warn("{:<44} skipped, setup failed", benchmark.Name);
+            continue;
+        }
+
+        const size_t        iterations = Calibrate(benchmark, options.MinTime);
+        std::vector<double> samples;
+        const uint64_t      drops      = benchmark.Drops ? benchmark.Drops() : 0;
+
+        for (int run = 0; run < options.Runs; run++)
+            samples.push_back(RunOnce(benchmark, iterations) / static_cast<double>(iterations));
+
+        // A timing that mostly measured the drop path isn't comparable, so the share is shown with it.
+        double drop_rate = -1.0;
+        if (benchmark.Drops)
+            drop_rate = static_cast<double>(benchmark.Drops() - drops) * 100.0 / (static_cast<double>(iterations) * options.Runs);
+
+        if (benchmark.Teardown)
+            benchmark.Teardown();
+
+        std::sort(samples.begin(), samples.end());
+
+        Result result;
+        result.Name       = benchmark.Name;
+        result.Iterations = iterations;
+        result.Median     = samples[samples.size() / 2];
+        result.Min        = samples.front();
+        result.Max        = samples.back();
+        result.Throughput = benchmark.Bytes ? static_cast<double>(benchmark.Bytes) / result.Median * 1e9 / (1024.0 * 1024.0) : 0.0;
+        result.DropRate   = drop_rate;
+
+        if (result.DropRate >= 0.0)
+            spdlog::info("{:<44} {:>12.1f} ns/op  {:>8.2f}% dropped", result.Name, result.Median, result.DropRate);
+        else if (result.Throughput > 0.0)
+            spdlog::info("{:<44} {:>12.1f} ns/op  {:>9.1f} MB/s", result.Name, result.Median, result.Throughput);
+        else
+            spdlog::info("{:<44} {:>12.1f} ns/op", result.Name, result.Median);
+
+        results.push_back(std::move(result));
+    }
+
+    return results;
+}
+
+
+
+bool Bench::WriteResults(const std::vector<Result>& results, const std::string& path)
+{
+    std::tm     timeinfo;
+    std::time_t current_time = std::time(nullptr);
+#ifdef _WIN32
+    localtime_s(&timeinfo, &current_time);
+#else
+    localtime_r(&current_time, &timeinfo);
+#endif
+
+    std::ostringstream timestamp;
+    timestamp << std::put_time(&timeinfo, "%Y-%m-%dT%H:%M:%S");
+
+    nlohmann::ordered_json json;
+    json["version"]   = 1;
+    json["timestamp"] = timestamp.str();
+    json["results"]   = nlohmann::ordered_json::array();
+
+    for (const Result& result : results)
+    {
+        json["results"].push_back({
+            { "name",       result.Name },
+            { "iterations", result.Iterations },
+            { "ns_per_op",  result.Median },
+            { "min_ns",     result.Min },
+            { "max_ns",     result.Max },
+            { "mb_per_s",   result.Throughput },
+        });
+
+        if (result.DropRate >= 0.0)
+            json["results"].back()["drop_percent"] = result.DropRate;
+    }
+
+    std::ofstream file(path);
+    if (!file.is_open())
+    {
+        spdlog::error("Could not write the results to '{}'.", path);
+        return false;
+    }
+
+    file << json.dump(4);
+    return true;
+}
+
+
+
+bool Bench::CompareBaseline(const std::vector<Result>& results, const std::string& path, double threshold)
+{
+    std::ifstream file(path);
+    if (!file.is_open())
+    {
+        spdlog::error("Could not open the baseline '{}'.", path);
+        return false;
+    }
+
+    std::unordered_map<std::string, double> baseline;
+    try
+    {
+        const nlohmann::json json = nlohmann::json::parse(file);
+        for (const auto& entry : json.at("results"))
+            baseline[entry.at("name").get<std::string>()] = entry.at("ns_per_op").get<double>();
+    }
+    catch (const nlohmann::json::exception& e)
+    {
+        spdlog::error("The baseline '{}' is invalid: {}", path, e.what());
+        return false;
+    }
+
+    size_t regressions = 0;
+    spdlog::info("");
+    spdlog::info("{:<44} {:>12} {:>12} {:>9}", "baseline comparison", "baseline", "current", "change");
+
+    for (const Result& result : results)
+    {
+        auto it = baseline.find(result.Name);
+        if (it == baseline.end() || it->second <= 0.0)
+        {
+            spdlog::info("{:<44} {:>12} {:>12.1f} {:>9}", result.Name, "-", result.Median, "new");
+            continue;
+        }
+
+        const double change = (result.Median - it->second) / it->second * 100.0;
+        if (change > threshold)
+        {
+            regressions++;
+            spdlog::error("{:<44} {:>12.1f} {:>12.1f} {:>+8.1f}%  REGRESSION", result.Name, it->second, result.Median, change);
+            continue;
+        }
+
+        spdlog::info("{:<44} {:>12.1f} {:>12.1f} {:>+8.1f}%", result.Name, it->second, result.Median, change);
+    }
+
+    if (regressions)
+        spdlog::error("{} cases are more than {:.1f}% slower than the baseline.", regressions, threshold);
+
+    return regressions == 0;
+}
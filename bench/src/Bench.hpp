@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if defined(__GNUC__)
+    #define BENCH_NOINLINE __attribute__((noinline))
+#else
+    #define BENCH_NOINLINE __declspec(noinline)
+#endif
+
+
+
+namespace Bench
+{
+    struct Case
+    {
+        Case() = default;
+        Case(std::string name, uint64_t bytes, std::function<bool()> setup, std::function<void()> teardown,
+             std::function<uint64_t(size_t)> run, std::function<uint64_t()> drops = nullptr)
+            : Name(std::move(name)), Bytes(bytes), Setup(std::move(setup)), Teardown(std::move(teardown)), Run(std::move(run)), Drops(std::move(drops))
+        {}
+
+        std::string                          Name;     // "group/case/variant", --filter matches substrings of it.
+        uint64_t                             Bytes = 0; // Processed per operation, enables the MB/s column.
+        std::function<bool()>                Setup;    // Optional, the case is skipped if it returns false.
+        std::function<void()>                Teardown; // Optional.
+        std::function<uint64_t(size_t)>      Run;      // Runs the operation n times, the result is consumed so nothing gets folded away.
+        std::function<uint64_t()>            Drops;    // Optional, total operations that skipped their work (e.g. a full ring), reported next to the timing.
+    };
+
+    struct Result
+    {
+        std::string Name;
+        uint64_t    Iterations = 0; // Per run.
+        double      Median     = 0.0; // ns per operation.
+        double      Min        = 0.0;
+        double      Max        = 0.0;
+        double      Throughput = 0.0; // MB/s, 0 without Bytes.
+        double      DropRate   = -1.0; // Percent of the measured operations that were dropped, -1 without Drops.
+    };
+
+    struct Options
+    {
+        std::string Filter;
+        std::string Output;
+        std::string Baseline;
+        double      Threshold = 10.0; // Percent a case may be slower than the baseline.
+        double      MinTime   = 20.0; // Milliseconds one run takes at least, iterations are calibrated to it.
+        int         Runs      = 7;    // The median run is reported, a single preemption doesn't skew it.
+    };
+
+
+
+    /*
+    Every file registers its cases with one of these, see main.cpp.
+    */
+    void RegisterHookCases(std::vector<Case>& cases);
+    void RegisterScannerCases(std::vector<Case>& cases);
+    void RegisterJsonCases(std::vector<Case>& cases);
+    void RegisterLoggerCases(std::vector<Case>& cases);
+    void RegisterL10nCases(std::vector<Case>& cases);
+
+
+
+    /*
+    Directory for generated input files, created on first use.
+    */
+    const std::string& GetScratchDirectory();
+
+
+
+    std::vector<Result> RunCases(std::vector<Case>& cases, const Options& options);
+    bool WriteResults(const std::vector<Result>& results, const std::string& path);
+
+
+
+    /*
+    Compares against a previous WriteResults file.
+
+    @return Returns false if a case got slower than the threshold allows.
+    */
+    bool CompareBaseline(const std::vector<Result>& results, const std::string& path, double threshold);
+}
@@ -0,0 +1,209 @@
+#include "Bench.hpp"
+
+#include <ProjectZvend/Memory.hpp>
+#include <ProjectZvend/NativeHook.hpp>
+
+#include <memory>
+
+
+
+namespace
+{
+    using Target_FUNC = int(*)(int, int);
+
+    // Big enough to have a relocatable prologue, small enough to not drown the hook overhead.
+    BENCH_NOINLINE int BenchTarget(int a, int b)
+    {
+        if (a > 0x10000)
+            return BenchTarget(a - 1, b) ^ b;
+
+        return a * 3 + b;
+    }
+
+    // Called through a volatile pointer so the compiler can't inline or fold the target.
+    Target_FUNC volatile g_Target = &BenchTarget;
+
+    PZvend::Memory::NativeHook<Target_FUNC> g_NativeHook;
+
+    BENCH_NOINLINE int NativeDetour(int a, int b)
+    {
+        return g_NativeHook.Call(a, b);
+    }
+
+    PZvend::Memory::NativeHook<Target_FUNC, PZvend::Memory::HookCounters> g_CountedHook;
+
+    BENCH_NOINLINE int CountedDetour(int a, int b)
+    {
+        auto scope = g_CountedHook.Scope();
+        return g_CountedHook.Call(a, b);
+    }
+
+
+
+    class Shape
+    {
+    public:
+        virtual ~Shape() = default;
+        virtual int Area(int scale) = 0;
+    };
+
+    class Square : public Shape
+    {
+    public:
+        BENCH_NOINLINE int Area(int scale) override
+        {
+            if (scale > 0x10000)
+                return Area(scale - 1) ^ m_Side;
+
+            return m_Side * m_Side * scale;
+        }
+
+        int m_Side = 3;
+    };
+
+    // Both destructors come first on Itanium, MSVC has one (scalar deleting).
+#if defined(_MSC_VER)
+    constexpr size_t AREA_INDEX = 1;
+#else
+    constexpr size_t AREA_INDEX = 2;
+#endif
+
+    using Area_FUNC = int(*)(Shape* self, int scale);
+
+    Square                             g_Square;
+    Shape* volatile                    g_Shape = &g_Square;
+    std::unique_ptr<PZvend::Memory::VmtShadow> g_Shadow;
+
+    PZvend::Memory::VmtHook<Area_FUNC> g_VmtHook;
+    PZvend::Memory::VmtHook<Area_FUNC> g_ShadowHook;
+    PZvend::Memory::Hook<Area_FUNC>    g_AreaHook;
+
+    BENCH_NOINLINE int VmtDetour(Shape* self, int scale)
+    {
+        return g_VmtHook.Call(self, scale);
+    }
+
+    BENCH_NOINLINE int ShadowDetour(Shape* self, int scale)
+    {
+        return g_ShadowHook.Call(self, scale);
+    }
+
+    BENCH_NOINLINE int AreaDetour(Shape* self, int scale)
+    {
+        return g_AreaHook.Call(self, scale);
+    }
+
+
+
+    uint64_t CallTarget(size_t iterations)
+    {
+        uint64_t sum = 0;
+        for (size_t i = 0; i < iterations; i++)
+            sum += g_Target(static_cast<int>(i & 0xFF), 1);
+
+        return sum;
+    }
+
+
+
+    uint64_t CallArea(size_t iterations)
+    {
+        uint64_t sum = 0;
+        for (size_t i = 0; i < iterations; i++)
+            sum += g_Shape->Area(static_cast<int>(i & 0xFF));
+
+        return sum;
+    }
+
+
+
+    // One Enable+Disable round trip per iteration.
+    template <class HookType>
+    uint64_t Toggle(HookType& hook, size_t iterations)
+    {
+        uint64_t sum = 0;
+        for (size_t i = 0; i < iterations; i++)
+            sum += static_cast<uint64_t>(hook.Enable()) + static_cast<uint64_t>(hook.Disable());
+
+        return sum;
+    }
+}
+
+
+
+void Bench::RegisterHookCases(std::vector<Case>& cases)
+{
+    cases.push_back({ "hook/direct_call", 0, nullptr, nullptr, CallTarget });
+
+    cases.push_back({ "hook/native", 0,
+        []() { g_NativeHook = PZvend::Memory::NativeHook<Target_FUNC>("BenchTarget", &BenchTarget, &NativeDetour); return g_NativeHook.Create() && g_NativeHook.Enable(); },
+        []() { g_NativeHook.Remove(); },
+        CallTarget });
+
+    cases.push_back({ "hook/native_trampoline", 0,
+        []() { g_NativeHook = PZvend::Memory::NativeHook<Target_FUNC>("BenchTarget", &BenchTarget, &NativeDetour); return g_NativeHook.Create(); },
+        []() { g_NativeHook.Remove(); },
+        [](size_t iterations)
+        {
+            uint64_t sum = 0;
+            for (size_t i = 0; i < iterations; i++)
+                sum += g_NativeHook.Call(static_cast<int>(i & 0xFF), 1);
+
+            return sum;
+        } });
+
+    cases.push_back({ "hook/native_counters", 0,
+        []() { g_CountedHook = PZvend::Memory::NativeHook<Target_FUNC, PZvend::Memory::HookCounters>("BenchTarget (counted)", &BenchTarget, &CountedDetour); return g_CountedHook.Create() && g_CountedHook.Enable(); },
+        []() { g_CountedHook.Remove(); },
+        CallTarget });
+
+    cases.push_back({ "hook/native_toggle", 0,
+        []() { g_NativeHook = PZvend::Memory::NativeHook<Target_FUNC>("BenchTarget", &BenchTarget, &NativeDetour); return g_NativeHook.Create(); },
+        []() { g_NativeHook.Remove(); },
+        [](size_t iterations) { return Toggle(g_NativeHook, iterations); } });
+
+    // The thiscall convention on x86 needs a different detour signature.
+#if !defined(_WIN32) || defined(_WIN64)
+    cases.push_back({ "hook/virtual_call", 0, nullptr, nullptr, CallArea });
+
+    cases.push_back({ "hook/vmt_slot", 0,
+        []() { g_VmtHook = PZvend::Memory::VmtHook<Area_FUNC>("Square::Area", PZvend::Memory::GetVTable(&g_Square), AREA_INDEX, &VmtDetour); return g_VmtHook.Create() && g_VmtHook.Enable(); },
+        []() { g_VmtHook.Remove(); },
+        CallArea });
+
+    cases.push_back({ "hook/vmt_slot_toggle", 0,
+        []() { g_VmtHook = PZvend::Memory::VmtHook<Area_FUNC>("Square::Area", PZvend::Memory::GetVTable(&g_Square), AREA_INDEX, &VmtDetour); return g_VmtHook.Create(); },
+        []() { g_VmtHook.Remove(); },
+        [](size_t iterations) { return Toggle(g_VmtHook, iterations); } });
+
+    cases.push_back({ "hook/vmt_shadow", 0,
+        []()
+        {
+            g_Shadow     = std::make_unique<PZvend::Memory::VmtShadow>(&g_Square);
+            g_ShadowHook = PZvend::Memory::VmtHook<Area_FUNC>("Square::Area (shadow)", *g_Shadow, AREA_INDEX, &ShadowDetour);
+            return g_ShadowHook.Create() && g_ShadowHook.Enable() && g_Shadow->Attach();
+        },
+        []() { g_ShadowHook.Remove(); g_Shadow.reset(); },
+        CallArea });
+
+    cases.push_back({ "hook/vmt_shadow_toggle", 0,
+        []()
+        {
+            g_Shadow     = std::make_unique<PZvend::Memory::VmtShadow>(&g_Square);
+            g_ShadowHook = PZvend::Memory::VmtHook<Area_FUNC>("Square::Area (shadow)", *g_Shadow, AREA_INDEX, &ShadowDetour);
+            return g_ShadowHook.Create() && g_Shadow->Attach();
+        },
+        []() { g_ShadowHook.Remove(); g_Shadow.reset(); },
+        [](size_t iterations) { return Toggle(g_ShadowHook, iterations); } });
+
+    cases.push_back({ "hook/inline_virtual", 0,
+        []()
+        {
+            const auto area = reinterpret_cast<Area_FUNC>(PZvend::Memory::GetVTable(&g_Square)[AREA_INDEX]);
+            g_AreaHook = PZvend::Memory::Hook<Area_FUNC>("Square::Area (inline)", area, &AreaDetour);
+            return g_AreaHook.Create() && g_AreaHook.Enable();
+        },
+        []() { g_AreaHook.Remove(); },
+        CallArea });
+#endif
+}
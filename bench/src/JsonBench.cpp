@@ -0,0 +1,290 @@
+#include "Bench.hpp"
+
+#include <ProjectZvend/ConcurrentJSON.hpp>
+#include <ProjectZvend/JSON.hpp>
+#include <ProjectZvend/JsonStruct.hpp>
+#include <ProjectZvend/JsonWatcher.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <random>
+
+
+
+struct BenchWindow
+{
+    int  Width      = 0;
+    int  Height     = 0;
+    bool Fullscreen = true;
+};
+
+struct BenchSettings
+{
+    BenchWindow Window;
+};
+
+struct BenchDocument
+{
+    BenchSettings Settings;
+};
+
+template <>
+struct PZvend::JsonBinding<BenchWindow>
+{
+    static constexpr auto Fields = std::make_tuple(
+        PZ_JSON_FIELD(BenchWindow, Width),
+        PZ_JSON_FIELD(BenchWindow, Height),
+        PZ_JSON_FIELD(BenchWindow, Fullscreen));
+};
+
+template <>
+struct PZvend::JsonBinding<BenchSettings>
+{
+    static constexpr auto Fields = std::make_tuple(PZ_JSON_FIELD(BenchSettings, Window));
+};
+
+template <>
+struct PZvend::JsonBinding<BenchDocument>
+{
+    static constexpr auto Fields = std::make_tuple(PZ_JSON_FIELD(BenchDocument, Settings));
+};
+
+
+
+namespace
+{
+    /*
+    A config sized file and a multi-MB one shaped like a dumped entity list.
+    Both are generated from fixed seeds, every run parses the same bytes.
+    */
+    nlohmann::ordered_json CreateDocument(size_t entries)
+    {
+        std::mt19937           rng(static_cast<uint32_t>(entries));
+        nlohmann::ordered_json json;
+
+        json["The"]["Answer"]["To"]["Everything"] = 42;
+        json["Settings"]["Window"] = { { "Width", 1920 }, { "Height", 1080 }, { "Fullscreen", false } };
+
+        auto& list = json["Entities"] = nlohmann::ordered_json::array();
+        for (size_t i = 0; i < entries; i++)
+        {
+            list.push_back({
+                { "Id",       i },
+                { "Name",     "Entity_" + std::to_string(rng() % 100000) },
+                { "Position", { static_cast<double>(rng() % 10000) / 10.0, static_cast<double>(rng() % 10000) / 10.0, static_cast<double>(rng() % 10000) / 10.0 } },
+                { "Flags",    rng() },
+                { "Tags",     { "npc", "spawned", rng() & 1 ? "hostile" : "friendly" } },
+            });
+        }
+
+        return json;
+    }
+
+
+
+    std::string WriteDocument(const std::string& name, size_t entries)
+    {
+        const std::string path = (std::filesystem::path(Bench::GetScratchDirectory()) / name).string();
+
+        std::ofstream file(path);
+        file << CreateDocument(entries).dump(4);
+        return path;
+    }
+
+
+
+    void RegisterFileCases(std::vector<Bench::Case>& cases, const std::string& variant, size_t entries)
+    {
+        const std::string path   = WriteDocument("bench_" + variant + ".json", entries);
+        const std::string output = (std::filesystem::path(Bench::GetScratchDirectory()) / ("bench_" + variant + "_saved.json")).string();
+        const uint64_t    size   = std::filesystem::file_size(path);
+
+        cases.push_back({ "json/load/" + variant, size, nullptr, nullptr, [path](size_t iterations)
+        {
+            uint64_t loaded = 0;
+            for (size_t i = 0; i < iterations; i++)
+            {
+                PZvend::JSON json;
+                loaded += json.Load(path);
+            }
+
+            return loaded;
+        } });
+
+        // Same document from its MessagePack sidecar. The first Load writes it, the loop only reads it.
+        cases.push_back({ "json/load_sidecar/" + variant, size,
+            [path]() { PZvend::JSON json(path, true); return std::filesystem::exists(path + ".pzcache"); },
+            nullptr,
+            [path](size_t iterations)
+        {
+            uint64_t loaded = 0;
+            for (size_t i = 0; i < iterations; i++)
+            {
+                PZvend::JSON json;
+                json.SetSidecar(true);
+                loaded += json.Load(path);
+            }
+
+            return loaded;
+        } });
+
+        // Only the window settings, the entity list is skipped without being parsed.
+        cases.push_back({ "json/visit_sparse/" + variant, size, nullptr, nullptr, [path](size_t iterations)
+        {
+            static const std::vector<PZvend::JSON::Path> paths = { PZvend::JSON::Path("Settings", "Window") };
+
+            uint64_t visited = 0;
+            for (size_t i = 0; i < iterations; i++)
+            {
+                std::string error;
+                PZvend::JSON::Visit(path, paths, [&visited](size_t, nlohmann::ordered_json&) { visited++; return true; }, error);
+            }
+
+            return visited;
+        } });
+
+        // Every entity, one at a time.
+        cases.push_back({ "json/visit_all/" + variant, size, nullptr, nullptr, [path](size_t iterations)
+        {
+            static const std::vector<PZvend::JSON::Path> paths = { PZvend::JSON::Path("Entities", "*") };
+
+            uint64_t visited = 0;
+            for (size_t i = 0; i < iterations; i++)
+            {
+                std::string error;
+                PZvend::JSON::Visit(path, paths, [&visited](size_t, nlohmann::ordered_json&) { visited++; return true; }, error);
+            }
+
+            return visited;
+        } });
+
+        // Parse and bind, the document is dropped right after.
+        cases.push_back({ "json/load_struct/" + variant, size, nullptr, nullptr, [path](size_t iterations)
+        {
+            uint64_t loaded = 0;
+            for (size_t i = 0; i < iterations; i++)
+            {
+                BenchDocument                        document;
+                std::vector<PZvend::JsonStructError> errors;
+                loaded += PZvend::JsonStruct::Load(path, document, errors) && document.Settings.Window.Width == 1920;
+            }
+
+            return loaded;
+        } });
+
+        auto document = std::make_shared<PZvend::JSON>(path);
+
+        cases.push_back({ "json/save/" + variant, size, nullptr, nullptr, [document, output](size_t iterations)
+        {
+            uint64_t saved = 0;
+            for (size_t i = 0; i < iterations; i++)
+                saved += document->SaveTo(output);
+
+            return saved;
+        } });
+    }
+}
+
+
+
+void Bench::RegisterJsonCases(std::vector<Case>& cases)
+{
+    RegisterFileCases(cases, "small", 8);
+    RegisterFileCases(cases, "4MB", 16000);
+
+    auto document = std::make_shared<PZvend::JSON>();
+    document->Load(WriteDocument("bench_access.json", 8));
+
+    cases.push_back({ "json/get/nested", 0, nullptr, nullptr, [document](size_t iterations)
+    {
+        uint64_t sum = 0;
+        for (size_t i = 0; i < iterations; i++)
+        {
+            uint32_t value = 0;
+            document->Get(value, "The", "Answer", "To", "Everything");
+            sum += value;
+        }
+
+        return sum;
+    } });
+
+    // Same value through a resolved path, no lookups.
+    cases.push_back({ "json/get/path", 0, nullptr, nullptr, [document](size_t iterations)
+    {
+        static const PZvend::JSON::Path path("The", "Answer", "To", "Everything");
+
+        uint64_t sum = 0;
+        for (size_t i = 0; i < iterations; i++)
+        {
+            uint32_t value = 0;
+            document->Get(value, path);
+            sum += value;
+        }
+
+        return sum;
+    } });
+
+    cases.push_back({ "json/set/nested", 0, nullptr, nullptr, [document](size_t iterations)
+    {
+        for (size_t i = 0; i < iterations; i++)
+            document->Set(static_cast<uint32_t>(i), "Bench", "Counter", "Value");
+
+        return static_cast<uint64_t>(iterations);
+    } });
+
+    // Snapshot plus one read, what a worker thread pays per access instead of a lock.
+    auto shared = std::make_shared<PZvend::ConcurrentJSON>(WriteDocument("bench_concurrent.json", 8));
+
+    cases.push_back({ "json/concurrent/acquire_get", 0, nullptr, nullptr, [shared](size_t iterations)
+    {
+        uint64_t sum = 0;
+        for (size_t i = 0; i < iterations; i++)
+        {
+            uint32_t value = 0;
+            shared->Acquire()->Get(value, "The", "Answer", "To", "Everything");
+            sum += value;
+        }
+
+        return sum;
+    } });
+
+    // Copy, two sets and a publish without readers in the way.
+    cases.push_back({ "json/concurrent/edit", 0, nullptr, nullptr, [shared](size_t iterations)
+    {
+        for (size_t i = 0; i < iterations; i++)
+        {
+            auto edit = shared->BeginEdit();
+            edit->Set(static_cast<uint32_t>(i), "Settings", "Window", "Width");
+            edit->Set(static_cast<uint32_t>(i), "Settings", "Window", "Height");
+            edit.Commit();
+        }
+
+        return static_cast<uint64_t>(iterations);
+    } });
+
+    // The per frame cost of a watched config that isn't edited, compare with a timed Reload.
+    auto watcher = std::make_shared<PZvend::JsonWatcher>();
+    auto watched = std::make_shared<PZvend::JSON>(WriteDocument("bench_watched.json", 8));
+
+    cases.push_back({ "json/watch/poll_idle", 0,
+        [watcher, watched]() { return watcher->Watch(*watched); },
+        [watcher, watched]() { watcher->Unwatch(*watched); },
+        [watcher](size_t iterations)
+    {
+        uint64_t reloaded = 0;
+        for (size_t i = 0; i < iterations; i++)
+            reloaded += watcher->Poll();
+
+        return reloaded + iterations;
+    } });
+
+    cases.push_back({ "json/watch/reload", 0, nullptr, nullptr, [watched](size_t iterations)
+    {
+        uint64_t reloaded = 0;
+        for (size_t i = 0; i < iterations; i++)
+            reloaded += watched->Reload();
+
+        return reloaded;
+    } });
+}
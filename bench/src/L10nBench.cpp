@@ -0,0 +1,85 @@
+#include "Bench.hpp"
+
+#include <ProjectZvend/JSON.hpp>
+#include <ProjectZvend/Localization.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+
+
+
+namespace
+{
+    using namespace PZvend::Literals;
+
+    /*
+    A UI sized table, the same strings as a JSON document and as a catalog.
+    */
+    std::string WriteTable()
+    {
+        const auto directory = std::filesystem::path(Bench::GetScratchDirectory()) / "lang";
+        std::filesystem::create_directories(directory);
+
+        nlohmann::ordered_json json;
+        json["menu"]["start"]    = "Start";
+        json["menu"]["greeting"] = "Hello {}, you have {} coins!";
+
+        for (size_t i = 0; i < 2000; i++)
+            json["ui"]["label_" + std::to_string(i)] = "Label number " + std::to_string(i);
+
+        std::ofstream file(directory / "bench.json");
+        file << json.dump(4);
+        return directory.string();
+    }
+}
+
+
+
+void Bench::RegisterL10nCases(std::vector<Case>& cases)
+{
+    const std::string directory = WriteTable();
+
+    // What the UI did before, a string keyed lookup per label and frame.
+    auto document = std::make_shared<PZvend::JSON>();
+    document->Load((std::filesystem::path(directory) / "bench.json").string());
+
+    cases.push_back({ "l10n/get/json", 0, nullptr, nullptr, [document](size_t iterations)
+    {
+        uint64_t size = 0;
+        for (size_t i = 0; i < iterations; i++)
+        {
+            std::string text;
+            document->Get(text, "menu", "start");
+            size += text.size();
+        }
+
+        return size;
+    } });
+
+    cases.push_back({ "l10n/get/catalog", 0,
+        [directory]() { PZvend::L10n::SetDirectory(directory); PZvend::L10n::SetLanguage("bench"); return !PZvend::L10n::Get<"menu.start"_h>().empty(); },
+        nullptr,
+        [](size_t iterations)
+    {
+        uint64_t size = 0;
+        for (size_t i = 0; i < iterations; i++)
+            size += PZvend::L10n::Get<"menu.start"_h>().size();
+
+        return size;
+    } });
+
+    cases.push_back({ "l10n/format", 0,
+        [directory]() { PZvend::L10n::SetDirectory(directory); PZvend::L10n::SetLanguage("bench"); return !PZvend::L10n::Get<"menu.greeting"_h>().empty(); },
+        nullptr,
+        [](size_t iterations)
+    {
+        char     buffer[128];
+        uint64_t size = 0;
+        for (size_t i = 0; i < iterations; i++)
+            size += PZvend::L10n::Format<"menu.greeting"_h>(buffer, "Zvend", i).size();
+
+        return size;
+    } });
+}
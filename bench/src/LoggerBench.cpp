@@ -0,0 +1,139 @@
+#include "Bench.hpp"
+
+#include <ProjectZvend/BinaryLog.hpp>
+#include <ProjectZvend/Log.hpp>
+#include <ProjectZvend/Logger.hpp>
+#include <ProjectZvend/MappedRingSink.hpp>
+
+#include <spdlog/sinks/basic_file_sink.h>
+#include <spdlog/sinks/null_sink.h>
+
+#include <filesystem>
+#include <memory>
+
+
+
+namespace
+{
+    std::shared_ptr<spdlog::logger> g_BenchLogger;
+
+
+
+    uint64_t LogMessages(size_t iterations)
+    {
+        for (size_t i = 0; i < iterations; i++)
+            g_BenchLogger->info("Player {} moved to ({:.2f}, {:.2f}) in zone '{}'", i, 12.5 + static_cast<double>(i & 0xFF), -3.25, "Lion's Arch");
+
+        return static_cast<uint64_t>(iterations);
+    }
+
+
+
+    // Same pattern and levels as CreateLogger, so only the sink differs between the cases.
+    std::shared_ptr<spdlog::logger> CreateBenchLogger(spdlog::sink_ptr sink)
+    {
+        sink->set_pattern("[%T][%n][%l] %v");
+
+        auto logger = std::make_shared<spdlog::logger>("Bench", sink);
+        logger->set_level(spdlog::level::info);
+        logger->flush_on(spdlog::level::info);
+        return logger;
+    }
+}
+
+
+
+void Bench::RegisterLoggerCases(std::vector<Case>& cases)
+{
+    // Formatting and dispatch only, nothing gets written.
+    cases.push_back({ "logger/null_sink", 0,
+        []() { g_BenchLogger = CreateBenchLogger(std::make_shared<spdlog::sinks::null_sink_mt>()); return true; },
+        []() { g_BenchLogger.reset(); },
+        LogMessages });
+
+    cases.push_back({ "logger/file_sink", 0,
+        []()
+        {
+            const auto path = std::filesystem::path(GetScratchDirectory()) / "bench_file_sink.log";
+            g_BenchLogger = CreateBenchLogger(std::make_shared<spdlog::sinks::basic_file_sink_mt>(path.string(), true));
+            return true;
+        },
+        []() { g_BenchLogger.reset(); },
+        LogMessages });
+
+    // The logger CreateLogger builds for a log directory, flushing every message.
+    cases.push_back({ "logger/rotating_sink", 0,
+        []()
+        {
+            g_BenchLogger = PZvend::CreateLogger("Bench", false, (std::filesystem::path(GetScratchDirectory()) / "logs").string());
+            return true;
+        },
+        []() { g_BenchLogger.reset(); },
+        LogMessages });
+
+    // Same sinks behind the writer thread. Blocking on a full queue, so the number includes back pressure instead of drops.
+    cases.push_back({ "logger/async_rotating_sink", 0,
+        []()
+        {
+            PZvend::LoggerConfig config;
+            config.Path     = (std::filesystem::path(GetScratchDirectory()) / "logs").string();
+            config.Async    = true;
+            config.Overflow = PZvend::LOG_OVERFLOW_BLOCK;
+
+            g_BenchLogger = PZvend::CreateLogger("Bench", config);
+            return true;
+        },
+        []() { g_BenchLogger.reset(); },
+        LogMessages });
+
+    // Format plus a copy into the mapping, no syscall per message.
+    cases.push_back({ "logger/ring_sink", 0,
+        []()
+        {
+            const auto path = std::filesystem::path(GetScratchDirectory()) / "bench_ring_sink.pzring";
+            auto       sink = std::make_shared<PZvend::MappedRingSink>(path.string(), 1024 * 1024);
+            if (!sink->IsOpen())
+                return false;
+
+            g_BenchLogger = CreateBenchLogger(sink);
+            return true;
+        },
+        []() { g_BenchLogger.reset(); },
+        LogMessages });
+
+    // Caller side cost of the deferred path. The file writer only copies bytes, but a single thread logging nonstop still
+    // outruns it, so the share of records that hit the cheaper drop path is reported with the timing.
+    cases.push_back({ "logger/binary_deferred", 0,
+        []()
+        {
+            const auto path = std::filesystem::path(GetScratchDirectory()) / "bench_binary.pzblog";
+            return PZvend::BinaryLog::StartFile(path.string(), spdlog::level::info, std::chrono::milliseconds(1));
+        },
+        []() { PZvend::BinaryLog::Stop(); },
+        [](size_t iterations)
+        {
+            for (size_t i = 0; i < iterations; i++)
+                PZ_BLOG_INFO("Player {} moved to ({:.2f}, {:.2f}) in zone '{}'", i, 12.5 + static_cast<double>(i & 0xFF), -3.25, "Lion's Arch");
+
+            return static_cast<uint64_t>(iterations);
+        },
+        []() { return PZvend::BinaryLog::GetDroppedRecords(); } });
+
+    // A hook failing every frame: after the burst the site's bucket is empty and lines are dropped unformatted.
+    cases.push_back({ "logger/subsystem_storm", 0,
+        []() { PZvend::SetLogLogger(PZvend::LOG_SUBSYSTEM_HOOKS, CreateBenchLogger(std::make_shared<spdlog::sinks::null_sink_mt>())); return true; },
+        []() { PZvend::SetLogLogger(PZvend::LOG_SUBSYSTEM_HOOKS, nullptr); },
+        [](size_t iterations)
+        {
+            for (size_t i = 0; i < iterations; i++)
+                PZ_LOG_ERROR(HOOKS, "Enabling '{}' failed with {}.", "Update", -1);
+
+            return static_cast<uint64_t>(iterations);
+        } });
+
+    // Below the level, the call should cost next to nothing.
+    cases.push_back({ "logger/filtered", 0,
+        []() { g_BenchLogger = CreateBenchLogger(std::make_shared<spdlog::sinks::null_sink_mt>()); g_BenchLogger->set_level(spdlog::level::warn); return true; },
+        []() { g_BenchLogger.reset(); },
+        LogMessages });
+}
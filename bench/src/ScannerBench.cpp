@@ -0,0 +1,173 @@
+#include "Bench.hpp"
+
+#include <ProjectZvend/Memory.hpp>
+
+#include <memory>
+#include <random>
+
+
+
+namespace
+{
+    constexpr size_t  PATTERN_LENGTH = 16;
+    constexpr uint8_t ANCHOR         = 0xE8; // First pattern byte, the scanner compares it before anything else.
+
+    struct Density
+    {
+        const char* Name;
+        uint32_t    AnchorEvery; // One anchor byte every n bytes on average.
+    };
+
+    struct Buffer
+    {
+        std::vector<uint8_t> Bytes;
+        uint8_t              Pattern[PATTERN_LENGTH];
+        char                 Mask[2][PATTERN_LENGTH + 1]; // Solid, half wildcards.
+    };
+
+    constexpr Density DENSITIES[] = {
+        { "rare",    4096 },
+        { "natural", 256 },  // Like random data.
+        { "dense",   8 },    // Worst case, the full compare runs constantly.
+    };
+
+    constexpr std::pair<const char*, size_t> SIZES[] = {
+        { "64KB", 64 * 1024 },
+        { "1MB",  1024 * 1024 },
+        { "16MB", 16 * 1024 * 1024 },
+    };
+
+
+
+    /*
+    Random bytes without the anchor, then anchors sprinkled in at the wanted frequency. Every anchor is
+    followed by the pattern's second byte half of the time, so partial matches run a few compares deep.
+    The full pattern doesn't occur, Find always scans the whole buffer.
+    */
+    std::shared_ptr<Buffer> CreateBuffer(size_t size, uint32_t anchor_every)
+    {
+        auto         buffer = std::make_shared<Buffer>();
+        std::mt19937 rng(static_cast<uint32_t>(size ^ anchor_every)); // Fixed seeds, every run scans the same data.
+
+        // Even with every odd byte a wildcard, eight random bytes would have to line up for a match.
+        for (size_t i = 0; i < PATTERN_LENGTH; i++)
+        {
+            buffer->Pattern[i] = static_cast<uint8_t>(i == 0 ? ANCHOR : 0x40 + i);
+            buffer->Mask[0][i] = 'x';
+            buffer->Mask[1][i] = i % 2 == 1 ? '?' : 'x';
+        }
+
+        buffer->Mask[0][PATTERN_LENGTH] = '\0';
+        buffer->Mask[1][PATTERN_LENGTH] = '\0';
+
+        buffer->Bytes.resize(size);
+        for (uint8_t& byte : buffer->Bytes)
+        {
+            byte = static_cast<uint8_t>(rng());
+            if (byte == ANCHOR)
+                byte = 0x00;
+        }
+
+        std::uniform_int_distribution<uint32_t> pick(0, anchor_every - 1);
+        for (size_t i = 0; i + PATTERN_LENGTH < size; i++)
+        {
+            if (pick(rng) != 0)
+                continue;
+
+            buffer->Bytes[i] = ANCHOR;
+            if (rng() & 1)
+                buffer->Bytes[i + 1] = buffer->Pattern[1];
+        }
+
+        return buffer;
+    }
+
+
+
+    // The ranges are explicit, the module only gives the scanner something to be constructed from.
+    const PZvend::Memory::Scanner& GetScanner()
+    {
+        static const PZvend::Memory::Scanner scanner(nullptr);
+        return scanner;
+    }
+}
+
+
+
+void Bench::RegisterScannerCases(std::vector<Case>& cases)
+{
+    for (const auto& [size_name, size] : SIZES)
+    {
+        for (const Density& density : DENSITIES)
+        {
+            auto buffer = CreateBuffer(size, density.AnchorEvery);
+
+            for (int wildcards = 0; wildcards < 2; wildcards++)
+            {
+                const std::string variant = std::string(size_name) + "/" + density.Name + (wildcards ? "/wildcards" : "/solid");
+
+                cases.push_back({ "scanner/find/" + variant, size, nullptr, nullptr, [buffer, wildcards](size_t iterations)
+                {
+                    uint8_t* start = buffer->Bytes.data();
+                    uint8_t* end   = start + buffer->Bytes.size();
+
+                    uint64_t found = 0;
+                    for (size_t i = 0; i < iterations; i++)
+                        found += GetScanner().Find(buffer->Pattern, buffer->Mask[wildcards], start, end) != nullptr;
+
+                    return found;
+                } });
+
+                // Backwards scans only differ in direction, one size is enough.
+                if (size == 1024 * 1024)
+                {
+                    cases.push_back({ "scanner/find_backward/" + variant, size, nullptr, nullptr, [buffer, wildcards](size_t iterations)
+                    {
+                        uint8_t* start = buffer->Bytes.data() + buffer->Bytes.size() - PATTERN_LENGTH;
+                        uint8_t* end   = buffer->Bytes.data() + PATTERN_LENGTH;
+
+                        uint64_t found = 0;
+                        for (size_t i = 0; i < iterations; i++)
+                            found += GetScanner().Find(buffer->Pattern, buffer->Mask[wildcards], start, end) != nullptr;
+
+                        return found;
+                    } });
+                }
+            }
+
+            // FindAll on a pattern that does occur, short enough to match at the anchor density.
+            cases.push_back({ "scanner/find_all/" + std::string(size_name) + "/" + density.Name, size, nullptr, nullptr, [buffer](size_t iterations)
+            {
+                const uint8_t pattern[] = { ANCHOR, buffer->Pattern[1] };
+                uint8_t*      start     = buffer->Bytes.data();
+                uint8_t*      end       = start + buffer->Bytes.size();
+
+                uint64_t found = 0;
+                for (size_t i = 0; i < iterations; i++)
+                    found += GetScanner().FindAll(pattern, "xx", start, end).size();
+
+                return found;
+            } });
+        }
+    }
+
+    const char* combos[][2] = {
+        { "short", "E8 ?? ?? ?? ?? 48 8B" },
+        { "long",  "48 89 5C 24 ?? 48 89 74 24 ?? 57 48 83 EC 20 48 8B F9 E8 ?? ?? ?? ?? 48 8B D8 48 85 C0 74 ?? 48 8B 0D ?? ?? ?? ??" },
+    };
+
+    for (const auto& [name, combo] : combos)
+    {
+        cases.push_back({ std::string("scanner/convert_combo/") + name, 0, nullptr, nullptr, [combo](size_t iterations)
+        {
+            uint8_t  pattern[256];
+            char     mask[256];
+            uint64_t length = 0;
+
+            for (size_t i = 0; i < iterations; i++)
+                length += PZvend::Memory::ConvertComboPattern(combo, pattern, mask);
+
+            return length;
+        } });
+    }
+}
@@ -0,0 +1,99 @@
+#include "Bench.hpp"
+
+#include <ProjectZvend/Logger.hpp>
+#include <ProjectZvend/Memory.hpp>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+/*
+Micro and macro benchmarks for the scanner, JSON, the logger sinks and the hooking backends.
+
+Usage: ProjectZvend_bench [--filter text] [--out results.json] [--baseline results.json]
+                          [--threshold percent] [--min-time ms] [--runs n]
+
+--filter     Only runs cases whose name contains the text, e.g. "scanner/find/" or "json".
+--out        Writes the results as JSON, the file can be used as a baseline later.
+--baseline   Compares against an earlier --out file, exits with 1 if a case regressed.
+--threshold  Percent a case may be slower than the baseline, 10 by default.
+--min-time   Milliseconds one run takes at least, 20 by default.
+--runs       Runs per case, the median is reported. 7 by default.
+
+Inputs are generated from fixed seeds into the temp directory, nothing is downloaded.
+*/
+
+namespace
+{
+    bool ParseOptions(int argc, char** argv, Bench::Options& options)
+    {
+        for (int i = 1; i < argc; i++)
+        {
+            const std::string argument = argv[i];
+            if (i + 1 >= argc)
+            {
+                spdlog::error("Missing value for '{}'.", argument);
+                return false;
+            }
+
+            const std::string value = argv[++i];
+            try
+            {
+                if (argument == "--filter")
+                    options.Filter = value;
+                else if (argument == "--out")
+                    options.Output = value;
+                else if (argument == "--baseline")
+                    options.Baseline = value;
+                else if (argument == "--threshold")
+                    options.Threshold = std::stod(value);
+                else if (argument == "--min-time")
+                    options.MinTime = std::stod(value);
+                else if (argument == "--runs")
+                    options.Runs = std::max(1, std::stoi(value));
+                else
+                {
+                    spdlog::error("Unknown argument '{}'.", argument);
+                    return false;
+                }
+            }
+            catch (const std::exception&)
+            {
+                spdlog::error("Invalid value '{}' for '{}'.", value, argument);
+                return false;
+            }
+        }
+
+        return true;
+    }
+}
+
+
+
+int main(int argc, char** argv)
+{
+    spdlog::set_default_logger(PZvend::CreateLogger("Bench", true));
+
+    Bench::Options options;
+    if (!ParseOptions(argc, argv, options))
+        return 2;
+
+    PZvend::Memory::Initialize();
+
+    std::vector<Bench::Case> cases;
+    Bench::RegisterHookCases(cases);
+    Bench::RegisterScannerCases(cases);
+    Bench::RegisterJsonCases(cases);
+    Bench::RegisterLoggerCases(cases);
+    Bench::RegisterL10nCases(cases);
+
+    const std::vector<Bench::Result> results = Bench::RunCases(cases, options);
+
+    if (!options.Output.empty() && !Bench::WriteResults(results, options.Output))
+        return 2;
+
+    if (!options.Baseline.empty() && !Bench::CompareBaseline(results, options.Baseline, options.Threshold))
+        return 1;
+
+    return 0;
+}
@@ -0,0 +1,304 @@
+#include <ProjectZvend/JSON.hpp>
+#include <ProjectZvend/Logger.hpp>
+#include <ProjectZvend/MappedFile.hpp>
+#include <ProjectZvend/Memory.hpp>
+#include <ProjectZvend/Stopwatch.hpp>
+
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*
+Validates a signature list against a directory of PE/ELF images.
+
+Usage: SignatureCorpus <signatures.txt> <image-dir> [output.json] [--threads N] [--strict]
+
+Signature file, one per line ('#' starts a comment):
+    <name> <section> <combo-pattern>
+    PlayerUpdate TEXT 55 48 89 E5 48 83 EC ?? 48 8B 05
+*/
+
+static auto g_Logger = PZvend::CreateLogger("Corpus", true);
+
+namespace
+{
+    constexpr size_t MAX_PATTERN = 256;
+    constexpr size_t MAX_RVAS    = 16;  // Only the first hits are listed, the count is always complete.
+
+    struct Signature
+    {
+        std::string                 Name;
+        PZvend::Memory::ScanSection Section = PZvend::Memory::TEXT;
+        uint8_t                     Pattern[MAX_PATTERN];
+        char                        Mask[MAX_PATTERN];
+    };
+
+    struct Image
+    {
+        std::string                              Name;
+        PZvend::MappedFile                       File;
+        std::unique_ptr<PZvend::Memory::Scanner> Scanner;
+    };
+
+    struct Result
+    {
+        bool                SectionMissing = false;
+        size_t              Hits = 0;
+        std::vector<size_t> RVAs;
+        double              TimeMS = 0.0;
+    };
+
+
+
+    bool ParseSection(const std::string& name, PZvend::Memory::ScanSection& out_section)
+    {
+        static const char* names[PZvend::Memory::ScanSection::MAX] = {
+            "TEXT", "RDATA", "DATA", "BSS", "EDATA", "IDATA", "RELOC", "RSRC", "TLS", "PDATA", "DEBUG"
+        };
+
+        for (uint16_t i = 0; i < PZvend::Memory::ScanSection::MAX; i++)
+        {
+            if (name == names[i])
+            {
+                out_section = static_cast<PZvend::Memory::ScanSection>(i);
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+
+
+    bool LoadSignatures(const std::string& filepath, std::vector<Signature>& out_signatures)
+    {
+        std::ifstream file(filepath);
+        if (!file.is_open())
+        {
+            g_Logger->critical("Could not open signature list '{}'.", filepath);
+            return false;
+        }
+
+        std::string line;
+        for (size_t number = 1; std::getline(file, line); number++)
+        {
+            line = line.substr(0, line.find('#'));
+
+            std::istringstream stream(line);
+            std::string        name, section, combo;
+
+            if (!(stream >> name))
+                continue;
+
+            stream >> section;
+            std::getline(stream, combo);
+
+            Signature signature;
+            signature.Name = name;
+
+            if (!ParseSection(section, signature.Section))
+            {
+                g_Logger->error("{}:{} unknown section '{}'.", filepath, number, section);
+                return false;
+            }
+
+            // A leading space would make ConvertComboPattern read the first byte twice.
+            combo.erase(0, combo.find_first_not_of(" \t"));
+            combo.erase(combo.find_last_not_of(" \t\r") + 1);
+
+            if (combo.empty() || combo.size() >= MAX_PATTERN || !PZvend::Memory::ConvertComboPattern(combo.c_str(), signature.Pattern, signature.Mask))
+            {
+                g_Logger->error("{}:{} invalid pattern for '{}'.", filepath, number, name);
+                return false;
+            }
+
+            out_signatures.push_back(std::move(signature));
+        }
+
+        return true;
+    }
+
+
+
+    bool IsImage(const PZvend::MappedFile& file)
+    {
+        const uint8_t* data = file.GetData();
+
+        return file.GetSize() >= 4 && ((data[0] == 'M' && data[1] == 'Z') || memcmp(data, "\x7F" "ELF", 4) == 0);
+    }
+
+
+
+    std::string ToHex(size_t value)
+    {
+        return fmt::format("0x{:X}", value);
+    }
+}
+
+
+
+int main(int argc, char** argv)
+{
+    std::vector<std::string> positional;
+    unsigned int             thread_count = std::max(1u, std::thread::hardware_concurrency());
+    bool                     strict       = false;
+
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+
+        if (arg == "--threads" && i + 1 < argc)
+            thread_count = std::max(1, std::atoi(argv[++i]));
+
+        else if (arg == "--strict")
+            strict = true;
+
+        else
+            positional.push_back(arg);
+    }
+
+    if (positional.size() < 2)
+    {
+        g_Logger->info("Usage: SignatureCorpus <signatures.txt> <image-dir> [output.json] [--threads N] [--strict]");
+        return 2;
+    }
+
+    const std::string output = positional.size() > 2 ? positional[2] : "corpus.json";
+
+    std::vector<Signature> signatures;
+    if (!LoadSignatures(positional[0], signatures))
+        return 1;
+
+    std::vector<Image> images;
+    std::error_code    error;
+
+    for (const auto& entry : std::filesystem::directory_iterator(positional[1], error))
+    {
+        if (!entry.is_regular_file())
+            continue;
+
+        Image image;
+        image.Name = entry.path().filename().string();
+
+        if (!image.File.Open(entry.path().string()) || !IsImage(image.File))
+            continue;
+
+        images.push_back(std::move(image));
+    }
+
+    if (error)
+    {
+        g_Logger->critical("Could not read image directory '{}': {}", positional[1], error.message());
+        return 1;
+    }
+
+    std::sort(images.begin(), images.end(), [](const Image& lhs, const Image& rhs) { return lhs.Name < rhs.Name; });
+
+    // Scanners are created after sorting, they keep pointers into the mapped files.
+    for (Image& image : images)
+        image.Scanner = std::make_unique<PZvend::Memory::Scanner>(image.File);
+
+    g_Logger->info("Scanning {} signatures x {} images on {} threads.", signatures.size(), images.size(), thread_count);
+
+    PZvend::Stopwatch   total(0.0);
+    std::vector<Result> results(images.size() * signatures.size());
+    std::atomic<size_t> next_job = 0;
+
+    auto worker = [&]()
+    {
+        for (size_t job = next_job++; job < results.size(); job = next_job++)
+        {
+            const Image&     image     = images[job / signatures.size()];
+            const Signature& signature = signatures[job % signatures.size()];
+            Result&          result    = results[job];
+
+            // Missing sections are reported as such, they say nothing about the signature itself.
+            if (!image.Scanner->HasSection(signature.Section))
+            {
+                result.SectionMissing = true;
+                continue;
+            }
+
+            PZvend::Stopwatch watch(0.0);
+            auto hits = image.Scanner->FindAll(signature.Pattern, signature.Mask, signature.Section);
+            result.TimeMS = watch.GetElapsedTime() * 1000.0;
+
+            result.Hits = hits.size();
+            for (size_t i = 0; i < hits.size() && i < MAX_RVAS; i++)
+                result.RVAs.push_back(image.Scanner->GetRVA(hits[i]));
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (unsigned int i = 0; i < thread_count; i++)
+        threads.emplace_back(worker);
+
+    for (std::thread& thread : threads)
+        thread.join();
+
+    PZvend::JSON json;
+    bool         all_unique = true;
+
+    for (size_t s = 0; s < signatures.size(); s++)
+    {
+        uint32_t unique = 0, missing = 0, ambiguous = 0, no_section = 0;
+
+        for (size_t i = 0; i < images.size(); i++)
+        {
+            const Result&            result = results[i * signatures.size() + s];
+            std::vector<std::string> rvas;
+
+            if (result.SectionMissing)
+            {
+                json.Set(std::string("section missing"), "results", images[i].Name, signatures[s].Name, "status");
+                no_section++;
+                continue;
+            }
+
+            for (size_t rva : result.RVAs)
+                rvas.push_back(ToHex(rva));
+
+            json.Set(result.Hits,   "results", images[i].Name, signatures[s].Name, "hits");
+            json.Set(rvas,          "results", images[i].Name, signatures[s].Name, "rvas");
+            json.Set(result.TimeMS, "results", images[i].Name, signatures[s].Name, "time_ms");
+
+            if (result.Hits == 0)
+                missing++;
+
+            else if (result.Hits == 1)
+                unique++;
+
+            else
+                ambiguous++;
+        }
+
+        json.Set(unique,    "summary", signatures[s].Name, "unique");
+        json.Set(missing,   "summary", signatures[s].Name, "missing");
+        json.Set(ambiguous, "summary", signatures[s].Name, "ambiguous");
+        json.Set(no_section, "summary", signatures[s].Name, "section_missing");
+
+        all_unique &= (missing == 0 && ambiguous == 0 && no_section == 0);
+
+        if (missing || ambiguous)
+            g_Logger->warn("'{}' is missing in {} and ambiguous in {} of {} images.", signatures[s].Name, missing, ambiguous, images.size());
+
+        if (no_section)
+            g_Logger->warn("'{}' names a section that {} of {} images don't have.", signatures[s].Name, no_section, images.size());
+    }
+
+    json.Set(images.size(),              "images");
+    json.Set(signatures.size(),          "signatures");
+    json.Set(total.GetElapsedTime(),     "time_s");
+
+    if (!json.SaveTo(output))
+    {
+        g_Logger->critical("Could not write '{}'.", output);
+        return 1;
+    }
+
+    g_Logger->info("Wrote '{}' in {:.3f}s.", output, total.GetElapsedTime());
+    return strict && !all_unique ? 1 : 0;
+}
@@ -0,0 +1,382 @@
+#pragma once
+
+#include "ProjectZvend/Stopwatch.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+
+
+/*
+Deferred formatting for hot paths. A call only copies the site id, a timestamp and the raw
+argument bytes into the calling thread's ring. Formatting happens later, on the writer thread
+(BinaryLog::Start) or offline with ProjectZvend_logtool (BinaryLog::StartFile).
+
+PZ_BLOG_INFO("Hooked {} at {}, speed {:.2f}", name, static_cast<const void*>(address), speed);
+
+The format string is checked against the arguments at compile time like spdlog's, and each call
+site registers it once. Supported arguments are bool, char, integers, enums, floats, pointers
+and strings. Strings are copied, up to BINARY_LOG_MAX_STRING bytes.
+*/
+#define PZ_BLOG(level, ...)                                                                      \
+    do                                                                                           \
+    {                                                                                            \
+        if (::PZvend::BinaryLog::IsEnabled(level))                                               \
+        {                                                                                        \
+            static ::PZvend::BinaryLog::Site pz_blog_site{ level, __FILE__, __LINE__ };          \
+            ::PZvend::BinaryLog::Write(pz_blog_site, __VA_ARGS__);                               \
+        }                                                                                        \
+    } while (0)
+
+#define PZ_BLOG_DEBUG(...) PZ_BLOG(::spdlog::level::debug, __VA_ARGS__)
+#define PZ_BLOG_INFO(...)  PZ_BLOG(::spdlog::level::info, __VA_ARGS__)
+#define PZ_BLOG_WARN(...)  PZ_BLOG(::spdlog::level::warn, __VA_ARGS__)
+#define PZ_BLOG_ERROR(...) PZ_BLOG(::spdlog::level::err, __VA_ARGS__)
+
+
+
+namespace PZvend
+{
+    namespace BinaryLog
+    {
+
+/*************\
+*    Types    *
+\*************/
+        constexpr uint32_t BINARY_LOG_RING_CAPACITY = 1 << 16; // Bytes per thread between two writer passes, more get dropped.
+        constexpr uint32_t BINARY_LOG_MAX_STRING    = 1024;    // Longer string arguments are cut.
+
+        enum BinaryLogArg : uint8_t
+        {
+            BLOG_ARG_BOOL,
+            BLOG_ARG_CHAR,
+            BLOG_ARG_I32,
+            BLOG_ARG_U32,
+            BLOG_ARG_I64,
+            BLOG_ARG_U64,
+            BLOG_ARG_F32,
+            BLOG_ARG_F64,
+            BLOG_ARG_POINTER, // uint64
+            BLOG_ARG_STRING,  // uint32 length, char[length]
+        };
+
+        /*
+        File layout of StartFile (little endian, no padding):
+            header  char[8] "PZBLOG\0\0", uint32 version, uint32 reserved, double ticks per second,
+                    uint64 start ticks, int64 start time (ns since the unix epoch)
+            site    uint8 1, uint32 id, uint8 level, uint32 line, uint16 length, char[length] file,
+                    uint16 length, char[length] format, uint8 count, uint8[count] BinaryLogArg
+            thread  uint8 2, uint32 thread id, uint64 os thread id
+            entry   uint8 3, uint32 thread id, uint32 site id, uint64 ticks, uint32 size, uint8[size] arguments
+
+        Sites and threads are written before the first entry using them.
+        */
+        constexpr uint32_t BINARY_LOG_VERSION = 1;
+
+        /*
+        One per PZ_BLOG call site, constant initialized. Id is assigned on the first call.
+        */
+        struct Site
+        {
+            spdlog::level::level_enum Level;
+            const char*               File;
+            uint32_t                  Line;
+            std::atomic<uint32_t>     Id = 0;
+        };
+
+        /*
+        A registered site, as the writer and the decoder see it.
+        */
+        struct SiteInfo
+        {
+            uint32_t                  Id    = 0;
+            spdlog::level::level_enum Level = spdlog::level::info;
+            uint32_t                  Line  = 0;
+            std::string               File;
+            std::string               Format;
+            std::vector<BinaryLogArg> Args;
+        };
+
+        // Ring record, padded to 8 bytes. Site 0 marks the unused rest of the ring before a wrap.
+        struct RecordHeader
+        {
+            uint32_t Size;
+            uint32_t Site;
+            uint64_t Ticks;
+        };
+
+        // Lowest level that gets recorded, off while no session runs. Only read on the hot path.
+        inline std::atomic<int> g_Level = spdlog::level::off;
+
+
+
+/*************\
+*  Functions  *
+\*************/
+
+        /*
+        Starts a session that formats on the writer thread and hands the lines to the logger, with
+        the time of the call. The logger's pattern sees the writer thread, not the calling one.
+
+        @param level Lowest level recorded, the logger's own level still applies on top.
+        @param interval Time between two writer passes, the per thread rings have to hold the records of one interval.
+        @return Returns false if a session is already running.
+        */
+        bool Start(std::shared_ptr<spdlog::logger> logger, spdlog::level::level_enum level = spdlog::level::info, std::chrono::milliseconds interval = std::chrono::milliseconds(10));
+
+
+
+        /*
+        Starts a session that writes the raw records, decode the file with ProjectZvend_logtool.
+
+        @param path File to write, it gets truncated.
+        @return Returns false if a session is already running or the file can't be opened.
+        */
+        bool StartFile(const std::string& path, spdlog::level::level_enum level = spdlog::level::info, std::chrono::milliseconds interval = std::chrono::milliseconds(10));
+
+
+
+        /*
+        Stops recording and writes what is left in the rings.
+        */
+        void Stop();
+
+
+
+        void SetLevel(spdlog::level::level_enum level) noexcept;
+
+        [[nodiscard]] inline bool IsEnabled(spdlog::level::level_enum level) noexcept { return level >= g_Level.load(std::memory_order_relaxed); }
+
+
+
+        /*
+        Records that didn't fit into their thread's ring since the session started.
+        */
+        [[nodiscard]] uint64_t GetDroppedRecords() noexcept;
+
+
+
+        /*
+        Formats the arguments of one record with the site's format string.
+
+        @return Returns false if the arguments don't match the site or the format throws.
+        */
+        bool FormatRecord(const SiteInfo& site, const uint8_t* arguments, size_t size, std::string& out);
+
+
+
+        /*
+        Used by Write, assigns the site its id. Thread safe, the first caller wins.
+        */
+        uint32_t RegisterSite(Site& site, std::string_view format, const BinaryLogArg* args, size_t count);
+
+
+
+        /*
+        Reserves size bytes in the calling thread's ring, nullptr if it is full.
+        Commit publishes the last reservation of the thread.
+        */
+        [[nodiscard]] uint8_t* Reserve(uint32_t size) noexcept;
+        void Commit(uint32_t size) noexcept;
+
+
+
+        template <class T>
+        constexpr BinaryLogArg GetArgType() noexcept
+        {
+            using Type = std::remove_cvref_t<T>;
+
+            if constexpr (std::is_same_v<Type, bool>)
+                return BLOG_ARG_BOOL;
+            else if constexpr (std::is_same_v<Type, char>)
+                return BLOG_ARG_CHAR;
+            else if constexpr (std::is_enum_v<Type>)
+                return GetArgType<std::underlying_type_t<Type>>();
+            else if constexpr (std::is_integral_v<Type> && std::is_signed_v<Type>)
+                return sizeof(Type) <= 4 ? BLOG_ARG_I32 : BLOG_ARG_I64;
+            else if constexpr (std::is_integral_v<Type>)
+                return sizeof(Type) <= 4 ? BLOG_ARG_U32 : BLOG_ARG_U64;
+            else if constexpr (std::is_same_v<Type, float>)
+                return BLOG_ARG_F32;
+            else if constexpr (std::is_floating_point_v<Type>)
+                return BLOG_ARG_F64;
+            else if constexpr (std::is_convertible_v<const T&, std::string_view>)
+                return BLOG_ARG_STRING;
+            else if constexpr (std::is_pointer_v<Type>)
+                return BLOG_ARG_POINTER;
+            else
+                static_assert(std::is_pointer_v<Type>, "PZ_BLOG: unsupported argument type, convert it to a number or a string.");
+        }
+
+
+
+        template <class T>
+        inline std::string_view ToStringView(const T& value) noexcept
+        {
+            if constexpr (std::is_pointer_v<T>)
+                return value ? std::string_view(value) : std::string_view();
+            else
+                return std::string_view(value);
+        }
+
+
+
+        template <class T>
+        inline uint32_t GetArgSize(const T& value) noexcept
+        {
+            constexpr BinaryLogArg type = GetArgType<T>();
+
+            if constexpr (type == BLOG_ARG_STRING)
+                return sizeof(uint32_t) + static_cast<uint32_t>(std::min<size_t>(ToStringView(value).size(), BINARY_LOG_MAX_STRING));
+            else if constexpr (type == BLOG_ARG_BOOL || type == BLOG_ARG_CHAR)
+                return 1;
+            else if constexpr (type == BLOG_ARG_I32 || type == BLOG_ARG_U32 || type == BLOG_ARG_F32)
+                return 4;
+            else
+                return 8;
+        }
+
+
+
+        template <class T>
+        inline uint8_t* EncodeArg(uint8_t* out, const T& value) noexcept
+        {
+            constexpr BinaryLogArg type = GetArgType<T>();
+
+            const auto put = [&out](const auto& raw)
+            {
+                std::memcpy(out, &raw, sizeof(raw));
+                out += sizeof(raw);
+            };
+
+            if constexpr (type == BLOG_ARG_STRING)
+            {
+                const std::string_view text = ToStringView(value);
+                const uint32_t         length = static_cast<uint32_t>(std::min<size_t>(text.size(), BINARY_LOG_MAX_STRING));
+
+                put(length);
+                std::memcpy(out, text.data(), length);
+                out += length;
+            }
+            else if constexpr (type == BLOG_ARG_BOOL)
+                put(static_cast<uint8_t>(value));
+            else if constexpr (type == BLOG_ARG_CHAR)
+                put(value);
+            else if constexpr (type == BLOG_ARG_I32)
+                put(static_cast<int32_t>(value));
+            else if constexpr (type == BLOG_ARG_U32)
+                put(static_cast<uint32_t>(value));
+            else if constexpr (type == BLOG_ARG_I64)
+                put(static_cast<int64_t>(value));
+            else if constexpr (type == BLOG_ARG_U64)
+                put(static_cast<uint64_t>(value));
+            else if constexpr (type == BLOG_ARG_F32)
+                put(value);
+            else if constexpr (type == BLOG_ARG_F64)
+                put(static_cast<double>(value));
+            else
+                put(static_cast<uint64_t>(reinterpret_cast<uintptr_t>(value)));
+
+            return out;
+        }
+
+
+
+        /*
+        Use PZ_BLOG, it skips the argument evaluation below the level and provides the site.
+        */
+        template <class... Args>
+        inline void Write(Site& site, spdlog::format_string_t<const Args&...> format, const Args&... args) noexcept
+        {
+            uint32_t id = site.Id.load(std::memory_order_acquire);
+            if (!id)
+            {
+                static constexpr BinaryLogArg types[] = { GetArgType<Args>()..., BLOG_ARG_BOOL }; // Never empty.
+
+                const auto view = fmt::string_view(format);
+                id = RegisterSite(site, std::string_view(view.data(), view.size()), types, sizeof...(Args));
+                if (!id)
+                    return;
+            }
+
+            const uint32_t size   = (static_cast<uint32_t>(sizeof(RecordHeader)) + (GetArgSize(args) + ... + 0u) + 7u) & ~7u;
+            uint8_t*       record = Reserve(size);
+            if (!record)
+                return;
+
+            const RecordHeader header = { size, id, ReadCycleCounter() };
+            std::memcpy(record, &header, sizeof(header));
+
+            uint8_t* out = record + sizeof(header);
+            ((out = EncodeArg(out, args)), ...);
+            (void)out;
+
+            Commit(size);
+        }
+
+
+
+/*************\
+*   Classes   *
+\*************/
+
+        struct BinaryLogEntry
+        {
+            const SiteInfo*                       Site     = nullptr;
+            uint64_t                              ThreadId = 0; // OS thread id.
+            std::chrono::system_clock::time_point Time;
+            std::string                           Message;
+        };
+
+        /**
+        * @brief Decodes a StartFile log, used by ProjectZvend_logtool.
+        *
+        * BinaryLogReader reader;
+        * if (reader.Open("game.pzblog"))
+        * {
+        *     BinaryLogEntry entry;
+        *     while (reader.Next(entry))
+        *         fmt::print("{}\n", entry.Message);
+        * }
+        *
+        * A file cut off by a crash reads up to the last complete record.
+        */
+        class BinaryLogReader
+        {
+        public:
+            bool Open(const std::string& path);
+
+            /*
+            @return Returns false at the end of the file or on a damaged record, see GetError.
+            */
+            bool Next(BinaryLogEntry& entry);
+
+            [[nodiscard]] inline const std::string& GetError() const noexcept { return m_Error; }
+
+        private:
+            bool IRead(void* out, size_t size);
+            bool IReadString(std::string& out);
+            bool IFail(const std::string& error);
+
+        private:
+            std::vector<uint8_t>                       m_Data;
+            size_t                                     m_Offset = 0;
+            double                                     m_TicksPerSecond = 1.0;
+            uint64_t                                   m_StartTicks = 0;
+            std::chrono::system_clock::time_point      m_StartTime;
+            std::vector<std::unique_ptr<SiteInfo>>     m_Sites;   // By id - 1.
+            std::vector<std::pair<uint32_t, uint64_t>> m_Threads; // Id, OS id.
+            std::string                                m_Error;
+        };
+    }
+}
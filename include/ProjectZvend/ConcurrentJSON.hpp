@@ -0,0 +1,133 @@
+#pragma once
+
+#include "ProjectZvend/GracePeriod.hpp"
+#include "ProjectZvend/JSON.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+
+
+
+namespace PZvend
+{
+
+/*************\
+*   Classes   *
+\*************/
+
+    /**
+    * @brief JSON document shared between threads, read through immutable snapshots.
+    *
+    * Acquire is wait-free: a couple of atomic increments, no lock, no retry. A snapshot is a
+    * reference to one published version and never changes, holding it keeps that version alive.
+    * Writers edit a private copy and publish it as the next version with one atomic swap, so any
+    * number of Set calls become visible together. Writers are serialized, a publish waits until
+    * no reader is still in the middle of an Acquire of the version it replaces.
+    *
+    * Every edit copies the whole document, batch the changes of a frame into one Edit.
+    * JSON::Path caches aren't thread safe, keep paths per thread (E.G.: static thread_local).
+    *
+    * // Any thread
+    * const auto config = g_Config.Acquire();
+    * config->Get(width, "Window", "Width");
+    *
+    * // UI thread
+    * auto edit = g_Config.BeginEdit();
+    * edit->Set(1920, "Window", "Width");
+    * edit->Set(1080, "Window", "Height");
+    * edit.Commit();
+    * g_Config.Acquire()->SaveAsync();
+    */
+    class ConcurrentJSON
+    {
+    public:
+        using Snapshot = std::shared_ptr<const JSON>;
+
+
+
+        /**
+        * @brief Private copy of the current version. Holds the writer lock until it is destroyed,
+        * changes that weren't committed are dropped.
+        */
+        class Edit
+        {
+        public:
+            Edit(Edit&&) noexcept            = default;
+            Edit& operator=(Edit&&) noexcept = default;
+
+            [[nodiscard]] inline JSON& operator*()  const noexcept { return *m_Json; }
+            [[nodiscard]] inline JSON* operator->() const noexcept { return m_Json.get(); }
+
+
+
+            /*
+            Publishes the copy as the new version and releases the writer lock, the edit can't be used afterwards.
+            */
+            void Commit();
+
+        private:
+            friend class ConcurrentJSON;
+            Edit(ConcurrentJSON& owner);
+
+            ConcurrentJSON*              m_Owner;
+            std::unique_lock<std::mutex> m_Lock;
+            std::shared_ptr<JSON>        m_Json;
+        };
+
+        ConcurrentJSON();
+        explicit ConcurrentJSON(const std::string& filepath, const bool sidecar = false);
+        ~ConcurrentJSON();
+
+        ConcurrentJSON(const ConcurrentJSON&)            = delete;
+        ConcurrentJSON& operator=(const ConcurrentJSON&) = delete;
+
+
+
+        /*
+        @return Returns the current version, never nullptr.
+        */
+        [[nodiscard]] Snapshot Acquire() const;
+
+
+
+        /*
+        Starts an edit of the current version, waiting for other writers first.
+        */
+        [[nodiscard]] Edit BeginEdit();
+
+
+
+        /*
+        Parses the file aside and publishes it. On failure the current version stays.
+        */
+        bool Load(const std::string& filepath);
+        bool Reload();
+
+
+
+        /*
+        Number of versions published so far, the initial one not counted.
+        */
+        [[nodiscard]] inline uint64_t GetVersion() const noexcept { return m_Published.load(std::memory_order_acquire); }
+
+    private:
+        // Only touched by Acquire between the reader counts, freed after a grace period.
+        struct Version
+        {
+            Snapshot Json;
+        };
+
+        void IPublish(std::shared_ptr<const JSON> json);
+
+    private:
+        std::mutex m_WriteMutex;
+
+        std::atomic<Version*> m_Current;
+        std::atomic<uint64_t> m_Published = 0;
+
+        GracePeriod           m_Grace;
+    };
+}
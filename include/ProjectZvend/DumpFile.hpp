@@ -0,0 +1,121 @@
+#pragma once
+
+#include "ProjectZvend/MappedFile.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+
+
+namespace PZvend
+{
+    namespace Memory
+    {
+
+/*************\
+*    Types    *
+\*************/
+        enum DumpFormat : uint8_t
+        {
+            UNKNOWN_DUMP,
+            MINIDUMP,     // Windows minidump (MINIDUMP_MODULE_LIST + MINIDUMP_MEMORY(64)_LIST).
+            ELF_CORE,     // Linux ELF64 core file (PT_LOAD segments + NT_FILE note).
+        };
+
+        enum RegionAccess : uint8_t
+        {
+            REGION_UNKNOWN = 0x00, // Minidumps don't record the page protection of captured memory.
+            REGION_READ    = 0x01,
+            REGION_WRITE   = 0x02,
+            REGION_EXECUTE = 0x04,
+        };
+
+        struct DumpModule
+        {
+            std::string Name;     // Full path as recorded in the dump.
+            uint64_t    Base = 0; // Virtual address in the crashed process.
+            uint64_t    Size = 0;
+        };
+
+        struct DumpRegion
+        {
+            uint64_t Address = 0;       // Virtual address in the crashed process.
+            uint64_t Size    = 0;       // Captured bytes, not the reserved size.
+            uint8_t* Data    = nullptr; // Points into the mapped dump file.
+            uint8_t  Access  = REGION_UNKNOWN;
+        };
+
+
+
+/*************\
+*   Classes   *
+\*************/
+
+        /**
+        * @brief Memory-mapped view of a crash dump's captured address space.
+        *
+        * Supports Windows minidumps and Linux ELF64 core files. Nothing is copied: regions point
+        * straight into the mapped file, so the DumpFile has to outlive every Scanner created on it.
+        *
+        * DumpFile dump("./crash.dmp");
+        * Scanner  scanner(dump, "game.exe");
+        * auto     address = scanner.Find("55 8B EC ?? ??", TEXT);
+        */
+        class DumpFile
+        {
+        public:
+            DumpFile() = default;
+            explicit DumpFile(const std::string& filepath);
+
+
+
+            /*
+            Maps the dump and rebuilds its module and memory layout.
+            */
+            bool Open(const std::string& filepath);
+
+
+
+            /*
+            Finds a module by its file name (case insensitive) or by its full recorded path.
+            */
+            [[nodiscard]] const DumpModule* FindModule(const char* modulename) const noexcept;
+
+
+
+            /*
+            Translates a virtual address of the crashed process into a pointer into the dump.
+            Optionally retrieves how many bytes are captured contiguously from there on.
+
+            @return Returns nullptr if the address was not captured.
+            */
+            [[nodiscard]] uint8_t* Translate(uint64_t address, uint64_t* out_available = nullptr) const noexcept;
+
+
+
+            /*
+            Retrieves the captured region containing the virtual address or nullptr.
+            */
+            [[nodiscard]] const DumpRegion* FindRegion(uint64_t address) const noexcept;
+
+
+
+            [[nodiscard]] inline bool                           IsOpen()     const noexcept { return m_Format != UNKNOWN_DUMP; }
+            [[nodiscard]] inline DumpFormat                     GetFormat()  const noexcept { return m_Format; }
+            [[nodiscard]] inline const std::vector<DumpModule>& GetModules() const noexcept { return m_Modules; }
+            [[nodiscard]] inline const std::vector<DumpRegion>& GetRegions() const noexcept { return m_Regions; }
+
+        private: /* (I)nternal functions */
+            bool IParseMinidump();
+            bool IParseElfCore();
+            void ISortRegions();
+
+        private: /* Variables */
+            MappedFile              m_File;
+            DumpFormat              m_Format = UNKNOWN_DUMP;
+            std::vector<DumpModule> m_Modules;
+            std::vector<DumpRegion> m_Regions; // Sorted by address, adjacent regions merged.
+        };
+    }
+}
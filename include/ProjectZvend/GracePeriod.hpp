@@ -0,0 +1,98 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+
+
+namespace PZvend
+{
+
+/*************\
+*   Classes   *
+\*************/
+
+    /**
+    * @brief Grace period for data that readers reach through an atomic pointer.
+    *
+    * Readers count themselves in one half of an epoch before loading the pointer and leave when they
+    * no longer use what it points to. A writer swaps the pointer, then Synchronize flips the epoch and
+    * waits for the old half to drain, twice. A reader can have read the epoch long before its count
+    * lands, so it may sit in either half; draining both once covers it. Readers that count themselves
+    * after a drain load the pointer after the swap and never see the old value.
+    *
+    * That last step is a store-buffer pattern (reader: count, then load the pointer; writer: swap the
+    * pointer, then load the count), acquire/release doesn't order it. The count increment, the pointer
+    * load, the swap and the drain loads all have to be seq_cst, otherwise the writer can read a zero
+    * count while a reader still holds the old pointer.
+    *
+    * Entering and leaving never wait, Synchronize blocks until every earlier reader left.
+    *
+    * const uint32_t half = m_Grace.Enter();
+    * const List*    list = m_List.load(std::memory_order_seq_cst);
+    * ...
+    * m_Grace.Leave(half);
+    *
+    * const List* previous = m_List.exchange(next, std::memory_order_seq_cst);
+    * m_Grace.Synchronize();
+    * delete previous;
+    */
+    class GracePeriod
+    {
+    public:
+        /*
+        Counts the reader in the current half, load the protected pointer (seq_cst) afterwards.
+
+        @return Returns the half to pass to Leave.
+        */
+        [[nodiscard]] inline uint32_t Enter() const noexcept
+        {
+            const uint32_t half = static_cast<uint32_t>(m_Epoch.load(std::memory_order_seq_cst) & 1);
+
+            m_Readers[half].Count.fetch_add(1, std::memory_order_seq_cst);
+            return half;
+        }
+
+
+
+        inline void Leave(uint32_t half) const noexcept
+        {
+            m_Readers[half].Count.fetch_sub(1, std::memory_order_release);
+        }
+
+
+
+        /*
+        Waits until every reader that entered before the call has left. Call it after swapping the pointer (seq_cst).
+        Never call it between Enter and Leave of the same thread, it would wait on itself.
+        */
+        void Synchronize() noexcept
+        {
+            // Two flips only drain both halves if nobody flips in between.
+            std::lock_guard lock(m_Mutex);
+
+            for (int i = 0; i < 2; i++)
+            {
+                const uint64_t epoch = m_Epoch.fetch_add(1, std::memory_order_seq_cst);
+                while (m_Readers[epoch & 1].Count.load(std::memory_order_seq_cst) != 0)
+                    std::this_thread::yield();
+            }
+        }
+
+
+    private: /* Types */
+        struct ReaderCount
+        {
+            alignas(64) std::atomic<uint32_t> Count = 0;
+        };
+
+
+    private: /* Variables */
+        std::atomic<uint64_t>              m_Epoch = 0;
+        mutable std::array<ReaderCount, 2> m_Readers;
+        std::mutex                         m_Mutex;
+    };
+}
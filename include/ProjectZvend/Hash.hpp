@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+
+
+namespace PZvend
+{
+
+/*************\
+*  Functions  *
+\*************/
+
+    /*
+    64 bit FNV-1a. Catches accidental changes like a torn write or a stale key, it is no defense
+    against someone crafting collisions. Usable at compile time.
+
+    Pass a previous result as the seed to hash several pieces as one.
+    */
+    constexpr uint64_t Fnv1a(std::string_view data, uint64_t seed = 14695981039346656037ull) noexcept
+    {
+        uint64_t hash = seed;
+        for (const char c : data)
+        {
+            hash ^= static_cast<uint8_t>(c);
+            hash *= 1099511628211ull;
+        }
+
+        return hash;
+    }
+}
@@ -0,0 +1,305 @@
+#pragma once
+
+#include "ProjectZvend/GracePeriod.hpp"
+#include "ProjectZvend/NativeHook.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+
+namespace PZvend
+{
+    namespace Memory
+    {
+        template <class T>
+        class HookChain;
+
+
+
+        /**
+        * @brief One native detour that fans out to a priority ordered list of subscribers.
+        *
+        * The subscriber list is an immutable array published through an atomic pointer. Subscribing and
+        * unsubscribing build a new array and swap it in, the call path never takes a lock and the hook is
+        * never recreated. A replaced array is freed once the calls still running on it are done (GracePeriod).
+        *
+        * Subscribers run from the highest to the lowest priority. Returning a value (true for void functions)
+        * short-circuits the chain and becomes the result; returning std::nullopt (false) passes the call on.
+        * The original function runs when every subscriber passed, it can also be called with CallOriginal.
+        *
+        * using Update_FUNC = void(*)(Player* self, float delta);
+        * static HookChain<Update_FUNC> g_Update("Player::Update", update_address);
+        *
+        * g_Update.Create<g_Update>();
+        * g_Update.Enable();
+        * g_Update.Subscribe([](Player* self, float delta)
+        * {
+        *     return self->IsFrozen(); // skips the original while frozen
+        * }, 10);
+        */
+        template <class R, class ...Args>
+        class HookChain<R(*)(Args...)>
+        {
+        public:
+            using Function = R(*)(Args...);
+            using Result   = std::conditional_t<std::is_void_v<R>, bool, std::optional<R>>;
+            using Callback = std::function<Result(Args...)>;
+
+            HookChain(const char* name, Function target)
+                : m_Name(name), m_Target(target), m_List(new List())
+            {}
+
+            ~HookChain()
+            {
+                Remove();
+
+                delete m_List.load();
+                m_Retired.clear();
+            }
+
+            HookChain(const HookChain&)            = delete;
+            HookChain& operator=(const HookChain&) = delete;
+
+
+
+            /*
+            Creates the native hook. The chain has to have static storage, it is passed as template
+            argument so every chain gets its own detour function.
+
+            static HookChain<Update_FUNC> g_Update("Player::Update", address);
+            g_Update.Create<g_Update>();
+            */
+            template <auto& Self>
+            bool Create()
+            {
+                static_assert(std::is_same_v<std::remove_cvref_t<decltype(Self)>, HookChain>, "Self has to be the chain itself.");
+
+                if (&Self != this)
+                {
+                    PZ_LOG_ERROR(HOOKS, "Creating chain '{}' failed, Self is a different chain.", m_Name);
+                    return false;
+                }
+
+                if (m_Created)
+                    return true;
+
+                m_Hook    = Hook<Function>(m_Name.c_str(), m_Target, &Thunk<Self>);
+                m_Created = m_Hook.Create();
+                return m_Created;
+            }
+
+
+
+            bool Remove()
+            {
+                if (!m_Created)
+                    return true;
+
+                if (!m_Hook.Remove())
+                    return false;
+
+                m_Created = false;
+                return true;
+            }
+
+
+
+            inline bool Enable()    { return m_Created && m_Hook.Enable(); }
+            inline bool Disable()   { return !m_Created || m_Hook.Disable(); }
+            inline bool IsEnabled() { return m_Created && m_Hook.IsEnabled(); }
+
+
+
+            /*
+            Adds a subscriber, higher priorities run first. Subscribers with the same priority run in the order they were added.
+
+            @return Returns the id needed to unsubscribe.
+            */
+            uint32_t Subscribe(Callback callback, int32_t priority = 0)
+            {
+                std::unique_lock lock(m_WriteMutex);
+
+                const uint32_t id   = ++m_LastId;
+                auto*          list = new List(*m_List.load(std::memory_order_relaxed));
+
+                Subscriber subscriber = { id, priority, std::move(callback) };
+                auto       position   = std::upper_bound(list->begin(), list->end(), priority, [](int32_t value, const Subscriber& other) { return value > other.Priority; });
+
+                list->insert(position, std::move(subscriber));
+                IPublish(list, lock);
+
+                PZ_LOG_DEBUG(HOOKS, "Subscribed #{} to chain '{}' with priority {}.", id, m_Name, priority);
+                return id;
+            }
+
+
+
+            /*
+            Removes a subscriber. A call that is already dispatching may still run it once.
+            Waits for those calls, a subscriber may remove itself though.
+            */
+            bool Unsubscribe(uint32_t id)
+            {
+                std::unique_lock lock(m_WriteMutex);
+
+                const List* current  = m_List.load(std::memory_order_relaxed);
+                auto        position = std::find_if(current->begin(), current->end(), [id](const Subscriber& subscriber) { return subscriber.Id == id; });
+
+                if (position == current->end())
+                    return false;
+
+                auto* list = new List(*current);
+                list->erase(list->begin() + (position - current->begin()));
+                IPublish(list, lock);
+
+                PZ_LOG_DEBUG(HOOKS, "Unsubscribed #{} from chain '{}'.", id, m_Name);
+                return true;
+            }
+
+
+
+            [[nodiscard]] size_t GetSubscriberCount() const noexcept
+            {
+                return m_List.load(std::memory_order_acquire)->size();
+            }
+
+
+
+            // Call the original function
+            R CallOriginal(Args... args)
+            {
+                return m_Hook.Call(std::forward<Args>(args)...);
+            }
+
+
+
+            /*
+            Runs the subscribers and, unless one of them short-circuits, the original function.
+            */
+            R Dispatch(Args... args)
+            {
+                {
+                    const uint32_t half = m_Grace.Enter();
+                    const List*    list = m_List.load(std::memory_order_seq_cst);
+
+                    struct Release
+                    {
+                        const GracePeriod& Grace;
+                        uint32_t           Half;
+                        DispatchFrame      Frame;
+
+                        ~Release()
+                        {
+                            t_Dispatching = Frame.Next;
+                            Grace.Leave(Half);
+                        }
+                    } release = { m_Grace, half, { this, t_Dispatching } };
+
+                    t_Dispatching = &release.Frame;
+
+                    for (const Subscriber& subscriber : *list)
+                    {
+                        if constexpr (std::is_void_v<R>)
+                        {
+                            if (subscriber.Handler(args...))
+                                return;
+                        }
+                        else
+                        {
+                            if (auto result = subscriber.Handler(args...))
+                                return std::move(*result);
+                        }
+                    }
+                }
+
+                // The original can run for a long time (or never return), it shouldn't keep retired lists alive.
+                return CallOriginal(std::forward<Args>(args)...);
+            }
+
+
+        private: /* Types */
+            struct Subscriber
+            {
+                uint32_t Id       = 0;
+                int32_t  Priority = 0;
+                Callback Handler;
+            };
+
+            using List = std::vector<Subscriber>;
+
+            // Chains of this type the thread is dispatching, innermost first.
+            struct DispatchFrame
+            {
+                const HookChain*     Chain;
+                const DispatchFrame* Next;
+            };
+
+
+        private: /* (I)nternal functions */
+            template <auto& Self>
+            static R Thunk(Args... args)
+            {
+                return Self.Dispatch(std::forward<Args>(args)...);
+            }
+
+
+
+            [[nodiscard]] bool IIsDispatching() const noexcept
+            {
+                for (const DispatchFrame* frame = t_Dispatching; frame; frame = frame->Next)
+                    if (frame->Chain == this)
+                        return true;
+
+                return false;
+            }
+
+
+
+            /*
+            Called with m_WriteMutex held, releases it. The grace period runs outside m_WriteMutex, so a subscriber
+            that changes its own chain never blocks behind it. It would wait on itself though, the lists it
+            retires are freed by the next change from outside instead.
+            */
+            void IPublish(const List* list, std::unique_lock<std::mutex>& lock)
+            {
+                m_Retired.emplace_back(m_List.exchange(list, std::memory_order_seq_cst));
+
+                if (IIsDispatching())
+                    return;
+
+                std::vector<std::unique_ptr<const List>> retired = std::move(m_Retired);
+                m_Retired.clear();
+                lock.unlock();
+
+                m_Grace.Synchronize();
+            }
+
+
+        private: /* Variables */
+            std::string                             m_Name;
+            Function                                m_Target      = nullptr;
+            Hook<Function>                          m_Hook;
+            bool                                    m_Created     = false;
+
+            std::atomic<const List*>                m_List;
+            GracePeriod                             m_Grace;
+
+            static inline thread_local const DispatchFrame* t_Dispatching = nullptr;
+
+            std::mutex                              m_WriteMutex;
+            std::vector<std::unique_ptr<const List>> m_Retired;
+            uint32_t                                m_LastId      = 0;
+        };
+    }
+}
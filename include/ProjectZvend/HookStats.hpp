@@ -0,0 +1,196 @@
+#pragma once
+
+#include "ProjectZvend/Stopwatch.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <memory>
+#include <string>
+#include <vector>
+
+
+
+namespace PZvend
+{
+    namespace Memory
+    {
+
+/*************\
+*    Types    *
+\*************/
+        constexpr size_t HOOK_THREAD_SLOTS      = 64; // Threads beyond this share slots, counts stay exact.
+        constexpr size_t HOOK_HISTOGRAM_BUCKETS = 40; // Bucket n counts durations in [2^(n-1), 2^n) cycles.
+
+        struct HookSnapshot
+        {
+            std::string Name;
+            uint64_t    Calls          = 0; // Detour scopes.
+            uint64_t    DetourCycles   = 0; // Inclusive, contains the original calls made from the detour.
+            uint64_t    OriginalCalls  = 0;
+            uint64_t    OriginalCycles = 0;
+
+            std::array<uint64_t, HOOK_HISTOGRAM_BUCKETS> DetourHistogram   = {};
+            std::array<uint64_t, HOOK_HISTOGRAM_BUCKETS> OriginalHistogram = {};
+
+            /*
+            Cycles spent in the detour itself, without the original function.
+            */
+            [[nodiscard]] inline uint64_t GetSelfCycles() const noexcept { return DetourCycles > OriginalCycles ? DetourCycles - OriginalCycles : 0; }
+
+            /*
+            Upper bound (in cycles) of the histogram bucket containing the percentile, 0.0 - 1.0.
+            */
+            [[nodiscard]] static uint64_t GetPercentile(const std::array<uint64_t, HOOK_HISTOGRAM_BUCKETS>& histogram, double percentile) noexcept;
+        };
+
+
+
+/*************\
+*  Functions  *
+\*************/
+
+        /*
+        Aggregates the counters of every live HookCounters instance across all threads.
+        The result is sorted by detour cycles, the most expensive hook comes first.
+        */
+        [[nodiscard]] std::vector<HookSnapshot> SnapshotHookCounters();
+
+
+
+        /*
+        Zeroes the counters of every live HookCounters instance.
+        */
+        void ResetHookCounters();
+
+
+
+/*************\
+*   Classes   *
+\*************/
+
+        /**
+        * @brief Default hook policy, records nothing and compiles to nothing.
+        */
+        struct NoInstrumentation
+        {
+            struct Scope {};
+
+            NoInstrumentation() = default;
+            explicit NoInstrumentation(const char*) noexcept {}
+
+            [[nodiscard]] inline Scope DetourScope() const noexcept { return {}; }
+            [[nodiscard]] inline Scope OriginalScope() const noexcept { return {}; }
+        };
+
+
+
+        /**
+        * @brief Hook policy recording call counts and cycle histograms per hook.
+        *
+        * Every thread writes to its own cache line with relaxed atomics, so recording never contends.
+        * Detour time has to be measured by the detour itself, the original is timed by Call.
+        *
+        * THook<Update_FUNC, HookCounters> g_Hook("Player::Update", address, &HookUpdate);
+        *
+        * void HookUpdate(Player* self, float delta)
+        * {
+        *     auto scope = g_Hook.Scope();
+        *     g_Hook.Call(self, delta);
+        * }
+        *
+        * for (const HookSnapshot& hook : SnapshotHookCounters())
+        *     spdlog::info("{}: {} calls, {} self cycles", hook.Name, hook.Calls, hook.GetSelfCycles());
+        */
+        class HookCounters
+        {
+        public:
+            struct alignas(64) ThreadSlot
+            {
+                std::atomic<uint64_t> Calls          = 0;
+                std::atomic<uint64_t> DetourCycles   = 0;
+                std::atomic<uint64_t> OriginalCalls  = 0;
+                std::atomic<uint64_t> OriginalCycles = 0;
+
+                std::array<std::atomic<uint64_t>, HOOK_HISTOGRAM_BUCKETS> DetourHistogram   = {};
+                std::array<std::atomic<uint64_t>, HOOK_HISTOGRAM_BUCKETS> OriginalHistogram = {};
+            };
+
+            struct Data
+            {
+                std::string                               Name;
+                std::array<ThreadSlot, HOOK_THREAD_SLOTS> Slots;
+            };
+
+
+
+            class Scope
+            {
+            public:
+                Scope(Data* data, bool original) noexcept
+                    : m_Data(data), m_Original(original), m_Start(data ? ReadCycleCounter() : 0)
+                {}
+
+                ~Scope()
+                {
+                    if (!m_Data)
+                        return;
+
+                    const uint64_t cycles = ReadCycleCounter() - m_Start;
+                    const size_t   bucket = std::min<size_t>(std::bit_width(cycles), HOOK_HISTOGRAM_BUCKETS - 1);
+                    ThreadSlot&    slot   = m_Data->Slots[GetThreadSlot()];
+
+                    if (m_Original)
+                    {
+                        slot.OriginalCalls.fetch_add(1, std::memory_order_relaxed);
+                        slot.OriginalCycles.fetch_add(cycles, std::memory_order_relaxed);
+                        slot.OriginalHistogram[bucket].fetch_add(1, std::memory_order_relaxed);
+                    }
+                    else
+                    {
+                        slot.Calls.fetch_add(1, std::memory_order_relaxed);
+                        slot.DetourCycles.fetch_add(cycles, std::memory_order_relaxed);
+                        slot.DetourHistogram[bucket].fetch_add(1, std::memory_order_relaxed);
+                    }
+                }
+
+                Scope(const Scope&)            = delete;
+                Scope& operator=(const Scope&) = delete;
+
+            private:
+                Data*    m_Data;
+                bool     m_Original;
+                uint64_t m_Start;
+            };
+
+
+
+            HookCounters() = default;
+            explicit HookCounters(const char* name);
+
+            [[nodiscard]] inline Scope DetourScope() const noexcept { return Scope(m_Data.get(), false); }
+            [[nodiscard]] inline Scope OriginalScope() const noexcept { return Scope(m_Data.get(), true); }
+
+            [[nodiscard]] HookSnapshot Snapshot() const;
+            void Reset() noexcept;
+
+            friend std::vector<HookSnapshot> SnapshotHookCounters();
+            friend void ResetHookCounters();
+
+
+        private: /* (I)nternal functions */
+            [[nodiscard]] static inline size_t GetThreadSlot() noexcept
+            {
+                static std::atomic<size_t> next_slot = 0;
+                thread_local const size_t  slot      = next_slot.fetch_add(1, std::memory_order_relaxed) % HOOK_THREAD_SLOTS;
+
+                return slot;
+            }
+
+
+        private: /* Variables */
+            std::shared_ptr<Data> m_Data; // Shared, hooks get copied around by value.
+        };
+    }
+}
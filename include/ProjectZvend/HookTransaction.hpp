@@ -0,0 +1,163 @@
+#pragma once
+
+#include "ProjectZvend/NativeHook.hpp"
+
+#include <string>
+#include <vector>
+
+
+
+namespace PZvend
+{
+    namespace Memory
+    {
+
+/*************\
+*    Types    *
+\*************/
+        enum HookOperation : uint8_t
+        {
+            HOOK_CREATE,
+            HOOK_ENABLE,
+            HOOK_DISABLE,
+            HOOK_REMOVE,
+        };
+
+        struct HookOperationResult
+        {
+            std::string   Name;
+            HookOperation Operation = HOOK_CREATE;
+            bool          Success   = false;
+            std::string   Status;   // Backend status (MH_* / INLINE_*), SKIPPED, CONFLICT or ROLLED_BACK.
+        };
+
+
+
+/*************\
+*  Functions  *
+\*************/
+        [[nodiscard]] const char* HookOperationToString(HookOperation operation) noexcept;
+
+
+
+/*************\
+*   Classes   *
+\*************/
+
+        /**
+        * @brief Batches create, enable, disable and remove operations of many hooks into one commit.
+        *
+        * Enabling hooks one by one makes MinHook suspend and resume every thread of the process per hook.
+        * A transaction queues the state changes and applies them with MH_ApplyQueued (one thread freeze)
+        * and ApplyQueuedInlineHooks (one protection pass per page) instead.
+        *
+        * Commit runs in three phases: creates, the queued enable/disable apply, removes. A failure in the
+        * first two phases rolls everything back, hooks created by the transaction are removed again.
+        * Removes run after the apply (the hooks are disabled by then, so MinHook doesn't freeze again)
+        * and can't be rolled back, their failures are only reported.
+        *
+        * HookTransaction transaction("Startup");
+        * transaction.Create(g_Update).Enable(g_Update);
+        * transaction.Create(g_Render).Enable(g_Render);
+        *
+        * if (!transaction.Commit())
+        * {
+        *     for (const HookOperationResult& result : transaction.GetResults())
+        *         spdlog::error("{} {}: {}", HookOperationToString(result.Operation), result.Name, result.Status);
+        * }
+        */
+        class HookTransaction
+        {
+        public:
+            HookTransaction() = default;
+            explicit HookTransaction(const char* name) : m_Name(name) {}
+
+            template <class HookType> HookTransaction& Create(HookType& hook)  { return IQueue(HOOK_CREATE, IState(hook)); }
+            template <class HookType> HookTransaction& Enable(HookType& hook)  { return IQueue(HOOK_ENABLE, IState(hook)); }
+            template <class HookType> HookTransaction& Disable(HookType& hook) { return IQueue(HOOK_DISABLE, IState(hook)); }
+            template <class HookType> HookTransaction& Remove(HookType& hook)  { return IQueue(HOOK_REMOVE, IState(hook)); }
+
+
+
+            /*
+            Applies every queued operation and clears the queue. GetResults has one entry per operation, in queue order.
+
+            @return Returns false if any operation failed. Unless a remove failed, nothing has been changed then.
+            */
+            bool Commit();
+
+
+
+            /*
+            Drops the queued operations without applying them.
+            */
+            inline void Clear() noexcept { m_Operations.clear(); }
+
+            [[nodiscard]] inline size_t GetCount() const noexcept { return m_Operations.size(); }
+            [[nodiscard]] inline const std::vector<HookOperationResult>& GetResults() const noexcept { return m_Results; }
+
+
+        private: /* Types */
+            enum HookBackend : uint8_t
+            {
+                BACKEND_MINHOOK,
+                BACKEND_NATIVE,
+            };
+
+            // Refers to the members of a THook / NativeHook, the transaction updates them like the hook's own functions would.
+            struct HookState
+            {
+                HookBackend        Backend  = BACKEND_NATIVE;
+                const std::string* Name     = nullptr;
+                void*              Target   = nullptr;
+                void*              Detour   = nullptr;
+                void**             Original = nullptr;
+                bool*              Enabled  = nullptr;
+            };
+
+            struct Operation
+            {
+                HookOperation Type;
+                HookState     Hook;
+            };
+
+
+        private: /* (I)nternal functions */
+            template <class T, class Policy>
+            static HookState IState(NativeHook<T, Policy>& hook) noexcept
+            {
+                return { BACKEND_NATIVE, &hook.m_Name, hook.m_FuncAddress, hook.m_DetourFunc, &hook.m_RetAddress, &hook.m_Enabled };
+            }
+
+#ifdef _WIN32
+            template <class T, class Policy>
+            static HookState IState(THook<T, Policy>& hook) noexcept
+            {
+                return { BACKEND_MINHOOK, &hook.m_Name, hook.m_FuncAddress, hook.m_DetourFunc, &hook.m_RetAddress, &hook.m_Enabled };
+            }
+#endif
+
+            inline HookTransaction& IQueue(HookOperation type, const HookState& hook)
+            {
+                m_Operations.push_back({ type, hook });
+                return *this;
+            }
+
+            bool ICommit();
+            bool IValidate();
+            bool IFail(size_t index, const char* status);
+            void IRollback(const std::vector<size_t>& created, const std::vector<size_t>& queued);
+
+            static bool ICreate(const HookState& hook, std::string& out_status);
+            static bool IRemove(const HookState& hook, std::string& out_status);
+            static bool IQueueState(const HookState& hook, bool enable, std::string& out_status);
+            static bool IApplyQueued(HookBackend backend, std::string& out_status);
+
+
+        private: /* Variables */
+            std::string                      m_Name;
+            std::vector<Operation>           m_Operations;
+            std::vector<HookOperationResult> m_Results;
+        };
+    }
+}
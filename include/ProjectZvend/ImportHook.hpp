@@ -0,0 +1,249 @@
+#pragma once
+
+#include "ProjectZvend/Memory.hpp"
+
+#include <spdlog/spdlog.h>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+
+
+namespace PZvend
+{
+    namespace Memory
+    {
+
+/*************\
+*    Types    *
+\*************/
+        struct ImportSlot
+        {
+            void**      Address  = nullptr; // IAT entry on Windows, GOT entry on Linux.
+            void*       Original = nullptr; // Value of the slot when it was found.
+            std::string Module;             // Module that owns the slot (the importer).
+        };
+
+
+
+/*************\
+*  Functions  *
+\*************/
+
+        /*
+        Finds the import slots of a function.
+
+        Windows walks the import descriptors of the modules, Linux the JUMP_SLOT and GLOB_DAT
+        relocations (.rela.plt / .rela.dyn) of every loaded object.
+
+        @param symbol Name of the imported function.
+        @param module Only search the imports of this module (file name), nullptr searches every loaded module.
+        @param library Only match imports from this library (Windows only, ELF imports are not bound to a library).
+        */
+        [[nodiscard]] std::vector<ImportSlot> FindImportSlots(const char* symbol, const char* module = nullptr, const char* library = nullptr);
+
+
+
+/*************\
+*   Classes   *
+\*************/
+
+        /**
+        * @brief Redirects imported functions by rewriting import slots instead of code.
+        *
+        * All slots of all hooks in the set are swapped with a single PatchSet, so every
+        * page gets its protection flipped once no matter how many imports get hooked.
+        *
+        * ImportHookSet io("FileIO");
+        * io.Add("fopen",  &HookFopen,  &g_OriginalFopen);
+        * io.Add("fclose", &HookFclose, &g_OriginalFclose);
+        * io.Enable();
+        */
+        class ImportHookSet
+        {
+        public:
+            ImportHookSet() = default;
+            explicit ImportHookSet(const char* name) : m_Name(name), m_Patches(name) {}
+            ~ImportHookSet() { Disable(); }
+
+            ImportHookSet(const ImportHookSet&)            = delete;
+            ImportHookSet& operator=(const ImportHookSet&) = delete;
+
+
+
+            /*
+            Resolves the slots of a symbol and queues them. Can only be called while the set is disabled.
+
+            @param out_original Receives the function the slots resolve to, used to call the original.
+            @return Returns false if no slot has been found.
+            */
+            bool Add(const char* symbol, void* detour, void** out_original = nullptr, const char* module = nullptr, const char* library = nullptr);
+
+
+
+            /*
+            Removes all hooks from the set, disables it first if needed.
+            */
+            bool Clear();
+
+
+
+            /*
+            Swaps every queued slot to its detour.
+            */
+            bool Enable();
+
+
+
+            /*
+            Restores every slot to its original value.
+            */
+            bool Disable();
+
+
+
+            [[nodiscard]] inline bool   IsEnabled() const noexcept { return m_Patches.IsApplied(); }
+            [[nodiscard]] inline size_t GetSlotCount() const noexcept { return m_Patches.GetCount(); }
+
+
+        private: /* Variables */
+            std::string m_Name;
+            PatchSet    m_Patches;
+        };
+
+
+
+        /**
+        * @brief Single import hook with the same surface as THook.
+        *
+        * Hooks the import in every module of the process unless a module is given.
+        *
+        * using fopen_FUNC = FILE*(*)(const char*, const char*);
+        * ImportHook<fopen_FUNC> g_Fopen("fopen", "fopen", &HookFopen);
+        *
+        * FILE* HookFopen(const char* path, const char* mode)
+        * {
+        *     return g_Fopen.Call(path, mode);
+        * }
+        */
+        template <class T>
+        class ImportHook
+        {
+        public:
+            ImportHook() = default;
+            ImportHook(const char* name, const char* symbol, T callback, const char* module = nullptr, const char* library = nullptr)
+                : m_Name(name), m_Symbol(symbol), m_Module(module ? module : ""), m_Library(library ? library : ""), m_DetourFunc((void*)callback)
+            {}
+
+            bool Create()
+            {
+                if (m_RetAddress)
+                    return true;
+
+                m_Set = std::make_unique<ImportHookSet>(m_Name.c_str());
+
+                if (!m_Set->Add(m_Symbol.c_str(), m_DetourFunc, &m_RetAddress, m_Module.empty() ? nullptr : m_Module.c_str(), m_Library.empty() ? nullptr : m_Library.c_str()))
+                {
+                    PZ_LOG_ERROR(HOOKS, "Creating '{}' failed, no import of '{}' found.", m_Name, m_Symbol);
+                    m_Set.reset();
+                    return false;
+                }
+
+                PZ_LOG_DEBUG(HOOKS, "Created '{}' Hook on {} import slots.", m_Name, m_Set->GetSlotCount());
+                return true;
+            }
+
+
+
+            bool Remove()
+            {
+                if (!m_RetAddress)
+                    return true;
+
+                if (!Disable())
+                    return false;
+
+                PZ_LOG_DEBUG(HOOKS, "Removed '{}' Hook.", m_Name);
+                m_Set.reset();
+                m_RetAddress = nullptr;
+                return true;
+            }
+
+
+
+            bool Enable()
+            {
+                if (IsEnabled())
+                    return true;
+
+                if (!m_Set || !m_Set->Enable())
+                {
+                    PZ_LOG_ERROR(HOOKS, "Enabling '{}' failed.", m_Name);
+                    return false;
+                }
+
+                PZ_LOG_DEBUG(HOOKS, "Enabled '{}' Hook.", m_Name);
+                return true;
+            }
+
+
+
+            bool Disable()
+            {
+                if (!IsEnabled())
+                    return true;
+
+                if (!m_Set->Disable())
+                {
+                    PZ_LOG_ERROR(HOOKS, "Disabling '{}' failed.", m_Name);
+                    return false;
+                }
+
+                PZ_LOG_DEBUG(HOOKS, "Disabled '{}' Hook.", m_Name);
+                return true;
+            }
+
+
+
+            bool Retour(T NewCallback)
+            {
+                bool enabled = IsEnabled();
+                if (!Remove())
+                    return false;
+
+                void* old_callback = m_DetourFunc;
+                m_DetourFunc = reinterpret_cast<void*>(NewCallback);
+
+                if (!Create())
+                    return false;
+
+                if (enabled)
+                    Enable();
+
+                PZ_LOG_DEBUG(HOOKS, "Retoured '{}' Hook from {} to {}.", m_Name, fmt::ptr(old_callback), fmt::ptr(m_DetourFunc));
+                return true;
+            }
+
+
+
+            inline bool IsEnabled() { return m_Set && m_Set->IsEnabled(); }
+
+            // Call the original function
+            template <typename ...Args>
+            auto Call(Args&& ...args)
+            {
+                return reinterpret_cast<T>(m_RetAddress)(std::forward<Args>(args)...);
+            }
+
+        private:
+            std::string                    m_Name;
+            std::string                    m_Symbol;
+            std::string                    m_Module;
+            std::string                    m_Library;
+            std::unique_ptr<ImportHookSet> m_Set;
+            void*                          m_RetAddress = nullptr;
+            void*                          m_DetourFunc = nullptr;
+        };
+    }
+}
@@ -1,9 +1,16 @@
 #pragma once
 
+#include "ProjectZvend/Log.hpp"
+
 #include <nlohmann/json.hpp>
 #include <spdlog/spdlog.h>
+#include <chrono>
+#include <cstdint>
+#include <functional>
 #include <string>
+#include <string_view>
 #include <type_traits>
+#include <vector>
 
 namespace PZvend
 {
@@ -13,32 +20,101 @@ namespace PZvend
     public:
         using ErrorHandler = nlohmann::detail::error_handler_t;
 
+
+
+        /**
+        * @brief Key sequence that is resolved once and then cached until the document changes.
+        *
+        * A read through a resolved path skips the key lookups. It only compares the document's
+        * generation and converts the value, which doesn't allocate for arithmetic types and bools.
+        * Load, Reload and every Set change the generation. A miss is cached too, and its warning
+        * is logged only once per generation.
+        *
+        * A path caches for one document at a time and isn't thread safe.
+        *
+        * static const JSON::Path answer("The", "Answer");
+        * int value = 0;
+        * config.Get(value, answer);
+        */
+        class Path
+        {
+        public:
+            template <typename... Keys>
+                requires (sizeof...(Keys) > 0 && (std::is_constructible_v<std::string, const Keys&> && ...))
+            explicit Path(const Keys&... keys) : m_Keys{ std::string(keys)... }
+            {}
+
+
+
+            /*
+            Parses a JSON pointer like "/The/Answer". "~1" and "~0" stand for '/' and '~'. A number indexes an array.
+            */
+            static Path FromPointer(std::string_view pointer);
+
+            [[nodiscard]] inline const std::vector<std::string>& GetKeys() const noexcept { return m_Keys; }
+
+        private:
+            Path() = default;
+
+            friend class JSON;
+
+            std::vector<std::string>              m_Keys;
+            mutable uint64_t                      m_Generation = 0;
+            mutable const nlohmann::ordered_json* m_Node       = nullptr;
+        };
+
         JSON();
-        JSON(const std::string& filepath);
+        JSON(const std::string& filepath, const bool sidecar = false);
+
+
+
+        /*
+        Keeps a MessagePack copy of the document in "<path>.pzcache". Load reads the copy instead of
+        the text while it was made from exactly the text's bytes (size, write time and a hash) and its checksum
+        holds, otherwise the text is parsed and the copy rewritten. Saves rewrite it as well. The text stays the source of
+        truth, deleting the copy is always safe.
+        */
+        inline void               SetSidecar(const bool enabled) noexcept { m_Sidecar = enabled; }
+        [[nodiscard]] inline bool HasSidecar() const noexcept             { return m_Sidecar; }
 
 
 
         /*
         Loads a new json file. If a new path is assigned, it will update the path internally.
+        On failure the current document stays, the reason is in GetLastError.
         */
         bool Load(const std::string& filepath);
 
 
 
         /*
-        Reloads the json file from the current path.
+        Reloads the json file from the current path. Fails like Load.
         */
         bool Reload();
 
 
 
         /*
-        Saves the json file.
+        Reloads like Reload and returns what changed as a JSON Patch (RFC 6902) from the old document
+        to the new one, an empty array if nothing did.
+        */
+        bool Reload(nlohmann::ordered_json& out_patch);
+
+
+
+        [[nodiscard]] inline const std::string& GetFilepath()  const noexcept { return m_Filepath; }
+        [[nodiscard]] inline const std::string& GetLastError() const noexcept { return m_LastError; }
+
+
+
+        /*
+        Saves the json file. Written to "<path>.tmp", synced and renamed over the file, a crash
+        leaves the old or the new file but never a truncated one. Replaces a pending SaveAsync.
         */
         bool Save(const int          indent        = 4,
                   const char         indent_char   = ' ',
                   const bool         ensure_ascii  = false,
-                  const ErrorHandler error_handler = ErrorHandler::strict);
+                  const ErrorHandler error_handler = ErrorHandler::strict) const;
 
 
 
@@ -49,29 +125,75 @@ namespace PZvend
                     const int          indent        = 4,
                     const char         indent_char   = ' ',
                     const bool         ensure_ascii  = false,
-                    const ErrorHandler error_handler = ErrorHandler::strict);
+                    const ErrorHandler error_handler = ErrorHandler::strict) const;
+
+
+
+        /*
+        Queues a snapshot for a background Save. Calls within the debounce window replace the snapshot
+        and are written once, at the latest ten windows after the first one.
+        Call Flush before shutting down, the saver thread doesn't outlive the process.
+        */
+        void SaveAsync(std::chrono::milliseconds debounce      = std::chrono::milliseconds(250),
+                       const int                 indent        = 4,
+                       const char                indent_char   = ' ',
+                       const bool                ensure_ascii  = false,
+                       const ErrorHandler        error_handler = ErrorHandler::strict) const;
+
+
+
+        /*
+        Writes a pending SaveAsync now and waits for it.
+
+        @return Returns false if that write failed.
+        */
+        bool Flush() const;
+
+
+
+        /*
+        Maps the file and parses it from the mapping. Load and Reload parse the same way.
+
+        @param error Receives the reason on failure, it is logged as well.
+        */
+        static bool Parse(const std::string& filepath, nlohmann::ordered_json& out_json, std::string& error);
+
+
+
+        /*
+        Writes a document the way Save does, queued behind any write in flight for the same path.
+        A pending SaveAsync of the path is dropped. JsonStruct saves go through here.
+        */
+        static bool Write(const std::string&            filepath,
+                          const nlohmann::ordered_json& json,
+                          const int                     indent        = 4,
+                          const char                    indent_char   = ' ',
+                          const bool                    ensure_ascii  = false,
+                          const ErrorHandler            error_handler = ErrorHandler::strict);
+
+
+
+        /*
+        Called with the index of the matching path and the value found there. Return false to stop reading.
+        */
+        using Visitor = std::function<bool(size_t path, nlohmann::ordered_json& value)>;
+
+        /*
+        Streams the file and builds only the values at the given paths, one at a time. A "*" key
+        matches every key or index of its level, so Path("Items", "*") visits the entries of a large table
+        without ever holding the whole table. Values inside a visited one are not visited separately.
+        Peak memory is the mapping plus the largest visited value.
+
+        @param error Receives the reason on failure, it is logged as well.
+        */
+        static bool Visit(const std::string& filepath, const std::vector<Path>& paths, const Visitor& visitor, std::string& error);
 
 
 
         template <typename T>
         bool Get(T& out_data, const std::string& key) const
         {
-            if (m_Json.contains(key))
-            {
-                try
-                {
-                    out_data = m_Json[key].get<T>();
-                    return true;
-                }
-                catch (nlohmann::detail::type_error e)
-                {
-                    SPDLOG_ERROR("[JSON] {}", e.what());
-                    return false;
-                }
-            }
-
-            SPDLOG_WARN("[JSON] Key '{}' does not exist.", key);
-            return false;
+            return IGet<T>(m_Json, out_data, key);
         }
 
 
@@ -84,9 +206,34 @@ namespace PZvend
 
 
 
+        /*
+        Reads through a cached path, see JSON::Path.
+        */
+        template <typename T>
+        bool Get(T& out_data, const Path& path) const
+        {
+            const nlohmann::ordered_json* node = IResolve(path);
+            if (!node)
+                return false;
+
+            try
+            {
+                node->get_to(out_data);
+                return true;
+            }
+            catch (const nlohmann::detail::type_error& e)
+            {
+                PZ_LOG_ERROR(JSON, "{}", e.what());
+                return false;
+            }
+        }
+
+
+
         template <typename T>
         void Set(const std::string& key, const T& value)
         {
+            m_Generation.Bump();
             m_Json[key] = value;
         }
 
@@ -95,28 +242,47 @@ namespace PZvend
         template <typename T, typename... Keys>
         void Set(const T& value, const std::string& key, const Keys&... keys)
         {
+            m_Generation.Bump();
             ISet(m_Json, value, key, keys...);
         }
 
+
+
+        /*
+        Creates missing objects along the path. A number only indexes an existing array.
+        */
+        template <typename T>
+        void Set(const Path& path, const T& value)
+        {
+            IAt(path) = value;
+        }
+
     private:
+        bool                          IParse(const std::string& filepath, nlohmann::ordered_json& out_json);
+        bool                          IReload(nlohmann::ordered_json* out_patch);
+        const nlohmann::ordered_json* IResolve(const Path& path) const;
+        nlohmann::ordered_json&       IAt(const Path& path);
+
+
+
         template <typename T>
         static bool IGet(const nlohmann::ordered_json& json, T& out_data, const std::string& key)
         {
-            if (json.contains(key))
+            if (const auto it = json.find(key); it != json.end())
             {
                 try
                 {
-                    out_data = json[key].get<T>();
+                    out_data = it->template get<T>();
                     return true;
                 }
                 catch (nlohmann::detail::type_error e)
                 {
-                    SPDLOG_ERROR("[JSON] {}", e.what());
+                    PZ_LOG_ERROR(JSON, "{}", e.what());
                     return false;
                 }
             }
 
-            SPDLOG_WARN("[JSON] Key '{}' does not exist.", key);
+            PZ_LOG_WARN(JSON, "Key '{}' does not exist.", key);
             return false;
         }
 
@@ -125,10 +291,10 @@ namespace PZvend
         template <typename T, typename... Keys>
         static bool IGet(const nlohmann::ordered_json& json, T& out_data, const std::string& key, const Keys&... keys)
         {
-            if (json.contains(key))
-                return IGet<T>(json[key], out_data, keys...);
+            if (const auto it = json.find(key); it != json.end())
+                return IGet<T>(*it, out_data, keys...);
 
-            SPDLOG_WARN("[JSON] Key '{}' does not exist.", key);
+            PZ_LOG_WARN(JSON, "Key '{}' does not exist.", key);
             return false;
         }
 
@@ -154,9 +320,27 @@ namespace PZvend
             ISet(json[key], value, keys...);
         }
 
+    private:
+        // Unique across all documents, a copy never shares one with its source, so a path can't mistake them.
+        struct Generation
+        {
+            uint64_t Value = Next();
+
+            Generation() = default;
+            Generation(const Generation&) noexcept : Value(Next()) {}
+            Generation& operator=(const Generation&) noexcept { Value = Next(); return *this; }
+
+            inline void Bump() noexcept { Value = Next(); }
+
+            static uint64_t Next() noexcept;
+        };
+
     private:
         std::string            m_Filepath;
+        std::string            m_LastError;
         nlohmann::ordered_json m_Json;
+        Generation             m_Generation;
+        bool                   m_Sidecar = false;
     };
 
 }
\ No newline at end of file
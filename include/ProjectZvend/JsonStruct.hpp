@@ -0,0 +1,256 @@
+#pragma once
+
+#include <nlohmann/json.hpp>
+
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+
+/*
+Shorthand for a field whose key is the member name.
+
+PZ_JSON_FIELD(WindowConfig, Width) -> PZvend::JsonField("Width", &WindowConfig::Width)
+*/
+#define PZ_JSON_FIELD(type, member) ::PZvend::JsonField(#member, &type::member)
+
+
+
+namespace PZvend
+{
+
+/*************\
+*    Types    *
+\*************/
+
+    /*
+    One key of a bound struct. The validator runs on the parsed value, a rejected value keeps the default.
+    */
+    template <typename Class, typename Member>
+    struct JsonField
+    {
+        using ClassType  = Class;
+        using MemberType = Member;
+
+        const char*   Key;
+        Member Class::*Pointer;
+        bool          (*Validator)(const Member&) = nullptr;
+        const char*   Message                     = nullptr; // Reported when the validator fails.
+
+        constexpr JsonField(const char* key, Member Class::*pointer, std::type_identity_t<bool (*)(const Member&)> validator = nullptr, const char* message = nullptr) noexcept
+            : Key(key), Pointer(pointer), Validator(validator), Message(message)
+        {}
+    };
+
+
+
+    /*
+    Specialize with a tuple of JsonFields to bind a struct. Members are bound structs, vectors of
+    them, or anything nlohmann converts by itself.
+
+    struct WindowConfig
+    {
+        int   Width      = 1920;
+        int   Height     = 1080;
+        bool  Fullscreen = false;
+        float Scale      = 1.0f;
+    };
+
+    template <>
+    struct PZvend::JsonBinding<WindowConfig>
+    {
+        static constexpr auto Fields = std::make_tuple(
+            PZ_JSON_FIELD(WindowConfig, Width),
+            PZ_JSON_FIELD(WindowConfig, Height),
+            PZvend::JsonField("Fullscreen", &WindowConfig::Fullscreen),
+            PZvend::JsonField("Scale", &WindowConfig::Scale, [](const float& scale) { return scale > 0.0f; }, "Must be positive."));
+    };
+    */
+    template <typename T>
+    struct JsonBinding;
+
+    template <typename T>
+    concept JsonBound = requires { JsonBinding<T>::Fields; };
+
+    struct JsonStructError
+    {
+        std::string Path;    // JSON pointer of the value, empty for the file itself.
+        std::string Message;
+    };
+
+
+
+/*************\
+*   Classes   *
+\*************/
+
+    /**
+    * @brief Parses json straight into bound structs and writes them back.
+    *
+    * The document only lives while a file is loaded or saved. Reads after that are plain member
+    * accesses. A missing key keeps the member's default. Value errors are collected instead of logged,
+    * the caller decides what to report.
+    *
+    * Config                               config;
+    * std::vector<PZvend::JsonStructError> errors;
+    * if (!PZvend::JsonStruct::Load("config.json", config, errors))
+    *     for (const auto& error : errors)
+    *         SPDLOG_WARN("[Config] {}: {}", error.Path, error.Message);
+    */
+    class JsonStruct
+    {
+    public:
+        /*
+        Loads the file into the struct. Values with errors keep their defaults, the rest is still applied.
+
+        @return Returns false if the file couldn't be read or any value had an error.
+        */
+        template <JsonBound T>
+        static bool Load(const std::string& filepath, T& out_data, std::vector<JsonStructError>& errors)
+        {
+            nlohmann::ordered_json json;
+            if (!IReadFile(filepath, json, errors))
+                return false;
+
+            const size_t before = errors.size();
+            Read(json, out_data, errors);
+            return errors.size() == before;
+        }
+
+
+
+        /*
+        Saves like JSON::Save, through a synced temp file renamed over the old one.
+        */
+        template <JsonBound T>
+        static bool Save(const std::string& filepath, const T& data, const int indent = 4)
+        {
+            nlohmann::ordered_json json;
+            Write(json, data);
+            return IWriteFile(filepath, json, indent);
+        }
+
+
+
+        template <JsonBound T>
+        static void Read(const nlohmann::ordered_json& json, T& out_data, std::vector<JsonStructError>& errors, const std::string& path = "")
+        {
+            if (!json.is_object())
+            {
+                errors.push_back({ path, std::string("Expected an object, but is ") + json.type_name() + "." });
+                return;
+            }
+
+            std::apply([&](const auto&... fields) { (IReadField(json, out_data, fields, errors, path), ...); }, JsonBinding<T>::Fields);
+        }
+
+
+
+        template <JsonBound T>
+        static void Write(nlohmann::ordered_json& json, const T& data)
+        {
+            json = nlohmann::ordered_json::object();
+            std::apply([&](const auto&... fields) { (IWriteValue(json[fields.Key], data.*fields.Pointer), ...); }, JsonBinding<T>::Fields);
+        }
+
+    private:
+        template <typename T>
+        struct IsBoundVector : std::false_type {};
+
+        template <JsonBound T, typename Allocator>
+        struct IsBoundVector<std::vector<T, Allocator>> : std::true_type {};
+
+
+
+        template <typename T, typename Field>
+        static void IReadField(const nlohmann::ordered_json& json, T& out_data, const Field& field, std::vector<JsonStructError>& errors, const std::string& path)
+        {
+            const auto it = json.find(field.Key);
+            if (it == json.end())
+                return;
+
+            const std::string field_path = path + '/' + field.Key;
+
+            typename Field::MemberType value = out_data.*field.Pointer;
+            if (!IReadValue(*it, value, errors, field_path))
+                return;
+
+            if (field.Validator && !field.Validator(value))
+            {
+                errors.push_back({ field_path, field.Message ? field.Message : "Rejected by the validator." });
+                return;
+            }
+
+            out_data.*field.Pointer = std::move(value);
+        }
+
+
+
+        /*
+        @return Returns false if the value can't be used at all. Nested structs and their vectors are
+                always applied, their own fields keep the defaults on errors.
+        */
+        template <typename T>
+        static bool IReadValue(const nlohmann::ordered_json& json, T& value, std::vector<JsonStructError>& errors, const std::string& path)
+        {
+            if constexpr (JsonBound<T>)
+            {
+                Read(json, value, errors, path);
+                return true;
+            }
+            else if constexpr (IsBoundVector<T>::value)
+            {
+                if (!json.is_array())
+                {
+                    errors.push_back({ path, std::string("Expected an array, but is ") + json.type_name() + "." });
+                    return false;
+                }
+
+                value.clear();
+                value.reserve(json.size());
+                for (size_t i = 0; i < json.size(); i++)
+                    Read(json[i], value.emplace_back(), errors, path + '/' + std::to_string(i));
+
+                return true;
+            }
+            else
+            {
+                try
+                {
+                    json.get_to(value);
+                    return true;
+                }
+                catch (const nlohmann::json::exception& e)
+                {
+                    errors.push_back({ path, e.what() });
+                    return false;
+                }
+            }
+        }
+
+
+
+        template <typename T>
+        static void IWriteValue(nlohmann::ordered_json& json, const T& value)
+        {
+            if constexpr (JsonBound<T>)
+                Write(json, value);
+            else if constexpr (IsBoundVector<T>::value)
+            {
+                json = nlohmann::ordered_json::array();
+                for (const auto& element : value)
+                    Write(json.emplace_back(), element);
+            }
+            else
+                json = value;
+        }
+
+
+
+        static bool IReadFile(const std::string& filepath, nlohmann::ordered_json& json, std::vector<JsonStructError>& errors);
+        static bool IWriteFile(const std::string& filepath, const nlohmann::ordered_json& json, const int indent);
+    };
+}
@@ -0,0 +1,171 @@
+#pragma once
+
+#include "ProjectZvend/JSON.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+
+namespace PZvend
+{
+
+/*************\
+*    Types    *
+\*************/
+    using JsonSubscriptionId = uint64_t; // 0 is never a valid subscription.
+
+    /*
+    Called after a reload with the JSON Patch (RFC 6902) operations that touch the subscribed path.
+    They are already applied, their paths start at the document root.
+    */
+    using JsonChangeCallback = std::function<void(JSON& json, const nlohmann::ordered_json& patch)>;
+
+
+
+/*************\
+*   Classes   *
+\*************/
+
+    /**
+    * @brief Hot reload for JSON documents, driven by file change notifications.
+    *
+    * A thread waits on inotify / ReadDirectoryChangesW and only notes which files changed. Poll
+    * reloads them on the calling thread once the debounce passed without another write, so an
+    * editor's burst of writes is one reload. A file whose content didn't change (a touch, a save
+    * without edits) isn't parsed at all. Poll without pending changes is a single atomic load.
+    *
+    * Subscribers get the operations of the diff between the old and the new document that lie
+    * on, above or below their path. A reload replaces unsaved changes of the document.
+    *
+    * Documents must be unwatched before they are destroyed. Everything but the notification
+    * thread runs on the thread calling Poll, the same one that uses the documents.
+    *
+    * JsonWatcher watcher;
+    * watcher.Subscribe(g_Config, JSON::Path("Window"), [](JSON& config, const nlohmann::ordered_json& patch)
+    * {
+    *     ApplyWindowSettings(config);
+    * });
+    *
+    * while (running)
+    * {
+    *     watcher.Poll(); // once per frame
+    *     <...>
+    * }
+    */
+    class JsonWatcher
+    {
+    public:
+        /*
+        @param debounce Quiet time after the last write before a file is reloaded.
+        */
+        explicit JsonWatcher(std::chrono::milliseconds debounce = std::chrono::milliseconds(100));
+        ~JsonWatcher();
+
+        JsonWatcher(const JsonWatcher&)            = delete;
+        JsonWatcher& operator=(const JsonWatcher&) = delete;
+
+
+
+        /*
+        Starts watching the document's file. Watching it twice does nothing.
+
+        @return Returns false if the document has no file or its directory can't be watched.
+        */
+        bool Watch(JSON& json);
+
+
+
+        /*
+        Stops watching the document and drops its subscriptions.
+        */
+        void Unwatch(JSON& json);
+
+
+
+        /*
+        Watches the document if it isn't yet. A path without keys (JSON::Path::FromPointer(""))
+        receives every change.
+
+        @return Returns 0 if the document can't be watched.
+        */
+        JsonSubscriptionId Subscribe(JSON& json, const JSON::Path& path, JsonChangeCallback callback);
+
+
+
+        /*
+        A callback may unsubscribe itself or others.
+
+        @return Returns false if the id wasn't subscribed.
+        */
+        bool Unsubscribe(JsonSubscriptionId id);
+
+
+
+        /*
+        Reloads every changed document whose debounce passed and runs the callbacks.
+
+        @return Returns the number of documents that were reloaded.
+        */
+        size_t Poll();
+        size_t Poll(std::chrono::steady_clock::time_point now);
+
+    private:
+        struct Subscription
+        {
+            JsonSubscriptionId       Id = 0;
+            std::vector<std::string> Keys;
+            JsonChangeCallback       Callback;
+        };
+
+        struct Document
+        {
+            JSON*                     Json = nullptr;
+            std::string               Filepath; // Absolute, as the notification thread reports it.
+            uint64_t                  Hash = 0; // Of the text last loaded.
+            std::vector<Subscription> Subscriptions;
+        };
+
+        // Platform state of one watched directory, kept until the watcher is destroyed.
+        struct Directory;
+
+    private:
+        Document* IFind(const JSON& json);
+        bool      IWatchDirectory(const std::string& directory);
+        bool      IReload(Document& document);
+        void      IMarkChanged(const std::string& filepath, std::chrono::steady_clock::time_point now);
+        void      IRun();
+
+    private:
+        const std::chrono::steady_clock::duration m_Debounce;
+
+        // Used by Poll and the API only.
+        std::vector<Document> m_Documents;
+        JsonSubscriptionId    m_NextId = 1;
+
+        // Shared with the notification thread.
+        std::mutex                                                   m_Mutex;
+        std::vector<std::unique_ptr<Directory>>                      m_Directories;
+        std::set<std::string>                                        m_Files;
+        std::map<std::string, std::chrono::steady_clock::time_point> m_Changed; // Time of the last write.
+        std::atomic<bool>                                            m_Pending = false;
+        std::atomic<bool>                                            m_Stop    = false;
+        std::thread                                                  m_Thread;
+
+    #ifdef _WIN32
+        void* m_Wake    = nullptr;
+    #else
+        int   m_Inotify = -1;
+        int   m_Wake    = -1;
+    #endif
+    };
+}
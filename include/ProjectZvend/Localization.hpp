@@ -1,2 +1,134 @@
 #pragma once
 
+#include "ProjectZvend/Hash.hpp"
+#include "ProjectZvend/Log.hpp"
+
+#include <spdlog/fmt/fmt.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+
+
+
+namespace PZvend
+{
+    inline namespace Literals
+    {
+        /*
+        Hash of a localization key, always computed at compile time.
+
+        L10n::Get<"menu.start"_h>()
+        */
+        consteval uint64_t operator""_h(const char* key, size_t size)
+        {
+            return Fnv1a(std::string_view(key, size));
+        }
+    }
+
+
+
+    /*
+    Translated strings from per language string tables.
+
+    "<directory>/<language>.json" holds the table, nested objects join their keys with '.':
+    { "menu": { "start": "Start", "greeting": "Hello {}!" } } has the keys "menu.start" and "menu.greeting".
+
+    The first lookup after SetLanguage maps "<directory>/<language>.pzl10n", a catalog of a perfect
+    hash index and a string pool. A catalog older than its table is compiled again first, shipping
+    only the catalogs works as well. Catalogs stay mapped until the process ends, so every view
+    handed out stays valid across language switches. Lookups are lock free and don't allocate.
+
+    L10n::SetDirectory("./lang");
+    L10n::SetLanguage("de");
+    L10n::SetFallbackLanguage("en");
+
+    DrawButton(L10n::Get<"menu.start"_h>());
+
+    char buffer[128];
+    DrawLabel(L10n::Format<"menu.greeting"_h>(buffer, player_name));
+    */
+    namespace L10n
+    {
+
+/*************\
+*  Functions  *
+\*************/
+
+        /*
+        Compiles a string table into a catalog. Written aside and renamed over the old one.
+
+        @param error Receives the reason on failure, e.g. a value that isn't a string or two keys with the same hash.
+        */
+        bool Compile(const std::string& source, const std::string& catalog, std::string& error);
+
+
+
+        /*
+        Directory of the tables and catalogs, "." by default. Languages are looked up again on the next lookup.
+        */
+        void SetDirectory(const std::string& directory);
+
+
+
+        /*
+        Selects the language, its catalog is loaded by the next lookup. Keys it lacks come from the fallback language.
+        */
+        void        SetLanguage(const std::string& language);
+        void        SetFallbackLanguage(const std::string& language);
+        std::string GetLanguage();
+
+
+
+        /*
+        @return Returns the translation without allocating, empty if neither language has the key.
+                The view is null terminated and stays valid until the process ends.
+        */
+        std::string_view Get(uint64_t key);
+
+        template <uint64_t Key>
+        std::string_view Get()
+        {
+            return Get(Key);
+        }
+
+
+
+        /*
+        Formats the translation with fmt placeholders into the buffer, cut off if it doesn't fit.
+        A translation with broken placeholders is returned as it is.
+
+        @return Returns the formatted text inside the buffer, null terminated.
+        */
+        template <typename... Args>
+        std::string_view Format(uint64_t key, std::span<char> buffer, const Args&... args)
+        {
+            if (buffer.empty())
+                return {};
+
+            const std::string_view text = Get(key);
+
+            try
+            {
+                const auto   result = fmt::format_to_n(buffer.data(), buffer.size() - 1, fmt::runtime(text), args...);
+                const size_t size   = result.size < buffer.size() - 1 ? result.size : buffer.size() - 1;
+
+                buffer[size] = '\0';
+                return std::string_view(buffer.data(), size);
+            }
+            catch (const fmt::format_error& e)
+            {
+                PZ_LOG_WARN(L10N, "Formatting '{}' failed: {}", text, e.what());
+                return text;
+            }
+        }
+
+        template <uint64_t Key, typename... Args>
+        std::string_view Format(std::span<char> buffer, const Args&... args)
+        {
+            return Format(Key, buffer, args...);
+        }
+    }
+}
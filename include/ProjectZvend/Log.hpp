@@ -0,0 +1,199 @@
+#pragma once
+
+#include <spdlog/spdlog.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string_view>
+
+
+
+/*
+Lowest level compiled in per subsystem, as SPDLOG_LEVEL_* values. Calls below it are discarded
+at compile time, arguments included. Defaults to SPDLOG_ACTIVE_LEVEL, set with the LOG_LEVEL_*
+CMake options or by defining them before the first include.
+*/
+#ifndef PZVEND_LOG_LEVEL_MEMORY
+    #define PZVEND_LOG_LEVEL_MEMORY SPDLOG_ACTIVE_LEVEL
+#endif
+
+#ifndef PZVEND_LOG_LEVEL_HOOKS
+    #define PZVEND_LOG_LEVEL_HOOKS SPDLOG_ACTIVE_LEVEL
+#endif
+
+#ifndef PZVEND_LOG_LEVEL_JSON
+    #define PZVEND_LOG_LEVEL_JSON SPDLOG_ACTIVE_LEVEL
+#endif
+
+#ifndef PZVEND_LOG_LEVEL_PATHS
+    #define PZVEND_LOG_LEVEL_PATHS SPDLOG_ACTIVE_LEVEL
+#endif
+
+#ifndef PZVEND_LOG_LEVEL_L10N
+    #define PZVEND_LOG_LEVEL_L10N SPDLOG_ACTIVE_LEVEL
+#endif
+
+#ifndef PZVEND_LOG_LEVEL_LOGGING
+    #define PZVEND_LOG_LEVEL_LOGGING SPDLOG_ACTIVE_LEVEL
+#endif
+
+#ifndef PZVEND_LOG_LEVEL_TIMING
+    #define PZVEND_LOG_LEVEL_TIMING SPDLOG_ACTIVE_LEVEL
+#endif
+
+
+
+/*
+Logs through the subsystem's logger with a "[Subsystem] " prefix. Each call site has its own
+token bucket and drops repeats of its last line, see LogLimits.
+
+PZ_LOG_ERROR(HOOKS, "Enabling '{}' failed with {}.", name, status);
+*/
+#define PZ_LOG(subsystem, severity, ...)                                                                               \
+    do                                                                                                                 \
+    {                                                                                                                  \
+        if constexpr ((severity) >= PZVEND_LOG_LEVEL_##subsystem)                                                      \
+        {                                                                                                              \
+            static ::PZvend::LogSite pz_log_site{ ::PZvend::LOG_SUBSYSTEM_##subsystem,                                 \
+                                                  static_cast<::spdlog::level::level_enum>(severity),                  \
+                                                  ::spdlog::source_loc{ __FILE__, __LINE__, SPDLOG_FUNCTION } };       \
+            ::PZvend::WriteLog(pz_log_site, __VA_ARGS__);                                                              \
+        }                                                                                                              \
+    } while (0)
+
+#define PZ_LOG_TRACE(subsystem, ...)    PZ_LOG(subsystem, SPDLOG_LEVEL_TRACE, __VA_ARGS__)
+#define PZ_LOG_DEBUG(subsystem, ...)    PZ_LOG(subsystem, SPDLOG_LEVEL_DEBUG, __VA_ARGS__)
+#define PZ_LOG_INFO(subsystem, ...)     PZ_LOG(subsystem, SPDLOG_LEVEL_INFO, __VA_ARGS__)
+#define PZ_LOG_WARN(subsystem, ...)     PZ_LOG(subsystem, SPDLOG_LEVEL_WARN, __VA_ARGS__)
+#define PZ_LOG_ERROR(subsystem, ...)    PZ_LOG(subsystem, SPDLOG_LEVEL_ERROR, __VA_ARGS__)
+#define PZ_LOG_CRITICAL(subsystem, ...) PZ_LOG(subsystem, SPDLOG_LEVEL_CRITICAL, __VA_ARGS__)
+
+
+
+namespace PZvend
+{
+
+/*************\
+*    Types    *
+\*************/
+    enum LogSubsystem
+    {
+        LOG_SUBSYSTEM_MEMORY,
+        LOG_SUBSYSTEM_HOOKS,
+        LOG_SUBSYSTEM_JSON,
+        LOG_SUBSYSTEM_PATHS,
+        LOG_SUBSYSTEM_L10N,
+        LOG_SUBSYSTEM_LOGGING, // BinaryLog and MappedRingSink.
+        LOG_SUBSYSTEM_TIMING,  // Profiler and TimerWheel.
+        LOG_SUBSYSTEM_COUNT
+    };
+
+    /*
+    Applied per call site. A line takes a token, a site without tokens drops its lines before
+    they are formatted. A line equal to the site's last one is dropped as well and reported as
+    "repeated N times" with the next different line, or once RepeatWindow passed.
+    */
+    struct LogLimits
+    {
+        double                    PerSecond    = 20.0;  // Refill rate, 0 disables the bucket.
+        double                    Burst        = 100.0; // Bucket size.
+        std::chrono::milliseconds RepeatWindow = std::chrono::seconds(10); // 0 disables deduplication.
+    };
+
+    struct LogCounters
+    {
+        uint64_t Written     = 0;
+        uint64_t Repeated    = 0; // Dropped as a repeat of the line before.
+        uint64_t RateLimited = 0; // Dropped because the site's bucket was empty.
+    };
+
+    /*
+    State of one PZ_LOG call site, constant initialized. Repeats are only detected within a site,
+    a line has to match the last one in size and in two independent hashes.
+    */
+    class LogSite
+    {
+    public:
+        constexpr LogSite(LogSubsystem subsystem, spdlog::level::level_enum level, spdlog::source_loc location) noexcept
+            : m_Subsystem(subsystem)
+            , m_Level(level)
+            , m_Location(location)
+        {
+        }
+
+        LogSite(const LogSite&)            = delete;
+        LogSite& operator=(const LogSite&) = delete;
+
+
+
+        /*
+        Checks the level and takes a token.
+
+        @return Returns the logger to format for, nullptr if the line is dropped.
+        */
+        spdlog::logger* Acquire();
+        void            Emit(spdlog::logger* logger, std::string_view text);
+
+    private:
+        const LogSubsystem              m_Subsystem;
+        const spdlog::level::level_enum m_Level;
+        const spdlog::source_loc        m_Location;
+
+        std::mutex                            m_Mutex;
+        double                                m_Tokens = 0.0;
+        std::chrono::steady_clock::time_point m_LastRefill;
+        std::chrono::steady_clock::time_point m_LastLine;
+        uint64_t                              m_LastHash    = 0;
+        uint64_t                              m_LastCheck   = 0; // Second, independent hash of the last line.
+        size_t                                m_LastSize    = 0;
+        uint64_t                              m_Repeats     = 0;
+        uint64_t                              m_RateLimited = 0;
+    };
+
+
+
+/*************\
+*  Functions  *
+\*************/
+
+    /*
+    Sets the logger of a subsystem, nullptr goes back to spdlog's default logger.
+    Replaced loggers are kept alive, a call on another thread might still use them.
+    */
+    void SetLogLogger(LogSubsystem subsystem, std::shared_ptr<spdlog::logger> logger);
+
+
+
+    /*
+    Runtime level of a subsystem on top of the compiled in one, trace by default.
+    */
+    void                      SetLogLevel(LogSubsystem subsystem, spdlog::level::level_enum level);
+    spdlog::level::level_enum GetLogLevel(LogSubsystem subsystem);
+
+
+
+    void      SetLogLimits(LogSubsystem subsystem, const LogLimits& limits);
+    LogLimits GetLogLimits(LogSubsystem subsystem);
+
+
+
+    LogCounters GetLogCounters(LogSubsystem subsystem);
+    const char* LogSubsystemToString(LogSubsystem subsystem);
+
+
+
+    template <typename... Args>
+    void WriteLog(LogSite& site, spdlog::format_string_t<Args...> format, Args&&... args)
+    {
+        spdlog::logger* logger = site.Acquire();
+        if (!logger)
+            return;
+
+        spdlog::memory_buf_t buffer;
+        fmt::format_to(fmt::appender(buffer), format, std::forward<Args>(args)...);
+        site.Emit(logger, std::string_view(buffer.data(), buffer.size()));
+    }
+}
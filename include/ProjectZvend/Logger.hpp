@@ -1,12 +1,20 @@
 #pragma once
 
 
-#include "ProjectZvend/Paths.hpp"
-
-#include <spdlog/sinks/rotating_file_sink.h>
-#include <spdlog/sinks/stdout_color_sinks.h>
+#include <spdlog/details/log_msg_buffer.h>
+#include <spdlog/sinks/sink.h>
 #include <spdlog/spdlog.h>
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
 
 
 namespace PZvend
@@ -51,11 +59,136 @@ namespace PZvend
         constexpr uint16_t Background_Intense_White     = Background_White   | Background_Intensity;
     }
 
+
+/*************\
+*    Types    *
+\*************/
+    enum LogOverflowPolicy
+    {
+        LOG_OVERFLOW_BLOCK,            // The logging thread waits for space, nothing is lost.
+        LOG_OVERFLOW_DROP_NEWEST,      // The new message is dropped, the call never waits.
+        LOG_OVERFLOW_OVERWRITE_OLDEST, // The oldest queued message is replaced, the call never waits.
+    };
+
+    struct LoggerConfig
+    {
+        bool        HasConsole  = false;
+        std::string Path;       // Log directory, no file sink if empty.
+        std::size_t MaxFileSize = 20 * 1024 * 1024;
+        std::size_t MaxFiles    = 3;
+        std::string RingPath;   // Crash surviving ring file, see MappedRingSink. Written directly, even with Async.
+        std::size_t RingSize    = 1024 * 1024;
+
+        bool                      Async         = false;
+        std::size_t               QueueSize     = 8192;                     // Messages, the slots are preallocated.
+        LogOverflowPolicy         Overflow      = LOG_OVERFLOW_DROP_NEWEST;
+        std::chrono::milliseconds FlushInterval = std::chrono::seconds(1);  // 0 disables the periodic flush.
+        std::size_t               FlushBytes    = 64 * 1024;                // Payload bytes written since the last flush, 0 disables it.
+        spdlog::level::level_enum FlushLevel    = spdlog::level::err;       // Messages at or above it are flushed right away.
+    };
+
+    struct LoggerMetrics
+    {
+        uint64_t    Enqueued      = 0;
+        uint64_t    Written       = 0;
+        uint64_t    DroppedNewest = 0;
+        uint64_t    Overwritten   = 0;
+        uint64_t    Blocked       = 0; // Calls that had to wait for space.
+        uint64_t    Flushes       = 0;
+        uint64_t    WriteErrors   = 0; // Messages a child sink threw on.
+        std::size_t QueueDepth    = 0;
+        std::size_t MaxQueueDepth = 0; // High water mark since creation.
+    };
+
+
+
+/*************\
+*   Classes   *
+\*************/
+
+    /**
+    * @brief Sink that hands messages to a writer thread, which formats them into its child sinks.
+    *
+    * The calling thread only copies the message into a preallocated slot, file writes and
+    * flushes happen on the writer thread. Created by CreateLogger with LoggerConfig::Async.
+    *
+    * LoggerConfig config;
+    * config.Path  = "logs";
+    * config.Async = true;
+    * auto logger  = CreateLogger("Game", config);
+    *
+    * logger->info("Hooked {} functions.", count); // returns without touching the file
+    * logger->flush();                             // waits until everything queued so far is written
+    *
+    * LoggerMetrics metrics;
+    * GetLoggerMetrics(logger, metrics);
+    *
+    * The writer thread is joined when the last logger holding the sink goes away. Inside a DLL,
+    * call Stop() before unloading, joining a thread under the loader lock deadlocks.
+    */
+    class AsyncLogSink final : public spdlog::sinks::sink
+    {
+    public:
+        AsyncLogSink(std::vector<spdlog::sink_ptr> sinks, const LoggerConfig& config);
+        ~AsyncLogSink() override;
+
+        AsyncLogSink(const AsyncLogSink&) = delete;
+        AsyncLogSink& operator=(const AsyncLogSink&) = delete;
+
+        void log(const spdlog::details::log_msg& msg) override;
+        void flush() override;
+        void set_pattern(const std::string& pattern) override;
+        void set_formatter(std::unique_ptr<spdlog::formatter> sink_formatter) override;
+
+        /*
+        Writes and flushes what is queued, then joins the writer thread.
+        Messages logged afterwards are counted as dropped.
+        */
+        void Stop();
+
+        [[nodiscard]] LoggerMetrics GetMetrics() const;
+
+    private:
+        void IRun();
+        void IFlushSinks();
+
+    private:
+        std::vector<spdlog::sink_ptr>                m_Sinks;
+        std::vector<spdlog::details::log_msg_buffer> m_Ring;
+        LogOverflowPolicy                            m_Overflow;
+        std::chrono::milliseconds                    m_FlushInterval;
+        std::size_t                                  m_FlushBytes;
+        spdlog::level::level_enum                    m_FlushLevel;
+
+        mutable std::mutex      m_Mutex;
+        std::condition_variable m_NotEmpty;
+        std::condition_variable m_NotFull;
+        std::condition_variable m_Flushed;
+        std::size_t             m_Head           = 0; // Next slot to read.
+        std::size_t             m_Size           = 0;
+        uint64_t                m_Popped         = 0; // Written or overwritten, flush() waits for a count of them.
+        uint64_t                m_FlushTarget    = 0;
+        uint64_t                m_FlushRequests  = 0;
+        uint64_t                m_FlushesHandled = 0;
+        bool                    m_Stopping       = false;
+        LoggerMetrics           m_Metrics;
+
+        std::thread m_Thread;
+    };
+
+
+
+/*****************\
+*    Functions    *
+\*****************/
+
     /*
     Creates a pre defined logger for simplification.
     Creates sub directories if non existing.
     No checks for the path.
 
+    Synchronous, every message at or above the logger level is flushed.
+
     @enhancement: verify path.
     */
     std::shared_ptr<spdlog::logger> CreateLogger(
@@ -63,56 +196,22 @@ namespace PZvend
         bool               has_console   = false,
         const std::string& path          = "",
         std::size_t        max_file_size = 20 * 1024 * 1024,
-        std::size_t        max_files     = 3)
-    {
-    #ifdef _DEBUG
-        auto level = spdlog::level::debug;
-    #else
-        auto level = spdlog::level::info;
-    #endif
-
-        std::vector<spdlog::sink_ptr> sinks;
-
-        if (has_console)
-        {
-            auto stdoutSink = std::make_shared<spdlog::sinks::stdout_color_sink_mt>();
-
-            stdoutSink->set_color(spdlog::level::trace   , LogColor::Foreground_Intense_Cyan);
-            stdoutSink->set_color(spdlog::level::debug   , LogColor::Foreground_Cyan);
-            stdoutSink->set_color(spdlog::level::info    , LogColor::Foreground_Green);
-            stdoutSink->set_color(spdlog::level::warn    , LogColor::Foreground_Intense_Yellow);
-            stdoutSink->set_color(spdlog::level::err     , LogColor::Foreground_Intense_Red);
-            stdoutSink->set_color(spdlog::level::critical, LogColor::Foreground_Intense_White | LogColor::Background_Red);
-
-            stdoutSink->set_pattern("[%T][%n][%^%l%$] %v");
-            stdoutSink->set_level(level);
-            sinks.push_back(stdoutSink);
-        }
-
-        if (!path.empty())
-        {
-            std::tm     timeinfo;
-            std::time_t current_time = std::time(nullptr);
-            localtime_s(&timeinfo, &current_time);
-
-            if (!Path::Create(path))
-                throw std::exception("Path could not be created.");
-
-            std::ostringstream oss;
-            oss << path;
-            if (!(path.ends_with('/')))
-                oss << '/';
-            oss << std::put_time(&timeinfo, "%Y-%m-%d.log");
-
-            auto rotatingSink = std::make_shared<spdlog::sinks::rotating_file_sink_mt>(oss.str(), max_file_size, max_files);
-            rotatingSink->set_pattern("[%T][%n][%l] %v");
-            rotatingSink->set_level(level);
-            sinks.push_back(rotatingSink);
-        }
-
-        auto logger = std::make_shared<spdlog::logger>(name, sinks.begin(), sinks.end());
-        logger->set_level(level);
-        logger->flush_on(level);
-        return logger;
-    }
-}
\ No newline at end of file
+        std::size_t        max_files     = 3);
+
+
+
+    /*
+    Same sinks as above. With config.Async the sinks sit behind an AsyncLogSink and the config's
+    flush policy applies, otherwise messages at or above FlushLevel are flushed synchronously.
+    */
+    std::shared_ptr<spdlog::logger> CreateLogger(const std::string& name, const LoggerConfig& config);
+
+
+
+    /*
+    Reads the metrics of a logger created with LoggerConfig::Async.
+
+    @return Returns false if the logger has no AsyncLogSink.
+    */
+    bool GetLoggerMetrics(const std::shared_ptr<spdlog::logger>& logger, LoggerMetrics& metrics);
+}
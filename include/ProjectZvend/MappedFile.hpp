@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+
+
+namespace PZvend
+{
+    /**
+    * @brief Read-only memory mapping of a whole file.
+    *
+    * The file content is paged in by the OS on access, nothing gets copied into the heap.
+    * The mapping (and every pointer handed out by it) stays valid until Close() is called
+    * or the MappedFile is destroyed.
+    *
+    * MappedFile file("./crash.dmp");
+    * if (file.IsOpen())
+    * {
+    *     <...> Read file.GetData() up to file.GetSize()
+    * }
+    */
+    class MappedFile
+    {
+    public:
+        MappedFile() = default;
+        explicit MappedFile(const std::string& filepath);
+        ~MappedFile();
+
+        MappedFile(const MappedFile&)            = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        MappedFile(MappedFile&& other) noexcept;
+        MappedFile& operator=(MappedFile&& other) noexcept;
+
+
+
+        /*
+        Maps the file read-only. An already opened file will be closed first.
+        Empty files can not be mapped.
+        */
+        bool Open(const std::string& filepath);
+
+
+
+        /*
+        Unmaps the file. All pointers into the mapping become invalid.
+        */
+        void Close() noexcept;
+
+
+
+        [[nodiscard]] inline bool           IsOpen()  const noexcept { return m_Data != nullptr; }
+        [[nodiscard]] inline const uint8_t* GetData() const noexcept { return m_Data; }
+        [[nodiscard]] inline size_t         GetSize() const noexcept { return m_Size; }
+
+    private:
+        uint8_t* m_Data = nullptr;
+        size_t   m_Size = 0;
+
+    #ifdef _WIN32
+        void*    m_File    = nullptr;
+        void*    m_Mapping = nullptr;
+    #else
+        int      m_File    = -1;
+    #endif
+    };
+}
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <spdlog/sinks/sink.h>
+#include <spdlog/spdlog.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+
+
+namespace PZvend
+{
+
+/*************\
+*    Types    *
+\*************/
+    constexpr uint32_t RING_LOG_VERSION      = 1;
+    constexpr size_t   RING_LOG_MIN_SIZE     = 64 * 1024;
+    constexpr uint32_t RING_LOG_RECORD_MAGIC = 0x4C525A50; // "PZRL"
+
+    /*
+    File layout (little endian), the data size is a power of two:
+        header  char[8] "PZRING\0\0", uint32 version, uint32 header size, uint64 data size,
+                uint64 cursor, uint8[32] reserved
+        data    records, 16 byte aligned, wrapping around at the data size
+
+    Record: uint64 position, uint32 length, uint32 magic, char[length] formatted line.
+    The position is the cursor value the record was reserved at and is written last, a
+    record only counts once it matches. Lines from a previous lap never do.
+    */
+    struct RingLogHeader
+    {
+        char     Magic[8];
+        uint32_t Version;
+        uint32_t HeaderSize;
+        uint64_t DataSize;
+        uint64_t Cursor;       // Total bytes ever reserved, only accessed atomically.
+        uint8_t  Reserved[32];
+    };
+
+    struct RingLogRecord
+    {
+        uint64_t Position;
+        uint32_t Length;
+        uint32_t Magic;
+    };
+
+
+
+/*************\
+*   Classes   *
+\*************/
+
+    /**
+    * @brief spdlog sink writing into a memory mapped file used as a lock-free ring.
+    *
+    * A line is formatted on the calling thread, gets its slot with one atomic add and is copied
+    * into the mapping, no syscall involved. The pages belong to the OS, so the last lines survive
+    * the process crashing. They don't survive the machine going down, flush() doesn't sync.
+    *
+    * An existing ring file is continued, not truncated, a restart after a crash keeps the old lines.
+    * Recover with MappedRingSink::Recover or "ProjectZvend_logtool recover game.pzring".
+    *
+    * LoggerConfig config;
+    * config.Path     = "logs";
+    * config.RingPath = "logs/game.pzring";
+    * auto logger     = CreateLogger("Game", config);
+    */
+    class MappedRingSink final : public spdlog::sinks::sink
+    {
+    public:
+        MappedRingSink();
+        MappedRingSink(const std::string& path, size_t size);
+        ~MappedRingSink() override;
+
+        MappedRingSink(const MappedRingSink&)            = delete;
+        MappedRingSink& operator=(const MappedRingSink&) = delete;
+
+
+
+        /*
+        Maps the file, created if missing. The size is rounded up to a power of two, at least RING_LOG_MIN_SIZE.
+        A file with a different size or an invalid header is reset.
+        */
+        bool Open(const std::string& path, size_t size);
+        void Close() noexcept;
+
+        [[nodiscard]] inline bool IsOpen() const noexcept { return m_Header != nullptr; }
+
+
+
+        void log(const spdlog::details::log_msg& msg) override;
+        void flush() override {}
+        void set_pattern(const std::string& pattern) override;
+        void set_formatter(std::unique_ptr<spdlog::formatter> sink_formatter) override;
+
+
+
+        /*
+        Reads the lines still in a ring file, oldest first. Works on a file a crashed
+        process left behind and on one that is still being written to.
+
+        @return Returns false if the file isn't a ring log.
+        */
+        static bool Recover(const std::string& path, std::vector<std::string>& lines);
+
+    private:
+        void ICopy(uint64_t position, const void* data, size_t size) noexcept;
+
+    private:
+        RingLogHeader* m_Header   = nullptr;
+        uint8_t*       m_Data     = nullptr;
+        uint64_t       m_Mask     = 0;
+        size_t         m_MaxLine  = 0;
+        size_t         m_FileSize = 0;
+
+        // Formatters aren't thread safe, every thread clones its own when the generation changes.
+        uint64_t                           m_Id;
+        std::mutex                         m_FormatterMutex;
+        std::unique_ptr<spdlog::formatter> m_Formatter;
+        std::atomic<uint64_t>              m_Generation = 1;
+
+    #ifdef _WIN32
+        void*    m_File    = nullptr;
+        void*    m_Mapping = nullptr;
+    #else
+        int      m_File    = -1;
+    #endif
+    };
+}
@@ -1,8 +1,22 @@
 #pragma once
 
+#include "ProjectZvend/DumpFile.hpp"
+#include "ProjectZvend/HookStats.hpp"
+#include "ProjectZvend/Log.hpp"
+#include "ProjectZvend/MappedFile.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <atomic>
 #include <functional>
-#include <MinHook.h>
-#include <wtypes.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+    #include <MinHook.h>
+    #include <wtypes.h>
+#endif
 
 
 
@@ -14,8 +28,13 @@ namespace PZvend
 /*************\
 *    Types    *
 \*************/
+#ifdef _WIN32
         using DllModule    = HMODULE;
+#else
+        using DllModule    = void*;
+#endif
         using ScanCallback = std::function<uint8_t* (uint8_t* address)>;
+        using Protection   = uint32_t; // Native page protection (PAGE_* on Windows, PROT_* on Linux).
 
         enum ScanSection : uint16_t
         {
@@ -39,6 +58,13 @@ namespace PZvend
             /* 0x0004 */ uint8_t* End   = nullptr;
         };
 
+        struct ScanRange
+        {
+            /* 0x0000 */ uint64_t RVA  = 0;
+            /* 0x0008 */ uint64_t Size = 0;
+            /* 0x0010 */ uint8_t* Data = nullptr;
+        };
+
 
 
 /*************\
@@ -96,6 +122,60 @@ namespace PZvend
         }
 
 
+        /*
+        Retrieves the size of a memory page.
+        */
+        [[nodiscard]] size_t GetPageSize() noexcept;
+
+
+        /*
+        Retrieves the protection of the page containing the address.
+        Optionally retrieves how many bytes from address on share that protection.
+        */
+        bool QueryProtection(const void* address, Protection* out_protection, size_t* out_size = nullptr) noexcept;
+
+
+        /*
+        Makes all pages of the range readable, writable and executable.
+        The previous protection of the first page can be retrieved to restore it with Protect.
+        */
+        bool Unprotect(void* address, size_t size, Protection* out_old = nullptr) noexcept;
+
+
+        /*
+        Applies a native protection to all pages of the range.
+        */
+        bool Protect(void* address, size_t size, Protection protection) noexcept;
+
+
+        /*
+        Makes sure the CPU does not execute stale instructions after code has been written.
+        */
+        void FlushInstructionCache(void* address, size_t size) noexcept;
+
+
+        /*
+        Checks if the page containing the address is writable and optionally retrieves its protection.
+        */
+        bool IsWritable(const void* address, Protection* out_protection = nullptr) noexcept;
+
+
+        /*
+        Retrieves the vtable of a polymorphic object (the first pointer of the object on MSVC and Itanium ABIs).
+        */
+        [[nodiscard]] inline void** GetVTable(const void* object) noexcept
+        {
+            return *reinterpret_cast<void** const*>(object);
+        }
+
+
+        /*
+        Counts the leading vtable entries that point into executable memory.
+        There is no ABI way to get the size of a vtable, this stops at the first non-code pointer.
+        */
+        [[nodiscard]] size_t CountVTableEntries(void** vtable, size_t max_entries = 1024) noexcept;
+
+
 
 /*************\
 *   Classes   *
@@ -105,9 +185,43 @@ namespace PZvend
         public:
             Scanner(const char* modulename);
 
+            /*
+            Scans a module captured in a crash dump instead of the running process.
+            Addresses returned by Find/FindAll point into the mapped dump, use GetRVA to resolve them.
+            The dump has to outlive the scanner.
+            */
+            Scanner(const DumpFile& dump, const char* modulename);
+
+            /*
+            Scans a PE or ELF image file on disk without loading it.
+            Sections are taken from the file's section headers, use GetRVA to resolve found addresses.
+            The mapped file has to outlive the scanner.
+            */
+            explicit Scanner(const MappedFile& image);
+
             [[nodiscard]] uint8_t* operator[](size_t RVA) const noexcept
             {
-                return reinterpret_cast<uint8_t*>(m_Module) + RVA;
+                if (m_Ranges.empty())
+                    return reinterpret_cast<uint8_t*>(m_Module) + RVA;
+
+                return ITranslate(RVA);
+            }
+
+
+            /*
+            Converts an address returned by Find/FindAll back into an RVA of the module.
+
+            @return Returns SIZE_MAX if the address does not belong to the module.
+            */
+            [[nodiscard]] size_t GetRVA(const uint8_t* address) const noexcept;
+
+
+            /*
+            Checks whether the image has the section at all, Find/FindAll on a missing one return nothing.
+            */
+            [[nodiscard]] bool HasSection(ScanSection section) const noexcept
+            {
+                return m_Sections[section].Start && m_Sections[section].End > m_Sections[section].Start;
             }
 
 
@@ -147,7 +261,7 @@ namespace PZvend
                 char    mask[maxLen];
 
                 if (!ConvertComboPattern(combo, pattern, mask))
-                    return reinterpret_cast<T>(nullptr);
+                    return T{};
 
                 uint8_t* address = IFind(pattern, mask, m_Sections[section].Start, m_Sections[section].End);
 
@@ -165,7 +279,7 @@ namespace PZvend
                 char    mask[maxLen];
 
                 if (!ConvertComboPattern(combo, pattern, mask))
-                    return reinterpret_cast<T>(nullptr);
+                    return T{};
 
                 uint8_t* address = IFind(pattern, mask, start, end);
 
@@ -184,7 +298,7 @@ namespace PZvend
                 char    mask[maxLen];
 
                 if (!ConvertComboPattern(combo, pattern, mask))
-                    return reinterpret_cast<T>(nullptr);
+                    return T{};
 
                 uint8_t* address = IFind(pattern, mask, m_Sections[section].Start, m_Sections[section].End);
                 return reinterpret_cast<T>(scan_cb ? scan_cb(address) : address);
@@ -201,7 +315,7 @@ namespace PZvend
                 char    mask[maxLen];
 
                 if (!ConvertComboPattern(combo, pattern, mask))
-                    return reinterpret_cast<T>(nullptr);
+                    return T{};
 
                 uint8_t* address = IFind(pattern, mask, start, end);
                 return reinterpret_cast<T>(scan_cb ? scan_cb(address) : address);
@@ -308,22 +422,344 @@ namespace PZvend
         protected: /* (I)nternal functions */
             [[nodiscard]] uint8_t* IFind(const uint8_t* pattern, const char* mask, uint8_t* start, uint8_t* end) const noexcept;
             [[nodiscard]] std::vector<uint8_t*> IFindAll(const uint8_t* pattern, const char* mask, uint8_t* start, uint8_t* end) const noexcept;
+            [[nodiscard]] uint8_t* ITranslate(size_t RVA) const noexcept;
 
 
         protected: /* Variables */
-            /* 0x0000 */ SectionData m_Sections[ScanSection::MAX] = {};
-            /* 0x0008 */ DllModule   m_Module                     = nullptr;
+            /* 0x0000 */ SectionData            m_Sections[ScanSection::MAX] = {};
+            /* 0x0008 */ DllModule              m_Module                     = nullptr;
+            /* 0x0010 */ uint64_t               m_ModuleSize                 = 0;       // Size of the contiguous image starting at m_Module.
+            /* 0x0018 */ std::vector<ScanRange> m_Ranges;                    // Only used if the module is not contiguous in memory (e.g. dumps).
+        };
+
+
+
+        /**
+        * @brief Collects byte patches and applies or reverts them as one unit.
+        *
+        * Patches are grouped by page: every page range gets its protection flipped once,
+        * no matter how many patches it contains. The original bytes are captured on Apply,
+        * so Revert restores the whole set. If a protection change fails, nothing is written.
+        *
+        * PatchSet patches("Startup");
+        * patches.AddNop(scanner.Find("E8 ? ? ? ? 84 C0 74 ?", TEXT), 5);
+        * patches.Add(scanner.Find("75 ? 8B 45 08", TEXT), { 0xEB });
+        * patches.Apply();
+        */
+        class PatchSet
+        {
+        public:
+            PatchSet() = default;
+            explicit PatchSet(const char* name) : m_Name(name) {}
+
+
+
+            /*
+            Queues a patch. Patches may not overlap and can only be added while the set is not applied.
+            */
+            bool Add(void* address, const uint8_t* bytes, size_t size);
+
+            bool Add(void* address, std::initializer_list<uint8_t> bytes)
+            {
+                return Add(address, bytes.begin(), bytes.size());
+            }
+
+
+
+            /*
+            Queues a patch that fills the range with NOPs.
+            */
+            bool AddNop(void* address, size_t size);
+
+
+
+            /*
+            Drops all queued patches. Fails while the set is applied.
+            */
+            bool Clear();
+
+
+
+            /*
+            Captures the original bytes and writes all patches.
+            */
+            bool Apply();
+
+
+
+            /*
+            Writes the original bytes of all patches back.
+            */
+            bool Revert();
+
+
+
+            /*
+            Checks that memory still holds the patched bytes (if applied) or the original bytes (if reverted).
+            */
+            [[nodiscard]] bool Verify() const noexcept;
+
+
+
+            [[nodiscard]] inline bool   IsApplied() const noexcept { return m_Applied; }
+            [[nodiscard]] inline size_t GetCount()  const noexcept { return m_Patches.size(); }
+
+        private: /* (I)nternal functions */
+            bool IWrite(bool apply);
+
+        private: /* Types */
+            struct Patch
+            {
+                uint8_t*             Address = nullptr;
+                std::vector<uint8_t> Bytes;
+                std::vector<uint8_t> Original;
+            };
+
+        private: /* Variables */
+            std::string        m_Name;
+            std::vector<Patch> m_Patches; // Sorted by address.
+            bool               m_Applied = false;
+        };
+
+
+
+        /**
+        * @brief Per-object copy of a vtable.
+        *
+        * Attaching points the object at the copy with a single pointer store, so hooks placed in
+        * the shadow only affect this object and never touch protected memory. The entries in front of
+        * the vtable are copied along (offset-to-top and RTTI on Itanium, the complete object locator on
+        * MSVC), dynamic_cast and typeid keep working.
+        *
+        * The shadow has to be detached or destroyed before the object is.
+        *
+        * VmtShadow shadow(player);
+        * VmtHook<Update_FUNC> hook("Player::Update", shadow, 3, &HookUpdate);
+        * hook.Create();
+        * hook.Enable();
+        * shadow.Attach();
+        */
+        class VmtShadow
+        {
+        public:
+            /*
+            @param object Polymorphic object to shadow.
+            @param entries Number of vtable entries to copy, 0 counts them with CountVTableEntries.
+            */
+            explicit VmtShadow(void* object, size_t entries = 0);
+            ~VmtShadow();
+
+            VmtShadow(const VmtShadow&)            = delete;
+            VmtShadow& operator=(const VmtShadow&) = delete;
+
+
+
+            /*
+            Swaps the object's vtable pointer to the shadow copy.
+            */
+            bool Attach() noexcept;
+
+
+
+            /*
+            Restores the object's original vtable pointer.
+            */
+            bool Detach() noexcept;
+
+
+
+            [[nodiscard]] inline bool   IsAttached() const noexcept { return m_Attached; }
+            [[nodiscard]] inline size_t GetCount() const noexcept { return m_Count; }
+            [[nodiscard]] inline void** GetOriginal() const noexcept { return m_Original; }
+            [[nodiscard]] inline void** GetTable() const noexcept { return m_Table.get() + PREFIX_ENTRIES; }
+
+
+        private: /* Variables */
+        #ifdef _MSC_VER
+            static constexpr size_t PREFIX_ENTRIES = 1; // RTTI complete object locator.
+        #else
+            static constexpr size_t PREFIX_ENTRIES = 2; // Offset-to-top and RTTI.
+        #endif
+
+            void*                    m_Object   = nullptr;
+            void**                   m_Original = nullptr;
+            std::unique_ptr<void*[]> m_Table;
+            size_t                   m_Count    = 0;
+            bool                     m_Attached = false;
         };
 
 
 
+        /**
+        * @brief Hooks a virtual function by swapping its vtable slot.
+        *
+        * Enabling and disabling is a single atomic pointer store: no thread gets suspended and no code gets rewritten.
+        * Hooking a class vtable affects every instance, hooking a VmtShadow only that object.
+        * Calls that the compiler devirtualized are not affected.
+        *
+        * T is the function pointer type with an explicit this parameter (__thiscall on x86 Windows).
+        *
+        * using Update_FUNC = void(*)(Player* self, float delta);
+        * VmtHook<Update_FUNC> g_Hook("Player::Update", GetVTable(player), 3, &HookUpdate);
+        *
+        * void HookUpdate(Player* self, float delta)
+        * {
+        *     g_Hook.Call(self, delta * 2.0f);
+        * }
+        */
         template <class T>
+        class VmtHook
+        {
+        public:
+            VmtHook() = default;
+            VmtHook(const char* name, void** vtable, size_t index, T callback)
+                : m_Name(name), m_Slot(vtable + index), m_DetourFunc((void*)callback)
+            {}
+
+            VmtHook(const char* name, VmtShadow& shadow, size_t index, T callback)
+                : m_Name(name), m_Slot(index < shadow.GetCount() ? shadow.GetTable() + index : nullptr), m_DetourFunc((void*)callback)
+            {}
+
+            bool Create()
+            {
+                if (m_Original)
+                    return true;
+
+                if (!m_Slot || !QueryProtection(m_Slot, &m_Protection))
+                {
+                    PZ_LOG_ERROR(HOOKS, "Creating '{}' failed, invalid vtable slot.", m_Name);
+                    return false;
+                }
+
+                m_Writable = IsWritable(m_Slot);
+                m_Original = std::atomic_ref<void*>(*m_Slot).load(std::memory_order_acquire);
+
+                PZ_LOG_DEBUG(HOOKS, "Created '{}' Hook.", m_Name);
+                return true;
+            }
+
+
+
+            bool Remove()
+            {
+                if (!m_Original)
+                    return true;
+
+                if (!Disable())
+                    return false;
+
+                PZ_LOG_DEBUG(HOOKS, "Removed '{}' Hook.", m_Name);
+                m_Original = nullptr;
+                return true;
+            }
+
+
+
+            bool Enable()
+            {
+                if (IsEnabled())
+                    return true;
+
+                if (!m_Original || !IWrite(m_DetourFunc))
+                {
+                    PZ_LOG_ERROR(HOOKS, "Enabling '{}' failed.", m_Name);
+                    return false;
+                }
+
+                PZ_LOG_DEBUG(HOOKS, "Enabled '{}' Hook.", m_Name);
+                m_Enabled = true;
+                return true;
+            }
+
+
+
+            bool Disable()
+            {
+                if (!IsEnabled())
+                    return true;
+
+                if (!IWrite(m_Original))
+                {
+                    PZ_LOG_ERROR(HOOKS, "Disabling '{}' failed.", m_Name);
+                    return false;
+                }
+
+                PZ_LOG_DEBUG(HOOKS, "Disabled '{}' Hook.", m_Name);
+                m_Enabled = false;
+                return true;
+            }
+
+
+
+            bool Retour(T NewCallback)
+            {
+                void* old_callback = m_DetourFunc;
+                m_DetourFunc = reinterpret_cast<void*>(NewCallback);
+
+                if (IsEnabled() && !IWrite(m_DetourFunc))
+                {
+                    PZ_LOG_ERROR(HOOKS, "Retouring '{}' failed.", m_Name);
+                    m_DetourFunc = old_callback;
+                    return false;
+                }
+
+                PZ_LOG_DEBUG(HOOKS, "Retoured '{}' Hook from {} to {}.", m_Name, fmt::ptr(old_callback), fmt::ptr(m_DetourFunc));
+                return true;
+            }
+
+
+
+            inline bool IsEnabled() { return m_Enabled; }
+
+            // Call the original function
+            template <typename ...Args>
+            auto Call(Args&& ...args)
+            {
+                return reinterpret_cast<T>(m_Original)(std::forward<Args>(args)...);
+            }
+
+
+        private: /* (I)nternal functions */
+            bool IWrite(void* value)
+            {
+                // Vtables usually live in read-only data, the protection is only flipped around the store.
+                if (!m_Writable && !Unprotect(m_Slot, sizeof(void*)))
+                    return false;
+
+                std::atomic_ref<void*>(*m_Slot).store(value, std::memory_order_release);
+
+                if (!m_Writable)
+                    Protect(m_Slot, sizeof(void*), m_Protection);
+
+                return true;
+            }
+
+
+        private: /* Variables */
+            std::string m_Name;
+            void**      m_Slot       = nullptr;
+            void*       m_Original   = nullptr;
+            void*       m_DetourFunc = nullptr;
+            Protection  m_Protection = 0;
+            bool        m_Writable   = false;
+            bool        m_Enabled    = false;
+        };
+
+
+
+#ifdef _WIN32
+        class HookTransaction;
+
+        /*
+        Policy is NoInstrumentation or HookCounters (see HookStats.hpp), the default keeps Call free of any bookkeeping.
+        */
+        template <class T, class Policy = NoInstrumentation>
         class THook
         {
         public:
             THook() = default;
             THook(const char* name, T address, T callback)
-                : m_Name(name), m_FuncAddress((void*)address), m_DetourFunc((void*)callback)
+                : m_Name(name), m_FuncAddress((void*)address), m_DetourFunc((void*)callback), m_Stats(name)
             {}
 
             bool Create()
@@ -334,11 +770,11 @@ namespace PZvend
                 auto mh_status = MH_CreateHook(m_FuncAddress, m_DetourFunc, &m_RetAddress);
                 if (mh_status != MH_OK)
                 {
-                    SPDLOG_ERROR("Creating '{}' failed with {}.", m_Name, MH_StatusToString(mh_status));
+                    PZ_LOG_ERROR(HOOKS, "Creating '{}' failed with {}.", m_Name, MH_StatusToString(mh_status));
                     return false;
                 }
 
-                SPDLOG_DEBUG("Created '{}' Hook.", m_Name);
+                PZ_LOG_DEBUG(HOOKS, "Created '{}' Hook.", m_Name);
                 return true;
             }
 
@@ -352,11 +788,11 @@ namespace PZvend
                 auto mh_status = MH_RemoveHook(m_FuncAddress);
                 if (mh_status != MH_OK)
                 {
-                    SPDLOG_ERROR("Removing '{}' failed with {}.", m_Name, MH_StatusToString(mh_status));
+                    PZ_LOG_ERROR(HOOKS, "Removing '{}' failed with {}.", m_Name, MH_StatusToString(mh_status));
                     return false;
                 }
 
-                SPDLOG_DEBUG("Removed '{}' Hook.", m_Name);
+                PZ_LOG_DEBUG(HOOKS, "Removed '{}' Hook.", m_Name);
                 m_Enabled    = false;
                 m_RetAddress = nullptr;
                 return true;
@@ -372,11 +808,11 @@ namespace PZvend
                 auto mh_status = MH_EnableHook(m_FuncAddress);
                 if (mh_status != MH_OK)
                 {
-                    SPDLOG_ERROR("Enabling '{}' failed with {}.", m_Name, MH_StatusToString(mh_status));
+                    PZ_LOG_ERROR(HOOKS, "Enabling '{}' failed with {}.", m_Name, MH_StatusToString(mh_status));
                     return false;
                 }
 
-                SPDLOG_DEBUG("Enabled '{}' Hook.", m_Name);
+                PZ_LOG_DEBUG(HOOKS, "Enabled '{}' Hook.", m_Name);
                 m_Enabled = true;
                 return true;
             }
@@ -391,11 +827,11 @@ namespace PZvend
                 auto mh_status = MH_DisableHook(m_FuncAddress);
                 if (mh_status != MH_OK)
                 {
-                    SPDLOG_ERROR("[Memory] Disabling '{}' failed with {}.", m_Name, MH_StatusToString(mh_status));
+                    PZ_LOG_ERROR(HOOKS, "Disabling '{}' failed with {}.", m_Name, MH_StatusToString(mh_status));
                     return false;
                 }
 
-                SPDLOG_DEBUG("[Memory] Disabled '{}' Hook.", m_Name);
+                PZ_LOG_DEBUG(HOOKS, "Disabled '{}' Hook.", m_Name);
                 m_Enabled = false;
                 return true;
             }
@@ -417,7 +853,7 @@ namespace PZvend
                 if (enabled)
                     Enable();
 
-                SPDLOG_DEBUG("[Memory] Retoured '{}' Hook from {} to {}.", m_Name, fmt::ptr(old_callback), fmt::ptr(m_DetourFunc));
+                PZ_LOG_DEBUG(HOOKS, "Retoured '{}' Hook from {} to {}.", m_Name, fmt::ptr(old_callback), fmt::ptr(m_DetourFunc));
                 return true;
             }
 
@@ -429,17 +865,25 @@ namespace PZvend
             template <typename ...Args>
             auto Call(Args&& ...args)
             {
-                SPDLOG_DEBUG("[Memory] Calling original function of '{}' with {} args.", m_Name, sizeof...(args));
+                [[maybe_unused]] auto scope = m_Stats.OriginalScope();
                 return reinterpret_cast<T>(m_RetAddress)(std::forward<Args>(args)...);
             }
 
+            // Measures the detour until the end of the scope, a no-op without instrumentation.
+            [[nodiscard]] inline auto Scope() const noexcept { return m_Stats.DetourScope(); }
+
+            [[nodiscard]] inline const Policy& GetStats() const noexcept { return m_Stats; }
+
+            friend class HookTransaction;
+
         private:
             std::string m_Name;
             void*       m_FuncAddress = nullptr;
             void*       m_RetAddress  = nullptr;
             void*       m_DetourFunc  = nullptr;
             bool        m_Enabled     = false;
+            Policy      m_Stats;
         };
+#endif
     }
-}
-
+}
\ No newline at end of file
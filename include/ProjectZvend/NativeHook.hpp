@@ -0,0 +1,233 @@
+#pragma once
+
+#include "ProjectZvend/Memory.hpp"
+
+#include <spdlog/spdlog.h>
+#include <string>
+#include <utility>
+
+
+
+namespace PZvend
+{
+    namespace Memory
+    {
+        class HookTransaction;
+
+/*************\
+*    Types    *
+\*************/
+        enum InlineHookStatus : uint8_t
+        {
+            INLINE_OK,
+            INLINE_ALREADY_CREATED,
+            INLINE_NOT_CREATED,
+            INLINE_ENABLED,
+            INLINE_DISABLED,
+            INLINE_NOT_EXECUTABLE,
+            INLINE_UNSUPPORTED_FUNCTION, // Prologue can't be relocated (too short, loop/jrcxz, branch into the patch).
+            INLINE_MEMORY_ALLOC,         // No trampoline memory within +-2GB of the target.
+            INLINE_MEMORY_PROTECT,
+            INLINE_UNSUPPORTED_PLATFORM, // Only x86-64 is implemented.
+        };
+
+
+
+/*************\
+*  Functions  *
+\*************/
+
+        /*
+        The native backend mirrors the MinHook API, so THook and NativeHook read the same.
+
+        A hook patches a 5 byte `jmp rel32` over the target's prologue. It lands on a relay slot
+        next to the target (allocated from a slab pool within +-2GB), which jumps to the detour.
+        The relocated prologue (RIP-relative operands and relative branches fixed up) plus a jump
+        back form the trampoline that calls the original function.
+
+        Unlike MinHook, other threads are not suspended while patching. The 5 byte write is done
+        as a single aligned 8 byte store whenever the prologue allows it.
+        */
+        [[nodiscard]] const char* InlineHookStatusToString(InlineHookStatus status) noexcept;
+
+        InlineHookStatus CreateInlineHook(void* target, void* detour, void** out_original);
+        InlineHookStatus RemoveInlineHook(void* target);
+        InlineHookStatus EnableInlineHook(void* target);
+        InlineHookStatus DisableInlineHook(void* target);
+
+
+
+        /*
+        Redirects an existing hook to a new detour by swapping the relay's jump address.
+        Neither the target nor the trampoline are touched, so it works while the hook is enabled.
+        */
+        InlineHookStatus SetInlineHookDetour(void* target, void* detour);
+
+
+
+        /*
+        Queued state changes, the counterpart of MH_QueueEnableHook / MH_ApplyQueued.
+
+        Queueing only records the wanted state, ApplyQueuedInlineHooks writes every pending patch with
+        one PatchSet: each touched page is unprotected and restored once, and either all hooks change
+        state or none does. Queueing the current state cancels a pending change.
+        */
+        InlineHookStatus QueueEnableInlineHook(void* target);
+        InlineHookStatus QueueDisableInlineHook(void* target);
+        InlineHookStatus ApplyQueuedInlineHooks();
+
+
+
+/*************\
+*   Classes   *
+\*************/
+        template <class T, class Policy = NoInstrumentation>
+        class NativeHook
+        {
+        public:
+            NativeHook() = default;
+            NativeHook(const char* name, T address, T callback)
+                : m_Name(name), m_FuncAddress((void*)address), m_DetourFunc((void*)callback), m_Stats(name)
+            {}
+
+            bool Create()
+            {
+                if (m_RetAddress)
+                    return true;
+
+                auto status = CreateInlineHook(m_FuncAddress, m_DetourFunc, &m_RetAddress);
+                if (status != INLINE_OK)
+                {
+                    PZ_LOG_ERROR(HOOKS, "Creating '{}' failed with {}.", m_Name, InlineHookStatusToString(status));
+                    return false;
+                }
+
+                PZ_LOG_DEBUG(HOOKS, "Created '{}' Hook.", m_Name);
+                return true;
+            }
+
+
+
+            bool Remove()
+            {
+                if (!m_RetAddress)
+                    return true;
+
+                auto status = RemoveInlineHook(m_FuncAddress);
+                if (status != INLINE_OK)
+                {
+                    PZ_LOG_ERROR(HOOKS, "Removing '{}' failed with {}.", m_Name, InlineHookStatusToString(status));
+                    return false;
+                }
+
+                PZ_LOG_DEBUG(HOOKS, "Removed '{}' Hook.", m_Name);
+                m_Enabled    = false;
+                m_RetAddress = nullptr;
+                return true;
+            }
+
+
+
+            bool Enable()
+            {
+                if (IsEnabled())
+                    return true;
+
+                auto status = EnableInlineHook(m_FuncAddress);
+                if (status != INLINE_OK)
+                {
+                    PZ_LOG_ERROR(HOOKS, "Enabling '{}' failed with {}.", m_Name, InlineHookStatusToString(status));
+                    return false;
+                }
+
+                PZ_LOG_DEBUG(HOOKS, "Enabled '{}' Hook.", m_Name);
+                m_Enabled = true;
+                return true;
+            }
+
+
+
+            bool Disable()
+            {
+                if (!IsEnabled())
+                    return true;
+
+                auto status = DisableInlineHook(m_FuncAddress);
+                if (status != INLINE_OK)
+                {
+                    PZ_LOG_ERROR(HOOKS, "Disabling '{}' failed with {}.", m_Name, InlineHookStatusToString(status));
+                    return false;
+                }
+
+                PZ_LOG_DEBUG(HOOKS, "Disabled '{}' Hook.", m_Name);
+                m_Enabled = false;
+                return true;
+            }
+
+
+
+            /*
+            Unlike THook::Retour the hook is not recreated, only the relay is pointed at the new callback.
+            */
+            bool Retour(T NewCallback)
+            {
+                void* old_callback = m_DetourFunc;
+                m_DetourFunc = reinterpret_cast<void*>(NewCallback);
+
+                if (!m_RetAddress)
+                    return true;
+
+                auto status = SetInlineHookDetour(m_FuncAddress, m_DetourFunc);
+                if (status != INLINE_OK)
+                {
+                    PZ_LOG_ERROR(HOOKS, "Retouring '{}' failed with {}.", m_Name, InlineHookStatusToString(status));
+                    m_DetourFunc = old_callback;
+                    return false;
+                }
+
+                PZ_LOG_DEBUG(HOOKS, "Retoured '{}' Hook from {} to {}.", m_Name, fmt::ptr(old_callback), fmt::ptr(m_DetourFunc));
+                return true;
+            }
+
+
+
+            inline bool IsEnabled() { return m_Enabled; }
+
+            // Call the original function
+            template <typename ...Args>
+            auto Call(Args&& ...args)
+            {
+                [[maybe_unused]] auto scope = m_Stats.OriginalScope();
+                return reinterpret_cast<T>(m_RetAddress)(std::forward<Args>(args)...);
+            }
+
+            // Measures the detour until the end of the scope, a no-op without instrumentation.
+            [[nodiscard]] inline auto Scope() const noexcept { return m_Stats.DetourScope(); }
+
+            [[nodiscard]] inline const Policy& GetStats() const noexcept { return m_Stats; }
+
+            friend class HookTransaction;
+
+        private:
+            std::string m_Name;
+            void*       m_FuncAddress = nullptr;
+            void*       m_RetAddress  = nullptr;
+            void*       m_DetourFunc  = nullptr;
+            bool        m_Enabled     = false;
+            Policy      m_Stats;
+        };
+
+
+
+        /*
+        The platform's default inline hook: MinHook on Windows, the native backend elsewhere.
+        */
+#ifdef _WIN32
+        template <class T, class Policy = NoInstrumentation>
+        using Hook = THook<T, Policy>;
+#else
+        template <class T, class Policy = NoInstrumentation>
+        using Hook = NativeHook<T, Policy>;
+#endif
+    }
+}
@@ -1,8 +1,13 @@
 #pragma once
 
 #include <filesystem>
+#include <sstream>
 #include <string>
-#include <wtypes.h>
+#include <vector>
+
+#ifdef _WIN32
+    #include <wtypes.h>
+#endif
 
 
 namespace PZvend
@@ -44,9 +49,16 @@ namespace PZvend
 
 
 
+#ifdef _WIN32
         /*
         Gets the current module path.
         */
         std::string GetModulePath(HMODULE hModule);
+#else
+        /*
+        Gets the path of the module containing the address.
+        */
+        std::string GetModulePath(const void* address);
+#endif
     }
 }
\ No newline at end of file
@@ -0,0 +1,143 @@
+#pragma once
+
+#include "ProjectZvend/Stopwatch.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+
+
+/*
+Zones are only compiled in with PZVEND_ENABLE_PROFILER (CMake option ENABLE_PROFILER), otherwise the
+macros expand to nothing. Compiled in but not started, a zone costs one relaxed load and a branch.
+
+void Scanner::Scan()
+{
+    PZ_PROFILE_FUNCTION();
+    {
+        PZ_PROFILE_SCOPE("Scanner::Scan/Compare");
+        <...>
+    }
+}
+
+Zone names have to outlive the profiler session, use string literals.
+*/
+#ifdef PZVEND_ENABLE_PROFILER
+    #define PZ_PROFILE_CONCAT_INNER(a, b) a##b
+    #define PZ_PROFILE_CONCAT(a, b)       PZ_PROFILE_CONCAT_INNER(a, b)
+
+    #define PZ_PROFILE_SCOPE(name) ::PZvend::Profiler::ScopedZone PZ_PROFILE_CONCAT(pz_profile_zone_, __LINE__)(name)
+    #define PZ_PROFILE_FUNCTION()  PZ_PROFILE_SCOPE(__func__)
+#else
+    #define PZ_PROFILE_SCOPE(name) ((void)0)
+    #define PZ_PROFILE_FUNCTION()  ((void)0)
+#endif
+
+
+
+namespace PZvend
+{
+    namespace Profiler
+    {
+
+/*************\
+*    Types    *
+\*************/
+        constexpr size_t PROFILER_RING_CAPACITY = 1 << 14; // Zones per thread between two flushes, more get dropped.
+
+        enum ProfilerFormat : uint8_t
+        {
+            PROFILER_CHROME_JSON, // Trace Event JSON, opens in chrome://tracing, Perfetto and Speedscope.
+            PROFILER_BINARY,      // Raw ticks, see below.
+        };
+
+        /*
+        Binary layout (little endian, no padding):
+            header  char[8] "PZTRACE\0", uint32 version, uint32 reserved, double ticks per second, uint64 start ticks
+            name    uint8 1, uint32 id, uint16 length, char[length]      (written before the first zone using it)
+            thread  uint8 2, uint32 thread id, uint64 os thread id       (written before the first zone of the thread)
+            zone    uint8 3, uint32 thread id, uint32 name id, uint64 start ticks, uint64 end ticks
+        */
+        constexpr uint32_t PROFILER_BINARY_VERSION = 1;
+
+        // Only read on the hot path, written by Start / Stop.
+        inline std::atomic<bool> g_Enabled = false;
+
+
+
+/*************\
+*  Functions  *
+\*************/
+
+        /*
+        Starts a session, zones are recorded from now on and flushed to the file by a background thread.
+
+        @param path File to write, it gets truncated.
+        @param interval Time between two flushes, the per thread rings have to hold the zones of one interval.
+        @return Returns false if a session is already running or the file can't be opened.
+        */
+        bool Start(const std::string& path, ProfilerFormat format = PROFILER_CHROME_JSON, std::chrono::milliseconds interval = std::chrono::milliseconds(50));
+
+
+
+        /*
+        Stops recording, flushes the remaining zones and closes the file.
+        */
+        void Stop();
+
+
+
+        [[nodiscard]] inline bool IsEnabled() noexcept { return g_Enabled.load(std::memory_order_relaxed); }
+
+
+
+        /*
+        Zones that didn't fit into their thread's ring since the session started.
+        */
+        [[nodiscard]] uint64_t GetDroppedZones() noexcept;
+
+
+
+        /*
+        Pushes a finished zone into the calling thread's ring, ticks are ReadCycleCounter values.
+        */
+        void Record(const char* name, uint64_t start, uint64_t end) noexcept;
+
+
+
+/*************\
+*   Classes   *
+\*************/
+
+        /**
+        * @brief Records the lifetime of the scope as a zone, use PZ_PROFILE_SCOPE instead of naming it.
+        */
+        class ScopedZone
+        {
+        public:
+            explicit ScopedZone(const char* name) noexcept
+            {
+                if (!IsEnabled())
+                    return;
+
+                m_Name  = name;
+                m_Start = ReadCycleCounter();
+            }
+
+            ~ScopedZone()
+            {
+                if (m_Name)
+                    Record(m_Name, m_Start, ReadCycleCounter());
+            }
+
+            ScopedZone(const ScopedZone&)            = delete;
+            ScopedZone& operator=(const ScopedZone&) = delete;
+
+        private:
+            const char* m_Name  = nullptr;
+            uint64_t    m_Start = 0;
+        };
+    }
+}
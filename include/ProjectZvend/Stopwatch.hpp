@@ -1,5 +1,10 @@
 #pragma once
 #include <chrono>
+#include <cstdint>
+
+#if defined(_MSC_VER)
+    #include <intrin.h>
+#endif
 
 
 
@@ -88,12 +93,58 @@ namespace PZvend
         {
             using namespace std::chrono;
 
-            duration<double> elapsed = duration_cast<milliseconds>(steady_clock::now() - m_TimeStarted);
-            return static_cast<int>(GetElapsedTime() * 1000);
+            return static_cast<int>(duration_cast<milliseconds>(steady_clock::now() - m_TimeStarted).count());
         }
 
     private:
         double                                m_WatchTime;
         std::chrono::steady_clock::time_point m_TimeStarted;
     };
+
+
+
+    /*
+    Reads the CPU's cycle counter (rdtsc on x86, cntvct_el0 on ARM64), falls back to steady_clock nanoseconds.
+    Only meant for measuring short intervals on the same thread, convert with GetCycleCounterFrequency.
+    */
+    [[nodiscard]] inline uint64_t ReadCycleCounter() noexcept
+    {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+        return __rdtsc();
+#elif defined(__x86_64__) || defined(__i386__)
+        return __builtin_ia32_rdtsc();
+#elif defined(__aarch64__)
+        uint64_t value;
+        asm volatile("mrs %0, cntvct_el0" : "=r"(value));
+        return value;
+#else
+        return static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+    }
+
+
+
+    /*
+    Gets the ticks per second of ReadCycleCounter. The first call calibrates against steady_clock for 10ms.
+    */
+    [[nodiscard]] inline double GetCycleCounterFrequency() noexcept
+    {
+        static const double frequency = []()
+        {
+            using namespace std::chrono;
+
+            const auto     start_time  = steady_clock::now();
+            const uint64_t start_ticks = ReadCycleCounter();
+
+            while (steady_clock::now() - start_time < milliseconds(10))
+                ;
+
+            const uint64_t         end_ticks = ReadCycleCounter();
+            const duration<double> elapsed   = steady_clock::now() - start_time;
+
+            return static_cast<double>(end_ticks - start_ticks) / elapsed.count();
+        }();
+
+        return frequency;
+    }
 }
\ No newline at end of file
@@ -0,0 +1,234 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+
+namespace PZvend
+{
+
+/*************\
+*    Types    *
+\*************/
+    constexpr uint32_t TIMER_WHEEL_BITS   = 6;
+    constexpr uint32_t TIMER_WHEEL_SLOTS  = 1u << TIMER_WHEEL_BITS;
+    constexpr uint32_t TIMER_WHEEL_LEVELS = 4; // 64^4 ticks, ~4.6 hours at 1ms. Longer delays wait in the last level.
+
+    using TimerId       = uint64_t; // 0 is never a valid timer.
+    using TimerCallback = std::function<void()>;
+
+
+
+/*************\
+*   Classes   *
+\*************/
+
+    /**
+    * @brief Read side of a CancellationSource, cheap to copy into many timers.
+    */
+    class CancellationToken
+    {
+    public:
+        CancellationToken() = default;
+
+        [[nodiscard]] inline bool IsCancelled() const noexcept { return m_State && m_State->load(std::memory_order_acquire); }
+        [[nodiscard]] inline bool CanBeCancelled() const noexcept { return m_State != nullptr; }
+
+    private:
+        friend class CancellationSource;
+        explicit CancellationToken(std::shared_ptr<std::atomic<bool>> state) noexcept : m_State(std::move(state)) {}
+
+        std::shared_ptr<std::atomic<bool>> m_State;
+    };
+
+
+
+    /**
+    * @brief Cancels every timer scheduled with one of its tokens at once.
+    *
+    * CancellationSource level_timers;
+    * wheel.Schedule(5.0, &SpawnBoss, level_timers.GetToken());
+    * wheel.SchedulePeriodic(1.0, &UpdateHud, level_timers.GetToken());
+    *
+    * level_timers.Cancel(); // level unloaded, neither callback runs anymore
+    */
+    class CancellationSource
+    {
+    public:
+        CancellationSource() : m_State(std::make_shared<std::atomic<bool>>(false)) {}
+
+        inline void Cancel() noexcept { m_State->store(true, std::memory_order_release); }
+
+        [[nodiscard]] inline bool              IsCancelled() const noexcept { return m_State->load(std::memory_order_acquire); }
+        [[nodiscard]] inline CancellationToken GetToken() const noexcept { return CancellationToken(m_State); }
+
+    private:
+        std::shared_ptr<std::atomic<bool>> m_State;
+    };
+
+
+
+    /**
+    * @brief Hierarchical timing wheel for one-shot and periodic callbacks.
+    *
+    * @author Zvendson
+    *
+    * Four levels of 64 slots each; a timer sits in the level matching its remaining delay and cascades
+    * down as time passes. Scheduling and cancelling are O(1), a tick reads the clock once no matter how
+    * many timers are pending. Timers live in a pooled node array, their ids carry a generation so a stale
+    * id never cancels a recycled node.
+    *
+    * Delays are in seconds like Stopwatch (E.G.: 1.7 = 1s and 700ms), rounded up to whole ticks and counted
+    * from the last Tick. Callbacks run on the ticking thread without the wheel's lock held, they may
+    * schedule and cancel timers themselves.
+    *
+    * TimerWheel wheel(0.001);
+    * TimerId autosave = wheel.SchedulePeriodic(60.0, []() { g_Config.Save(); });
+    *
+    * while (running)
+    * {
+    *     wheel.Tick(); // once per frame, or wheel.StartThread()
+    *     <...>
+    * }
+    */
+    class TimerWheel
+    {
+    public:
+        /*
+        @param tick Duration of one tick in seconds, the resolution of every delay.
+        */
+        explicit TimerWheel(double tick = 0.001);
+        ~TimerWheel();
+
+        TimerWheel(const TimerWheel&)            = delete;
+        TimerWheel& operator=(const TimerWheel&) = delete;
+
+
+
+        /*
+        Runs the callback once after the delay.
+
+        @return Returns the id to cancel the timer with.
+        */
+        TimerId Schedule(double delay, TimerCallback callback, CancellationToken token = {});
+
+
+
+        /*
+        Runs the callback every interval until it gets cancelled.
+        */
+        TimerId SchedulePeriodic(double interval, TimerCallback callback, CancellationToken token = {});
+
+
+
+        /*
+        Cancels a pending timer. A callback may cancel its own timer, it just doesn't run again.
+
+        @return Returns false if the timer already ran or was cancelled.
+        */
+        bool Cancel(TimerId id);
+
+
+
+        [[nodiscard]] bool IsScheduled(TimerId id);
+
+
+
+        /*
+        Advances the wheel to now and runs every due callback.
+
+        @return Returns the number of callbacks that ran.
+        */
+        size_t Tick();
+
+
+
+        /*
+        Same as Tick, for hosts that already read the clock for the frame.
+        */
+        size_t Tick(std::chrono::steady_clock::time_point now);
+
+
+
+        /*
+        Ticks from a dedicated thread instead of the host's frame.
+        The thread sleeps until the next timer runs or cascades rather than waking up every tick.
+        */
+        bool StartThread();
+        void StopThread();
+
+
+
+        /*
+        Grows the node pool up front so scheduling doesn't allocate.
+        */
+        void Reserve(size_t timers);
+
+
+
+        [[nodiscard]] size_t GetCount();
+        [[nodiscard]] inline double GetTickDuration() const noexcept { return std::chrono::duration<double>(m_TickDuration).count(); }
+
+
+    private: /* Types */
+        static constexpr uint32_t NO_NODE      = UINT32_MAX;
+        static constexpr uint32_t NO_LIST      = UINT32_MAX;
+        static constexpr uint32_t RUNNING_LIST = TIMER_WHEEL_LEVELS * TIMER_WHEEL_SLOTS; // Due timers of the current tick.
+        static constexpr uint64_t NO_EVENT     = UINT64_MAX;
+
+        struct Node
+        {
+            TimerCallback     Callback;
+            CancellationToken Token;
+            uint64_t          Expires    = 0; // Absolute tick.
+            uint64_t          Period     = 0; // Ticks, 0 for one-shot timers.
+            uint32_t          Generation = 1;
+            uint32_t          Prev       = NO_NODE;
+            uint32_t          Next       = NO_NODE;
+            uint32_t          List       = NO_LIST;
+            bool              Firing     = false;
+            bool              Cancelled  = false;
+        };
+
+
+    private: /* (I)nternal functions */
+        TimerId  ISchedule(double delay, uint64_t period, TimerCallback callback, CancellationToken token);
+        uint64_t IToTicks(double seconds) const noexcept;
+        Node*    IResolve(TimerId id) noexcept;
+
+        void     IInsert(uint32_t index);
+        void     ILink(uint32_t index, uint32_t list);
+        void     IUnlink(uint32_t index);
+        void     IFree(uint32_t index);
+        void     ICascade(uint32_t level);
+        uint64_t INextEvent() const noexcept;
+        size_t   IRunDue(std::unique_lock<std::mutex>& lock);
+
+
+    private: /* Variables */
+        std::mutex                                                   m_Mutex;
+        std::vector<Node>                                            m_Nodes;
+        uint32_t                                                     m_FreeList  = NO_NODE;
+        std::array<uint32_t, TIMER_WHEEL_LEVELS * TIMER_WHEEL_SLOTS + 1> m_Lists;
+        size_t                                                       m_Count     = 0;
+
+        std::chrono::steady_clock::duration                          m_TickDuration;
+        std::chrono::steady_clock::time_point                        m_Start;
+        uint64_t                                                     m_Current   = 0; // Last processed tick.
+        bool                                                         m_Ticking   = false;
+
+        std::thread                                                  m_Thread;
+        std::condition_variable                                      m_Wakeup;
+        bool                                                         m_Stopping  = false;
+        uint64_t                                                     m_Deadline  = 0; // Tick the thread sleeps until, 0 while it doesn't sleep.
+    };
+}
@@ -0,0 +1,208 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+
+
+
+namespace PZvend
+{
+
+/*************\
+*    Types    *
+\*************/
+    constexpr uint32_t TIMING_SUB_BUCKET_BITS = 5;                            // 32 linear buckets per power of two, <= 3.2% error.
+    constexpr uint32_t TIMING_SUB_BUCKETS     = 1u << TIMING_SUB_BUCKET_BITS;
+    constexpr uint32_t TIMING_MAX_BITS        = 40;                           // Up to 2^40 ns (~18 minutes), longer laps are clamped.
+    constexpr uint32_t TIMING_BUCKETS         = (TIMING_MAX_BITS - TIMING_SUB_BUCKET_BITS + 1) * TIMING_SUB_BUCKETS;
+
+    struct TimingSummary
+    {
+        uint64_t Count  = 0;
+        uint64_t Min    = 0; // All values in nanoseconds.
+        uint64_t Max    = 0;
+        double   Mean   = 0.0;
+        double   StdDev = 0.0;
+        uint64_t P50    = 0;
+        uint64_t P90    = 0;
+        uint64_t P99    = 0;
+        uint64_t P999   = 0;
+    };
+
+
+
+/*************\
+*   Classes   *
+\*************/
+
+    /**
+    * @brief Aggregates durations into a fixed size log-linear histogram plus exact min/max/mean/stddev.
+    *
+    * Recording never allocates, the histogram is a flat array of TIMING_BUCKETS counters. An instance
+    * is not synchronized: give every thread its own and Merge them for reporting.
+    *
+    * TimingStats frame_times;
+    * frame_times.Record(std::chrono::microseconds(16600));
+    *
+    * TimingSummary summary = frame_times.GetSummary();
+    * if (summary.P99 > 20'000'000)
+    *     <...> Frame time SLO missed
+    */
+    class TimingStats
+    {
+    public:
+        TimingStats() = default;
+
+
+
+        /*
+        Records one duration in nanoseconds. Welford's update keeps the mean and variance stable over millions of samples.
+        */
+        inline void Record(uint64_t nanoseconds) noexcept
+        {
+            m_Count++;
+            m_Min = std::min(m_Min, nanoseconds);
+            m_Max = std::max(m_Max, nanoseconds);
+
+            const double value = static_cast<double>(nanoseconds);
+            const double delta = value - m_Mean;
+            m_Mean += delta / static_cast<double>(m_Count);
+            m_M2   += delta * (value - m_Mean);
+
+            m_Buckets[GetBucket(nanoseconds)]++;
+        }
+
+        template <class Rep, class Period>
+        inline void Record(std::chrono::duration<Rep, Period> duration) noexcept
+        {
+            const auto nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count();
+            Record(static_cast<uint64_t>(std::max<decltype(nanoseconds)>(nanoseconds, 0)));
+        }
+
+
+
+        /*
+        Adds the samples of another instance, e.g. the stats of another thread.
+        */
+        void Merge(const TimingStats& other) noexcept;
+
+
+
+        void Reset() noexcept;
+
+
+
+        /*
+        Gets the duration at a percentile (0.0 - 1.0), accurate to the bucket width and clamped to the recorded min/max.
+        */
+        [[nodiscard]] uint64_t GetPercentile(double percentile) const noexcept;
+
+
+
+        [[nodiscard]] TimingSummary GetSummary() const noexcept;
+
+
+
+        [[nodiscard]] inline uint64_t GetCount() const noexcept { return m_Count; }
+        [[nodiscard]] inline uint64_t GetMin() const noexcept { return m_Count ? m_Min : 0; }
+        [[nodiscard]] inline uint64_t GetMax() const noexcept { return m_Max; }
+        [[nodiscard]] inline double   GetMean() const noexcept { return m_Mean; }
+        [[nodiscard]] inline double   GetStdDev() const noexcept { return m_Count > 1 ? std::sqrt(m_M2 / static_cast<double>(m_Count - 1)) : 0.0; }
+
+
+
+        /*
+        Maps a duration onto its histogram bucket. Values below TIMING_SUB_BUCKETS get a bucket each, above
+        that every power of two is split into TIMING_SUB_BUCKETS linear buckets.
+        */
+        [[nodiscard]] static constexpr uint32_t GetBucket(uint64_t nanoseconds) noexcept
+        {
+            nanoseconds = std::min<uint64_t>(nanoseconds, (1ull << TIMING_MAX_BITS) - 1);
+            if (nanoseconds < TIMING_SUB_BUCKETS)
+                return static_cast<uint32_t>(nanoseconds);
+
+            const uint32_t shift = static_cast<uint32_t>(std::bit_width(nanoseconds)) - 1 - TIMING_SUB_BUCKET_BITS;
+            return (shift + 1) * TIMING_SUB_BUCKETS + static_cast<uint32_t>((nanoseconds >> shift) - TIMING_SUB_BUCKETS);
+        }
+
+
+
+        /*
+        Gets the highest duration that falls into a bucket.
+        */
+        [[nodiscard]] static constexpr uint64_t GetBucketLimit(uint32_t bucket) noexcept
+        {
+            if (bucket < TIMING_SUB_BUCKETS)
+                return bucket;
+
+            const uint32_t shift = bucket / TIMING_SUB_BUCKETS - 1;
+            const uint64_t lower = static_cast<uint64_t>(bucket % TIMING_SUB_BUCKETS + TIMING_SUB_BUCKETS) << shift;
+            return lower + (1ull << shift) - 1;
+        }
+
+    private:
+        uint64_t                                m_Count   = 0;
+        uint64_t                                m_Min     = UINT64_MAX;
+        uint64_t                                m_Max     = 0;
+        double                                  m_Mean    = 0.0;
+        double                                  m_M2      = 0.0; // Sum of squared differences from the mean.
+        std::array<uint64_t, TIMING_BUCKETS>    m_Buckets = {};
+    };
+
+
+
+    /**
+    * @brief Stopwatch that records every lap into a TimingStats.
+    *
+    * LapTimer frame_timer;
+    * while (running)
+    * {
+    *     <...> Render the frame
+    *     frame_timer.Lap();
+    * }
+    *
+    * spdlog::info("p99 frame time: {} ns", frame_timer.GetStats().GetPercentile(0.99));
+    */
+    class LapTimer
+    {
+    public:
+        LapTimer() noexcept : m_LapStarted(std::chrono::steady_clock::now()) {}
+
+
+
+        /*
+        Ends the current lap, records it and starts the next one.
+
+        @return Returns the duration of the lap in nanoseconds.
+        */
+        inline uint64_t Lap() noexcept
+        {
+            const auto now     = std::chrono::steady_clock::now();
+            const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(now - m_LapStarted).count();
+
+            m_LapStarted = now;
+            m_Stats.Record(static_cast<uint64_t>(elapsed));
+            return static_cast<uint64_t>(elapsed);
+        }
+
+
+
+        /*
+        Starts a new lap without recording the current one.
+        */
+        inline void Restart() noexcept { m_LapStarted = std::chrono::steady_clock::now(); }
+
+
+
+        [[nodiscard]] inline const TimingStats& GetStats() const noexcept { return m_Stats; }
+        [[nodiscard]] inline TimingStats&       GetStats() noexcept { return m_Stats; }
+
+    private:
+        std::chrono::steady_clock::time_point m_LapStarted;
+        TimingStats                           m_Stats;
+    };
+}
@@ -0,0 +1,125 @@
+#include <ProjectZvend/BinaryLog.hpp>
+#include <ProjectZvend/Logger.hpp>
+#include <ProjectZvend/MappedRingSink.hpp>
+
+#include <ctime>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+/*
+Reads the log files that aren't plain text.
+
+Usage: ProjectZvend_logtool decode <file.pzblog> [--level debug|info|warn|err]
+       ProjectZvend_logtool recover <file.pzring>
+
+decode   Binary logs written by PZvend::BinaryLog::StartFile. Prints one line per entry, in the
+         pattern CreateLogger's file sink uses plus date, thread and source:
+         [2026-10-19 07:42:41.123456][4711][info] Hooked Update at 0x7ff6a1c0 (src/Hooks.cpp:42)
+
+recover  Ring files of PZvend::MappedRingSink, e.g. after a crash. Prints the lines still in the ring, oldest first.
+*/
+
+static auto g_Logger = PZvend::CreateLogger("LogTool", true);
+
+namespace
+{
+    void PrintEntry(const PZvend::BinaryLog::BinaryLogEntry& entry)
+    {
+        const auto        since_epoch  = entry.Time.time_since_epoch();
+        const std::time_t seconds      = std::chrono::duration_cast<std::chrono::seconds>(since_epoch).count();
+        const auto        microseconds = std::chrono::duration_cast<std::chrono::microseconds>(since_epoch).count() % 1000000;
+
+        std::tm timeinfo;
+#ifdef _WIN32
+        localtime_s(&timeinfo, &seconds);
+#else
+        localtime_r(&seconds, &timeinfo);
+#endif
+
+        const auto level = spdlog::level::to_string_view(entry.Site->Level);
+
+        std::cout << '[' << std::put_time(&timeinfo, "%Y-%m-%d %H:%M:%S") << '.' << std::setw(6) << std::setfill('0') << microseconds << ']'
+                  << '[' << entry.ThreadId << "][" << std::string_view(level.data(), level.size()) << "] " << entry.Message
+                  << " (" << entry.Site->File << ':' << entry.Site->Line << ")\n";
+    }
+
+
+
+    int Decode(const std::string& path, spdlog::level::level_enum level)
+    {
+        PZvend::BinaryLog::BinaryLogReader reader;
+        if (!reader.Open(path))
+        {
+            g_Logger->error("Could not read '{}': {}", path, reader.GetError());
+            return 1;
+        }
+
+        size_t                            count = 0;
+        PZvend::BinaryLog::BinaryLogEntry entry;
+
+        while (reader.Next(entry))
+        {
+            count++;
+            if (entry.Site->Level >= level)
+                PrintEntry(entry);
+        }
+
+        std::cout.flush();
+
+        // A crash cuts the file mid record, everything before it is still fine.
+        if (!reader.GetError().empty())
+        {
+            g_Logger->warn("Stopped after {} entries: {}", count, reader.GetError());
+            return 2;
+        }
+
+        return 0;
+    }
+
+
+
+    int Recover(const std::string& path)
+    {
+        std::vector<std::string> lines;
+        if (!PZvend::MappedRingSink::Recover(path, lines))
+        {
+            g_Logger->error("'{}' is not a ring log.", path);
+            return 1;
+        }
+
+        for (const std::string& line : lines)
+            std::cout << line << '\n';
+
+        std::cout.flush();
+        return 0;
+    }
+}
+
+
+
+int main(int argc, char** argv)
+{
+    const std::string command = argc >= 3 ? argv[1] : "";
+
+    if (command == "recover")
+        return Recover(argv[2]);
+
+    if (command != "decode")
+    {
+        g_Logger->info("Usage: ProjectZvend_logtool decode <file.pzblog> [--level debug|info|warn|err]");
+        g_Logger->info("       ProjectZvend_logtool recover <file.pzring>");
+        return 1;
+    }
+
+    spdlog::level::level_enum level = spdlog::level::trace;
+
+    for (int i = 3; i + 1 < argc; i += 2)
+    {
+        if (std::string(argv[i]) == "--level")
+            level = spdlog::level::from_str(argv[i + 1]);
+    }
+
+    return Decode(argv[2], level);
+}
@@ -0,0 +1,750 @@
+#include "ProjectZvend/BinaryLog.hpp"
+#include "ProjectZvend/Log.hpp"
+
+#include "Macros.hpp"
+
+#ifdef PZVEND_IS_WINDOWS
+    #include <wtypes.h>
+#else
+    #include <sys/syscall.h>
+    #include <unistd.h>
+#endif
+
+#ifdef SPDLOG_FMT_EXTERNAL
+    #include <fmt/args.h>
+#else
+    #include <spdlog/fmt/bundled/args.h>
+#endif
+
+#include <condition_variable>
+#include <fstream>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
+
+
+
+namespace
+{
+    using namespace PZvend::BinaryLog;
+
+    constexpr uint32_t RING_MASK = BINARY_LOG_RING_CAPACITY - 1;
+
+    /*
+    Single producer (the owning thread), single consumer (the writer), same scheme as the profiler's
+    rings but with variable sized records. A record never wraps, the rest of the ring is padded instead.
+    */
+    struct ThreadRing
+    {
+        uint32_t              Id        = 0;
+        uint64_t              OsId      = 0;
+        bool                  Announced = false; // Writer only, thread record written this session.
+        uint64_t              Reserved  = 0;     // Owner only, head of the pending reservation.
+        std::atomic<bool>     Retired   = false;
+        std::atomic<uint64_t> Dropped   = 0;
+
+        alignas(64) std::atomic<uint64_t> Head = 0;
+        alignas(64) std::atomic<uint64_t> Tail = 0;
+
+        alignas(8) uint8_t Bytes[BINARY_LOG_RING_CAPACITY];
+    };
+
+    struct Pending
+    {
+        uint64_t            Ticks;
+        uint32_t            Order; // Keeps one thread's records in order when the ticks tie.
+        ThreadRing*         Ring;
+        const RecordHeader* Header;
+    };
+
+    struct Session
+    {
+        std::mutex                               Control;     // Start / Stop
+        std::mutex                               RingsMutex;
+        std::vector<std::unique_ptr<ThreadRing>> Rings;
+        uint32_t                                 LastThreadId = 0;
+
+        std::mutex                               SitesMutex;
+        std::vector<std::unique_ptr<SiteInfo>>   Sites;       // By id - 1, never shrinks.
+
+        std::mutex                               WakeMutex;
+        std::condition_variable                  Wakeup;
+        bool                                     Stopping     = false;
+        std::thread                              Writer;
+
+        // Set up by Start, only the writer touches them while the session runs.
+        bool                                     Running      = false;
+        std::shared_ptr<spdlog::logger>          Logger;
+        std::ofstream                            File;
+        std::unordered_set<uint32_t>             WrittenSites;
+        std::vector<const SiteInfo*>             KnownSites;
+        uint64_t                                 StartTicks   = 0;
+        double                                   TicksPerSecond = 1.0;
+        std::chrono::system_clock::time_point    StartTime;
+        std::atomic<uint64_t>                    RetiredDropped = 0;
+    };
+
+
+
+    // Threads log until they exit, the session has to outlive every thread_local destructor.
+    Session& GetSession()
+    {
+        static auto* session = new Session();
+        return *session;
+    }
+
+
+
+    uint64_t GetOsThreadId() noexcept
+    {
+#ifdef PZVEND_IS_WINDOWS
+        return GetCurrentThreadId();
+#else
+        return static_cast<uint64_t>(syscall(SYS_gettid));
+#endif
+    }
+
+
+
+    ThreadRing* GetThreadRing()
+    {
+        struct Handle
+        {
+            ThreadRing* Ring = nullptr;
+            ~Handle()
+            {
+                if (Ring)
+                    Ring->Retired.store(true, std::memory_order_release);
+            }
+        };
+
+        thread_local Handle handle;
+        if (handle.Ring)
+            return handle.Ring;
+
+        Session& session = GetSession();
+        auto     ring    = std::make_unique<ThreadRing>();
+        ring->OsId = GetOsThreadId();
+
+        std::lock_guard lock(session.RingsMutex);
+        ring->Id    = ++session.LastThreadId;
+        handle.Ring = ring.get();
+        session.Rings.push_back(std::move(ring));
+        return handle.Ring;
+    }
+
+
+
+    template <class T>
+    void WriteRaw(std::string& out, const T& value)
+    {
+        out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+
+
+    void WriteString(std::string& out, const std::string& text)
+    {
+        const uint16_t length = static_cast<uint16_t>(std::min<size_t>(text.size(), UINT16_MAX));
+
+        WriteRaw(out, length);
+        out.append(text.data(), length);
+    }
+
+
+
+    const SiteInfo* FindSite(Session& session, uint32_t id)
+    {
+        if (id > session.KnownSites.size())
+        {
+            std::lock_guard lock(session.SitesMutex);
+            for (size_t i = session.KnownSites.size(); i < session.Sites.size(); i++)
+                session.KnownSites.push_back(session.Sites[i].get());
+        }
+
+        return id && id <= session.KnownSites.size() ? session.KnownSites[id - 1] : nullptr;
+    }
+
+
+
+    void WriteEntry(Session& session, ThreadRing& ring, const RecordHeader& header, std::string& out)
+    {
+        const SiteInfo* site = FindSite(session, header.Site);
+        if (!site)
+            return;
+
+        const uint8_t* arguments = reinterpret_cast<const uint8_t*>(&header + 1);
+        const uint32_t size      = header.Size - static_cast<uint32_t>(sizeof(RecordHeader)); // Includes the padding, the decoder stops at the last argument.
+
+        if (session.Logger)
+        {
+            std::string message;
+            if (!FormatRecord(*site, arguments, size, message))
+                message = fmt::format("<invalid record for '{}'>", site->Format);
+
+            const auto offset = std::chrono::duration<double>(static_cast<double>(static_cast<int64_t>(header.Ticks - session.StartTicks)) / session.TicksPerSecond);
+            const auto time   = session.StartTime + std::chrono::duration_cast<std::chrono::system_clock::duration>(offset);
+
+            session.Logger->log(time, spdlog::source_loc{ site->File.c_str(), static_cast<int>(site->Line), "" }, site->Level, message);
+            return;
+        }
+
+        if (!ring.Announced)
+        {
+            WriteRaw(out, uint8_t(2));
+            WriteRaw(out, ring.Id);
+            WriteRaw(out, ring.OsId);
+            ring.Announced = true;
+        }
+
+        if (session.WrittenSites.insert(site->Id).second)
+        {
+            WriteRaw(out, uint8_t(1));
+            WriteRaw(out, site->Id);
+            WriteRaw(out, static_cast<uint8_t>(site->Level));
+            WriteRaw(out, site->Line);
+            WriteString(out, site->File);
+            WriteString(out, site->Format);
+            WriteRaw(out, static_cast<uint8_t>(site->Args.size()));
+            out.append(reinterpret_cast<const char*>(site->Args.data()), site->Args.size());
+        }
+
+        WriteRaw(out, uint8_t(3));
+        WriteRaw(out, ring.Id);
+        WriteRaw(out, header.Site);
+        WriteRaw(out, header.Ticks);
+        WriteRaw(out, size);
+        out.append(reinterpret_cast<const char*>(arguments), size);
+    }
+
+
+
+    /*
+    Collects the records of every ring, sorts them by time and writes them. The tails only move
+    after writing, until then the producers can't overwrite the records.
+    */
+    void Flush(Session& session)
+    {
+        std::vector<ThreadRing*> rings;
+        {
+            std::lock_guard lock(session.RingsMutex);
+            for (const auto& ring : session.Rings)
+                rings.push_back(ring.get());
+        }
+
+        std::vector<Pending>                          pending;
+        std::vector<std::pair<ThreadRing*, uint64_t>> heads;
+        std::vector<ThreadRing*>                      retired;
+
+        for (ThreadRing* ring : rings)
+        {
+            // Read before draining, a retired thread can't push anything after the flag.
+            const bool     exited = ring->Retired.load(std::memory_order_acquire);
+            const uint64_t head   = ring->Head.load(std::memory_order_acquire);
+            uint64_t       tail   = ring->Tail.load(std::memory_order_relaxed);
+
+            for (uint32_t order = 0; tail != head; order++)
+            {
+                const auto* header = reinterpret_cast<const RecordHeader*>(&ring->Bytes[tail & RING_MASK]);
+                if (header->Site)
+                    pending.push_back({ header->Ticks, order, ring, header });
+
+                tail += header->Size;
+            }
+
+            heads.emplace_back(ring, head);
+
+            if (exited)
+                retired.push_back(ring);
+        }
+
+        std::sort(pending.begin(), pending.end(), [](const Pending& a, const Pending& b)
+        {
+            return a.Ticks != b.Ticks ? static_cast<int64_t>(a.Ticks - b.Ticks) < 0 : a.Order < b.Order;
+        });
+
+        std::string out;
+        for (const Pending& record : pending)
+            WriteEntry(session, *record.Ring, *record.Header, out);
+
+        if (!out.empty())
+        {
+            session.File.write(out.data(), static_cast<std::streamsize>(out.size()));
+            session.File.flush();
+        }
+
+        for (const auto& [ring, head] : heads)
+            ring->Tail.store(head, std::memory_order_release);
+
+        if (retired.empty())
+            return;
+
+        std::lock_guard lock(session.RingsMutex);
+        std::erase_if(session.Rings, [&session, &retired](const std::unique_ptr<ThreadRing>& ring)
+        {
+            if (std::find(retired.begin(), retired.end(), ring.get()) == retired.end())
+                return false;
+
+            session.RetiredDropped.fetch_add(ring->Dropped.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            return true;
+        });
+    }
+
+
+
+    void WriteLoop(std::chrono::milliseconds interval)
+    {
+        Session&         session = GetSession();
+        std::unique_lock lock(session.WakeMutex);
+
+        while (!session.Wakeup.wait_for(lock, interval, [&session]() { return session.Stopping; }))
+        {
+            lock.unlock();
+            Flush(session);
+            lock.lock();
+        }
+    }
+
+
+
+    /*
+    Shared part of Start and StartFile, the caller holds Control and set up the output.
+    Resets the rings and takes the session's start time, nothing runs yet.
+    */
+    void PrepareSession(Session& session)
+    {
+        session.TicksPerSecond = PZvend::GetCycleCounterFrequency();
+        session.Stopping       = false;
+        session.WrittenSites.clear();
+        session.RetiredDropped.store(0, std::memory_order_relaxed);
+
+        // Records from before the session are stale, the writer isn't running so the tails are ours.
+        {
+            std::lock_guard lock(session.RingsMutex);
+            for (const auto& ring : session.Rings)
+            {
+                ring->Tail.store(ring->Head.load(std::memory_order_acquire), std::memory_order_release);
+                ring->Dropped.store(0, std::memory_order_relaxed);
+                ring->Announced = false;
+            }
+        }
+
+        session.StartTicks = PZvend::ReadCycleCounter();
+        session.StartTime  = std::chrono::system_clock::now();
+    }
+
+
+
+    /*
+    Starts the writer and opens the hot path, the output has to be complete from here on.
+    */
+    void LaunchSession(Session& session, spdlog::level::level_enum level, std::chrono::milliseconds interval)
+    {
+        session.Running = true;
+        session.Writer  = std::thread(WriteLoop, interval);
+        g_Level.store(level, std::memory_order_release);
+    }
+}
+
+
+
+bool PZvend::BinaryLog::Start(std::shared_ptr<spdlog::logger> logger, spdlog::level::level_enum level, std::chrono::milliseconds interval)
+{
+    Session&        session = GetSession();
+    std::lock_guard control(session.Control);
+
+    if (session.Running)
+    {
+        PZ_LOG_ERROR(LOGGING, "A binary log session is already running.");
+        return false;
+    }
+
+    session.Logger = std::move(logger);
+    PrepareSession(session);
+    LaunchSession(session, level, interval);
+    return true;
+}
+
+
+
+bool PZvend::BinaryLog::StartFile(const std::string& path, spdlog::level::level_enum level, std::chrono::milliseconds interval)
+{
+    Session&        session = GetSession();
+    std::lock_guard control(session.Control);
+
+    if (session.Running)
+    {
+        PZ_LOG_ERROR(LOGGING, "A binary log session is already running.");
+        return false;
+    }
+
+    session.File.open(path, std::ios::binary | std::ios::trunc);
+    if (!session.File)
+    {
+        PZ_LOG_ERROR(LOGGING, "Could not open the binary log '{}'.", path);
+        return false;
+    }
+
+    session.Logger.reset();
+    PrepareSession(session);
+
+    const int64_t start_time = std::chrono::duration_cast<std::chrono::nanoseconds>(session.StartTime.time_since_epoch()).count();
+
+    std::string header;
+    header.append("PZBLOG\0", 8);
+    WriteRaw(header, BINARY_LOG_VERSION);
+    WriteRaw(header, uint32_t(0));
+    WriteRaw(header, session.TicksPerSecond);
+    WriteRaw(header, session.StartTicks);
+    WriteRaw(header, start_time);
+
+    session.File.write(header.data(), static_cast<std::streamsize>(header.size()));
+    session.File.flush();
+
+    // The writer owns the file from here on.
+    LaunchSession(session, level, interval);
+
+    PZ_LOG_DEBUG(LOGGING, "Started binary log session '{}'.", path);
+    return true;
+}
+
+
+
+void PZvend::BinaryLog::Stop()
+{
+    Session&        session = GetSession();
+    std::lock_guard control(session.Control);
+
+    if (!session.Running)
+        return;
+
+    g_Level.store(spdlog::level::off, std::memory_order_release);
+
+    {
+        std::lock_guard lock(session.WakeMutex);
+        session.Stopping = true;
+    }
+
+    session.Wakeup.notify_all();
+    session.Writer.join();
+
+    // Records finished between the last pass and the join.
+    Flush(session);
+
+    if (session.Logger)
+        session.Logger->flush();
+
+    session.File.close();
+    session.Logger.reset();
+    session.Running = false;
+
+    const uint64_t dropped = GetDroppedRecords();
+    if (dropped)
+        PZ_LOG_WARN(LOGGING, "Binary log dropped {} records, write more often or raise BINARY_LOG_RING_CAPACITY.", dropped);
+}
+
+
+
+void PZvend::BinaryLog::SetLevel(spdlog::level::level_enum level) noexcept
+{
+    Session&        session = GetSession();
+    std::lock_guard control(session.Control);
+
+    if (session.Running)
+        g_Level.store(level, std::memory_order_release);
+}
+
+
+
+uint64_t PZvend::BinaryLog::GetDroppedRecords() noexcept
+{
+    Session& session = GetSession();
+    uint64_t dropped = session.RetiredDropped.load(std::memory_order_relaxed);
+
+    std::lock_guard lock(session.RingsMutex);
+    for (const auto& ring : session.Rings)
+        dropped += ring->Dropped.load(std::memory_order_relaxed);
+
+    return dropped;
+}
+
+
+
+bool PZvend::BinaryLog::FormatRecord(const SiteInfo& site, const uint8_t* arguments, size_t size, std::string& out)
+{
+    fmt::dynamic_format_arg_store<fmt::format_context> store;
+    store.reserve(site.Args.size(), 0);
+
+    size_t offset = 0;
+    const auto read = [&](auto& value)
+    {
+        if (offset + sizeof(value) > size)
+            return false;
+
+        std::memcpy(&value, arguments + offset, sizeof(value));
+        offset += sizeof(value);
+        return true;
+    };
+
+    for (const BinaryLogArg type : site.Args)
+    {
+        bool valid = false;
+
+        switch (type)
+        {
+            case BLOG_ARG_BOOL:    { uint8_t  value; if ((valid = read(value))) store.push_back(value != 0);   break; }
+            case BLOG_ARG_CHAR:    { char     value; if ((valid = read(value))) store.push_back(value);        break; }
+            case BLOG_ARG_I32:     { int32_t  value; if ((valid = read(value))) store.push_back(value);        break; }
+            case BLOG_ARG_U32:     { uint32_t value; if ((valid = read(value))) store.push_back(value);        break; }
+            case BLOG_ARG_I64:     { int64_t  value; if ((valid = read(value))) store.push_back(value);        break; }
+            case BLOG_ARG_U64:     { uint64_t value; if ((valid = read(value))) store.push_back(value);        break; }
+            case BLOG_ARG_F32:     { float    value; if ((valid = read(value))) store.push_back(value);        break; }
+            case BLOG_ARG_F64:     { double   value; if ((valid = read(value))) store.push_back(value);        break; }
+            case BLOG_ARG_POINTER: { uint64_t value; if ((valid = read(value))) store.push_back(reinterpret_cast<const void*>(static_cast<uintptr_t>(value))); break; }
+            case BLOG_ARG_STRING:
+            {
+                uint32_t length;
+                if ((valid = read(length) && offset + length <= size))
+                {
+                    store.push_back(std::string_view(reinterpret_cast<const char*>(arguments + offset), length));
+                    offset += length;
+                }
+
+                break;
+            }
+        }
+
+        if (!valid)
+            return false;
+    }
+
+    try
+    {
+        out = fmt::vformat(site.Format, store);
+    }
+    catch (const fmt::format_error&)
+    {
+        return false;
+    }
+
+    return true;
+}
+
+
+
+uint32_t PZvend::BinaryLog::RegisterSite(Site& site, std::string_view format, const BinaryLogArg* args, size_t count)
+{
+    Session&        session = GetSession();
+    std::lock_guard lock(session.SitesMutex);
+
+    // Another thread might have registered it while this one waited.
+    if (const uint32_t id = site.Id.load(std::memory_order_acquire))
+        return id;
+
+    auto info    = std::make_unique<SiteInfo>();
+    info->Id     = static_cast<uint32_t>(session.Sites.size() + 1);
+    info->Level  = site.Level;
+    info->Line   = site.Line;
+    info->File   = site.File;
+    info->Format = format;
+    info->Args.assign(args, args + count);
+
+    const uint32_t id = info->Id;
+    session.Sites.push_back(std::move(info));
+    site.Id.store(id, std::memory_order_release);
+    return id;
+}
+
+
+
+uint8_t* PZvend::BinaryLog::Reserve(uint32_t size) noexcept
+{
+    ThreadRing* ring = GetThreadRing();
+
+    const uint64_t head       = ring->Head.load(std::memory_order_relaxed);
+    const uint64_t used       = head - ring->Tail.load(std::memory_order_acquire);
+    const uint32_t offset     = static_cast<uint32_t>(head & RING_MASK);
+    const uint32_t contiguous = BINARY_LOG_RING_CAPACITY - offset;
+    const uint32_t padding    = size > contiguous ? contiguous : 0;
+
+    if (size > BINARY_LOG_RING_CAPACITY / 2 || used + padding + size > BINARY_LOG_RING_CAPACITY)
+    {
+        ring->Dropped.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    if (padding)
+    {
+        const RecordHeader pad = { padding, 0, 0 };
+        std::memcpy(&ring->Bytes[offset], &pad, sizeof(uint32_t) * 2); // Offsets are 8 aligned, Size and Site always fit.
+
+        // Published on its own, the writer may skip it before the record arrives.
+        ring->Head.store(head + padding, std::memory_order_release);
+    }
+
+    ring->Reserved = head + padding;
+    return &ring->Bytes[ring->Reserved & RING_MASK];
+}
+
+
+
+void PZvend::BinaryLog::Commit(uint32_t size) noexcept
+{
+    ThreadRing* ring = GetThreadRing();
+    ring->Head.store(ring->Reserved + size, std::memory_order_release);
+}
+
+
+
+bool PZvend::BinaryLog::BinaryLogReader::Open(const std::string& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+        return IFail("Could not open the file.");
+
+    m_Data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    m_Offset = 0;
+    m_Sites.clear();
+    m_Threads.clear();
+    m_Error.clear();
+
+    char     magic[8];
+    uint32_t version  = 0;
+    uint32_t reserved = 0;
+    int64_t  start_time = 0;
+
+    if (!IRead(magic, sizeof(magic)) || std::memcmp(magic, "PZBLOG\0", 8) != 0)
+        return IFail("Not a binary log.");
+
+    if (!IRead(&version, sizeof(version)) || version != BINARY_LOG_VERSION)
+        return IFail(fmt::format("Unsupported version {}.", version));
+
+    if (!IRead(&reserved, sizeof(reserved)) || !IRead(&m_TicksPerSecond, sizeof(m_TicksPerSecond)) ||
+        !IRead(&m_StartTicks, sizeof(m_StartTicks)) || !IRead(&start_time, sizeof(start_time)))
+        return IFail("The header is cut off.");
+
+    m_StartTime = std::chrono::system_clock::time_point(std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::nanoseconds(start_time)));
+    return true;
+}
+
+
+
+bool PZvend::BinaryLog::BinaryLogReader::Next(BinaryLogEntry& entry)
+{
+    while (m_Offset < m_Data.size())
+    {
+        uint8_t tag = 0;
+        IRead(&tag, sizeof(tag));
+
+        if (tag == 1)
+        {
+            auto    site  = std::make_unique<SiteInfo>();
+            uint8_t level = 0;
+            uint8_t count = 0;
+
+            if (!IRead(&site->Id, sizeof(site->Id)) || !IRead(&level, sizeof(level)) || !IRead(&site->Line, sizeof(site->Line)) ||
+                !IReadString(site->File) || !IReadString(site->Format) || !IRead(&count, sizeof(count)))
+                return IFail("A site record is cut off.");
+
+            site->Level = static_cast<spdlog::level::level_enum>(level);
+            site->Args.resize(count);
+            if (!IRead(site->Args.data(), count))
+                return IFail("A site record is cut off.");
+
+            // Ids are handed out in order, anything far beyond the sites seen so far is garbage.
+            if (site->Id == 0 || site->Id > m_Sites.size() + (1 << 16))
+                return IFail(fmt::format("A site record has the invalid id {}.", site->Id));
+
+            if (m_Sites.size() < site->Id)
+                m_Sites.resize(site->Id);
+
+            m_Sites[site->Id - 1] = std::move(site);
+            continue;
+        }
+
+        if (tag == 2)
+        {
+            uint32_t id    = 0;
+            uint64_t os_id = 0;
+
+            if (!IRead(&id, sizeof(id)) || !IRead(&os_id, sizeof(os_id)))
+                return IFail("A thread record is cut off.");
+
+            m_Threads.emplace_back(id, os_id);
+            continue;
+        }
+
+        if (tag != 3)
+            return IFail(fmt::format("Unknown record {} at offset {}.", tag, m_Offset - 1));
+
+        uint32_t thread = 0;
+        uint32_t id     = 0;
+        uint64_t ticks  = 0;
+        uint32_t size   = 0;
+
+        if (!IRead(&thread, sizeof(thread)) || !IRead(&id, sizeof(id)) || !IRead(&ticks, sizeof(ticks)) || !IRead(&size, sizeof(size)) ||
+            m_Offset + size > m_Data.size())
+            return IFail("An entry is cut off.");
+
+        const uint8_t* arguments = m_Data.data() + m_Offset;
+        m_Offset += size;
+
+        if (id == 0 || id > m_Sites.size() || !m_Sites[id - 1])
+            return IFail(fmt::format("An entry uses the unknown site {}.", id));
+
+        entry.Site     = m_Sites[id - 1].get();
+        entry.ThreadId = 0;
+        for (const auto& [known, os_id] : m_Threads)
+        {
+            if (known == thread)
+                entry.ThreadId = os_id;
+        }
+
+        const auto offset = std::chrono::duration<double>(static_cast<double>(static_cast<int64_t>(ticks - m_StartTicks)) / m_TicksPerSecond);
+        entry.Time = m_StartTime + std::chrono::duration_cast<std::chrono::system_clock::duration>(offset);
+
+        if (!FormatRecord(*entry.Site, arguments, size, entry.Message))
+            entry.Message = fmt::format("<invalid record for '{}'>", entry.Site->Format);
+
+        return true;
+    }
+
+    return false;
+}
+
+
+
+bool PZvend::BinaryLog::BinaryLogReader::IRead(void* out, size_t size)
+{
+    if (m_Offset + size > m_Data.size())
+    {
+        m_Offset = m_Data.size();
+        return false;
+    }
+
+    std::memcpy(out, m_Data.data() + m_Offset, size);
+    m_Offset += size;
+    return true;
+}
+
+
+
+bool PZvend::BinaryLog::BinaryLogReader::IReadString(std::string& out)
+{
+    uint16_t length = 0;
+    if (!IRead(&length, sizeof(length)) || m_Offset + length > m_Data.size())
+        return false;
+
+    out.assign(reinterpret_cast<const char*>(m_Data.data() + m_Offset), length);
+    m_Offset += length;
+    return true;
+}
+
+
+
+bool PZvend::BinaryLog::BinaryLogReader::IFail(const std::string& error)
+{
+    m_Error  = error;
+    m_Offset = m_Data.size();
+    return false;
+}
@@ -0,0 +1,116 @@
+#include <ProjectZvend/ConcurrentJSON.hpp>
+#include <ProjectZvend/Profiler.hpp>
+
+
+
+PZvend::ConcurrentJSON::Edit::Edit(ConcurrentJSON& owner)
+    : m_Owner(&owner)
+    , m_Lock(owner.m_WriteMutex)
+    , m_Json(std::make_shared<JSON>(*owner.m_Current.load(std::memory_order_acquire)->Json)) // Only writers free versions.
+{}
+
+
+
+void PZvend::ConcurrentJSON::Edit::Commit()
+{
+    m_Owner->IPublish(std::move(m_Json));
+    m_Lock.unlock();
+}
+
+
+
+PZvend::ConcurrentJSON::ConcurrentJSON()
+    : m_Current(new Version{ std::make_shared<const JSON>() })
+{}
+
+
+
+PZvend::ConcurrentJSON::ConcurrentJSON(const std::string& filepath, const bool sidecar)
+    : m_Current(new Version{ std::make_shared<const JSON>(filepath, sidecar) })
+{}
+
+
+
+PZvend::ConcurrentJSON::~ConcurrentJSON()
+{
+    delete m_Current.load(std::memory_order_acquire);
+}
+
+
+
+/*
+The grace period keeps the version from being freed between loading it and taking a reference
+to its document. Every step is a single atomic operation, nothing waits on a writer.
+*/
+PZvend::ConcurrentJSON::Snapshot PZvend::ConcurrentJSON::Acquire() const
+{
+    const uint32_t half = m_Grace.Enter();
+
+    Snapshot snapshot = m_Current.load(std::memory_order_seq_cst)->Json;
+    m_Grace.Leave(half);
+
+    return snapshot;
+}
+
+
+
+PZvend::ConcurrentJSON::Edit PZvend::ConcurrentJSON::BeginEdit()
+{
+    return Edit(*this);
+}
+
+
+
+bool PZvend::ConcurrentJSON::Load(const std::string& filepath)
+{
+    std::lock_guard lock(m_WriteMutex);
+
+    auto json = std::make_shared<JSON>();
+    json->SetSidecar(m_Current.load(std::memory_order_acquire)->Json->HasSidecar());
+
+    if (!json->Load(filepath))
+        return false;
+
+    IPublish(std::move(json));
+    return true;
+}
+
+
+
+bool PZvend::ConcurrentJSON::Reload()
+{
+    std::lock_guard lock(m_WriteMutex);
+
+    const JSON& current = *m_Current.load(std::memory_order_acquire)->Json;
+    if (current.GetFilepath().empty())
+    {
+        PZ_LOG_ERROR(JSON, "No file was loaded.");
+        return false;
+    }
+
+    auto json = std::make_shared<JSON>();
+    json->SetSidecar(current.HasSidecar());
+
+    if (!json->Load(current.GetFilepath()))
+        return false;
+
+    IPublish(std::move(json));
+    return true;
+}
+
+
+
+/*
+Called with the writer lock held. The previous version is freed once no Acquire can still be reading it.
+*/
+void PZvend::ConcurrentJSON::IPublish(std::shared_ptr<const JSON> json)
+{
+    PZ_PROFILE_SCOPE("ConcurrentJSON::Publish");
+
+    Version* previous = m_Current.exchange(new Version{ std::move(json) }, std::memory_order_seq_cst);
+
+    m_Grace.Synchronize();
+
+    m_Published.fetch_add(1, std::memory_order_release);
+    delete previous;
+}
@@ -0,0 +1,349 @@
+#include "Disassembler.hpp"
+
+#include <array>
+#include <cstring>
+
+
+
+namespace
+{
+    enum OperandFlags : uint8_t
+    {
+        OP_NONE    = 0x00,
+        OP_MODRM   = 0x01,
+        OP_IMM8    = 0x02,
+        OP_IMM16   = 0x04,
+        OP_IMMZ    = 0x08, // imm16 with 66 prefix, imm32 otherwise (imm64 for B8-BF with REX.W)
+        OP_MOFFS   = 0x10, // 8 byte address, 4 with 67 prefix
+        OP_REL8    = 0x20,
+        OP_REL32   = 0x40,
+        OP_INVALID = 0x80,
+    };
+
+    using OpcodeTable = std::array<uint8_t, 256>;
+
+
+
+    constexpr OpcodeTable BuildOneByteTable()
+    {
+        OpcodeTable table = {};
+
+        // ALU blocks: op r/m,r | op r,r/m | op al,imm8 | op eax,immz
+        for (int base = 0x00; base <= 0x38; base += 0x08)
+        {
+            for (int i = 0; i < 4; i++)
+                table[base + i] = OP_MODRM;
+
+            table[base + 4] = OP_IMM8;
+            table[base + 5] = OP_IMMZ;
+        }
+
+        // push/pop es/cs/ss/ds, daa/das/aaa/aas don't exist in 64-bit mode
+        for (int opcode : { 0x06, 0x07, 0x0E, 0x16, 0x17, 0x1E, 0x1F, 0x27, 0x2F, 0x37, 0x3F })
+            table[opcode] = OP_INVALID;
+
+        for (int opcode : { 0x60, 0x61, 0x82, 0x9A, 0xCE, 0xD4, 0xD5, 0xD6, 0xEA })
+            table[opcode] = OP_INVALID;
+
+        table[0x63] = OP_MODRM;
+        table[0x68] = OP_IMMZ;
+        table[0x69] = OP_MODRM | OP_IMMZ;
+        table[0x6A] = OP_IMM8;
+        table[0x6B] = OP_MODRM | OP_IMM8;
+
+        for (int opcode = 0x70; opcode <= 0x7F; opcode++)
+            table[opcode] = OP_REL8;
+
+        table[0x80] = OP_MODRM | OP_IMM8;
+        table[0x81] = OP_MODRM | OP_IMMZ;
+        table[0x83] = OP_MODRM | OP_IMM8;
+
+        for (int opcode = 0x84; opcode <= 0x8F; opcode++)
+            table[opcode] = OP_MODRM;
+
+        for (int opcode = 0xA0; opcode <= 0xA3; opcode++)
+            table[opcode] = OP_MOFFS;
+
+        table[0xA8] = OP_IMM8;
+        table[0xA9] = OP_IMMZ;
+
+        for (int opcode = 0xB0; opcode <= 0xB7; opcode++)
+            table[opcode] = OP_IMM8;
+
+        for (int opcode = 0xB8; opcode <= 0xBF; opcode++)
+            table[opcode] = OP_IMMZ;
+
+        table[0xC0] = OP_MODRM | OP_IMM8;
+        table[0xC1] = OP_MODRM | OP_IMM8;
+        table[0xC2] = OP_IMM16;
+        table[0xC6] = OP_MODRM | OP_IMM8;
+        table[0xC7] = OP_MODRM | OP_IMMZ;
+        table[0xC8] = OP_IMM16 | OP_IMM8;
+        table[0xCA] = OP_IMM16;
+        table[0xCD] = OP_IMM8;
+
+        for (int opcode = 0xD0; opcode <= 0xD3; opcode++)
+            table[opcode] = OP_MODRM;
+
+        for (int opcode = 0xD8; opcode <= 0xDF; opcode++)
+            table[opcode] = OP_MODRM;
+
+        for (int opcode = 0xE0; opcode <= 0xE3; opcode++)
+            table[opcode] = OP_REL8;
+
+        for (int opcode = 0xE4; opcode <= 0xE7; opcode++)
+            table[opcode] = OP_IMM8;
+
+        table[0xE8] = OP_REL32;
+        table[0xE9] = OP_REL32;
+        table[0xEB] = OP_REL8;
+
+        table[0xF6] = OP_MODRM; // imm8 depends on ModRM.reg
+        table[0xF7] = OP_MODRM; // immz depends on ModRM.reg
+        table[0xFE] = OP_MODRM;
+        table[0xFF] = OP_MODRM;
+
+        return table;
+    }
+
+
+
+    constexpr OpcodeTable BuildTwoByteTable()
+    {
+        OpcodeTable table = {};
+
+        // Nearly the whole 0F map takes a ModRM byte, the exceptions are listed below.
+        for (int opcode = 0x00; opcode <= 0xFF; opcode++)
+            table[opcode] = OP_MODRM;
+
+        for (int opcode : { 0x04, 0x0A, 0x0C, 0x24, 0x25, 0x26, 0x27, 0x36, 0x39, 0x3B, 0x3C, 0x3D, 0x3E, 0x3F, 0x7A, 0x7B, 0xA6, 0xA7, 0xFF })
+            table[opcode] = OP_INVALID;
+
+        for (int opcode : { 0x05, 0x06, 0x07, 0x08, 0x09, 0x0B, 0x0E, 0x30, 0x31, 0x32, 0x33, 0x34, 0x35, 0x37, 0x77, 0xA0, 0xA1, 0xA2, 0xA8, 0xA9, 0xAA })
+            table[opcode] = OP_NONE;
+
+        for (int opcode = 0xC8; opcode <= 0xCF; opcode++)
+            table[opcode] = OP_NONE;
+
+        for (int opcode = 0x80; opcode <= 0x8F; opcode++)
+            table[opcode] = OP_REL32;
+
+        for (int opcode : { 0x70, 0x71, 0x72, 0x73, 0xA4, 0xAC, 0xBA, 0xC2, 0xC4, 0xC5, 0xC6 })
+            table[opcode] = OP_MODRM | OP_IMM8;
+
+        table[0x0F] = OP_MODRM | OP_IMM8; // 3DNow! suffix byte
+        table[0x38] = OP_MODRM;           // three byte map 0F 38, handled separately
+        table[0x3A] = OP_MODRM | OP_IMM8; // three byte map 0F 3A, handled separately
+
+        return table;
+    }
+
+
+
+    constexpr OpcodeTable ONE_BYTE = BuildOneByteTable();
+    constexpr OpcodeTable TWO_BYTE = BuildTwoByteTable();
+
+    constexpr uint8_t MAX_LENGTH = 15;
+}
+
+
+
+bool PZvend::Memory::Disassemble(const uint8_t* code, Instruction& out_instruction) noexcept
+{
+    Instruction instruction;
+
+    const uint8_t* cursor       = code;
+    bool           operand_size = false; // 66
+    bool           address_size = false; // 67
+    bool           rex_w        = false;
+
+    // Legacy prefixes, any order.
+    while (cursor - code < MAX_LENGTH)
+    {
+        uint8_t byte = *cursor;
+
+        if (byte == 0x66)
+            operand_size = true;
+
+        else if (byte == 0x67)
+            address_size = true;
+
+        else if (byte != 0xF0 && byte != 0xF2 && byte != 0xF3 && byte != 0x2E && byte != 0x36 &&
+                 byte != 0x3E && byte != 0x26 && byte != 0x64 && byte != 0x65)
+            break;
+
+        cursor++;
+    }
+
+    // REX has to be the last prefix before the opcode.
+    if ((*cursor & 0xF0) == 0x40)
+    {
+        rex_w = (*cursor & 0x08) != 0;
+        cursor++;
+    }
+
+    uint8_t flags = OP_NONE;
+    uint8_t map   = 1; // 1 = one byte, 2 = 0F, 3 = 0F 38, 4 = 0F 3A
+
+    if (*cursor == 0xC4 || *cursor == 0xC5 || *cursor == 0x62)
+    {
+        // VEX2 / VEX3 / EVEX: map is encoded in the prefix, ModRM is always present.
+        if (*cursor == 0xC5)
+        {
+            map     = 2;
+            cursor += 2;
+        }
+        else if (*cursor == 0xC4)
+        {
+            map     = 1 + (cursor[1] & 0x1F);
+            rex_w   = (cursor[2] & 0x80) != 0;
+            cursor += 3;
+        }
+        else
+        {
+            map     = 1 + (cursor[1] & 0x07);
+            cursor += 4;
+        }
+
+        if (map < 2 || map > 4)
+            return false;
+
+        instruction.Opcode    = *cursor++;
+        instruction.IsTwoByte = true;
+        flags = OP_MODRM | (map == 4 ? OP_IMM8 : OP_NONE);
+
+        // Immediates follow the legacy 0F map, vzeroupper/vzeroall are the only ones without ModRM.
+        if (map == 2 && instruction.Opcode == 0x77)
+            flags = OP_NONE;
+
+        else if (map == 2)
+            flags = OP_MODRM | (TWO_BYTE[instruction.Opcode] & OP_IMM8);
+    }
+    else if (*cursor == 0x0F)
+    {
+        cursor++;
+        instruction.IsTwoByte = true;
+
+        if (*cursor == 0x38 || *cursor == 0x3A)
+        {
+            map = *cursor == 0x38 ? 3 : 4;
+            cursor++;
+            flags = OP_MODRM | (map == 4 ? OP_IMM8 : OP_NONE);
+        }
+        else
+        {
+            map   = 2;
+            flags = TWO_BYTE[*cursor];
+        }
+
+        instruction.Opcode = *cursor++;
+
+        if (map == 2 && flags & OP_REL32)
+            instruction.Branch = BRANCH_JCC;
+    }
+    else
+    {
+        instruction.Opcode = *cursor++;
+        flags = ONE_BYTE[instruction.Opcode];
+
+        uint8_t opcode = instruction.Opcode;
+
+        if (opcode >= 0x70 && opcode <= 0x7F)
+            instruction.Branch = BRANCH_JCC;
+
+        else if (opcode == 0xEB || opcode == 0xE9)
+            instruction.Branch = BRANCH_JMP;
+
+        else if (opcode == 0xE8)
+            instruction.Branch = BRANCH_CALL;
+
+        else if (opcode >= 0xE0 && opcode <= 0xE3)
+            instruction.Branch = BRANCH_LOOP;
+
+        instruction.IsReturn = opcode == 0xC2 || opcode == 0xC3 || opcode == 0xCA || opcode == 0xCB;
+    }
+
+    if (flags & OP_INVALID)
+        return false;
+
+    if (flags & OP_MODRM)
+    {
+        uint8_t modrm = *cursor++;
+        uint8_t mod   = modrm >> 6;
+        uint8_t reg   = (modrm >> 3) & 0x07;
+        uint8_t rm    = modrm & 0x07;
+
+        // test r/m, imm lives in the F6/F7 group
+        if (map == 1 && instruction.Opcode == 0xF6 && reg <= 1)
+            flags |= OP_IMM8;
+
+        else if (map == 1 && instruction.Opcode == 0xF7 && reg <= 1)
+            flags |= OP_IMMZ;
+
+        if (mod != 3)
+        {
+            if (rm == 4)
+            {
+                uint8_t sib = *cursor++;
+                if (mod == 0 && (sib & 0x07) == 5)
+                    cursor += 4;
+            }
+            else if (mod == 0 && rm == 5)
+            {
+                instruction.IsRipRelative = true;
+                instruction.DispOffset    = static_cast<uint8_t>(cursor - code);
+                cursor += 4;
+            }
+
+            if (mod == 1)
+                cursor += 1;
+
+            else if (mod == 2)
+                cursor += 4;
+        }
+    }
+
+    if (flags & OP_MOFFS)
+        cursor += address_size ? 4 : 8;
+
+    if (flags & OP_IMM16)
+        cursor += 2;
+
+    if (flags & OP_IMMZ)
+    {
+        if (map == 1 && instruction.Opcode >= 0xB8 && instruction.Opcode <= 0xBF && rex_w)
+            cursor += 8;
+
+        else
+            cursor += (operand_size && !rex_w) ? 2 : 4;
+    }
+
+    if (flags & OP_IMM8)
+        cursor += 1;
+
+    if (flags & (OP_REL8 | OP_REL32))
+    {
+        instruction.RelOffset = static_cast<uint8_t>(cursor - code);
+        instruction.RelSize   = (flags & OP_REL8) ? 1 : 4;
+
+        if (instruction.RelSize == 1)
+        {
+            instruction.RelTarget = static_cast<int8_t>(*cursor);
+        }
+        else
+        {
+            int32_t rel = 0;
+            memcpy(&rel, cursor, sizeof(rel));
+            instruction.RelTarget = rel;
+        }
+
+        cursor += instruction.RelSize;
+    }
+
+    if (cursor - code > MAX_LENGTH)
+        return false;
+
+    instruction.Length = static_cast<uint8_t>(cursor - code);
+    out_instruction    = instruction;
+    return true;
+}
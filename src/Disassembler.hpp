@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+
+
+namespace PZvend
+{
+    namespace Memory
+    {
+        /*
+        Kind of control flow change an instruction performs. Relative branches need to be
+        re-targeted whenever the instruction gets copied somewhere else.
+        */
+        enum BranchType : uint8_t
+        {
+            BRANCH_NONE,
+            BRANCH_JMP,  // EB / E9
+            BRANCH_CALL, // E8
+            BRANCH_JCC,  // 70-7F / 0F 80-8F
+            BRANCH_LOOP, // E0-E3 (loop*, jrcxz) - rel8 only, can't be widened
+        };
+
+        struct Instruction
+        {
+            uint8_t    Length         = 0;
+            uint8_t    Opcode         = 0;           // Last opcode byte (second byte for 0F xx).
+            bool       IsTwoByte      = false;       // 0F escape.
+            bool       IsRipRelative  = false;       // ModRM addresses [rip + disp32].
+            bool       IsReturn       = false;       // C2 / C3 / CA / CB, control never falls through.
+            uint8_t    DispOffset     = 0;           // Offset of the RIP-relative disp32.
+            BranchType Branch         = BRANCH_NONE;
+            uint8_t    RelOffset      = 0;           // Offset of the relative branch immediate.
+            uint8_t    RelSize        = 0;           // 1 or 4.
+            int64_t    RelTarget      = 0;           // Branch displacement relative to the end of the instruction.
+        };
+
+
+
+        /*
+        Decodes the length and the relocation relevant parts of one x86-64 instruction.
+        Supports legacy, REX, VEX and EVEX encodings; operands are not decoded.
+
+        @return Returns false for invalid or unsupported encodings.
+        */
+        bool Disassemble(const uint8_t* code, Instruction& out_instruction) noexcept;
+    }
+}
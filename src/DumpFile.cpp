@@ -0,0 +1,548 @@
+#include "ProjectZvend/DumpFile.hpp"
+#include "ProjectZvend/Log.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <spdlog/spdlog.h>
+
+
+
+namespace
+{
+    /*
+    The dump structures are declared here instead of pulling in DbgHelp.h / elf.h,
+    so dumps of either platform can be read on any host.
+    */
+    constexpr uint32_t MINIDUMP_SIGNATURE   = 0x504D444D; // 'MDMP'
+    constexpr uint32_t MODULE_LIST_STREAM   = 4;
+    constexpr uint32_t MEMORY_LIST_STREAM   = 5;
+    constexpr uint32_t MEMORY64_LIST_STREAM = 9;
+
+    constexpr uint8_t  ELF_CLASS64 = 2;
+    constexpr uint16_t ET_CORE     = 4;
+    constexpr uint32_t PT_LOAD     = 1;
+    constexpr uint32_t PT_NOTE     = 4;
+    constexpr uint32_t PF_X        = 0x1;
+    constexpr uint32_t PF_W        = 0x2;
+    constexpr uint32_t PF_R        = 0x4;
+    constexpr uint32_t NT_FILE     = 0x46494C45;
+
+#pragma pack(push, 4)
+    struct MinidumpHeader
+    {
+        uint32_t Signature;
+        uint32_t Version;
+        uint32_t NumberOfStreams;
+        uint32_t StreamDirectoryRva;
+        uint32_t CheckSum;
+        uint32_t TimeDateStamp;
+        uint64_t Flags;
+    };
+
+    struct MinidumpDirectory
+    {
+        uint32_t StreamType;
+        uint32_t DataSize;
+        uint32_t Rva;
+    };
+
+    struct MinidumpModule
+    {
+        uint64_t BaseOfImage;
+        uint32_t SizeOfImage;
+        uint32_t CheckSum;
+        uint32_t TimeDateStamp;
+        uint32_t ModuleNameRva;
+        uint32_t VersionInfo[13];
+        uint32_t CvRecord[2];
+        uint32_t MiscRecord[2];
+        uint64_t Reserved0;
+        uint64_t Reserved1;
+    };
+
+    struct MinidumpMemoryDescriptor
+    {
+        uint64_t StartOfMemoryRange;
+        uint32_t DataSize;
+        uint32_t Rva;
+    };
+
+    struct MinidumpMemoryDescriptor64
+    {
+        uint64_t StartOfMemoryRange;
+        uint64_t DataSize;
+    };
+#pragma pack(pop)
+
+    static_assert(sizeof(MinidumpHeader)           == 32);
+    static_assert(sizeof(MinidumpModule)           == 108);
+    static_assert(sizeof(MinidumpMemoryDescriptor) == 16);
+
+    struct Elf64Header
+    {
+        uint8_t  Ident[16];
+        uint16_t Type;
+        uint16_t Machine;
+        uint32_t Version;
+        uint64_t Entry;
+        uint64_t PhOffset;
+        uint64_t ShOffset;
+        uint32_t Flags;
+        uint16_t EhSize;
+        uint16_t PhEntSize;
+        uint16_t PhNum;
+        uint16_t ShEntSize;
+        uint16_t ShNum;
+        uint16_t ShStrNdx;
+    };
+
+    struct Elf64ProgramHeader
+    {
+        uint32_t Type;
+        uint32_t Flags;
+        uint64_t Offset;
+        uint64_t VAddr;
+        uint64_t PAddr;
+        uint64_t FileSize;
+        uint64_t MemSize;
+        uint64_t Align;
+    };
+
+    static_assert(sizeof(Elf64Header)        == 64);
+    static_assert(sizeof(Elf64ProgramHeader) == 56);
+
+
+
+    /*
+    Bounds checked view into the mapped file. Every offset read from the dump goes through it,
+    a truncated or hostile dump must never make us read outside the mapping.
+    */
+    class FileView
+    {
+    public:
+        FileView(const uint8_t* data, size_t size) : m_Data(data), m_Size(size) {}
+
+        [[nodiscard]] bool Contains(uint64_t offset, uint64_t length) const noexcept
+        {
+            return offset <= m_Size && length <= m_Size - offset;
+        }
+
+        template <typename T>
+        [[nodiscard]] const T* Get(uint64_t offset, uint64_t count = 1) const noexcept
+        {
+            if (count > m_Size / sizeof(T) || !Contains(offset, count * sizeof(T)))
+                return nullptr;
+
+            return reinterpret_cast<const T*>(m_Data + offset);
+        }
+
+        [[nodiscard]] uint8_t* At(uint64_t offset) const noexcept
+        {
+            return const_cast<uint8_t*>(m_Data + offset);
+        }
+
+    private:
+        const uint8_t* m_Data;
+        size_t         m_Size;
+    };
+
+
+
+    std::string ReadMinidumpString(const FileView& view, uint32_t rva)
+    {
+        const uint32_t* length = view.Get<uint32_t>(rva);
+        if (!length)
+            return {};
+
+        const uint16_t* chars = view.Get<uint16_t>(rva + sizeof(uint32_t), *length / sizeof(uint16_t));
+        if (!chars)
+            return {};
+
+        // UTF-16 to UTF-8, module paths rarely leave the BMP but surrogates are handled anyway.
+        std::string result;
+        result.reserve(*length / sizeof(uint16_t));
+
+        for (uint32_t i = 0; i < *length / sizeof(uint16_t); i++)
+        {
+            uint32_t code = chars[i];
+
+            if (code >= 0xD800 && code <= 0xDBFF && i + 1 < *length / sizeof(uint16_t))
+            {
+                code = 0x10000 + ((code - 0xD800) << 10) + (chars[i + 1] - 0xDC00);
+                i++;
+            }
+
+            if (code < 0x80)
+            {
+                result += static_cast<char>(code);
+            }
+            else if (code < 0x800)
+            {
+                result += static_cast<char>(0xC0 | (code >> 6));
+                result += static_cast<char>(0x80 | (code & 0x3F));
+            }
+            else if (code < 0x10000)
+            {
+                result += static_cast<char>(0xE0 | (code >> 12));
+                result += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+                result += static_cast<char>(0x80 | (code & 0x3F));
+            }
+            else
+            {
+                result += static_cast<char>(0xF0 | (code >> 18));
+                result += static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+                result += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+                result += static_cast<char>(0x80 | (code & 0x3F));
+            }
+        }
+
+        return result;
+    }
+
+
+
+    bool EqualsNoCase(std::string_view lhs, std::string_view rhs) noexcept
+    {
+        if (lhs.size() != rhs.size())
+            return false;
+
+        for (size_t i = 0; i < lhs.size(); i++)
+            if (tolower(static_cast<unsigned char>(lhs[i])) != tolower(static_cast<unsigned char>(rhs[i])))
+                return false;
+
+        return true;
+    }
+}
+
+
+
+PZvend::Memory::DumpFile::DumpFile(const std::string& filepath)
+{
+    Open(filepath);
+}
+
+
+
+bool PZvend::Memory::DumpFile::Open(const std::string& filepath)
+{
+    m_Format = UNKNOWN_DUMP;
+    m_Modules.clear();
+    m_Regions.clear();
+
+    if (!m_File.Open(filepath))
+        return false;
+
+    const uint8_t* data = m_File.GetData();
+    bool parsed = false;
+
+    if (m_File.GetSize() >= sizeof(MinidumpHeader) && memcmp(data, "MDMP", 4) == 0)
+        parsed = IParseMinidump();
+
+    else if (m_File.GetSize() >= sizeof(Elf64Header) && memcmp(data, "\x7F" "ELF", 4) == 0)
+        parsed = IParseElfCore();
+
+    else
+        PZ_LOG_ERROR(MEMORY, "'{}' is neither a minidump nor an ELF core file.", filepath);
+
+    if (!parsed)
+    {
+        m_Format = UNKNOWN_DUMP;
+        m_Modules.clear();
+        m_Regions.clear();
+        m_File.Close();
+        return false;
+    }
+
+    ISortRegions();
+
+    PZ_LOG_DEBUG(MEMORY, "Opened dump '{}' with {} modules and {} regions.", filepath, m_Modules.size(), m_Regions.size());
+    return true;
+}
+
+
+
+const PZvend::Memory::DumpModule* PZvend::Memory::DumpFile::FindModule(const char* modulename) const noexcept
+{
+    std::string_view name = modulename;
+
+    for (const DumpModule& module : m_Modules)
+    {
+        std::string_view path     = module.Name;
+        size_t           slash    = path.find_last_of("/\\");
+        std::string_view filename = slash == std::string_view::npos ? path : path.substr(slash + 1);
+
+        if (EqualsNoCase(filename, name) || EqualsNoCase(path, name))
+            return &module;
+    }
+
+    return nullptr;
+}
+
+
+
+const PZvend::Memory::DumpRegion* PZvend::Memory::DumpFile::FindRegion(uint64_t address) const noexcept
+{
+    auto it = std::upper_bound(m_Regions.begin(), m_Regions.end(), address,
+        [](uint64_t value, const DumpRegion& region) { return value < region.Address; });
+
+    if (it == m_Regions.begin())
+        return nullptr;
+
+    --it;
+    if (address - it->Address >= it->Size)
+        return nullptr;
+
+    return &*it;
+}
+
+
+
+uint8_t* PZvend::Memory::DumpFile::Translate(uint64_t address, uint64_t* out_available) const noexcept
+{
+    const DumpRegion* region = FindRegion(address);
+    if (!region)
+    {
+        if (out_available)
+            *out_available = 0;
+
+        return nullptr;
+    }
+
+    uint64_t offset = address - region->Address;
+    if (out_available)
+        *out_available = region->Size - offset;
+
+    return region->Data + offset;
+}
+
+
+
+bool PZvend::Memory::DumpFile::IParseMinidump()
+{
+    FileView view(m_File.GetData(), m_File.GetSize());
+
+    const auto* header = view.Get<MinidumpHeader>(0);
+    if (!header || header->Signature != MINIDUMP_SIGNATURE)
+        return false;
+
+    const auto* directory = view.Get<MinidumpDirectory>(header->StreamDirectoryRva, header->NumberOfStreams);
+    if (!directory)
+    {
+        PZ_LOG_ERROR(MEMORY, "Minidump stream directory is truncated.");
+        return false;
+    }
+
+    for (uint32_t i = 0; i < header->NumberOfStreams; i++)
+    {
+        const MinidumpDirectory& stream = directory[i];
+
+        switch (stream.StreamType)
+        {
+            case MODULE_LIST_STREAM:
+                {
+                    const auto* count   = view.Get<uint32_t>(stream.Rva);
+                    const auto* modules = count ? view.Get<MinidumpModule>(stream.Rva + sizeof(uint32_t), *count) : nullptr;
+                    if (!modules)
+                        break;
+
+                    for (uint32_t m = 0; m < *count; m++)
+                        m_Modules.push_back({ ReadMinidumpString(view, modules[m].ModuleNameRva), modules[m].BaseOfImage, modules[m].SizeOfImage });
+                }
+                break;
+
+            case MEMORY_LIST_STREAM:
+                {
+                    const auto* count  = view.Get<uint32_t>(stream.Rva);
+                    const auto* ranges = count ? view.Get<MinidumpMemoryDescriptor>(stream.Rva + sizeof(uint32_t), *count) : nullptr;
+                    if (!ranges)
+                        break;
+
+                    for (uint32_t r = 0; r < *count; r++)
+                    {
+                        if (!view.Contains(ranges[r].Rva, ranges[r].DataSize))
+                            continue;
+
+                        m_Regions.push_back({ ranges[r].StartOfMemoryRange, ranges[r].DataSize, view.At(ranges[r].Rva), REGION_UNKNOWN });
+                    }
+                }
+                break;
+
+            case MEMORY64_LIST_STREAM:
+                {
+                    // Full memory dumps store all ranges back to back, starting at BaseRva.
+                    const auto* count    = view.Get<uint64_t>(stream.Rva);
+                    const auto* base_rva = view.Get<uint64_t>(stream.Rva + sizeof(uint64_t));
+                    const auto* ranges   = count && base_rva ? view.Get<MinidumpMemoryDescriptor64>(stream.Rva + 2 * sizeof(uint64_t), *count) : nullptr;
+                    if (!ranges)
+                        break;
+
+                    uint64_t offset = *base_rva;
+                    for (uint64_t r = 0; r < *count; r++)
+                    {
+                        if (!view.Contains(offset, ranges[r].DataSize))
+                            break;
+
+                        m_Regions.push_back({ ranges[r].StartOfMemoryRange, ranges[r].DataSize, view.At(offset), REGION_UNKNOWN });
+                        offset += ranges[r].DataSize;
+                    }
+                }
+                break;
+
+            default:
+                break;
+        }
+    }
+
+    if (m_Regions.empty())
+    {
+        PZ_LOG_ERROR(MEMORY, "Minidump does not contain any memory. Was it written with MiniDumpWithFullMemory or MiniDumpWithDataSegs?");
+        return false;
+    }
+
+    m_Format = MINIDUMP;
+    return true;
+}
+
+
+
+bool PZvend::Memory::DumpFile::IParseElfCore()
+{
+    FileView view(m_File.GetData(), m_File.GetSize());
+
+    const auto* header = view.Get<Elf64Header>(0);
+    if (!header || header->Ident[4] != ELF_CLASS64)
+    {
+        PZ_LOG_ERROR(MEMORY, "Only ELF64 core files are supported.");
+        return false;
+    }
+
+    if (header->Type != ET_CORE)
+    {
+        PZ_LOG_ERROR(MEMORY, "ELF file is not a core dump (e_type = {}).", header->Type);
+        return false;
+    }
+
+    if (header->PhEntSize != sizeof(Elf64ProgramHeader))
+        return false;
+
+    const auto* segments = view.Get<Elf64ProgramHeader>(header->PhOffset, header->PhNum);
+    if (!segments)
+    {
+        PZ_LOG_ERROR(MEMORY, "ELF core program headers are truncated.");
+        return false;
+    }
+
+    for (uint16_t i = 0; i < header->PhNum; i++)
+    {
+        const Elf64ProgramHeader& segment = segments[i];
+
+        if (segment.Type == PT_LOAD)
+        {
+            // Segments with FileSize < MemSize had pages left out of the dump (e.g. read-only file mappings).
+            if (segment.FileSize == 0 || !view.Contains(segment.Offset, segment.FileSize))
+                continue;
+
+            uint8_t access = REGION_UNKNOWN;
+            if (segment.Flags & PF_R) access |= REGION_READ;
+            if (segment.Flags & PF_W) access |= REGION_WRITE;
+            if (segment.Flags & PF_X) access |= REGION_EXECUTE;
+
+            m_Regions.push_back({ segment.VAddr, segment.FileSize, view.At(segment.Offset), access });
+        }
+        else if (segment.Type == PT_NOTE)
+        {
+            uint64_t offset = segment.Offset;
+            uint64_t end    = segment.Offset + segment.FileSize;
+
+            while (offset + 3 * sizeof(uint32_t) <= end)
+            {
+                const auto* note = view.Get<uint32_t>(offset, 3);
+                if (!note)
+                    break;
+
+                uint64_t name_size = (static_cast<uint64_t>(note[0]) + 3) & ~3ull;
+                uint64_t desc_size = (static_cast<uint64_t>(note[1]) + 3) & ~3ull;
+                uint64_t desc      = offset + 3 * sizeof(uint32_t) + name_size;
+
+                if (note[2] == NT_FILE && note[1] >= 2 * sizeof(uint64_t) && view.Contains(desc, note[1]))
+                {
+                    // count, page_size, count * { start, end, file_ofs }, count * "name\0"
+                    const auto* count = view.Get<uint64_t>(desc);
+
+                    // The entries have to fit into the note itself, which also keeps count * 3 from overflowing.
+                    const bool  valid   = *count <= (note[1] - 2 * sizeof(uint64_t)) / (3 * sizeof(uint64_t));
+                    const auto* entries = valid ? view.Get<uint64_t>(desc + 2 * sizeof(uint64_t), *count * 3) : nullptr;
+
+                    if (entries)
+                    {
+                        const char* name     = reinterpret_cast<const char*>(view.At(desc + (2 + *count * 3) * sizeof(uint64_t)));
+                        const char* name_end = reinterpret_cast<const char*>(view.At(desc + note[1]));
+
+                        for (uint64_t e = 0; e < *count && name < name_end; e++)
+                        {
+                            std::string_view path(name, strnlen(name, name_end - name));
+                            name += path.size() + 1;
+
+                            uint64_t start = entries[e * 3 + 0];
+                            uint64_t stop  = entries[e * 3 + 1];
+
+                            auto module = std::find_if(m_Modules.begin(), m_Modules.end(),
+                                [&](const DumpModule& other) { return other.Name == path; });
+
+                            if (module == m_Modules.end())
+                            {
+                                m_Modules.push_back({ std::string(path), start, stop - start });
+                                continue;
+                            }
+
+                            uint64_t module_end = std::max(module->Base + module->Size, stop);
+                            module->Base = std::min(module->Base, start);
+                            module->Size = module_end - module->Base;
+                        }
+                    }
+                }
+
+                offset = desc + desc_size;
+            }
+        }
+    }
+
+    if (m_Regions.empty())
+    {
+        PZ_LOG_ERROR(MEMORY, "ELF core file does not contain any memory.");
+        return false;
+    }
+
+    m_Format = ELF_CORE;
+    return true;
+}
+
+
+
+void PZvend::Memory::DumpFile::ISortRegions()
+{
+    std::sort(m_Regions.begin(), m_Regions.end(),
+        [](const DumpRegion& lhs, const DumpRegion& rhs) { return lhs.Address < rhs.Address; });
+
+    // Merge ranges that are adjacent in the process AND in the file, so scans can run across them.
+    std::vector<DumpRegion> merged;
+    merged.reserve(m_Regions.size());
+
+    for (const DumpRegion& region : m_Regions)
+    {
+        if (!merged.empty())
+        {
+            DumpRegion& last = merged.back();
+
+            if (last.Address + last.Size == region.Address && last.Data + last.Size == region.Data && last.Access == region.Access)
+            {
+                last.Size += region.Size;
+                continue;
+            }
+        }
+
+        merged.push_back(region);
+    }
+
+    m_Regions = std::move(merged);
+}
@@ -0,0 +1,158 @@
+#include "ProjectZvend/HookStats.hpp"
+
+#include <mutex>
+
+
+
+namespace
+{
+    using namespace PZvend::Memory;
+
+    struct Registry
+    {
+        std::mutex                                      Mutex;
+        std::vector<std::weak_ptr<HookCounters::Data>> Counters;
+    };
+
+
+
+    // Leaked on purpose, hooks living in globals unregister during static destruction.
+    Registry& GetRegistry()
+    {
+        static auto* registry = new Registry();
+        return *registry;
+    }
+}
+
+
+
+uint64_t PZvend::Memory::HookSnapshot::GetPercentile(const std::array<uint64_t, HOOK_HISTOGRAM_BUCKETS>& histogram, double percentile) noexcept
+{
+    uint64_t total = 0;
+    for (uint64_t count : histogram)
+        total += count;
+
+    if (!total)
+        return 0;
+
+    const auto target  = static_cast<uint64_t>(std::clamp(percentile, 0.0, 1.0) * static_cast<double>(total - 1)) + 1;
+    uint64_t   reached = 0;
+
+    for (size_t bucket = 0; bucket < HOOK_HISTOGRAM_BUCKETS; bucket++)
+    {
+        reached += histogram[bucket];
+        if (reached >= target)
+            return bucket ? (1ull << bucket) - 1 : 0;
+    }
+
+    return UINT64_MAX;
+}
+
+
+
+PZvend::Memory::HookCounters::HookCounters(const char* name)
+    : m_Data(std::make_shared<Data>())
+{
+    m_Data->Name = name;
+
+    Registry&       registry = GetRegistry();
+    std::lock_guard lock(registry.Mutex);
+
+    // Drop the entries of destroyed hooks while we are at it.
+    std::erase_if(registry.Counters, [](const std::weak_ptr<Data>& counters) { return counters.expired(); });
+    registry.Counters.push_back(m_Data);
+}
+
+
+
+PZvend::Memory::HookSnapshot PZvend::Memory::HookCounters::Snapshot() const
+{
+    HookSnapshot snapshot;
+    if (!m_Data)
+        return snapshot;
+
+    snapshot.Name = m_Data->Name;
+
+    for (const ThreadSlot& slot : m_Data->Slots)
+    {
+        snapshot.Calls          += slot.Calls.load(std::memory_order_relaxed);
+        snapshot.DetourCycles   += slot.DetourCycles.load(std::memory_order_relaxed);
+        snapshot.OriginalCalls  += slot.OriginalCalls.load(std::memory_order_relaxed);
+        snapshot.OriginalCycles += slot.OriginalCycles.load(std::memory_order_relaxed);
+
+        for (size_t bucket = 0; bucket < HOOK_HISTOGRAM_BUCKETS; bucket++)
+        {
+            snapshot.DetourHistogram[bucket]   += slot.DetourHistogram[bucket].load(std::memory_order_relaxed);
+            snapshot.OriginalHistogram[bucket] += slot.OriginalHistogram[bucket].load(std::memory_order_relaxed);
+        }
+    }
+
+    return snapshot;
+}
+
+
+
+void PZvend::Memory::HookCounters::Reset() noexcept
+{
+    if (!m_Data)
+        return;
+
+    // Calls racing with the reset may be lost, the counters are statistics.
+    for (ThreadSlot& slot : m_Data->Slots)
+    {
+        slot.Calls.store(0, std::memory_order_relaxed);
+        slot.DetourCycles.store(0, std::memory_order_relaxed);
+        slot.OriginalCalls.store(0, std::memory_order_relaxed);
+        slot.OriginalCycles.store(0, std::memory_order_relaxed);
+
+        for (size_t bucket = 0; bucket < HOOK_HISTOGRAM_BUCKETS; bucket++)
+        {
+            slot.DetourHistogram[bucket].store(0, std::memory_order_relaxed);
+            slot.OriginalHistogram[bucket].store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+
+
+std::vector<PZvend::Memory::HookSnapshot> PZvend::Memory::SnapshotHookCounters()
+{
+    std::vector<std::shared_ptr<HookCounters::Data>> live;
+    {
+        Registry&       registry = GetRegistry();
+        std::lock_guard lock(registry.Mutex);
+
+        for (const auto& counters : registry.Counters)
+            if (auto data = counters.lock())
+                live.push_back(std::move(data));
+    }
+
+    std::vector<HookSnapshot> snapshots;
+    for (auto& data : live)
+    {
+        HookCounters counters;
+        counters.m_Data = std::move(data);
+        snapshots.push_back(counters.Snapshot());
+    }
+
+    std::sort(snapshots.begin(), snapshots.end(), [](const HookSnapshot& lhs, const HookSnapshot& rhs) { return lhs.DetourCycles > rhs.DetourCycles; });
+    return snapshots;
+}
+
+
+
+void PZvend::Memory::ResetHookCounters()
+{
+    Registry&       registry = GetRegistry();
+    std::lock_guard lock(registry.Mutex);
+
+    for (const auto& counters : registry.Counters)
+    {
+        if (auto data = counters.lock())
+        {
+            HookCounters handle;
+            handle.m_Data = std::move(data);
+            handle.Reset();
+        }
+    }
+}
@@ -0,0 +1,321 @@
+#include "ProjectZvend/HookTransaction.hpp"
+#include "ProjectZvend/Log.hpp"
+
+#include "Macros.hpp"
+
+#include <spdlog/spdlog.h>
+#include <unordered_map>
+
+
+
+const char* PZvend::Memory::HookOperationToString(HookOperation operation) noexcept
+{
+    switch (operation)
+    {
+    case HOOK_CREATE:  return "HOOK_CREATE";
+    case HOOK_ENABLE:  return "HOOK_ENABLE";
+    case HOOK_DISABLE: return "HOOK_DISABLE";
+    case HOOK_REMOVE:  return "HOOK_REMOVE";
+    }
+
+    return "HOOK_UNKNOWN";
+}
+
+
+
+bool PZvend::Memory::HookTransaction::Commit()
+{
+    bool committed = ICommit();
+    m_Operations.clear();
+
+    if (committed)
+        PZ_LOG_DEBUG(HOOKS, "Committed transaction '{}' with {} operations.", m_Name, m_Results.size());
+
+    return committed;
+}
+
+
+
+bool PZvend::Memory::HookTransaction::ICommit()
+{
+    m_Results.clear();
+    m_Results.reserve(m_Operations.size());
+
+    for (const Operation& operation : m_Operations)
+        m_Results.push_back({ *operation.Hook.Name, operation.Type, false, "SKIPPED" });
+
+    if (!IValidate())
+        return false;
+
+    std::vector<size_t> created;
+    std::vector<size_t> queued;
+    std::string         status;
+
+    // Creating doesn't touch the targets, nothing runs through the new hooks yet.
+    for (size_t i = 0; i < m_Operations.size(); i++)
+    {
+        const Operation& operation = m_Operations[i];
+        if (operation.Type != HOOK_CREATE)
+            continue;
+
+        if (*operation.Hook.Original)
+        {
+            m_Results[i] = { *operation.Hook.Name, operation.Type, true, "ALREADY_CREATED" };
+            continue;
+        }
+
+        if (!ICreate(operation.Hook, status))
+        {
+            IRollback(created, queued);
+            return IFail(i, status.c_str());
+        }
+
+        created.push_back(i);
+        m_Results[i].Success = true;
+        m_Results[i].Status  = status;
+    }
+
+    // Enables, disables and the disable in front of a remove only get queued, the backends apply them at once below.
+    bool pending[2] = {};
+    for (size_t i = 0; i < m_Operations.size(); i++)
+    {
+        const Operation& operation = m_Operations[i];
+        if (operation.Type == HOOK_CREATE)
+            continue;
+
+        const bool enable = operation.Type == HOOK_ENABLE;
+
+        if (!*operation.Hook.Original)
+        {
+            if (enable)
+            {
+                IRollback(created, queued);
+                return IFail(i, "NOT_CREATED");
+            }
+
+            // Disabling or removing a hook that doesn't exist is a no-op, like on the hooks themselves.
+            m_Results[i] = { *operation.Hook.Name, operation.Type, true, "NOT_CREATED" };
+            continue;
+        }
+
+        if (*operation.Hook.Enabled == enable)
+            continue;
+
+        if (!IQueueState(operation.Hook, enable, status))
+        {
+            IRollback(created, queued);
+            return IFail(i, status.c_str());
+        }
+
+        queued.push_back(i);
+        pending[operation.Hook.Backend] = true;
+    }
+
+    std::string applied[2] = { "UNCHANGED", "UNCHANGED" };
+    for (HookBackend backend : { BACKEND_MINHOOK, BACKEND_NATIVE })
+    {
+        if (!pending[backend])
+            continue;
+
+        if (IApplyQueued(backend, applied[backend]))
+            continue;
+
+        IRollback(created, queued);
+
+        for (size_t i : queued)
+        {
+            if (m_Operations[i].Hook.Backend == backend)
+                m_Results[i].Status = applied[backend];
+        }
+
+        PZ_LOG_ERROR(HOOKS, "Transaction '{}' failed to apply {} queued hooks with {}, rolled back.", m_Name, queued.size(), applied[backend]);
+        return false;
+    }
+
+    for (size_t i : queued)
+        *m_Operations[i].Hook.Enabled = m_Operations[i].Type == HOOK_ENABLE;
+
+    for (size_t i = 0; i < m_Operations.size(); i++)
+    {
+        const Operation& operation = m_Operations[i];
+        if ((operation.Type == HOOK_ENABLE || operation.Type == HOOK_DISABLE) && *operation.Hook.Original)
+            m_Results[i] = { *operation.Hook.Name, operation.Type, true, applied[operation.Hook.Backend] };
+    }
+
+    // Past this point nothing can be rolled back anymore.
+    bool success = true;
+    for (size_t i = 0; i < m_Operations.size(); i++)
+    {
+        const Operation& operation = m_Operations[i];
+        if (operation.Type != HOOK_REMOVE || !*operation.Hook.Original)
+            continue;
+
+        if (!IRemove(operation.Hook, status))
+        {
+            success = false;
+            IFail(i, status.c_str());
+            continue;
+        }
+
+        *operation.Hook.Original = nullptr;
+        *operation.Hook.Enabled  = false;
+        m_Results[i] = { *operation.Hook.Name, operation.Type, true, status };
+    }
+
+    return success;
+}
+
+
+
+bool PZvend::Memory::HookTransaction::IValidate()
+{
+    std::unordered_map<void*, uint8_t> operations;
+
+    for (size_t i = 0; i < m_Operations.size(); i++)
+    {
+        if (!m_Operations[i].Hook.Target)
+            return IFail(i, "INVALID_HOOK");
+
+        operations[m_Operations[i].Hook.Target] |= 1 << m_Operations[i].Type;
+    }
+
+    // The phases run in a fixed order, so opposing operations on one hook have no meaningful result.
+    for (size_t i = 0; i < m_Operations.size(); i++)
+    {
+        const uint8_t mask = operations[m_Operations[i].Hook.Target];
+
+        const bool enable_conflict = (mask & (1 << HOOK_ENABLE)) && (mask & ((1 << HOOK_DISABLE) | (1 << HOOK_REMOVE)));
+        const bool create_conflict = (mask & (1 << HOOK_CREATE)) && (mask & (1 << HOOK_REMOVE));
+
+        if (enable_conflict || create_conflict)
+            return IFail(i, "CONFLICT");
+    }
+
+    return true;
+}
+
+
+
+bool PZvend::Memory::HookTransaction::IFail(size_t index, const char* status)
+{
+    HookOperationResult& result = m_Results[index];
+    result.Success = false;
+    result.Status  = status;
+
+    PZ_LOG_ERROR(HOOKS, "Transaction '{}' failed to {} '{}' with {}.", m_Name, HookOperationToString(result.Operation), result.Name, status);
+    return false;
+}
+
+
+
+void PZvend::Memory::HookTransaction::IRollback(const std::vector<size_t>& created, const std::vector<size_t>& queued)
+{
+    std::string status;
+
+    // Queueing the current state again cancels pending changes and undoes the ones a partial apply already made.
+    bool pending[2] = {};
+    for (size_t i : queued)
+    {
+        const HookState& hook = m_Operations[i].Hook;
+
+        IQueueState(hook, *hook.Enabled, status);
+        pending[hook.Backend] = true;
+        m_Results[i] = { *hook.Name, m_Operations[i].Type, false, "ROLLED_BACK" };
+    }
+
+    for (HookBackend backend : { BACKEND_MINHOOK, BACKEND_NATIVE })
+    {
+        if (pending[backend] && !IApplyQueued(backend, status))
+            PZ_LOG_ERROR(HOOKS, "Rolling back transaction '{}' failed with {}, some hooks may still be enabled.", m_Name, status);
+    }
+
+    for (auto it = created.rbegin(); it != created.rend(); ++it)
+    {
+        const HookState& hook = m_Operations[*it].Hook;
+
+        if (!IRemove(hook, status))
+        {
+            PZ_LOG_ERROR(HOOKS, "Rolling back the creation of '{}' failed with {}.", *hook.Name, status);
+            continue;
+        }
+
+        *hook.Original = nullptr;
+        *hook.Enabled  = false;
+        m_Results[*it] = { *hook.Name, HOOK_CREATE, false, "ROLLED_BACK" };
+    }
+}
+
+
+
+bool PZvend::Memory::HookTransaction::ICreate(const HookState& hook, std::string& out_status)
+{
+#ifdef PZVEND_IS_WINDOWS
+    if (hook.Backend == BACKEND_MINHOOK)
+    {
+        MH_STATUS mh_status = MH_CreateHook(hook.Target, hook.Detour, hook.Original);
+        out_status = MH_StatusToString(mh_status);
+        return mh_status == MH_OK;
+    }
+#endif
+
+    InlineHookStatus inline_status = CreateInlineHook(hook.Target, hook.Detour, hook.Original);
+    out_status = InlineHookStatusToString(inline_status);
+    return inline_status == INLINE_OK;
+}
+
+
+
+bool PZvend::Memory::HookTransaction::IRemove(const HookState& hook, std::string& out_status)
+{
+#ifdef PZVEND_IS_WINDOWS
+    if (hook.Backend == BACKEND_MINHOOK)
+    {
+        MH_STATUS mh_status = MH_RemoveHook(hook.Target);
+        out_status = MH_StatusToString(mh_status);
+        return mh_status == MH_OK;
+    }
+#endif
+
+    InlineHookStatus inline_status = RemoveInlineHook(hook.Target);
+    out_status = InlineHookStatusToString(inline_status);
+    return inline_status == INLINE_OK;
+}
+
+
+
+bool PZvend::Memory::HookTransaction::IQueueState(const HookState& hook, bool enable, std::string& out_status)
+{
+#ifdef PZVEND_IS_WINDOWS
+    if (hook.Backend == BACKEND_MINHOOK)
+    {
+        MH_STATUS mh_status = enable ? MH_QueueEnableHook(hook.Target) : MH_QueueDisableHook(hook.Target);
+        out_status = MH_StatusToString(mh_status);
+        return mh_status == MH_OK;
+    }
+#endif
+
+    InlineHookStatus inline_status = enable ? QueueEnableInlineHook(hook.Target) : QueueDisableInlineHook(hook.Target);
+    out_status = InlineHookStatusToString(inline_status);
+    return inline_status == INLINE_OK;
+}
+
+
+
+bool PZvend::Memory::HookTransaction::IApplyQueued(HookBackend backend, std::string& out_status)
+{
+#ifdef PZVEND_IS_WINDOWS
+    if (backend == BACKEND_MINHOOK)
+    {
+        // Suspends the other threads once for every queued MinHook hook of the process.
+        MH_STATUS mh_status = MH_ApplyQueued();
+        out_status = MH_StatusToString(mh_status);
+        return mh_status == MH_OK;
+    }
+#else
+    (void)backend;
+#endif
+
+    InlineHookStatus inline_status = ApplyQueuedInlineHooks();
+    out_status = InlineHookStatusToString(inline_status);
+    return inline_status == INLINE_OK;
+}
@@ -0,0 +1,280 @@
+#include "ProjectZvend/ImportHook.hpp"
+
+#include "Macros.hpp"
+
+#ifdef PZVEND_IS_WINDOWS
+    #include <wtypes.h>
+    #include <Psapi.h>
+#else
+    #include <dlfcn.h>
+    #include <link.h>
+#endif
+
+#include <string_view>
+
+
+
+namespace
+{
+    using namespace PZvend::Memory;
+
+#ifdef PZVEND_IS_WINDOWS
+    void CollectSlots(HMODULE module, const char* symbol, const char* library, std::vector<ImportSlot>& out_slots)
+    {
+        auto* base = reinterpret_cast<uint8_t*>(module);
+        auto* dos  = reinterpret_cast<IMAGE_DOS_HEADER*>(base);
+        if (dos->e_magic != IMAGE_DOS_SIGNATURE)
+            return;
+
+        auto* nt = reinterpret_cast<IMAGE_NT_HEADERS*>(base + dos->e_lfanew);
+        if (nt->Signature != IMAGE_NT_SIGNATURE)
+            return;
+
+        const IMAGE_DATA_DIRECTORY& directory = nt->OptionalHeader.DataDirectory[IMAGE_DIRECTORY_ENTRY_IMPORT];
+        if (!directory.VirtualAddress || !directory.Size)
+            return;
+
+        char module_name[MAX_PATH] = {};
+        GetModuleBaseNameA(GetCurrentProcess(), module, module_name, MAX_PATH);
+
+        auto* descriptor = reinterpret_cast<IMAGE_IMPORT_DESCRIPTOR*>(base + directory.VirtualAddress);
+        for (; descriptor->Name; descriptor++)
+        {
+            if (library && _stricmp(reinterpret_cast<const char*>(base + descriptor->Name), library) != 0)
+                continue;
+
+            // Bound imports overwrite the first thunk array, the names live in the original one.
+            auto* names = reinterpret_cast<IMAGE_THUNK_DATA*>(base + (descriptor->OriginalFirstThunk ? descriptor->OriginalFirstThunk : descriptor->FirstThunk));
+            auto* slots = reinterpret_cast<IMAGE_THUNK_DATA*>(base + descriptor->FirstThunk);
+
+            for (; names->u1.AddressOfData; names++, slots++)
+            {
+                if (IMAGE_SNAP_BY_ORDINAL(names->u1.Ordinal))
+                    continue;
+
+                auto* by_name = reinterpret_cast<IMAGE_IMPORT_BY_NAME*>(base + names->u1.AddressOfData);
+                if (strcmp(reinterpret_cast<const char*>(by_name->Name), symbol) != 0)
+                    continue;
+
+                auto* slot = reinterpret_cast<void**>(&slots->u1.Function);
+                out_slots.push_back({ slot, *slot, module_name });
+            }
+        }
+    }
+#else
+    struct SearchData
+    {
+        const char*              Symbol;
+        const char*              Module;
+        std::vector<ImportSlot>* Slots;
+    };
+
+
+
+    /*
+    Walks the relocations of one table and collects the GOT entries bound to the symbol.
+    glibc relocates the pointers of the dynamic section in place, other loaders don't.
+    */
+    template <class Relocation>
+    void CollectRelocations(const dl_phdr_info* info, const Relocation* table, size_t size, const ElfW(Sym)* symbols, const char* strings, const char* symbol, const char* module, std::vector<ImportSlot>& out_slots)
+    {
+        for (size_t i = 0; i < size / sizeof(Relocation); i++)
+        {
+            const Relocation& relocation = table[i];
+            const auto        type       = ELF64_R_TYPE(relocation.r_info);
+
+#if defined(__x86_64__)
+            if (type != R_X86_64_JUMP_SLOT && type != R_X86_64_GLOB_DAT)
+                continue;
+#elif defined(__aarch64__)
+            if (type != R_AARCH64_JUMP_SLOT && type != R_AARCH64_GLOB_DAT)
+                continue;
+#else
+            (void)type;
+            continue;
+#endif
+
+            const ElfW(Sym)& entry = symbols[ELF64_R_SYM(relocation.r_info)];
+            if (strcmp(strings + entry.st_name, symbol) != 0)
+                continue;
+
+            auto* slot = reinterpret_cast<void**>(info->dlpi_addr + relocation.r_offset);
+            out_slots.push_back({ slot, *slot, module });
+        }
+    }
+
+
+
+    int CollectSlots(dl_phdr_info* info, size_t, void* context)
+    {
+        auto&            search = *static_cast<SearchData*>(context);
+        std::string_view path   = info->dlpi_name ? info->dlpi_name : "";
+        std::string_view name   = path.substr(path.find_last_of('/') + 1);
+
+        // The main executable is reported first and without a name, an empty filter selects it.
+        if (search.Module && name != search.Module && path != search.Module)
+            return 0;
+
+        const ElfW(Dyn)* dynamic = nullptr;
+        for (uint16_t i = 0; i < info->dlpi_phnum; i++)
+        {
+            if (info->dlpi_phdr[i].p_type == PT_DYNAMIC)
+                dynamic = reinterpret_cast<const ElfW(Dyn)*>(info->dlpi_addr + info->dlpi_phdr[i].p_vaddr);
+        }
+
+        if (!dynamic)
+            return 0;
+
+        uintptr_t jmprel = 0, jmprel_size = 0, rela = 0, rela_size = 0, symtab = 0, strtab = 0;
+        for (; dynamic->d_tag != DT_NULL; dynamic++)
+        {
+            switch (dynamic->d_tag)
+            {
+            case DT_JMPREL:   jmprel      = dynamic->d_un.d_ptr; break;
+            case DT_PLTRELSZ: jmprel_size = dynamic->d_un.d_val; break;
+            case DT_RELA:     rela        = dynamic->d_un.d_ptr; break;
+            case DT_RELASZ:   rela_size   = dynamic->d_un.d_val; break;
+            case DT_SYMTAB:   symtab      = dynamic->d_un.d_ptr; break;
+            case DT_STRTAB:   strtab      = dynamic->d_un.d_ptr; break;
+            }
+        }
+
+        auto relocate = [info](uintptr_t address) { return address && address < info->dlpi_addr ? address + info->dlpi_addr : address; };
+
+        symtab = relocate(symtab);
+        strtab = relocate(strtab);
+        if (!symtab || !strtab)
+            return 0;
+
+        const auto* symbols = reinterpret_cast<const ElfW(Sym)*>(symtab);
+        const auto* strings = reinterpret_cast<const char*>(strtab);
+        std::string module  = path.empty() ? "<main>" : std::string(path);
+
+        // x86-64 and AArch64 only use RELA, DT_PLTREL is always DT_RELA there.
+        if (jmprel)
+            CollectRelocations(info, reinterpret_cast<const ElfW(Rela)*>(relocate(jmprel)), jmprel_size, symbols, strings, search.Symbol, module.c_str(), *search.Slots);
+
+        if (rela)
+            CollectRelocations(info, reinterpret_cast<const ElfW(Rela)*>(relocate(rela)), rela_size, symbols, strings, search.Symbol, module.c_str(), *search.Slots);
+
+        return 0;
+    }
+#endif
+}
+
+
+
+std::vector<PZvend::Memory::ImportSlot> PZvend::Memory::FindImportSlots(const char* symbol, const char* module, const char* library)
+{
+    std::vector<ImportSlot> slots;
+    if (!symbol || !*symbol)
+        return slots;
+
+#ifdef PZVEND_IS_WINDOWS
+    if (module)
+    {
+        HMODULE handle = GetModuleHandleA(*module ? module : nullptr);
+        if (handle)
+            CollectSlots(handle, symbol, library, slots);
+
+        return slots;
+    }
+
+    HMODULE modules[1024] = {};
+    DWORD   needed        = 0;
+
+    if (!EnumProcessModules(GetCurrentProcess(), modules, sizeof(modules), &needed))
+        return slots;
+
+    for (DWORD i = 0; i < std::min<DWORD>(needed / sizeof(HMODULE), 1024); i++)
+        CollectSlots(modules[i], symbol, library, slots);
+#else
+    (void)library;
+
+    SearchData search = { symbol, module, &slots };
+    dl_iterate_phdr(CollectSlots, &search);
+
+    // Some linkers let DT_RELA cover .rela.plt as well.
+    std::sort(slots.begin(), slots.end(), [](const ImportSlot& lhs, const ImportSlot& rhs) { return lhs.Address < rhs.Address; });
+    slots.erase(std::unique(slots.begin(), slots.end(), [](const ImportSlot& lhs, const ImportSlot& rhs) { return lhs.Address == rhs.Address; }), slots.end());
+#endif
+
+    return slots;
+}
+
+
+
+bool PZvend::Memory::ImportHookSet::Add(const char* symbol, void* detour, void** out_original, const char* module, const char* library)
+{
+    if (IsEnabled())
+    {
+        PZ_LOG_ERROR(HOOKS, "Import hook set '{}' is enabled, '{}' can't be added.", m_Name, symbol);
+        return false;
+    }
+
+    auto slots = FindImportSlots(symbol, module, library);
+    if (slots.empty())
+    {
+        PZ_LOG_ERROR(HOOKS, "Import hook set '{}' found no import of '{}'.", m_Name, symbol);
+        return false;
+    }
+
+    void* original = slots.front().Original;
+
+#ifndef PZVEND_IS_WINDOWS
+    // Lazily bound GOT entries still point at the PLT stub, which would resolve and overwrite the slot again.
+    if (void* resolved = dlsym(RTLD_DEFAULT, symbol))
+        original = resolved;
+#endif
+
+    size_t added = 0;
+    for (const ImportSlot& slot : slots)
+    {
+        if (!m_Patches.Add(slot.Address, reinterpret_cast<const uint8_t*>(&detour), sizeof(detour)))
+        {
+            PZ_LOG_ERROR(HOOKS, "Import hook set '{}' could not queue the '{}' slot of {}.", m_Name, symbol, slot.Module);
+            continue;
+        }
+
+        added++;
+    }
+
+    if (!added)
+        return false;
+
+    if (out_original)
+        *out_original = original;
+
+    PZ_LOG_DEBUG(HOOKS, "Import hook set '{}' queued {} slots of '{}'.", m_Name, added, symbol);
+    return true;
+}
+
+
+
+bool PZvend::Memory::ImportHookSet::Clear()
+{
+    if (!Disable())
+        return false;
+
+    return m_Patches.Clear();
+}
+
+
+
+bool PZvend::Memory::ImportHookSet::Enable()
+{
+    if (IsEnabled())
+        return true;
+
+    return m_Patches.Apply();
+}
+
+
+
+bool PZvend::Memory::ImportHookSet::Disable()
+{
+    if (!IsEnabled())
+        return true;
+
+    return m_Patches.Revert();
+}
@@ -1,117 +1,1246 @@
+#include <ProjectZvend/Hash.hpp>
 #include <ProjectZvend/JSON.hpp>
+#include <ProjectZvend/MappedFile.hpp>
 #include <ProjectZvend/Paths.hpp>
+#include <ProjectZvend/Profiler.hpp>
+
+#include "Macros.hpp"
+
+#ifdef PZVEND_IS_WINDOWS
+    #include <Windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+#include <atomic>
+#include <charconv>
+#include <condition_variable>
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <thread>
 
 
 
 namespace
 {
-    bool SaveJSON(
-        const std::string&                      filepath,
-        const nlohmann::ordered_json&           json,
-        const int                               indent,
-        const char                              indent_char,
-        const bool                              ensure_ascii,
-        const nlohmann::detail::error_handler_t error_handler)
+    using Clock = std::chrono::steady_clock;
+
+    struct SaveOptions
     {
-        if (filepath.empty())
+        int                               Indent       = 4;
+        char                              IndentChar   = ' ';
+        bool                              EnsureAscii  = false;
+        nlohmann::detail::error_handler_t ErrorHandler = nlohmann::detail::error_handler_t::strict;
+        bool                              Sidecar      = false;
+    };
+
+
+
+    /*
+    Output going through a fixed buffer into "<path>.tmp". Commit syncs it to disk and renames it
+    over the real file, a crash at any point leaves either the old or the new file.
+    */
+    class AtomicFileWriter final
+    {
+    public:
+        ~AtomicFileWriter()
+        {
+            Abort();
+        }
+
+        bool Open(const std::string& filepath)
+        {
+            m_Path     = filepath;
+            m_TempPath = filepath + ".tmp";
+            m_Buffer.resize(64 * 1024);
+
+            // The directory usually exists, only create it when opening fails.
+            if (IOpen())
+                return true;
+
+            return PZvend::Path::Create(filepath) && IOpen();
+        }
+
+        void Put(char c)
+        {
+            if (m_Used == m_Buffer.size())
+                IFlush();
+
+            m_Buffer[m_Used++] = c;
+        }
+
+        void Write(const char* s, std::size_t length)
+        {
+            if (m_Used + length > m_Buffer.size())
+            {
+                IFlush();
+
+                if (length > m_Buffer.size())
+                {
+                    IWrite(s, length);
+                    return;
+                }
+            }
+
+            std::memcpy(m_Buffer.data() + m_Used, s, length);
+            m_Used += length;
+        }
+
+        /*
+        FNV-1a of everything written so far, the sidecar names its text by it.
+        */
+        [[nodiscard]] uint64_t GetHash() const noexcept
+        {
+            return PZvend::Fnv1a(std::string_view(m_Buffer.data(), m_Used), m_Hash);
+        }
+
+        bool Commit()
+        {
+            IFlush();
+
+        #ifdef PZVEND_IS_WINDOWS
+            m_Failed = m_Failed || !FlushFileBuffers(m_File);
+            CloseHandle(m_File);
+            m_File = INVALID_HANDLE_VALUE;
+
+            if (m_Failed || !MoveFileExA(m_TempPath.c_str(), m_Path.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH))
+            {
+                DeleteFileA(m_TempPath.c_str());
+                return false;
+            }
+        #else
+            m_Failed = m_Failed || fsync(m_File) != 0;
+            m_Failed = close(m_File) != 0 || m_Failed;
+            m_File   = -1;
+
+            if (m_Failed || rename(m_TempPath.c_str(), m_Path.c_str()) != 0)
+            {
+                unlink(m_TempPath.c_str());
+                return false;
+            }
+
+            // The rename itself lives in the directory.
+            const auto directory = std::filesystem::path(m_Path).parent_path();
+            const int  handle    = open(directory.empty() ? "." : directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+            if (handle >= 0)
+            {
+                fsync(handle);
+                close(handle);
+            }
+        #endif
+
+            return true;
+        }
+
+        void Abort()
+        {
+        #ifdef PZVEND_IS_WINDOWS
+            if (m_File == INVALID_HANDLE_VALUE)
+                return;
+
+            CloseHandle(m_File);
+            DeleteFileA(m_TempPath.c_str());
+            m_File = INVALID_HANDLE_VALUE;
+        #else
+            if (m_File < 0)
+                return;
+
+            close(m_File);
+            unlink(m_TempPath.c_str());
+            m_File = -1;
+        #endif
+        }
+
+    private:
+        bool IOpen()
+        {
+        #ifdef PZVEND_IS_WINDOWS
+            m_File = CreateFileA(m_TempPath.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+            return m_File != INVALID_HANDLE_VALUE;
+        #else
+            m_File = open(m_TempPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+            if (m_File < 0)
+                return false;
+
+            // The rename replaces the file's mode as well, so the temp file takes over the old one.
+            struct stat original;
+            if (stat(m_Path.c_str(), &original) == 0)
+                m_Failed = fchmod(m_File, original.st_mode & 07777) != 0;
+
+            return true;
+        #endif
+        }
+
+        void IFlush()
+        {
+            IWrite(m_Buffer.data(), m_Used);
+            m_Used = 0;
+        }
+
+        void IWrite(const char* data, std::size_t size)
+        {
+            m_Hash = PZvend::Fnv1a(std::string_view(data, size), m_Hash);
+
+            while (size && !m_Failed)
+            {
+            #ifdef PZVEND_IS_WINDOWS
+                DWORD written = 0;
+                if (!WriteFile(m_File, data, static_cast<DWORD>(size < 0x40000000 ? size : 0x40000000), &written, nullptr) || written == 0)
+                    m_Failed = true;
+            #else
+                const ssize_t written = write(m_File, data, size);
+                if (written < 0 && errno == EINTR)
+                    continue;
+
+                if (written <= 0)
+                    m_Failed = true;
+            #endif
+
+                if (!m_Failed)
+                {
+                    data += written;
+                    size -= static_cast<std::size_t>(written);
+                }
+            }
+        }
+
+    private:
+        std::string       m_Path;
+        std::string       m_TempPath;
+        std::vector<char> m_Buffer;
+        std::size_t       m_Used   = 0;
+        uint64_t          m_Hash   = PZvend::Fnv1a({});
+        bool              m_Failed = false;
+
+    #ifdef PZVEND_IS_WINDOWS
+        HANDLE m_File = INVALID_HANDLE_VALUE;
+    #else
+        int    m_File = -1;
+    #endif
+    };
+
+
+
+    /*
+    Streams the text into the writer instead of building it in a string first. This is the only code
+    using nlohmann internals (detail::output_adapter_protocol and detail::serializer), they aren't
+    public API and are pinned to the bundled nlohmann/json 3.11.2. Check them here when updating it.
+    */
+    static_assert(NLOHMANN_JSON_VERSION_MAJOR == 3 && NLOHMANN_JSON_VERSION_MINOR == 11, "Serialize uses nlohmann/json 3.11 internals.");
+
+    void Serialize(const nlohmann::ordered_json& json, const SaveOptions& options, AtomicFileWriter& writer)
+    {
+        class Adapter final : public nlohmann::detail::output_adapter_protocol<char>
+        {
+        public:
+            explicit Adapter(AtomicFileWriter& writer) : m_Writer(writer) {}
+
+            void write_character(char c) override                             { m_Writer.Put(c); }
+            void write_characters(const char* s, std::size_t length) override { m_Writer.Write(s, length); }
+
+        private:
+            AtomicFileWriter& m_Writer;
+        };
+
+        nlohmann::detail::serializer<nlohmann::ordered_json> serializer(std::make_shared<Adapter>(writer), options.IndentChar, options.ErrorHandler);
+
+        if (options.Indent >= 0)
+            serializer.dump(json, true, options.EnsureAscii, static_cast<unsigned int>(options.Indent));
+        else
+            serializer.dump(json, false, options.EnsureAscii, 0);
+    }
+
+
+
+    /*
+    "<path>.pzcache": this header, then the document as MessagePack. The header names the text it was
+    made from by a hash of its bytes. Size and write time only reject a changed text without hashing it,
+    a same-size edit within the clock's granularity or a copy that keeps the time still fails the hash.
+    The checksum covers the header and the payload, so a stale, torn or foreign file never loads.
+    */
+    struct SidecarHeader
+    {
+        uint32_t Magic       = 0x434A5A50; // "PZJC"
+        uint32_t Version     = 2;
+        uint64_t SourceSize  = 0;
+        int64_t  SourceTime  = 0; // Write time of the text in file clock ticks.
+        uint64_t SourceHash  = 0; // FNV-1a of the text.
+        uint64_t PayloadSize = 0;
+        uint64_t Checksum    = 0; // FNV-1a over everything before it, then the payload.
+    };
+
+    static_assert(sizeof(SidecarHeader) == 48);
+
+
+
+    std::string GetSidecarPath(const std::string& filepath)
+    {
+        return filepath + ".pzcache";
+    }
+
+
+
+    bool GetSourceStamp(const std::string& filepath, SidecarHeader& header)
+    {
+        std::error_code error;
+        const auto      size = std::filesystem::file_size(filepath, error);
+        if (error)
+            return false;
+
+        const auto time = std::filesystem::last_write_time(filepath, error);
+        if (error)
+            return false;
+
+        header.SourceSize = static_cast<uint64_t>(size);
+        header.SourceTime = static_cast<int64_t>(time.time_since_epoch().count());
+        return true;
+    }
+
+
+
+    uint64_t GetSidecarChecksum(const SidecarHeader& header, const uint8_t* payload)
+    {
+        const uint64_t seed = PZvend::Fnv1a(std::string_view(reinterpret_cast<const char*>(&header), offsetof(SidecarHeader, Checksum)));
+        return PZvend::Fnv1a(std::string_view(reinterpret_cast<const char*>(payload), header.PayloadSize), seed);
+    }
+
+
+
+    /*
+    @param stamp Size and write time of the text, taken before it was read, and the hash of the text the document came from.
+    */
+    bool WriteSidecar(const std::string& filepath, const SidecarHeader& stamp, const nlohmann::ordered_json& json)
+    {
+        PZ_PROFILE_SCOPE("JSON::WriteSidecar");
+
+        const std::vector<uint8_t> payload = nlohmann::ordered_json::to_msgpack(json);
+
+        SidecarHeader header = stamp;
+        header.PayloadSize   = payload.size();
+        header.Checksum      = GetSidecarChecksum(header, payload.data());
+
+        AtomicFileWriter writer;
+        if (!writer.Open(GetSidecarPath(filepath)))
+            return false;
+
+        writer.Write(reinterpret_cast<const char*>(&header), sizeof(header));
+        writer.Write(reinterpret_cast<const char*>(payload.data()), payload.size());
+        return writer.Commit();
+    }
+
+
+
+    /*
+    @param stamp Size and write time the text has now.
+    @param text The text itself, only hashed if the sidecar passes the other checks.
+    @return Returns false if there is no usable sidecar, the text has to be parsed then.
+    */
+    bool ReadSidecar(const std::string& filepath, const SidecarHeader& stamp, std::string_view text, nlohmann::ordered_json& out_json)
+    {
+        PZ_PROFILE_SCOPE("JSON::ReadSidecar");
+
+        const std::string sidecar_path = GetSidecarPath(filepath);
+
+        // Checked before mapping, a missing or older sidecar is the normal case and not worth an error.
+        std::error_code error;
+        const auto      time = std::filesystem::last_write_time(sidecar_path, error);
+        if (error || time.time_since_epoch().count() < stamp.SourceTime)
             return false;
 
-        if (!PZvend::Path::Create(filepath))
+        PZvend::MappedFile file;
+        if (!file.Open(sidecar_path) || file.GetSize() < sizeof(SidecarHeader))
             return false;
 
-        std::ofstream savefile(filepath);
-        if (!savefile.is_open())
+        SidecarHeader header;
+        std::memcpy(&header, file.GetData(), sizeof(header));
+
+        const uint8_t* payload = file.GetData() + sizeof(header);
+
+        if (header.Magic != SidecarHeader().Magic || header.Version != SidecarHeader().Version ||
+            header.SourceSize != stamp.SourceSize || header.SourceTime != stamp.SourceTime ||
+            header.PayloadSize != file.GetSize() - sizeof(header) || header.Checksum != GetSidecarChecksum(header, payload) ||
+            header.SourceHash != PZvend::Fnv1a(text))
+        {
+            PZ_LOG_DEBUG(JSON, "Sidecar of '{}' is stale or damaged.", filepath);
+            return false;
+        }
+
+        try
+        {
+            out_json = nlohmann::ordered_json::from_msgpack(payload, payload + header.PayloadSize);
+            return true;
+        }
+        catch (const nlohmann::json::exception& e)
+        {
+            PZ_LOG_WARN(JSON, "Sidecar of '{}' is unreadable: {}", filepath, e.what());
             return false;
+        }
+    }
+
 
+
+    bool ParseText(const std::string& filepath, std::string_view text, nlohmann::ordered_json& out_json, std::string& error)
+    {
         try
         {
-            savefile << json.dump(indent, indent_char, ensure_ascii, error_handler);
-            savefile.close();
+            out_json = nlohmann::ordered_json::parse(text.begin(), text.end());
+        }
+        catch (const nlohmann::json::exception& e)
+        {
+            error = "Parsing '" + filepath + "' failed: " + e.what();
+            PZ_LOG_ERROR(JSON, "{}", error);
+            return false;
+        }
+
+        error.clear();
+        return true;
+    }
+
+
+
+    bool WriteJSON(const std::string& filepath, const nlohmann::ordered_json& json, const SaveOptions& options)
+    {
+        PZ_PROFILE_SCOPE("JSON::Save");
+
+        if (filepath.empty())
+            return false;
+
+        AtomicFileWriter writer;
+        if (!writer.Open(filepath))
+            return false;
+
+        try
+        {
+            Serialize(json, options, writer);
         }
         catch (const nlohmann::json::exception&)
         {
+            writer.Abort();
             return false;
         }
 
+        if (!writer.Commit())
+            return false;
+
+        // The text is saved either way, a sidecar that failed keeps the old stamp and is ignored.
+        SidecarHeader stamp;
+        stamp.SourceHash = writer.GetHash();
+
+        if (options.Sidecar && !(GetSourceStamp(filepath, stamp) && WriteSidecar(filepath, stamp, json)))
+            PZ_LOG_WARN(JSON, "Writing the sidecar of '{}' failed.", filepath);
+
         return true;
     }
+
+
+
+    /*
+    Debounced saves of all documents, keyed by path. SaveAsync replaces the pending snapshot and
+    pushes the deadline back, up to ten windows after the first unsaved change. Writes to one path
+    never overlap, a Save or Flush waits for the one in flight.
+    */
+    struct PendingSave
+    {
+        nlohmann::ordered_json Json;
+        SaveOptions            Options;
+        Clock::time_point      Deadline;
+        Clock::time_point      Latest;
+    };
+
+    struct SaveQueue
+    {
+        std::mutex                         Mutex;
+        std::condition_variable            Changed;
+        std::map<std::string, PendingSave> Pending;
+        std::set<std::string>              Writing;
+        std::thread                        Thread;
+    };
+
+
+
+    void RunSaveQueue(SaveQueue& queue)
+    {
+        std::unique_lock lock(queue.Mutex);
+
+        for (;;)
+        {
+            if (queue.Pending.empty())
+            {
+                queue.Changed.wait(lock);
+                continue;
+            }
+
+            auto next = queue.Pending.end();
+            for (auto it = queue.Pending.begin(); it != queue.Pending.end(); ++it)
+            {
+                if (!queue.Writing.contains(it->first) && (next == queue.Pending.end() || it->second.Deadline < next->second.Deadline))
+                    next = it;
+            }
+
+            if (next == queue.Pending.end())
+            {
+                queue.Changed.wait(lock);
+                continue;
+            }
+
+            if (Clock::now() < next->second.Deadline)
+            {
+                queue.Changed.wait_until(lock, next->second.Deadline);
+                continue;
+            }
+
+            const std::string path    = next->first;
+            PendingSave       pending = std::move(next->second);
+            queue.Pending.erase(next);
+            queue.Writing.insert(path);
+
+            lock.unlock();
+            const bool saved = WriteJSON(path, pending.Json, pending.Options);
+            lock.lock();
+
+            queue.Writing.erase(path);
+            queue.Changed.notify_all();
+
+            if (!saved)
+                PZ_LOG_ERROR(JSON, "Saving '{}' in the background failed.", path);
+        }
+    }
+
+
+
+    SaveQueue& GetSaveQueue()
+    {
+        static auto* queue = []()
+        {
+            auto* queue   = new SaveQueue();
+            queue->Thread = std::thread(RunSaveQueue, std::ref(*queue));
+            queue->Thread.detach();
+            return queue;
+        }();
+
+        return *queue;
+    }
+
+
+
+    /*
+    Writes on the calling thread, after the write in flight for the path. A pending save of the path
+    is dropped when a newer snapshot is given, or written instead when none is.
+    */
+    bool SaveNow(const std::string& filepath, const nlohmann::ordered_json* json, const SaveOptions& options)
+    {
+        if (filepath.empty())
+            return false;
+
+        SaveQueue&       queue = GetSaveQueue();
+        std::unique_lock lock(queue.Mutex);
+
+        queue.Changed.wait(lock, [&]() { return !queue.Writing.contains(filepath); });
+
+        std::optional<PendingSave> pending;
+        if (const auto it = queue.Pending.find(filepath); it != queue.Pending.end())
+        {
+            if (!json)
+                pending = std::move(it->second);
+
+            queue.Pending.erase(it);
+        }
+
+        if (!json && !pending)
+            return true;
+
+        queue.Writing.insert(filepath);
+        lock.unlock();
+
+        const bool saved = json ? WriteJSON(filepath, *json, options) : WriteJSON(filepath, pending->Json, pending->Options);
+
+        lock.lock();
+        queue.Writing.erase(filepath);
+        queue.Changed.notify_all();
+        return saved;
+    }
+
+
+
+    /*
+    Rewrites the sidecar after Load had to parse the text. Serialized with the saves of the path,
+    skipped if the text changed meanwhile or a queued save will rewrite it anyway.
+    */
+    void RegenerateSidecar(const std::string& filepath, const SidecarHeader& stamp, const nlohmann::ordered_json& json)
+    {
+        SaveQueue&       queue = GetSaveQueue();
+        std::unique_lock lock(queue.Mutex);
+
+        queue.Changed.wait(lock, [&]() { return !queue.Writing.contains(filepath); });
+
+        SidecarHeader current;
+        if (queue.Pending.contains(filepath) || !GetSourceStamp(filepath, current) ||
+            current.SourceSize != stamp.SourceSize || current.SourceTime != stamp.SourceTime)
+            return;
+
+        queue.Writing.insert(filepath);
+        lock.unlock();
+
+        if (!WriteSidecar(filepath, stamp, json))
+            PZ_LOG_WARN(JSON, "Writing the sidecar of '{}' failed.", filepath);
+
+        lock.lock();
+        queue.Writing.erase(filepath);
+        queue.Changed.notify_all();
+    }
+
+
+
+    /*
+    Walks the mapped text for JSON::Visit. Containers that no path leads into are skipped by
+    bracket matching, values at a requested path are cut out and parsed on their own. Only those
+    get nlohmann's full validation, the rest is checked for structure.
+    */
+    class SubtreeScanner
+    {
+    public:
+        SubtreeScanner(const char* begin, const char* end, const std::vector<PZvend::JSON::Path>& paths, const PZvend::JSON::Visitor& visitor)
+            : m_Begin(begin), m_Position(begin), m_End(end), m_Paths(paths), m_Visitor(visitor)
+        {}
+
+        bool Run()
+        {
+            if (!IValue())
+                return false;
+
+            ISkipWhitespace();
+            return m_Position == m_End || IFail("Unexpected data after the document");
+        }
+
+        [[nodiscard]] inline bool               IsStopped() const noexcept { return m_Stopped; }
+        [[nodiscard]] inline const std::string& GetError()  const noexcept { return m_Error; }
+
+    private:
+        struct Segment
+        {
+            bool        IsIndex = false;
+            size_t      Index   = 0;
+            std::string Key;
+        };
+
+        bool IValue()
+        {
+            ISkipWhitespace();
+            if (m_Position == m_End)
+                return IFail("Unexpected end of the document");
+
+            if (const size_t match = IMatch(); match != m_Paths.size())
+            {
+                const char* start = m_Position;
+                if (!ISkipValue())
+                    return false;
+
+                nlohmann::ordered_json value;
+                try
+                {
+                    value = nlohmann::ordered_json::parse(start, m_Position);
+                }
+                catch (const nlohmann::json::exception& e)
+                {
+                    return IFail(std::string(e.what()) + " in the value starting", start);
+                }
+
+                m_Stopped = !m_Visitor(match, value);
+                return !m_Stopped;
+            }
+
+            if (*m_Position == '{' && IIsPrefix())
+                return IObject();
+
+            if (*m_Position == '[' && IIsPrefix())
+                return IArray();
+
+            return ISkipValue();
+        }
+
+        bool IObject()
+        {
+            m_Position++;
+            ISkipWhitespace();
+
+            if (m_Position < m_End && *m_Position == '}')
+            {
+                m_Position++;
+                return true;
+            }
+
+            for (;;)
+            {
+                ISkipWhitespace();
+
+                Segment segment;
+                if (!IKey(segment.Key))
+                    return false;
+
+                ISkipWhitespace();
+                if (m_Position == m_End || *m_Position != ':')
+                    return IFail("Expected ':'");
+
+                m_Position++;
+                m_Path.push_back(std::move(segment));
+                const bool parsed = IValue();
+                m_Path.pop_back();
+
+                if (!parsed)
+                    return false;
+
+                ISkipWhitespace();
+                if (m_Position < m_End && *m_Position == ',')
+                    m_Position++;
+                else if (m_Position < m_End && *m_Position == '}')
+                {
+                    m_Position++;
+                    return true;
+                }
+                else
+                    return IFail("Expected ',' or '}'");
+            }
+        }
+
+        bool IArray()
+        {
+            m_Position++;
+            ISkipWhitespace();
+
+            if (m_Position < m_End && *m_Position == ']')
+            {
+                m_Position++;
+                return true;
+            }
+
+            for (size_t index = 0;; index++)
+            {
+                Segment segment;
+                segment.IsIndex = true;
+                segment.Index   = index;
+
+                m_Path.push_back(std::move(segment));
+                const bool parsed = IValue();
+                m_Path.pop_back();
+
+                if (!parsed)
+                    return false;
+
+                ISkipWhitespace();
+                if (m_Position < m_End && *m_Position == ',')
+                    m_Position++;
+                else if (m_Position < m_End && *m_Position == ']')
+                {
+                    m_Position++;
+                    return true;
+                }
+                else
+                    return IFail("Expected ',' or ']'");
+            }
+        }
+
+        bool IKey(std::string& key)
+        {
+            if (m_Position == m_End || *m_Position != '"')
+                return IFail("Expected a key");
+
+            const char* start   = m_Position;
+            bool        escaped = false;
+            if (!ISkipString(escaped))
+                return false;
+
+            if (!escaped)
+            {
+                key.assign(start + 1, m_Position - 1);
+                return true;
+            }
+
+            try
+            {
+                key = nlohmann::ordered_json::parse(start, m_Position).get<std::string>();
+            }
+            catch (const nlohmann::json::exception& e)
+            {
+                return IFail(e.what(), start);
+            }
+
+            return true;
+        }
+
+        /*
+        Moves past a string, the position has to be at its opening quote.
+        */
+        bool ISkipString(bool& escaped)
+        {
+            const char* start = m_Position++;
+
+            for (;;)
+            {
+                const auto* quote = static_cast<const char*>(std::memchr(m_Position, '"', m_End - m_Position));
+                if (!quote)
+                    return IFail("Unterminated string", start);
+
+                // An odd number of backslashes in front escapes the quote.
+                size_t backslashes = 0;
+                while (quote - backslashes > m_Position && quote[-1 - static_cast<std::ptrdiff_t>(backslashes)] == '\\')
+                    backslashes++;
+
+                escaped    = escaped || backslashes || std::memchr(m_Position, '\\', quote - m_Position);
+                m_Position = quote + 1;
+
+                if (backslashes % 2 == 0)
+                    return true;
+            }
+        }
+
+        bool ISkipValue()
+        {
+            const char* start = m_Position;
+            bool        escaped = false;
+
+            if (*m_Position == '"')
+                return ISkipString(escaped);
+
+            if (*m_Position != '{' && *m_Position != '[')
+            {
+                while (m_Position < m_End && !std::strchr(",}] \t\r\n", *m_Position))
+                    m_Position++;
+
+                return m_Position != start || IFail("Unexpected character");
+            }
+
+            std::string closers;
+            while (m_Position < m_End)
+            {
+                const char c = *m_Position;
+
+                if (c == '"')
+                {
+                    if (!ISkipString(escaped))
+                        return false;
+
+                    continue;
+                }
+
+                if (c == '{' || c == '[')
+                    closers.push_back(c == '{' ? '}' : ']');
+                else if (c == '}' || c == ']')
+                {
+                    if (closers.back() != c)
+                        return IFail("Mismatched bracket");
+
+                    closers.pop_back();
+                    if (closers.empty())
+                    {
+                        m_Position++;
+                        return true;
+                    }
+                }
+
+                m_Position++;
+            }
+
+            return IFail("Unterminated container", start);
+        }
+
+        void ISkipWhitespace() noexcept
+        {
+            while (m_Position < m_End && (*m_Position == ' ' || *m_Position == '\n' || *m_Position == '\r' || *m_Position == '\t'))
+                m_Position++;
+        }
+
+        bool ISegmentMatches(const std::string& key, const Segment& segment) const
+        {
+            if (key == "*")
+                return true;
+
+            if (!segment.IsIndex)
+                return key == segment.Key;
+
+            size_t     index  = 0;
+            const auto result = std::from_chars(key.data(), key.data() + key.size(), index);
+            return result.ec == std::errc() && result.ptr == key.data() + key.size() && index == segment.Index;
+        }
+
+        /*
+        Returns the first path naming the current position, or the path count.
+        */
+        size_t IMatch() const
+        {
+            for (size_t i = 0; i < m_Paths.size(); i++)
+            {
+                const auto& keys = m_Paths[i].GetKeys();
+                if (keys.size() != m_Path.size())
+                    continue;
+
+                size_t level = 0;
+                while (level < keys.size() && ISegmentMatches(keys[level], m_Path[level]))
+                    level++;
+
+                if (level == keys.size())
+                    return i;
+            }
+
+            return m_Paths.size();
+        }
+
+        bool IIsPrefix() const
+        {
+            for (const auto& path : m_Paths)
+            {
+                const auto& keys = path.GetKeys();
+                if (keys.size() <= m_Path.size())
+                    continue;
+
+                size_t level = 0;
+                while (level < m_Path.size() && ISegmentMatches(keys[level], m_Path[level]))
+                    level++;
+
+                if (level == m_Path.size())
+                    return true;
+            }
+
+            return false;
+        }
+
+        bool IFail(const std::string& message, const char* at = nullptr)
+        {
+            m_Error = message + " at byte " + std::to_string((at ? at : m_Position) - m_Begin) + ".";
+            return false;
+        }
+
+    private:
+        const char* m_Begin;
+        const char* m_Position;
+        const char* m_End;
+
+        const std::vector<PZvend::JSON::Path>& m_Paths;
+        const PZvend::JSON::Visitor&           m_Visitor;
+
+        std::vector<Segment> m_Path;
+        bool                 m_Stopped = false;
+        std::string          m_Error;
+    };
 }
 
 
 PZvend::JSON::JSON()
 {}
 
-PZvend::JSON::JSON(const std::string& filepath) : m_Filepath(filepath)
+PZvend::JSON::JSON(const std::string& filepath, const bool sidecar) : m_Filepath(filepath), m_Sidecar(sidecar)
 {
-    Path::Create(filepath);
+    PZvend::Path::Create(filepath);
 
-    if (Path::Exist(filepath))
+    if (PZvend::Path::Exist(filepath))
         Load(filepath);
 }
 
 bool PZvend::JSON::Load(const std::string& filepath)
 {
+    PZ_PROFILE_SCOPE("JSON::Load");
+
     if (!filepath.ends_with(".json"))
+    {
+        m_LastError = "'" + filepath + "' is not a .json file.";
+        PZ_LOG_ERROR(JSON, "{}", m_LastError);
+        return false;
+    }
+
+    // Parsed aside, a broken file keeps the current document.
+    nlohmann::ordered_json json;
+    if (!IParse(filepath, json))
         return false;
 
-    std::ifstream loadfile(filepath);
-    if (loadfile.is_open())
+    m_Generation.Bump();
+    m_Json     = std::move(json);
+    m_Filepath = filepath;
+    return true;
+}
+
+bool PZvend::JSON::Reload()
+{
+    return IReload(nullptr);
+}
+
+bool PZvend::JSON::Reload(nlohmann::ordered_json& out_patch)
+{
+    return IReload(&out_patch);
+}
+
+bool PZvend::JSON::Save(
+    const int indent,
+    const char indent_char,
+    const bool ensure_ascii,
+    const ErrorHandler error_handler) const
+{
+    return SaveNow(m_Filepath, &m_Json, { indent, indent_char, ensure_ascii, error_handler, m_Sidecar });
+}
+
+bool PZvend::JSON::SaveTo(const std::string& filepath,
+                          const int          indent,
+                          const char         indent_char,
+                          const bool         ensure_ascii,
+                          const ErrorHandler error_handler) const
+{
+    return SaveNow(filepath, &m_Json, { indent, indent_char, ensure_ascii, error_handler, m_Sidecar });
+}
+
+void PZvend::JSON::SaveAsync(std::chrono::milliseconds debounce,
+                             const int                 indent,
+                             const char                indent_char,
+                             const bool                ensure_ascii,
+                             const ErrorHandler        error_handler) const
+{
+    if (m_Filepath.empty())
+        return;
+
+    // The copy is the only work on the calling thread, serializing and writing happen on the saver.
+    nlohmann::ordered_json snapshot = m_Json;
+
+    SaveQueue& queue = GetSaveQueue();
+    const auto now   = Clock::now();
+
     {
-        try
+        std::lock_guard lock(queue.Mutex);
+
+        auto [it, inserted] = queue.Pending.try_emplace(m_Filepath);
+        if (inserted)
+            it->second.Latest = now + debounce * 10;
+
+        it->second.Json     = std::move(snapshot);
+        it->second.Options  = { indent, indent_char, ensure_ascii, error_handler, m_Sidecar };
+        it->second.Deadline = now + debounce < it->second.Latest ? now + debounce : it->second.Latest;
+    }
+
+    queue.Changed.notify_all();
+}
+
+bool PZvend::JSON::Flush() const
+{
+    return SaveNow(m_Filepath, nullptr, {});
+}
+
+
+
+PZvend::JSON::Path PZvend::JSON::Path::FromPointer(std::string_view pointer)
+{
+    Path path;
+
+    // "" is the whole document, every key starts with a '/'.
+    size_t start = pointer.find('/');
+    while (start != std::string_view::npos)
+    {
+        const size_t end = pointer.find('/', start + 1);
+        const auto   raw = pointer.substr(start + 1, end == std::string_view::npos ? std::string_view::npos : end - start - 1);
+
+        std::string key;
+        key.reserve(raw.size());
+        for (size_t i = 0; i < raw.size(); i++)
         {
-            loadfile >> m_Json;
-            loadfile.close();
+            if (raw[i] == '~' && i + 1 < raw.size() && (raw[i + 1] == '0' || raw[i + 1] == '1'))
+                key += raw[++i] == '0' ? '~' : '/';
+            else
+                key += raw[i];
         }
-        catch (const nlohmann::json::exception& e)
+
+        path.m_Keys.push_back(std::move(key));
+        start = end;
+    }
+
+    return path;
+}
+
+
+
+/*
+Walks the keys once per generation, one lookup per level. Misses are cached as well, so a missing
+key in a per frame read warns once instead of every frame.
+*/
+const nlohmann::ordered_json* PZvend::JSON::IResolve(const Path& path) const
+{
+    if (path.m_Generation == m_Generation.Value)
+        return path.m_Node;
+
+    const nlohmann::ordered_json* node = &m_Json;
+    for (const std::string& key : path.m_Keys)
+    {
+        const nlohmann::ordered_json* next = nullptr;
+
+        if (node->is_object())
         {
-            loadfile.close();
-            throw e;
-            return false;
+            if (const auto it = node->find(key); it != node->end())
+                next = &*it;
+        }
+        else if (node->is_array())
+        {
+            size_t     index  = 0;
+            const auto result = std::from_chars(key.data(), key.data() + key.size(), index);
+            if (result.ec == std::errc() && result.ptr == key.data() + key.size() && index < node->size())
+                next = &(*node)[index];
         }
 
-        m_Filepath = filepath;
-        return true;
+        if (!next)
+            PZ_LOG_WARN(JSON, "Key '{}' does not exist.", key);
+
+        node = next;
+        if (!node)
+            break;
     }
 
-    return false;
+    path.m_Generation = m_Generation.Value;
+    path.m_Node       = node;
+    return node;
 }
 
-bool PZvend::JSON::Reload()
+
+
+nlohmann::ordered_json& PZvend::JSON::IAt(const Path& path)
 {
-    if (m_Filepath.empty())
-        return false;
+    m_Generation.Bump();
+
+    nlohmann::ordered_json* node = &m_Json;
+    for (const std::string& key : path.m_Keys)
+    {
+        size_t     index  = 0;
+        const auto result = std::from_chars(key.data(), key.data() + key.size(), index);
+
+        if (node->is_array() && result.ec == std::errc() && result.ptr == key.data() + key.size() && index < node->size())
+            node = &(*node)[index];
+        else
+            node = &(*node)[key]; // Null becomes an object, other types throw like the key based Set.
+    }
+
+    return *node;
+}
 
-    std::ifstream loadfile(m_Filepath);
-    if (!loadfile.is_open())
+
+
+/*
+The stamp is taken before anything is read. A text that changes while it's parsed gets a sidecar
+with the old stamp, which the next Load rejects. The hash and the parse see the same mapped bytes,
+so a sidecar always carries the hash of the text its document came from.
+*/
+bool PZvend::JSON::IParse(const std::string& filepath, nlohmann::ordered_json& out_json)
+{
+    SidecarHeader stamp;
+    if (!m_Sidecar || !GetSourceStamp(filepath, stamp))
+        return Parse(filepath, out_json, m_LastError);
+
+    MappedFile file;
+    if (!file.Open(filepath))
+    {
+        m_LastError = "Could not map '" + filepath + "'.";
+        PZ_LOG_ERROR(JSON, "{}", m_LastError);
         return false;
+    }
 
-    try
+    const std::string_view text(reinterpret_cast<const char*>(file.GetData()), file.GetSize());
+
+    if (ReadSidecar(filepath, stamp, text, out_json))
     {
-        loadfile >> m_Json;
-        loadfile.close();
+        m_LastError.clear();
+        return true;
     }
-    catch (const nlohmann::json::exception&)
+
+    if (!ParseText(filepath, text, out_json, m_LastError))
+        return false;
+
+    stamp.SourceHash = Fnv1a(text);
+    RegenerateSidecar(filepath, stamp, out_json);
+    return true;
+}
+
+
+
+bool PZvend::JSON::IReload(nlohmann::ordered_json* out_patch)
+{
+    PZ_PROFILE_SCOPE("JSON::Reload");
+
+    if (m_Filepath.empty())
     {
+        m_LastError = "No file was loaded.";
+        PZ_LOG_ERROR(JSON, "{}", m_LastError);
         return false;
     }
 
+    nlohmann::ordered_json json;
+    if (!IParse(m_Filepath, json))
+        return false;
+
+    if (out_patch)
+        *out_patch = nlohmann::ordered_json::diff(m_Json, json);
+
+    m_Generation.Bump();
+    m_Json = std::move(json);
     return true;
 }
 
-bool PZvend::JSON::Save(
-    const int indent,
-    const char indent_char,
-    const bool ensure_ascii,
-    const ErrorHandler error_handler)
+
+
+uint64_t PZvend::JSON::Generation::Next() noexcept
 {
-    return SaveJSON(m_Filepath, m_Json, indent, indent_char, ensure_ascii, error_handler);
+    static std::atomic<uint64_t> next = 1;
+    return next.fetch_add(1, std::memory_order_relaxed);
 }
 
-bool PZvend::JSON::SaveTo(const std::string& filepath,
-                          const int          indent,
-                          const char         indent_char,
-                          const bool         ensure_ascii,
-                          const ErrorHandler error_handler)
+
+
+/*
+The file is parsed straight from the mapping, without a stream or a copy in between.
+*/
+bool PZvend::JSON::Parse(const std::string& filepath, nlohmann::ordered_json& out_json, std::string& error)
+{
+    PZ_PROFILE_SCOPE("JSON::Parse");
+
+    MappedFile file;
+    if (!file.Open(filepath))
+    {
+        error = "Could not map '" + filepath + "'.";
+        PZ_LOG_ERROR(JSON, "{}", error);
+        return false;
+    }
+
+    return ParseText(filepath, std::string_view(reinterpret_cast<const char*>(file.GetData()), file.GetSize()), out_json, error);
+}
+
+
+
+bool PZvend::JSON::Write(const std::string& filepath, const nlohmann::ordered_json& json, const int indent, const char indent_char, const bool ensure_ascii, const ErrorHandler error_handler)
 {
-    return SaveJSON(filepath, m_Json, indent, indent_char, ensure_ascii, error_handler);
+    return SaveNow(filepath, &json, { indent, indent_char, ensure_ascii, error_handler, false });
+}
+
+
+
+bool PZvend::JSON::Visit(const std::string& filepath, const std::vector<Path>& paths, const Visitor& visitor, std::string& error)
+{
+    PZ_PROFILE_SCOPE("JSON::Visit");
+
+    MappedFile file;
+    if (!file.Open(filepath))
+    {
+        error = "Could not map '" + filepath + "'.";
+        PZ_LOG_ERROR(JSON, "{}", error);
+        return false;
+    }
+
+    const auto*    begin = reinterpret_cast<const char*>(file.GetData());
+    SubtreeScanner scanner(begin, begin + file.GetSize(), paths, visitor);
+
+    if (!scanner.Run() && !scanner.IsStopped())
+    {
+        error = "Parsing '" + filepath + "' failed: " + scanner.GetError();
+        PZ_LOG_ERROR(JSON, "{}", error);
+        return false;
+    }
+
+    error.clear();
+    return true;
 }
@@ -0,0 +1,25 @@
+#include "ProjectZvend/JsonStruct.hpp"
+
+#include "ProjectZvend/JSON.hpp"
+#include "ProjectZvend/Profiler.hpp"
+
+
+
+bool PZvend::JsonStruct::IReadFile(const std::string& filepath, nlohmann::ordered_json& json, std::vector<JsonStructError>& errors)
+{
+    std::string error;
+    if (JSON::Parse(filepath, json, error))
+        return true;
+
+    errors.push_back({ "", std::move(error) });
+    return false;
+}
+
+
+
+bool PZvend::JsonStruct::IWriteFile(const std::string& filepath, const nlohmann::ordered_json& json, const int indent)
+{
+    PZ_PROFILE_SCOPE("JsonStruct::Save");
+
+    return JSON::Write(filepath, json, indent);
+}
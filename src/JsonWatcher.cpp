@@ -0,0 +1,523 @@
+#include <ProjectZvend/Hash.hpp>
+#include <ProjectZvend/JsonWatcher.hpp>
+#include <ProjectZvend/MappedFile.hpp>
+#include <ProjectZvend/Profiler.hpp>
+
+#include "Macros.hpp"
+
+#ifdef PZVEND_IS_WINDOWS
+    #include <Windows.h>
+#else
+    #include <poll.h>
+    #include <sys/eventfd.h>
+    #include <sys/inotify.h>
+    #include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <filesystem>
+
+
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+
+
+    /*
+    An operation concerns a subscriber if one path leads into the other. A replaced parent
+    changes the subscribed value, a changed child changes it as well.
+    */
+    bool IsRelated(const std::vector<std::string>& subscribed, const std::vector<std::string>& changed)
+    {
+        const size_t common = std::min(subscribed.size(), changed.size());
+        return std::equal(subscribed.begin(), subscribed.begin() + common, changed.begin());
+    }
+
+
+
+    bool HashFile(const std::string& filepath, uint64_t& out_hash)
+    {
+        // A file being replaced can be missing or empty for a moment, the write that follows is noticed as well.
+        std::error_code error;
+        if (!std::filesystem::exists(filepath, error) || std::filesystem::file_size(filepath, error) == 0 || error)
+            return false;
+
+        PZvend::MappedFile file;
+        if (!file.Open(filepath))
+            return false;
+
+        out_hash = PZvend::Fnv1a(std::string_view(reinterpret_cast<const char*>(file.GetData()), file.GetSize()));
+        return true;
+    }
+}
+
+
+
+#ifdef PZVEND_IS_WINDOWS
+struct PZvend::JsonWatcher::Directory
+{
+    std::string Path;
+    HANDLE      Handle     = INVALID_HANDLE_VALUE;
+    OVERLAPPED  Overlapped = {};
+    bool        Reading    = false;
+
+    alignas(DWORD) uint8_t Buffer[16 * 1024];
+};
+#else
+struct PZvend::JsonWatcher::Directory
+{
+    std::string Path;
+    int         Handle = -1;
+};
+#endif
+
+
+
+PZvend::JsonWatcher::JsonWatcher(std::chrono::milliseconds debounce) : m_Debounce(debounce)
+{
+#ifdef PZVEND_IS_WINDOWS
+    m_Wake = CreateEventA(nullptr, FALSE, FALSE, nullptr);
+    if (!m_Wake)
+    {
+        PZ_LOG_ERROR(JSON, "Creating the watcher's event failed with {}.", GetLastError());
+        return;
+    }
+#else
+    m_Inotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    m_Wake    = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (m_Inotify < 0 || m_Wake < 0)
+    {
+        PZ_LOG_ERROR(JSON, "Creating the watcher's inotify instance failed with {}.", errno);
+        return;
+    }
+#endif
+
+    m_Thread = std::thread(&JsonWatcher::IRun, this);
+}
+
+
+
+PZvend::JsonWatcher::~JsonWatcher()
+{
+    m_Stop.store(true, std::memory_order_release);
+
+#ifdef PZVEND_IS_WINDOWS
+    if (m_Thread.joinable())
+    {
+        SetEvent(m_Wake);
+        m_Thread.join();
+    }
+
+    for (auto& directory : m_Directories)
+    {
+        if (directory->Reading)
+        {
+            DWORD size = 0;
+            CancelIoEx(directory->Handle, &directory->Overlapped);
+            GetOverlappedResult(directory->Handle, &directory->Overlapped, &size, TRUE);
+        }
+
+        CloseHandle(directory->Overlapped.hEvent);
+        CloseHandle(directory->Handle);
+    }
+
+    if (m_Wake)
+        CloseHandle(m_Wake);
+#else
+    if (m_Thread.joinable())
+    {
+        const uint64_t one = 1;
+        write(m_Wake, &one, sizeof(one));
+        m_Thread.join();
+    }
+
+    // Closing the instance drops its watches.
+    if (m_Inotify >= 0)
+        close(m_Inotify);
+
+    if (m_Wake >= 0)
+        close(m_Wake);
+#endif
+}
+
+
+
+bool PZvend::JsonWatcher::Watch(JSON& json)
+{
+    if (IFind(json))
+        return true;
+
+    if (!m_Thread.joinable() || json.GetFilepath().empty())
+        return false;
+
+    std::error_code error;
+    const auto      filepath = std::filesystem::absolute(json.GetFilepath(), error).lexically_normal();
+    if (error)
+        return false;
+
+    if (!IWatchDirectory(filepath.parent_path().string()))
+        return false;
+
+    Document document;
+    document.Json     = &json;
+    document.Filepath = filepath.string();
+    HashFile(document.Filepath, document.Hash);
+
+    {
+        std::lock_guard lock(m_Mutex);
+        m_Files.insert(document.Filepath);
+    }
+
+    m_Documents.push_back(std::move(document));
+    return true;
+}
+
+
+
+void PZvend::JsonWatcher::Unwatch(JSON& json)
+{
+    const auto it = std::find_if(m_Documents.begin(), m_Documents.end(), [&](const Document& document) { return document.Json == &json; });
+    if (it == m_Documents.end())
+        return;
+
+    const std::string filepath = it->Filepath;
+    m_Documents.erase(it);
+
+    // Another document might use the same file.
+    if (std::any_of(m_Documents.begin(), m_Documents.end(), [&](const Document& document) { return document.Filepath == filepath; }))
+        return;
+
+    std::lock_guard lock(m_Mutex);
+    m_Files.erase(filepath);
+    m_Changed.erase(filepath);
+}
+
+
+
+PZvend::JsonSubscriptionId PZvend::JsonWatcher::Subscribe(JSON& json, const JSON::Path& path, JsonChangeCallback callback)
+{
+    if (!Watch(json))
+        return 0;
+
+    const JsonSubscriptionId id = m_NextId++;
+
+    Subscription subscription;
+    subscription.Id       = id;
+    subscription.Keys     = path.GetKeys();
+    subscription.Callback = std::move(callback);
+
+    IFind(json)->Subscriptions.push_back(std::move(subscription));
+    return id;
+}
+
+
+
+bool PZvend::JsonWatcher::Unsubscribe(JsonSubscriptionId id)
+{
+    for (Document& document : m_Documents)
+    {
+        const auto it = std::find_if(document.Subscriptions.begin(), document.Subscriptions.end(), [id](const Subscription& subscription) { return subscription.Id == id; });
+        if (it != document.Subscriptions.end())
+        {
+            document.Subscriptions.erase(it);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+
+size_t PZvend::JsonWatcher::Poll()
+{
+    // Checked here as well, an idle watcher shouldn't even read the clock.
+    if (!m_Pending.load(std::memory_order_acquire))
+        return 0;
+
+    return Poll(Clock::now());
+}
+
+
+
+size_t PZvend::JsonWatcher::Poll(std::chrono::steady_clock::time_point now)
+{
+    if (!m_Pending.load(std::memory_order_acquire))
+        return 0;
+
+    std::vector<std::string> due;
+
+    {
+        std::lock_guard lock(m_Mutex);
+
+        for (auto it = m_Changed.begin(); it != m_Changed.end();)
+        {
+            if (now - it->second < m_Debounce)
+            {
+                ++it;
+                continue;
+            }
+
+            due.push_back(it->first);
+            it = m_Changed.erase(it);
+        }
+
+        m_Pending.store(!m_Changed.empty(), std::memory_order_release);
+    }
+
+    size_t reloaded = 0;
+    for (const std::string& filepath : due)
+    {
+        // Looked up again before each reload, a callback may unwatch documents and move the others.
+        std::vector<JSON*> documents;
+        for (const Document& document : m_Documents)
+        {
+            if (document.Filepath == filepath)
+                documents.push_back(document.Json);
+        }
+
+        for (JSON* json : documents)
+        {
+            if (Document* document = IFind(*json))
+                reloaded += IReload(*document);
+        }
+    }
+
+    return reloaded;
+}
+
+
+
+PZvend::JsonWatcher::Document* PZvend::JsonWatcher::IFind(const JSON& json)
+{
+    const auto it = std::find_if(m_Documents.begin(), m_Documents.end(), [&](const Document& document) { return document.Json == &json; });
+    return it != m_Documents.end() ? &*it : nullptr;
+}
+
+
+
+/*
+Directories are watched instead of files, saving through a rename replaces the file and a watch
+on it would be gone. They stay watched until the watcher is destroyed, events of files nobody
+watches are dropped by the thread.
+*/
+bool PZvend::JsonWatcher::IWatchDirectory(const std::string& directory)
+{
+    std::lock_guard lock(m_Mutex);
+
+    if (std::any_of(m_Directories.begin(), m_Directories.end(), [&](const auto& watched) { return watched->Path == directory; }))
+        return true;
+
+    auto watched  = std::make_unique<Directory>();
+    watched->Path = directory;
+
+#ifdef PZVEND_IS_WINDOWS
+    watched->Handle = CreateFileW(std::filesystem::path(directory).c_str(), FILE_LIST_DIRECTORY, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                                  nullptr, OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, nullptr);
+    if (watched->Handle == INVALID_HANDLE_VALUE)
+    {
+        PZ_LOG_ERROR(JSON, "Watching '{}' failed with {}.", directory, GetLastError());
+        return false;
+    }
+
+    watched->Overlapped.hEvent = CreateEventA(nullptr, TRUE, FALSE, nullptr);
+    if (!watched->Overlapped.hEvent)
+    {
+        PZ_LOG_ERROR(JSON, "Watching '{}' failed with {}.", directory, GetLastError());
+        CloseHandle(watched->Handle);
+        return false;
+    }
+
+    // The thread starts the reads, they would be cancelled with the calling thread otherwise.
+    m_Directories.push_back(std::move(watched));
+    SetEvent(m_Wake);
+#else
+    watched->Handle = inotify_add_watch(m_Inotify, directory.c_str(), IN_CLOSE_WRITE | IN_MODIFY | IN_MOVED_TO | IN_CREATE);
+    if (watched->Handle < 0)
+    {
+        PZ_LOG_ERROR(JSON, "Watching '{}' failed with {}.", directory, errno);
+        return false;
+    }
+
+    m_Directories.push_back(std::move(watched));
+#endif
+
+    return true;
+}
+
+
+
+/*
+Only parses when the bytes changed. A reload that fails keeps the document and the old hash,
+the next write of the file tries again.
+*/
+bool PZvend::JsonWatcher::IReload(Document& document)
+{
+    PZ_PROFILE_SCOPE("JsonWatcher::Reload");
+
+    uint64_t hash = 0;
+    if (!HashFile(document.Filepath, hash) || hash == document.Hash)
+        return false;
+
+    JSON*                  json = document.Json;
+    nlohmann::ordered_json patch;
+    if (!json->Reload(patch))
+        return false;
+
+    document.Hash = hash;
+
+    // Collected first, the callbacks may change the subscriptions.
+    std::vector<std::pair<JsonChangeCallback, nlohmann::ordered_json>> calls;
+    for (const Subscription& subscription : document.Subscriptions)
+    {
+        nlohmann::ordered_json operations = nlohmann::ordered_json::array();
+        for (const auto& operation : patch)
+        {
+            if (IsRelated(subscription.Keys, JSON::Path::FromPointer(operation["path"].get_ref<const std::string&>()).GetKeys()))
+                operations.push_back(operation);
+        }
+
+        if (!operations.empty())
+            calls.emplace_back(subscription.Callback, std::move(operations));
+    }
+
+    PZ_LOG_DEBUG(JSON, "Reloaded '{}', {} changes.", document.Filepath, patch.size());
+
+    for (const auto& [callback, operations] : calls)
+        callback(*json, operations);
+
+    return true;
+}
+
+
+
+void PZvend::JsonWatcher::IMarkChanged(const std::string& filepath, std::chrono::steady_clock::time_point now)
+{
+    if (!m_Files.contains(filepath))
+        return;
+
+    m_Changed[filepath] = now;
+    m_Pending.store(true, std::memory_order_release);
+}
+
+
+
+#ifdef PZVEND_IS_WINDOWS
+void PZvend::JsonWatcher::IRun()
+{
+    while (!m_Stop.load(std::memory_order_acquire))
+    {
+        std::vector<HANDLE>     handles = { m_Wake };
+        std::vector<Directory*> directories;
+
+        {
+            std::lock_guard lock(m_Mutex);
+
+            for (auto& directory : m_Directories)
+            {
+                if (!directory->Reading)
+                {
+                    directory->Reading = ReadDirectoryChangesW(directory->Handle, directory->Buffer, sizeof(directory->Buffer), FALSE,
+                                                               FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_SIZE,
+                                                               nullptr, &directory->Overlapped, nullptr);
+                }
+
+                if (directory->Reading && handles.size() < MAXIMUM_WAIT_OBJECTS)
+                {
+                    handles.push_back(directory->Overlapped.hEvent);
+                    directories.push_back(directory.get());
+                }
+            }
+        }
+
+        const DWORD result = WaitForMultipleObjects(static_cast<DWORD>(handles.size()), handles.data(), FALSE, INFINITE);
+        if (result <= WAIT_OBJECT_0 || result >= WAIT_OBJECT_0 + handles.size())
+            continue;
+
+        Directory* directory = directories[result - WAIT_OBJECT_0 - 1];
+        DWORD      size      = 0;
+        const bool read      = GetOverlappedResult(directory->Handle, &directory->Overlapped, &size, FALSE);
+        const auto now       = Clock::now();
+
+        std::lock_guard lock(m_Mutex);
+        directory->Reading = false;
+
+        if (!read)
+            continue;
+
+        // The buffer overflowed, any file of the directory might have changed.
+        if (size == 0)
+        {
+            for (const std::string& filepath : m_Files)
+            {
+                if (std::filesystem::path(filepath).parent_path() == directory->Path)
+                    IMarkChanged(filepath, now);
+            }
+
+            continue;
+        }
+
+        for (size_t offset = 0;;)
+        {
+            const auto* info = reinterpret_cast<const FILE_NOTIFY_INFORMATION*>(directory->Buffer + offset);
+            const auto  name = std::filesystem::path(std::wstring(info->FileName, info->FileNameLength / sizeof(WCHAR)));
+
+            IMarkChanged((std::filesystem::path(directory->Path) / name).lexically_normal().string(), now);
+
+            if (!info->NextEntryOffset)
+                break;
+
+            offset += info->NextEntryOffset;
+        }
+    }
+}
+#else
+void PZvend::JsonWatcher::IRun()
+{
+    alignas(inotify_event) char buffer[16 * 1024];
+
+    for (;;)
+    {
+        pollfd handles[2] = { { m_Inotify, POLLIN, 0 }, { m_Wake, POLLIN, 0 } };
+        if (poll(handles, 2, -1) < 0)
+        {
+            if (errno == EINTR)
+                continue;
+
+            PZ_LOG_ERROR(JSON, "Waiting for file changes failed with {}.", errno);
+            return;
+        }
+
+        if (m_Stop.load(std::memory_order_acquire))
+            return;
+
+        const ssize_t size = read(m_Inotify, buffer, sizeof(buffer));
+        if (size <= 0)
+            continue;
+
+        const auto      now = Clock::now();
+        std::lock_guard lock(m_Mutex);
+
+        for (ssize_t offset = 0; offset < size;)
+        {
+            const auto* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+            offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+
+            // The queue overflowed, any file might have changed.
+            if (event->mask & IN_Q_OVERFLOW)
+            {
+                for (const std::string& filepath : m_Files)
+                    IMarkChanged(filepath, now);
+
+                continue;
+            }
+
+            const auto directory = std::find_if(m_Directories.begin(), m_Directories.end(), [&](const auto& watched) { return watched->Handle == event->wd; });
+            if (directory != m_Directories.end() && event->len)
+                IMarkChanged((std::filesystem::path((*directory)->Path) / event->name).lexically_normal().string(), now);
+        }
+    }
+}
+#endif
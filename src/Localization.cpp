@@ -0,0 +1,588 @@
+#include <ProjectZvend/JSON.hpp>
+#include <ProjectZvend/Localization.hpp>
+#include <ProjectZvend/MappedFile.hpp>
+#include <ProjectZvend/Paths.hpp>
+#include <ProjectZvend/Profiler.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+
+
+namespace
+{
+    /*
+    "<language>.pzl10n": this header, a displacement per bucket (padded to 8 bytes), an entry per
+    slot and the string pool. A key's bucket picks the displacement that sends it to its slot, the
+    slot's key hash confirms the hit. Unused slots are zeroed. Strings in the pool are null terminated.
+    */
+    struct CatalogHeader
+    {
+        uint32_t Magic       = 0x434C5A50; // "PZLC"
+        uint32_t Version     = 2;
+        uint32_t Count       = 0; // Entries.
+        uint32_t BucketCount = 0;
+        uint32_t SlotCount   = 0; // About 10% more than entries, the last buckets still find free slots quickly.
+        uint32_t Reserved    = 0;
+        uint64_t PoolSize    = 0;
+        uint64_t SourceSize  = 0; // Size and write time of the table it was compiled from.
+        int64_t  SourceTime  = 0;
+        uint64_t Checksum    = 0; // FNV-1a over everything before it, then everything after the header.
+    };
+
+    static_assert(sizeof(CatalogHeader) == 56);
+
+    struct CatalogEntry
+    {
+        uint64_t Key    = 0;
+        uint32_t Offset = 0;
+        uint32_t Length = 0;
+    };
+
+    static_assert(sizeof(CatalogEntry) == 16);
+
+
+
+    // One language, mapped until the process ends.
+    struct Catalog
+    {
+        PZvend::MappedFile   File;
+        const CatalogHeader* Header        = nullptr;
+        const int32_t*       Displacements = nullptr;
+        const CatalogEntry*  Entries       = nullptr;
+        const char*          Pool          = nullptr;
+    };
+
+    struct State
+    {
+        std::mutex  Mutex;
+        std::string Directory = ".";
+        std::string Language;
+        std::string FallbackLanguage;
+
+        // nullptr for a language that failed to load, it isn't tried again until the directory changes.
+        std::map<std::string, std::unique_ptr<Catalog>> Catalogs;
+        std::vector<std::unique_ptr<Catalog>>           Retired;
+
+        std::atomic<bool>           Resolved = true;
+        std::atomic<const Catalog*> Current  = nullptr;
+        std::atomic<const Catalog*> Fallback = nullptr;
+    };
+
+
+
+    State& GetState()
+    {
+        static auto* state = new State();
+        return *state;
+    }
+
+
+
+    // splitmix64's finalizer, spreads the FNV-1a bits before the modulo.
+    uint64_t Mix(uint64_t key, uint64_t seed)
+    {
+        uint64_t x = key + seed * 0x9E3779B97F4A7C15ull;
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+        return x ^ (x >> 31);
+    }
+
+
+
+    size_t GetDisplacementsSize(uint32_t bucket_count)
+    {
+        return (static_cast<size_t>(bucket_count) * sizeof(int32_t) + 7) & ~size_t(7);
+    }
+
+
+
+    /*
+    Displacements below 0 place a single key straight into slot -d - 1, the others are seeds for Mix.
+    */
+    const CatalogEntry* Find(const Catalog& catalog, uint64_t key)
+    {
+        const uint32_t slots = catalog.Header->SlotCount;
+        if (!slots)
+            return nullptr;
+
+        const int32_t  displacement = catalog.Displacements[Mix(key, 0) % catalog.Header->BucketCount];
+        const uint64_t slot         = displacement < 0 ? static_cast<uint64_t>(-(displacement + 1)) : Mix(key, static_cast<uint64_t>(displacement)) % slots;
+
+        const CatalogEntry& entry = catalog.Entries[slot];
+        return entry.Key == key ? &entry : nullptr;
+    }
+
+
+
+    bool GetSourceStamp(const std::string& filepath, CatalogHeader& header)
+    {
+        std::error_code error;
+        const auto      size = std::filesystem::file_size(filepath, error);
+        if (error)
+            return false;
+
+        const auto time = std::filesystem::last_write_time(filepath, error);
+        if (error)
+            return false;
+
+        header.SourceSize = static_cast<uint64_t>(size);
+        header.SourceTime = static_cast<int64_t>(time.time_since_epoch().count());
+        return true;
+    }
+
+
+
+    uint64_t GetChecksum(const CatalogHeader& header, const uint8_t* body, size_t size)
+    {
+        const uint64_t seed = PZvend::Fnv1a(std::string_view(reinterpret_cast<const char*>(&header), offsetof(CatalogHeader, Checksum)));
+        return PZvend::Fnv1a(std::string_view(reinterpret_cast<const char*>(body), size), seed);
+    }
+
+
+
+    /*
+    @param stamp The table's size and write time, nullptr if there is no table to compare with.
+    @return Returns false if the catalog is missing, damaged or older than the table.
+    */
+    bool OpenCatalog(const std::string& filepath, Catalog& catalog, const CatalogHeader* stamp)
+    {
+        std::error_code error;
+        if (!std::filesystem::exists(filepath, error) || !catalog.File.Open(filepath))
+            return false;
+
+        const uint8_t* data = catalog.File.GetData();
+        const size_t   size = catalog.File.GetSize();
+        if (size < sizeof(CatalogHeader))
+            return false;
+
+        const auto* header = reinterpret_cast<const CatalogHeader*>(data);
+        if (header->Magic != CatalogHeader().Magic || header->Version != CatalogHeader().Version || !header->BucketCount)
+            return false;
+
+        if (stamp && (header->SourceSize != stamp->SourceSize || header->SourceTime != stamp->SourceTime))
+            return false;
+
+        if (header->Count > header->SlotCount)
+            return false;
+
+        const size_t displacements = GetDisplacementsSize(header->BucketCount);
+        const size_t entries       = static_cast<size_t>(header->SlotCount) * sizeof(CatalogEntry);
+        if (header->PoolSize > size || size != sizeof(CatalogHeader) + displacements + entries + header->PoolSize)
+            return false;
+
+        if (header->Checksum != GetChecksum(*header, data + sizeof(CatalogHeader), size - sizeof(CatalogHeader)))
+            return false;
+
+        catalog.Header        = header;
+        catalog.Displacements = reinterpret_cast<const int32_t*>(data + sizeof(CatalogHeader));
+        catalog.Entries       = reinterpret_cast<const CatalogEntry*>(data + sizeof(CatalogHeader) + displacements);
+        catalog.Pool          = reinterpret_cast<const char*>(data + sizeof(CatalogHeader) + displacements + entries);
+
+        // A catalog without a table is used as it is, a well-formed but wrong one must not send Find or Get outside the file.
+        for (uint32_t bucket = 0; bucket < header->BucketCount; bucket++)
+        {
+            const int32_t displacement = catalog.Displacements[bucket];
+            if (displacement < 0 && static_cast<uint64_t>(-(static_cast<int64_t>(displacement) + 1)) >= header->SlotCount)
+                return false;
+        }
+
+        for (uint32_t slot = 0; slot < header->SlotCount; slot++)
+        {
+            const CatalogEntry& entry = catalog.Entries[slot];
+            const uint64_t      end   = static_cast<uint64_t>(entry.Offset) + entry.Length;
+
+            if (!entry.Key && !entry.Offset && !entry.Length)
+                continue;
+
+            if (end >= header->PoolSize || catalog.Pool[end] != '\0')
+                return false;
+        }
+
+        return true;
+    }
+
+
+
+    /*
+    Compiles the table first if the catalog doesn't match it. Called with the state locked.
+    */
+    const Catalog* LoadCatalog(State& state, const std::string& language)
+    {
+        if (language.empty())
+            return nullptr;
+
+        if (const auto it = state.Catalogs.find(language); it != state.Catalogs.end())
+            return it->second.get();
+
+        PZ_PROFILE_SCOPE("L10n::Load");
+
+        const auto        directory    = std::filesystem::path(state.Directory);
+        const std::string source_path  = (directory / (language + ".json")).string();
+        const std::string catalog_path = (directory / (language + ".pzl10n")).string();
+
+        CatalogHeader stamp;
+        const bool    has_source = GetSourceStamp(source_path, stamp);
+
+        auto catalog = std::make_unique<Catalog>();
+        if (!OpenCatalog(catalog_path, *catalog, has_source ? &stamp : nullptr))
+        {
+            std::string error = "Neither '" + source_path + "' nor '" + catalog_path + "' could be read.";
+
+            catalog->File.Close();
+            if (!has_source || !PZvend::L10n::Compile(source_path, catalog_path, error) || !OpenCatalog(catalog_path, *catalog, nullptr))
+            {
+                PZ_LOG_ERROR(L10N, "Loading '{}' failed: {}", language, error);
+                catalog.reset();
+            }
+        }
+
+        return (state.Catalogs[language] = std::move(catalog)).get();
+    }
+
+
+
+    void Resolve(State& state)
+    {
+        std::lock_guard lock(state.Mutex);
+
+        if (state.Resolved.load(std::memory_order_relaxed))
+            return;
+
+        state.Current.store(LoadCatalog(state, state.Language), std::memory_order_release);
+        state.Fallback.store(LoadCatalog(state, state.FallbackLanguage), std::memory_order_release);
+        state.Resolved.store(true, std::memory_order_release);
+    }
+
+
+
+    /*
+    Tables are parsed into nlohmann::json, the catalog doesn't keep the key order anyway.
+    ordered_json searches its keys linearly on every insert, 100k keys took half a minute.
+    */
+    bool ParseTable(const std::string& filepath, nlohmann::json& out_json, std::string& error)
+    {
+        PZvend::MappedFile file;
+        if (!file.Open(filepath))
+        {
+            error = "Could not map '" + filepath + "'.";
+            return false;
+        }
+
+        const auto* begin = reinterpret_cast<const char*>(file.GetData());
+
+        try
+        {
+            out_json = nlohmann::json::parse(begin, begin + file.GetSize());
+        }
+        catch (const nlohmann::json::exception& e)
+        {
+            error = "Parsing '" + filepath + "' failed: " + e.what();
+            return false;
+        }
+
+        return true;
+    }
+
+
+
+    /*
+    Nested objects join their keys with '.', every leaf has to be a string.
+    */
+    bool Flatten(const nlohmann::json& json, const std::string& prefix, std::vector<std::pair<std::string, std::string>>& out_strings, std::string& error)
+    {
+        for (const auto& [key, value] : json.items())
+        {
+            const std::string path = prefix.empty() ? key : prefix + '.' + key;
+
+            if (value.is_object())
+            {
+                if (!Flatten(value, path, out_strings, error))
+                    return false;
+            }
+            else if (value.is_string())
+                out_strings.emplace_back(path, value.get<std::string>());
+            else
+            {
+                error = "'" + path + "' is " + value.type_name() + ", expected a string or an object.";
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+
+
+    /*
+    Hash and displace: buckets of about four keys, the largest placed first while most slots are
+    free. Each searches for a seed that sends all its keys to free slots, single keys take the next
+    free slot directly. The spare slots keep the search short for the buckets placed last.
+    */
+    bool BuildIndex(const std::vector<CatalogEntry>& keys, uint32_t bucket_count, uint32_t slot_count, std::vector<int32_t>& out_displacements, std::vector<CatalogEntry>& out_slots, std::string& error)
+    {
+        const uint32_t count = static_cast<uint32_t>(keys.size());
+
+        std::vector<std::vector<uint32_t>> buckets(bucket_count);
+        for (uint32_t i = 0; i < count; i++)
+            buckets[Mix(keys[i].Key, 0) % bucket_count].push_back(i);
+
+        std::vector<uint32_t> order(bucket_count);
+        for (uint32_t i = 0; i < bucket_count; i++)
+            order[i] = i;
+
+        std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return buckets[a].size() > buckets[b].size(); });
+
+        out_displacements.assign(bucket_count, 0);
+        out_slots.assign(slot_count, CatalogEntry());
+
+        std::vector<bool>     used(slot_count, false);
+        std::vector<uint64_t> candidates;
+        uint32_t              next_free = 0;
+
+        for (const uint32_t bucket : order)
+        {
+            const auto& members = buckets[bucket];
+            if (members.empty())
+                break;
+
+            if (members.size() == 1)
+            {
+                while (used[next_free])
+                    next_free++;
+
+                used[next_free]            = true;
+                out_slots[next_free]       = keys[members[0]];
+                out_displacements[bucket]  = -static_cast<int32_t>(next_free) - 1;
+                continue;
+            }
+
+            bool placed = false;
+            for (uint32_t displacement = 1; displacement < (1u << 24) && !placed; displacement++)
+            {
+                candidates.clear();
+                for (const uint32_t member : members)
+                {
+                    const uint64_t slot = Mix(keys[member].Key, displacement) % slot_count;
+                    if (used[slot] || std::find(candidates.begin(), candidates.end(), slot) != candidates.end())
+                        break;
+
+                    candidates.push_back(slot);
+                }
+
+                if (candidates.size() != members.size())
+                    continue;
+
+                for (size_t i = 0; i < members.size(); i++)
+                {
+                    used[candidates[i]]      = true;
+                    out_slots[candidates[i]] = keys[members[i]];
+                }
+
+                out_displacements[bucket] = static_cast<int32_t>(displacement);
+                placed                    = true;
+            }
+
+            if (!placed)
+            {
+                error = "No displacement places bucket " + std::to_string(bucket) + ".";
+                return false;
+            }
+        }
+
+        return true;
+    }
+}
+
+
+
+bool PZvend::L10n::Compile(const std::string& source, const std::string& catalog, std::string& error)
+{
+    PZ_PROFILE_SCOPE("L10n::Compile");
+
+    // Taken before reading, a table edited meanwhile leaves a catalog that is already stale.
+    CatalogHeader header;
+    if (!GetSourceStamp(source, header))
+    {
+        error = "'" + source + "' does not exist.";
+        return false;
+    }
+
+    nlohmann::json json;
+    if (!ParseTable(source, json, error))
+        return false;
+
+    if (!json.is_object())
+    {
+        error = "'" + source + "' is not an object.";
+        return false;
+    }
+
+    std::vector<std::pair<std::string, std::string>> strings;
+    if (!Flatten(json, "", strings, error))
+        return false;
+
+    // Equal translations share their pool bytes.
+    std::vector<CatalogEntry>                      keys;
+    std::unordered_map<uint64_t, std::string_view> names;
+    std::unordered_map<std::string_view, uint32_t> offsets;
+    std::vector<char>                              pool;
+
+    pool.reserve(strings.size() * 16);
+    for (const auto& [name, text] : strings)
+    {
+        CatalogEntry entry;
+        entry.Key    = Fnv1a(name);
+        entry.Length = static_cast<uint32_t>(text.size());
+
+        if (const auto [it, inserted] = names.try_emplace(entry.Key, name); !inserted)
+        {
+            error = "'" + name + "' and '" + std::string(it->second) + "' have the same hash.";
+            return false;
+        }
+
+        if (const auto it = offsets.find(text); it != offsets.end())
+            entry.Offset = it->second;
+        else
+        {
+            entry.Offset = static_cast<uint32_t>(pool.size());
+            offsets.emplace(text, entry.Offset);
+            pool.insert(pool.end(), text.begin(), text.end());
+            pool.push_back('\0');
+        }
+
+        keys.push_back(entry);
+    }
+
+    header.Count       = static_cast<uint32_t>(keys.size());
+    header.BucketCount = std::max<uint32_t>(1, (header.Count + 3) / 4);
+    header.SlotCount   = static_cast<uint32_t>((static_cast<uint64_t>(header.Count) * 10 + 8) / 9);
+    header.PoolSize    = pool.size();
+
+    std::vector<int32_t>      displacements;
+    std::vector<CatalogEntry> slots;
+    if (!BuildIndex(keys, header.BucketCount, header.SlotCount, displacements, slots, error))
+        return false;
+
+    std::vector<uint8_t> body(GetDisplacementsSize(header.BucketCount) + slots.size() * sizeof(CatalogEntry) + pool.size(), 0);
+    uint8_t*             position = body.data();
+
+    std::memcpy(position, displacements.data(), displacements.size() * sizeof(int32_t));
+    position += GetDisplacementsSize(header.BucketCount);
+    std::memcpy(position, slots.data(), slots.size() * sizeof(CatalogEntry));
+    position += slots.size() * sizeof(CatalogEntry);
+    std::memcpy(position, pool.data(), pool.size());
+
+    header.Checksum = GetChecksum(header, body.data(), body.size());
+
+    // A torn catalog fails its checksum and gets compiled again, writing aside is enough.
+    const std::string temp_path = catalog + ".tmp";
+    if (!Path::Create(catalog))
+    {
+        error = "Could not create the directory of '" + catalog + "'.";
+        return false;
+    }
+
+    {
+        std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(body.data()), static_cast<std::streamsize>(body.size()));
+
+        if (!file)
+        {
+            error = "Writing '" + temp_path + "' failed.";
+            return false;
+        }
+    }
+
+    std::error_code rename_error;
+    std::filesystem::rename(temp_path, catalog, rename_error);
+    if (rename_error)
+    {
+        error = "Replacing '" + catalog + "' failed: " + rename_error.message();
+        std::filesystem::remove(temp_path, rename_error);
+        return false;
+    }
+
+    return true;
+}
+
+
+
+void PZvend::L10n::SetDirectory(const std::string& directory)
+{
+    State&          state = GetState();
+    std::lock_guard lock(state.Mutex);
+
+    // Views into the old catalogs may still be in use.
+    for (auto& [language, catalog] : state.Catalogs)
+    {
+        if (catalog)
+            state.Retired.push_back(std::move(catalog));
+    }
+
+    state.Catalogs.clear();
+    state.Directory = directory;
+    state.Resolved.store(false, std::memory_order_release);
+}
+
+
+
+void PZvend::L10n::SetLanguage(const std::string& language)
+{
+    State&          state = GetState();
+    std::lock_guard lock(state.Mutex);
+
+    state.Language = language;
+    state.Resolved.store(false, std::memory_order_release);
+}
+
+
+
+void PZvend::L10n::SetFallbackLanguage(const std::string& language)
+{
+    State&          state = GetState();
+    std::lock_guard lock(state.Mutex);
+
+    state.FallbackLanguage = language;
+    state.Resolved.store(false, std::memory_order_release);
+}
+
+
+
+std::string PZvend::L10n::GetLanguage()
+{
+    State&          state = GetState();
+    std::lock_guard lock(state.Mutex);
+    return state.Language;
+}
+
+
+
+std::string_view PZvend::L10n::Get(uint64_t key)
+{
+    State& state = GetState();
+
+    if (!state.Resolved.load(std::memory_order_acquire))
+        Resolve(state);
+
+    for (const Catalog* catalog : { state.Current.load(std::memory_order_acquire), state.Fallback.load(std::memory_order_acquire) })
+    {
+        if (!catalog)
+            continue;
+
+        if (const CatalogEntry* entry = Find(*catalog, key))
+            return std::string_view(catalog->Pool + entry->Offset, entry->Length);
+    }
+
+    return "";
+}
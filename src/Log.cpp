@@ -0,0 +1,203 @@
+#include "ProjectZvend/Log.hpp"
+#include "ProjectZvend/Hash.hpp"
+
+#include <array>
+#include <functional>
+#include <vector>
+
+
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    struct Subsystem
+    {
+        std::atomic<spdlog::logger*> Logger = nullptr;
+        std::atomic<int>             Level  = spdlog::level::trace;
+
+        std::atomic<double>  PerSecond    = PZvend::LogLimits().PerSecond;
+        std::atomic<double>  Burst        = PZvend::LogLimits().Burst;
+        std::atomic<int64_t> RepeatWindow = PZvend::LogLimits().RepeatWindow.count();
+
+        std::atomic<uint64_t> Written     = 0;
+        std::atomic<uint64_t> Repeated    = 0;
+        std::atomic<uint64_t> RateLimited = 0;
+    };
+
+    std::array<Subsystem, PZvend::LOG_SUBSYSTEM_COUNT> g_Subsystems;
+
+    // Every logger ever set, a raw pointer might still be in use on another thread.
+    std::mutex                                   g_LoggersMutex;
+    std::vector<std::shared_ptr<spdlog::logger>> g_Loggers;
+
+
+
+    spdlog::logger* GetLogger(const Subsystem& subsystem)
+    {
+        spdlog::logger* logger = subsystem.Logger.load(std::memory_order_acquire);
+        return logger ? logger : spdlog::default_logger_raw();
+    }
+}
+
+
+
+spdlog::logger* PZvend::LogSite::Acquire()
+{
+    Subsystem& subsystem = g_Subsystems[m_Subsystem];
+
+    if (m_Level < subsystem.Level.load(std::memory_order_relaxed))
+        return nullptr;
+
+    spdlog::logger* logger = GetLogger(subsystem);
+    if (!logger || !logger->should_log(m_Level))
+        return nullptr;
+
+    const double per_second = subsystem.PerSecond.load(std::memory_order_relaxed);
+    if (per_second <= 0.0)
+        return logger;
+
+    const double burst = subsystem.Burst.load(std::memory_order_relaxed);
+    const auto   now   = Clock::now();
+
+    std::lock_guard lock(m_Mutex);
+
+    if (m_LastRefill == Clock::time_point())
+        m_Tokens = burst;
+    else
+        m_Tokens = std::min(burst, m_Tokens + std::chrono::duration<double>(now - m_LastRefill).count() * per_second);
+
+    m_LastRefill = now;
+
+    if (m_Tokens < 1.0)
+    {
+        m_RateLimited++;
+        subsystem.RateLimited.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    m_Tokens -= 1.0;
+    return logger;
+}
+
+
+
+/*
+Reports what the site dropped since its last line before writing the new one.
+*/
+void PZvend::LogSite::Emit(spdlog::logger* logger, std::string_view text)
+{
+    Subsystem&    subsystem = g_Subsystems[m_Subsystem];
+    const int64_t window    = subsystem.RepeatWindow.load(std::memory_order_relaxed);
+    const auto    name      = LogSubsystemToString(m_Subsystem);
+    const auto    hash      = std::hash<std::string_view>()(text);
+    const auto    now       = Clock::now();
+
+    // Seeded with the site's location, so a line only ever matches one from the same site.
+    const uint64_t check = Fnv1a(text, Fnv1a(m_Location.filename ? m_Location.filename : "") + static_cast<uint64_t>(m_Location.line));
+
+    uint64_t repeats      = 0;
+    uint64_t rate_limited = 0;
+
+    {
+        std::lock_guard lock(m_Mutex);
+
+        if (window > 0 && hash == m_LastHash && check == m_LastCheck && text.size() == m_LastSize && m_LastLine != Clock::time_point() && now - m_LastLine < std::chrono::milliseconds(window))
+        {
+            m_Repeats++;
+            subsystem.Repeated.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        repeats       = m_Repeats;
+        rate_limited  = m_RateLimited;
+        m_Repeats     = 0;
+        m_RateLimited = 0;
+        m_LastHash    = hash;
+        m_LastCheck   = check;
+        m_LastSize    = text.size();
+        m_LastLine    = now;
+    }
+
+    if (repeats)
+        logger->log(m_Location, m_Level, "[{}] Last message repeated {} times.", name, repeats);
+
+    if (rate_limited)
+        logger->log(m_Location, m_Level, "[{}] {} messages dropped by the rate limit.", name, rate_limited);
+
+    logger->log(m_Location, m_Level, "[{}] {}", name, text);
+    subsystem.Written.fetch_add(1, std::memory_order_relaxed);
+}
+
+
+
+void PZvend::SetLogLogger(LogSubsystem subsystem, std::shared_ptr<spdlog::logger> logger)
+{
+    std::lock_guard lock(g_LoggersMutex);
+
+    g_Subsystems[subsystem].Logger.store(logger.get(), std::memory_order_release);
+    if (logger)
+        g_Loggers.push_back(std::move(logger));
+}
+
+
+
+void PZvend::SetLogLevel(LogSubsystem subsystem, spdlog::level::level_enum level)
+{
+    g_Subsystems[subsystem].Level.store(level, std::memory_order_relaxed);
+}
+
+
+
+spdlog::level::level_enum PZvend::GetLogLevel(LogSubsystem subsystem)
+{
+    return static_cast<spdlog::level::level_enum>(g_Subsystems[subsystem].Level.load(std::memory_order_relaxed));
+}
+
+
+
+void PZvend::SetLogLimits(LogSubsystem subsystem, const LogLimits& limits)
+{
+    g_Subsystems[subsystem].PerSecond.store(limits.PerSecond, std::memory_order_relaxed);
+    g_Subsystems[subsystem].Burst.store(std::max(limits.Burst, 1.0), std::memory_order_relaxed);
+    g_Subsystems[subsystem].RepeatWindow.store(limits.RepeatWindow.count(), std::memory_order_relaxed);
+}
+
+
+
+PZvend::LogLimits PZvend::GetLogLimits(LogSubsystem subsystem)
+{
+    LogLimits limits;
+    limits.PerSecond    = g_Subsystems[subsystem].PerSecond.load(std::memory_order_relaxed);
+    limits.Burst        = g_Subsystems[subsystem].Burst.load(std::memory_order_relaxed);
+    limits.RepeatWindow = std::chrono::milliseconds(g_Subsystems[subsystem].RepeatWindow.load(std::memory_order_relaxed));
+    return limits;
+}
+
+
+
+PZvend::LogCounters PZvend::GetLogCounters(LogSubsystem subsystem)
+{
+    LogCounters counters;
+    counters.Written     = g_Subsystems[subsystem].Written.load(std::memory_order_relaxed);
+    counters.Repeated    = g_Subsystems[subsystem].Repeated.load(std::memory_order_relaxed);
+    counters.RateLimited = g_Subsystems[subsystem].RateLimited.load(std::memory_order_relaxed);
+    return counters;
+}
+
+
+
+const char* PZvend::LogSubsystemToString(LogSubsystem subsystem)
+{
+    switch (subsystem)
+    {
+        case LOG_SUBSYSTEM_MEMORY:  return "Memory";
+        case LOG_SUBSYSTEM_HOOKS:   return "Hooks";
+        case LOG_SUBSYSTEM_JSON:    return "JSON";
+        case LOG_SUBSYSTEM_PATHS:   return "Paths";
+        case LOG_SUBSYSTEM_L10N:    return "L10n";
+        case LOG_SUBSYSTEM_LOGGING: return "Logging";
+        case LOG_SUBSYSTEM_TIMING:  return "Timing";
+        default:                    return "Unknown";
+    }
+}
@@ -0,0 +1,393 @@
+#include "ProjectZvend/Logger.hpp"
+
+#include "ProjectZvend/MappedRingSink.hpp"
+#include "ProjectZvend/Paths.hpp"
+
+#include <spdlog/sinks/rotating_file_sink.h>
+#include <spdlog/sinks/stdout_color_sinks.h>
+
+#include <ctime>
+#include <iomanip>
+#include <stdexcept>
+
+
+
+namespace
+{
+    spdlog::level::level_enum GetDefaultLevel()
+    {
+    #ifdef _DEBUG
+        return spdlog::level::debug;
+    #else
+        return spdlog::level::info;
+    #endif
+    }
+
+
+
+    std::vector<spdlog::sink_ptr> CreateSinks(const PZvend::LoggerConfig& config, spdlog::level::level_enum level)
+    {
+        std::vector<spdlog::sink_ptr> sinks;
+
+        if (config.HasConsole)
+        {
+            auto stdoutSink = std::make_shared<spdlog::sinks::stdout_color_sink_mt>();
+
+        #ifdef _WIN32
+            stdoutSink->set_color(spdlog::level::trace   , PZvend::LogColor::Foreground_Intense_Cyan);
+            stdoutSink->set_color(spdlog::level::debug   , PZvend::LogColor::Foreground_Cyan);
+            stdoutSink->set_color(spdlog::level::info    , PZvend::LogColor::Foreground_Green);
+            stdoutSink->set_color(spdlog::level::warn    , PZvend::LogColor::Foreground_Intense_Yellow);
+            stdoutSink->set_color(spdlog::level::err     , PZvend::LogColor::Foreground_Intense_Red);
+            stdoutSink->set_color(spdlog::level::critical, PZvend::LogColor::Foreground_Intense_White | PZvend::LogColor::Background_Red);
+        #else
+            // ANSI terminals take escape sequences instead of console attributes.
+            stdoutSink->set_color(spdlog::level::trace   , stdoutSink->cyan);
+            stdoutSink->set_color(spdlog::level::debug   , stdoutSink->cyan);
+            stdoutSink->set_color(spdlog::level::info    , stdoutSink->green);
+            stdoutSink->set_color(spdlog::level::warn    , stdoutSink->yellow_bold);
+            stdoutSink->set_color(spdlog::level::err     , stdoutSink->red_bold);
+            stdoutSink->set_color(spdlog::level::critical, stdoutSink->bold_on_red);
+        #endif
+
+            stdoutSink->set_pattern("[%T][%n][%^%l%$] %v");
+            stdoutSink->set_level(level);
+            sinks.push_back(stdoutSink);
+        }
+
+        if (!config.Path.empty())
+        {
+            std::tm     timeinfo;
+            std::time_t current_time = std::time(nullptr);
+        #ifdef _WIN32
+            localtime_s(&timeinfo, &current_time);
+        #else
+            localtime_r(&current_time, &timeinfo);
+        #endif
+
+            if (!PZvend::Path::Create(config.Path))
+                throw std::runtime_error("Path could not be created.");
+
+            std::ostringstream oss;
+            oss << config.Path;
+            if (!(config.Path.ends_with('/')))
+                oss << '/';
+            oss << std::put_time(&timeinfo, "%Y-%m-%d.log");
+
+            auto rotatingSink = std::make_shared<spdlog::sinks::rotating_file_sink_mt>(oss.str(), config.MaxFileSize, config.MaxFiles);
+            rotatingSink->set_pattern("[%T][%n][%l] %v");
+            rotatingSink->set_level(level);
+            sinks.push_back(rotatingSink);
+        }
+
+        return sinks;
+    }
+}
+
+
+
+PZvend::AsyncLogSink::AsyncLogSink(std::vector<spdlog::sink_ptr> sinks, const LoggerConfig& config)
+    : m_Sinks(std::move(sinks))
+    , m_Ring(std::max<std::size_t>(config.QueueSize, 1))
+    , m_Overflow(config.Overflow)
+    , m_FlushInterval(config.FlushInterval)
+    , m_FlushBytes(config.FlushBytes)
+    , m_FlushLevel(config.FlushLevel)
+{
+    m_Thread = std::thread(&AsyncLogSink::IRun, this);
+}
+
+
+
+PZvend::AsyncLogSink::~AsyncLogSink()
+{
+    Stop();
+}
+
+
+
+/*
+The message is copied before taking the lock, under it there is only a move into the slot.
+*/
+void PZvend::AsyncLogSink::log(const spdlog::details::log_msg& msg)
+{
+    spdlog::details::log_msg_buffer copy(msg);
+
+    std::unique_lock lock(m_Mutex);
+
+    if (m_Size == m_Ring.size() && !m_Stopping)
+    {
+        switch (m_Overflow)
+        {
+            case LOG_OVERFLOW_BLOCK:
+                m_Metrics.Blocked++;
+                m_NotFull.wait(lock, [this]() { return m_Size < m_Ring.size() || m_Stopping; });
+                break;
+
+            case LOG_OVERFLOW_OVERWRITE_OLDEST:
+                m_Head = (m_Head + 1) % m_Ring.size();
+                m_Size--;
+                m_Popped++;
+                m_Metrics.Overwritten++;
+                break;
+
+            default:
+                m_Metrics.DroppedNewest++;
+                return;
+        }
+    }
+
+    if (m_Stopping)
+    {
+        m_Metrics.DroppedNewest++;
+        return;
+    }
+
+    m_Ring[(m_Head + m_Size) % m_Ring.size()] = std::move(copy);
+    m_Size++;
+    m_Metrics.Enqueued++;
+    m_Metrics.MaxQueueDepth = std::max(m_Metrics.MaxQueueDepth, m_Size);
+
+    lock.unlock();
+    m_NotEmpty.notify_one();
+}
+
+
+
+/*
+Blocks until every message queued before the call is written and the sinks are flushed.
+*/
+void PZvend::AsyncLogSink::flush()
+{
+    std::unique_lock lock(m_Mutex);
+
+    if (m_Stopping)
+    {
+        lock.unlock();
+        IFlushSinks();
+        return;
+    }
+
+    m_FlushTarget = std::max(m_FlushTarget, m_Popped + m_Size);
+    const uint64_t ticket = ++m_FlushRequests;
+
+    m_NotEmpty.notify_one();
+    m_Flushed.wait(lock, [this, ticket]() { return m_FlushesHandled >= ticket; });
+}
+
+
+
+void PZvend::AsyncLogSink::set_pattern(const std::string& pattern)
+{
+    for (auto& sink : m_Sinks)
+        sink->set_pattern(pattern);
+}
+
+
+
+void PZvend::AsyncLogSink::set_formatter(std::unique_ptr<spdlog::formatter> sink_formatter)
+{
+    for (auto& sink : m_Sinks)
+        sink->set_formatter(sink_formatter->clone());
+}
+
+
+
+void PZvend::AsyncLogSink::Stop()
+{
+    {
+        std::lock_guard lock(m_Mutex);
+        m_Stopping = true;
+    }
+
+    m_NotEmpty.notify_all();
+    m_NotFull.notify_all();
+
+    if (m_Thread.joinable() && m_Thread.get_id() != std::this_thread::get_id())
+        m_Thread.join();
+}
+
+
+
+PZvend::LoggerMetrics PZvend::AsyncLogSink::GetMetrics() const
+{
+    std::lock_guard lock(m_Mutex);
+
+    LoggerMetrics metrics = m_Metrics;
+    metrics.QueueDepth    = m_Size;
+    return metrics;
+}
+
+
+
+/*
+Writer thread. Takes one message at a time and writes it with the lock released, so loggers
+only ever wait for a slot copy. Flushes when a message reaches the flush level, when enough
+bytes piled up, when the interval passed with unflushed data, or when flush() asks for it.
+*/
+void PZvend::AsyncLogSink::IRun()
+{
+    using Clock = std::chrono::steady_clock;
+
+    spdlog::details::log_msg_buffer current;
+    Clock::time_point               last_flush = Clock::now();
+    std::size_t                     unflushed  = 0;
+    bool                            dirty      = false;
+
+    std::unique_lock lock(m_Mutex);
+
+    for (;;)
+    {
+        const auto has_work = [this]() { return m_Size || m_Stopping || m_FlushesHandled != m_FlushRequests; };
+
+        if (dirty && m_FlushInterval.count() > 0)
+            m_NotEmpty.wait_until(lock, last_flush + m_FlushInterval, has_work);
+        else
+            m_NotEmpty.wait(lock, has_work);
+
+        bool flush = false;
+
+        if (m_Size)
+        {
+            current = m_Ring[m_Head];
+            m_Head  = (m_Head + 1) % m_Ring.size();
+            m_Size--;
+            m_Popped++;
+
+            lock.unlock();
+            m_NotFull.notify_one();
+
+            bool failed = false;
+            for (auto& sink : m_Sinks)
+            {
+                if (!sink->should_log(current.level))
+                    continue;
+
+                try
+                {
+                    sink->log(current);
+                }
+                catch (const std::exception&)
+                {
+                    failed = true;
+                }
+            }
+
+            unflushed += current.payload.size();
+            dirty      = true;
+            flush      = current.level >= m_FlushLevel || (m_FlushBytes && unflushed >= m_FlushBytes);
+
+            lock.lock();
+            m_Metrics.Written++;
+            m_Metrics.WriteErrors += failed;
+        }
+
+        const bool     requested = m_FlushesHandled != m_FlushRequests && m_Popped >= m_FlushTarget;
+        const uint64_t requests  = m_FlushRequests;
+        const bool     draining  = m_Stopping && m_Size == 0;
+
+        flush = flush || requested || (dirty && draining);
+        flush = flush || (dirty && m_FlushInterval.count() > 0 && Clock::now() - last_flush >= m_FlushInterval);
+
+        if (flush)
+        {
+            lock.unlock();
+            IFlushSinks();
+            lock.lock();
+
+            last_flush = Clock::now();
+            unflushed  = 0;
+            dirty      = false;
+            m_Metrics.Flushes++;
+        }
+
+        if (requested || draining)
+        {
+            m_FlushesHandled = draining ? m_FlushRequests : requests;
+            m_Flushed.notify_all();
+        }
+
+        if (draining)
+            break;
+    }
+}
+
+
+
+void PZvend::AsyncLogSink::IFlushSinks()
+{
+    for (auto& sink : m_Sinks)
+    {
+        try
+        {
+            sink->flush();
+        }
+        catch (const std::exception&)
+        {
+        }
+    }
+}
+
+
+
+std::shared_ptr<spdlog::logger> PZvend::CreateLogger(const std::string& name, bool has_console, const std::string& path, std::size_t max_file_size, std::size_t max_files)
+{
+    LoggerConfig config;
+    config.HasConsole  = has_console;
+    config.Path        = path;
+    config.MaxFileSize = max_file_size;
+    config.MaxFiles    = max_files;
+    config.FlushLevel  = GetDefaultLevel();
+
+    return CreateLogger(name, config);
+}
+
+
+
+std::shared_ptr<spdlog::logger> PZvend::CreateLogger(const std::string& name, const LoggerConfig& config)
+{
+    const auto level = GetDefaultLevel();
+    auto       sinks = CreateSinks(config, level);
+
+    // Sinks behind an AsyncLogSink lose their queue in a crash, the ring is written right away.
+    std::vector<spdlog::sink_ptr> direct;
+    if (config.Async)
+        direct.push_back(std::make_shared<AsyncLogSink>(std::move(sinks), config));
+    else
+        direct = std::move(sinks);
+
+    if (!config.RingPath.empty())
+    {
+        auto ringSink = std::make_shared<MappedRingSink>(config.RingPath, config.RingSize);
+        if (!ringSink->IsOpen())
+            throw std::runtime_error("Ring log could not be mapped.");
+
+        ringSink->set_level(level);
+        direct.push_back(ringSink);
+    }
+
+    auto logger = std::make_shared<spdlog::logger>(name, direct.begin(), direct.end());
+
+    // A logger side flush would block on the writer, the async sink applies the flush policy itself.
+    // The ring sink's flush does nothing, it doesn't matter here.
+    logger->flush_on(config.Async ? spdlog::level::off : config.FlushLevel);
+
+    logger->set_level(level);
+    return logger;
+}
+
+
+
+bool PZvend::GetLoggerMetrics(const std::shared_ptr<spdlog::logger>& logger, LoggerMetrics& metrics)
+{
+    for (const auto& sink : logger->sinks())
+    {
+        if (auto async = std::dynamic_pointer_cast<AsyncLogSink>(sink))
+        {
+            metrics = async->GetMetrics();
+            return true;
+        }
+    }
+
+    return false;
+}
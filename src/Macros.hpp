@@ -8,7 +8,7 @@
     #else
         #define PZVEND_IS_X32
     #endif
-#elif defined(linux) || defined(__linux) || defined(__linux__) || defined(__gnu_linux__))
+#elif defined(linux) || defined(__linux) || defined(__linux__) || defined(__gnu_linux__)
     #define PZVEND_IS_LINUX
 
     // TODO: i should see if there are significant differences in win32/64 and linux32/64 for assembly or if i can just unify them like that.
@@ -17,8 +17,6 @@
     #else
         #define PZVEND_IS_X32
     #endif
-
-    #error Linux is not yet supported
 #else
     #error Unsupported OS
 #endif
\ No newline at end of file
@@ -0,0 +1,151 @@
+#include "ProjectZvend/MappedFile.hpp"
+#include "ProjectZvend/Log.hpp"
+
+#include "Macros.hpp"
+
+#ifdef PZVEND_IS_WINDOWS
+    #include <Windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+
+
+
+PZvend::MappedFile::MappedFile(const std::string& filepath)
+{
+    Open(filepath);
+}
+
+PZvend::MappedFile::~MappedFile()
+{
+    Close();
+}
+
+PZvend::MappedFile::MappedFile(MappedFile&& other) noexcept
+{
+    *this = std::move(other);
+}
+
+PZvend::MappedFile& PZvend::MappedFile::operator=(MappedFile&& other) noexcept
+{
+    if (this == &other)
+        return *this;
+
+    Close();
+
+    std::swap(m_Data, other.m_Data);
+    std::swap(m_Size, other.m_Size);
+    std::swap(m_File, other.m_File);
+#ifdef PZVEND_IS_WINDOWS
+    std::swap(m_Mapping, other.m_Mapping);
+#endif
+
+    return *this;
+}
+
+
+
+bool PZvend::MappedFile::Open(const std::string& filepath)
+{
+    Close();
+
+#ifdef PZVEND_IS_WINDOWS
+    HANDLE file = CreateFileA(filepath.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        PZ_LOG_ERROR(MEMORY, "Opening '{}' failed with {}.", filepath, GetLastError());
+        return false;
+    }
+
+    LARGE_INTEGER size = {};
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+    {
+        CloseHandle(file);
+        return false;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping)
+    {
+        PZ_LOG_ERROR(MEMORY, "Mapping '{}' failed with {}.", filepath, GetLastError());
+        CloseHandle(file);
+        return false;
+    }
+
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!view)
+    {
+        PZ_LOG_ERROR(MEMORY, "Viewing '{}' failed with {}.", filepath, GetLastError());
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+
+    m_File    = file;
+    m_Mapping = mapping;
+    m_Data    = static_cast<uint8_t*>(view);
+    m_Size    = static_cast<size_t>(size.QuadPart);
+#else
+    int file = open(filepath.c_str(), O_RDONLY | O_CLOEXEC);
+    if (file < 0)
+    {
+        PZ_LOG_ERROR(MEMORY, "Opening '{}' failed with {}.", filepath, errno);
+        return false;
+    }
+
+    struct stat info = {};
+    if (fstat(file, &info) != 0 || info.st_size == 0)
+    {
+        close(file);
+        return false;
+    }
+
+    void* view = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+    if (view == MAP_FAILED)
+    {
+        PZ_LOG_ERROR(MEMORY, "Mapping '{}' failed with {}.", filepath, errno);
+        close(file);
+        return false;
+    }
+
+    m_File = file;
+    m_Data = static_cast<uint8_t*>(view);
+    m_Size = static_cast<size_t>(info.st_size);
+#endif
+
+    return true;
+}
+
+
+
+void PZvend::MappedFile::Close() noexcept
+{
+#ifdef PZVEND_IS_WINDOWS
+    if (m_Data)
+        UnmapViewOfFile(m_Data);
+
+    if (m_Mapping)
+        CloseHandle(m_Mapping);
+
+    if (m_File)
+        CloseHandle(m_File);
+
+    m_Mapping = nullptr;
+    m_File    = nullptr;
+#else
+    if (m_Data)
+        munmap(m_Data, m_Size);
+
+    if (m_File >= 0)
+        close(m_File);
+
+    m_File = -1;
+#endif
+
+    m_Data = nullptr;
+    m_Size = 0;
+}
@@ -0,0 +1,329 @@
+#include "ProjectZvend/MappedRingSink.hpp"
+
+#include "ProjectZvend/Log.hpp"
+#include "ProjectZvend/MappedFile.hpp"
+#include "ProjectZvend/Paths.hpp"
+
+#include "Macros.hpp"
+
+#ifdef PZVEND_IS_WINDOWS
+    #include <Windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+#include <spdlog/pattern_formatter.h>
+
+#include <atomic>
+#include <bit>
+#include <cstring>
+#include <filesystem>
+
+
+
+namespace
+{
+    constexpr char     RING_MAGIC[8] = { 'P', 'Z', 'R', 'I', 'N', 'G', '\0', '\0' };
+    constexpr uint64_t ALIGNMENT     = 16; // Record headers never wrap around the end of the data.
+
+    // The file survives the process, date and thread are worth the bytes.
+    constexpr const char* DEFAULT_PATTERN = "[%Y-%m-%d %T.%e][%n][%l][%t] %v";
+
+    std::atomic<uint64_t> g_NextSinkId = 1;
+
+
+
+    uint64_t AlignRecord(uint64_t size) noexcept
+    {
+        return (size + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+    }
+
+
+
+    bool IsValidHeader(const PZvend::RingLogHeader& header, uint64_t available) noexcept
+    {
+        return std::memcmp(header.Magic, RING_MAGIC, sizeof(RING_MAGIC)) == 0 &&
+               header.Version    == PZvend::RING_LOG_VERSION &&
+               header.HeaderSize == sizeof(PZvend::RingLogHeader) &&
+               header.DataSize   >= PZvend::RING_LOG_MIN_SIZE &&
+               std::has_single_bit(header.DataSize) &&
+               header.DataSize   <= available;
+    }
+}
+
+
+
+PZvend::MappedRingSink::MappedRingSink()
+    : m_Id(g_NextSinkId.fetch_add(1, std::memory_order_relaxed))
+    , m_Formatter(std::make_unique<spdlog::pattern_formatter>(DEFAULT_PATTERN))
+{
+}
+
+PZvend::MappedRingSink::MappedRingSink(const std::string& path, size_t size)
+    : MappedRingSink()
+{
+    Open(path, size);
+}
+
+PZvend::MappedRingSink::~MappedRingSink()
+{
+    Close();
+}
+
+
+
+bool PZvend::MappedRingSink::Open(const std::string& path, size_t size)
+{
+    Close();
+
+    const uint64_t data_size = std::bit_ceil(std::max<uint64_t>(size, RING_LOG_MIN_SIZE));
+    const uint64_t file_size = sizeof(RingLogHeader) + data_size;
+
+    const auto directory = std::filesystem::path(path).parent_path();
+    if (!directory.empty() && !Path::Create(directory.string() + "/"))
+    {
+        PZ_LOG_ERROR(LOGGING, "Could not create the directory of the ring log '{}'.", path);
+        return false;
+    }
+
+    uint64_t current_size = 0;
+    void*    view         = nullptr;
+
+#ifdef PZVEND_IS_WINDOWS
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        PZ_LOG_ERROR(LOGGING, "Opening the ring log '{}' failed with {}.", path, GetLastError());
+        return false;
+    }
+
+    LARGE_INTEGER size_info = {};
+    GetFileSizeEx(file, &size_info);
+    current_size = static_cast<uint64_t>(size_info.QuadPart);
+
+    LARGE_INTEGER end = {};
+    end.QuadPart = static_cast<LONGLONG>(file_size);
+    if (current_size != file_size && (!SetFilePointerEx(file, end, nullptr, FILE_BEGIN) || !SetEndOfFile(file)))
+    {
+        PZ_LOG_ERROR(LOGGING, "Resizing the ring log '{}' failed with {}.", path, GetLastError());
+        CloseHandle(file);
+        return false;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READWRITE, static_cast<DWORD>(file_size >> 32), static_cast<DWORD>(file_size), nullptr);
+    if (mapping)
+        view = MapViewOfFile(mapping, FILE_MAP_WRITE, 0, 0, static_cast<SIZE_T>(file_size));
+
+    if (!view)
+    {
+        PZ_LOG_ERROR(LOGGING, "Mapping the ring log '{}' failed with {}.", path, GetLastError());
+        if (mapping)
+            CloseHandle(mapping);
+
+        CloseHandle(file);
+        return false;
+    }
+
+    m_File    = file;
+    m_Mapping = mapping;
+#else
+    const int file = open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (file < 0)
+    {
+        PZ_LOG_ERROR(LOGGING, "Opening the ring log '{}' failed with {}.", path, errno);
+        return false;
+    }
+
+    struct stat info = {};
+    fstat(file, &info);
+    current_size = static_cast<uint64_t>(info.st_size);
+
+    if (current_size != file_size && ftruncate(file, static_cast<off_t>(file_size)) != 0)
+    {
+        PZ_LOG_ERROR(LOGGING, "Resizing the ring log '{}' failed with {}.", path, errno);
+        close(file);
+        return false;
+    }
+
+    view = mmap(nullptr, file_size, PROT_READ | PROT_WRITE, MAP_SHARED, file, 0);
+    if (view == MAP_FAILED)
+    {
+        PZ_LOG_ERROR(LOGGING, "Mapping the ring log '{}' failed with {}.", path, errno);
+        close(file);
+        return false;
+    }
+
+    m_File = file;
+#endif
+
+    m_Header   = static_cast<RingLogHeader*>(view);
+    m_Data     = static_cast<uint8_t*>(view) + sizeof(RingLogHeader);
+    m_Mask     = data_size - 1;
+    m_MaxLine  = data_size / 4;
+    m_FileSize = file_size;
+
+    // Continue an intact ring, the lines of a crashed run are still waiting to be recovered.
+    if (current_size != file_size || !IsValidHeader(*m_Header, data_size) || m_Header->DataSize != data_size)
+    {
+        std::memset(view, 0, file_size);
+        std::memcpy(m_Header->Magic, RING_MAGIC, sizeof(RING_MAGIC));
+        m_Header->Version    = RING_LOG_VERSION;
+        m_Header->HeaderSize = sizeof(RingLogHeader);
+        m_Header->DataSize   = data_size;
+    }
+
+    return true;
+}
+
+
+
+void PZvend::MappedRingSink::Close() noexcept
+{
+    if (!m_Header)
+        return;
+
+#ifdef PZVEND_IS_WINDOWS
+    UnmapViewOfFile(m_Header);
+    CloseHandle(m_Mapping);
+    CloseHandle(m_File);
+
+    m_Mapping = nullptr;
+    m_File    = nullptr;
+#else
+    munmap(m_Header, m_FileSize);
+    close(m_File);
+
+    m_File = -1;
+#endif
+
+    m_Header   = nullptr;
+    m_Data     = nullptr;
+    m_FileSize = 0;
+}
+
+
+
+/*
+Lock-free: the slot comes from one atomic add on the shared cursor. The text goes in first,
+the position last with release, so a record is either complete or not there at all.
+*/
+void PZvend::MappedRingSink::log(const spdlog::details::log_msg& msg)
+{
+    if (!m_Header)
+        return;
+
+    struct ThreadFormatter
+    {
+        uint64_t                           SinkId     = 0;
+        uint64_t                           Generation = 0;
+        std::unique_ptr<spdlog::formatter> Formatter;
+        spdlog::memory_buf_t               Buffer;
+    };
+
+    thread_local ThreadFormatter local;
+
+    if (local.SinkId != m_Id || local.Generation != m_Generation.load(std::memory_order_acquire))
+    {
+        std::lock_guard lock(m_FormatterMutex);
+        local.Formatter  = m_Formatter->clone();
+        local.SinkId     = m_Id;
+        local.Generation = m_Generation.load(std::memory_order_relaxed);
+    }
+
+    local.Buffer.clear();
+    local.Formatter->format(msg, local.Buffer);
+
+    const uint32_t length   = static_cast<uint32_t>(std::min<size_t>(local.Buffer.size(), m_MaxLine));
+    const uint64_t size     = AlignRecord(sizeof(RingLogRecord) + length);
+    const uint64_t position = std::atomic_ref<uint64_t>(m_Header->Cursor).fetch_add(size, std::memory_order_relaxed);
+
+    ICopy(position + sizeof(RingLogRecord), local.Buffer.data(), length);
+
+    auto* record   = reinterpret_cast<RingLogRecord*>(m_Data + (position & m_Mask));
+    record->Length = length;
+    record->Magic  = RING_LOG_RECORD_MAGIC;
+    std::atomic_ref<uint64_t>(record->Position).store(position, std::memory_order_release);
+}
+
+
+
+void PZvend::MappedRingSink::set_pattern(const std::string& pattern)
+{
+    set_formatter(std::make_unique<spdlog::pattern_formatter>(pattern));
+}
+
+
+
+void PZvend::MappedRingSink::set_formatter(std::unique_ptr<spdlog::formatter> sink_formatter)
+{
+    std::lock_guard lock(m_FormatterMutex);
+    m_Formatter = std::move(sink_formatter);
+    m_Generation.fetch_add(1, std::memory_order_release);
+}
+
+
+
+/*
+The cursor marks the end, the ring holds at most the data size before it. Walks that window in
+record alignment steps and takes every record whose position matches where it was found, which
+skips partial records at the start, torn ones from the crash and leftovers of earlier laps.
+*/
+bool PZvend::MappedRingSink::Recover(const std::string& path, std::vector<std::string>& lines)
+{
+    MappedFile file(path);
+    if (!file.IsOpen() || file.GetSize() < sizeof(RingLogHeader))
+        return false;
+
+    RingLogHeader header;
+    std::memcpy(&header, file.GetData(), sizeof(header));
+    if (!IsValidHeader(header, file.GetSize() - sizeof(RingLogHeader)))
+        return false;
+
+    const uint8_t* data   = file.GetData() + sizeof(RingLogHeader);
+    const uint64_t mask   = header.DataSize - 1;
+    const uint64_t cursor = header.Cursor;
+
+    uint64_t position = AlignRecord(cursor > header.DataSize ? cursor - header.DataSize : 0);
+
+    while (position + sizeof(RingLogRecord) <= cursor)
+    {
+        RingLogRecord record;
+        std::memcpy(&record, data + (position & mask), sizeof(record));
+
+        const uint64_t size = AlignRecord(sizeof(RingLogRecord) + record.Length);
+        if (record.Position != position || record.Magic != RING_LOG_RECORD_MAGIC || record.Length > header.DataSize / 4 || position + size > cursor)
+        {
+            position += ALIGNMENT;
+            continue;
+        }
+
+        std::string line(record.Length, '\0');
+
+        const uint64_t offset = (position + sizeof(RingLogRecord)) & mask;
+        const uint64_t first  = std::min<uint64_t>(record.Length, header.DataSize - offset);
+        std::memcpy(line.data(), data + offset, first);
+        std::memcpy(line.data() + first, data, record.Length - first);
+
+        while (!line.empty() && (line.back() == '\n' || line.back() == '\r'))
+            line.pop_back();
+
+        lines.push_back(std::move(line));
+        position += size;
+    }
+
+    return true;
+}
+
+
+
+void PZvend::MappedRingSink::ICopy(uint64_t position, const void* data, size_t size) noexcept
+{
+    const uint64_t offset = position & m_Mask;
+    const size_t   first  = static_cast<size_t>(std::min<uint64_t>(size, m_Mask + 1 - offset));
+
+    std::memcpy(m_Data + offset, data, first);
+    std::memcpy(m_Data, static_cast<const uint8_t*>(data) + first, size - first);
+}
@@ -1,15 +1,102 @@
 #include "ProjectZvend/Memory.hpp"
+#include "ProjectZvend/Profiler.hpp"
 
 #include "Macros.hpp"
 
-#include <DbgHelp.h>
-#include <Psapi.h>
+#ifdef PZVEND_IS_WINDOWS
+    #include <DbgHelp.h>
+    #include <Psapi.h>
+#else
+    #include <cinttypes>
+    #include <link.h>
+    #include <sys/mman.h>
+    #include <unistd.h>
+#endif
+
 #include <spdlog/spdlog.h>
 
 
 namespace
 {
     static bool g_MemoryInitialized = false;
+
+
+
+    /*
+    Maps a PE/ELF section name onto its ScanSection or 0xFF if it's not tracked.
+    Names are matched exactly, ELF images carry look-alikes such as .data.rel.ro or .text.unlikely.
+    */
+    uint8_t GetScanSection(std::string_view name) noexcept
+    {
+        using namespace PZvend::Memory;
+
+        if (name == ".text")
+            return ScanSection::TEXT;
+
+        else if (name == ".rdata" || name == ".rodata")
+            return ScanSection::RDATA;
+
+        else if (name == ".data")
+            return ScanSection::DATA;
+
+        else if (name == ".idata")
+            return ScanSection::IDATA;
+
+        else if (name == ".reloc")
+            return ScanSection::RELOC;
+
+        else if (name == ".pdata")
+            return ScanSection::PDATA;
+
+        else if (name == ".bss")
+            return ScanSection::BSS;
+
+        else if (name == ".edata")
+            return ScanSection::EDATA;
+
+        else if (name == ".rsrc")
+            return ScanSection::RSRC;
+
+        else if (name == ".tls")
+            return ScanSection::TLS;
+
+        else if (name == ".debug")
+            return ScanSection::DEBUG;
+
+        return 0xFF;
+    }
+
+
+
+    /*
+    PE section names are padded to 8 bytes and not terminated if they use all of them.
+    */
+    std::string_view GetPESectionName(const void* name) noexcept
+    {
+        const char* text = static_cast<const char*>(name);
+        return { text, strnlen(text, 8) };
+    }
+
+
+
+    /*
+    Maps segment permissions onto a ScanSection for images without section headers in memory.
+    */
+    uint16_t GetScanSection(uint8_t access) noexcept
+    {
+        using namespace PZvend::Memory;
+
+        if (access & REGION_EXECUTE)
+            return ScanSection::TEXT;
+
+        else if (access & REGION_WRITE)
+            return ScanSection::DATA;
+
+        else if (access & REGION_READ)
+            return ScanSection::RDATA;
+
+        return ScanSection::MAX;
+    }
 }
 
 
@@ -19,12 +106,14 @@ bool PZvend::Memory::Initialize()
     if (g_MemoryInitialized)
         return true;
 
+#ifdef PZVEND_IS_WINDOWS
     auto mh_status = MH_Initialize();
     if (mh_status != MH_OK)
     {
-        SPDLOG_CRITICAL("Memory could not be initialized, because: {}.", MH_StatusToString(mh_status));
+        PZ_LOG_CRITICAL(MEMORY, "Memory could not be initialized, because: {}.", MH_StatusToString(mh_status));
         return false;
     }
+#endif
 
     g_MemoryInitialized = true;
     return true;
@@ -123,51 +212,204 @@ uint8_t* PZvend::Memory::DereferencePointer(uint8_t* address) noexcept
 
 
 
-PZvend::Memory::Scanner::Scanner(const char* modulename)
+size_t PZvend::Memory::GetPageSize() noexcept
 {
-    m_Module = static_cast<DllModule>(GetModuleHandleA(modulename));
-    auto module_base = reinterpret_cast<uint64_t>(m_Module);
+    static const size_t page_size = []()
+    {
+#ifdef PZVEND_IS_WINDOWS
+        SYSTEM_INFO info = {};
+        GetSystemInfo(&info);
+        return static_cast<size_t>(info.dwPageSize);
+#else
+        return static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#endif
+    }();
 
-    IMAGE_NT_HEADERS*     nt_header      = ImageNtHeader(m_Module);
-    IMAGE_SECTION_HEADER* section_header = reinterpret_cast<IMAGE_SECTION_HEADER*>(nt_header + 1);
+    return page_size;
+}
 
-    for (uint64_t i = 0; i < nt_header->FileHeader.NumberOfSections; i++)
+
+
+bool PZvend::Memory::QueryProtection(const void* address, Protection* out_protection, size_t* out_size) noexcept
+{
+#ifdef PZVEND_IS_WINDOWS
+    MEMORY_BASIC_INFORMATION info = {};
+    if (!VirtualQuery(address, &info, sizeof(info)) || info.State != MEM_COMMIT)
+        return false;
+
+    if (out_protection)
+        *out_protection = info.Protect;
+
+    if (out_size)
+        *out_size = static_cast<size_t>(reinterpret_cast<uint8_t*>(info.BaseAddress) + info.RegionSize - static_cast<const uint8_t*>(address));
+
+    return true;
+#else
+    // Linux has no query syscall, the kernel's mapping list is the only source.
+    FILE* maps = fopen("/proc/self/maps", "r");
+    if (!maps)
+        return false;
+
+    auto target = reinterpret_cast<uintptr_t>(address);
+    bool found  = false;
+    char line[512];
+
+    while (fgets(line, sizeof(line), maps))
+    {
+        uintptr_t start = 0, end = 0;
+        char      perms[5] = {};
+
+        if (sscanf(line, "%" SCNxPTR "-%" SCNxPTR " %4s", &start, &end, perms) != 3)
+            continue;
+
+        if (target < start || target >= end)
+            continue;
+
+        Protection protection = PROT_NONE;
+        if (perms[0] == 'r') protection |= PROT_READ;
+        if (perms[1] == 'w') protection |= PROT_WRITE;
+        if (perms[2] == 'x') protection |= PROT_EXEC;
+
+        if (out_protection)
+            *out_protection = protection;
+
+        if (out_size)
+            *out_size = end - target;
+
+        found = true;
+        break;
+    }
+
+    fclose(maps);
+    return found;
+#endif
+}
+
+
+
+bool PZvend::Memory::Unprotect(void* address, size_t size, Protection* out_old) noexcept
+{
+#ifdef PZVEND_IS_WINDOWS
+    DWORD old = 0;
+    if (!VirtualProtect(address, size, PAGE_EXECUTE_READWRITE, &old))
+        return false;
+
+    if (out_old)
+        *out_old = old;
+
+    return true;
+#else
+    if (out_old && !QueryProtection(address, out_old))
+        return false;
+
+    return Protect(address, size, PROT_READ | PROT_WRITE | PROT_EXEC);
+#endif
+}
+
+
+
+bool PZvend::Memory::Protect(void* address, size_t size, Protection protection) noexcept
+{
+#ifdef PZVEND_IS_WINDOWS
+    DWORD old = 0;
+    return VirtualProtect(address, size, protection, &old) != 0;
+#else
+    const uintptr_t page_size = GetPageSize();
+    const uintptr_t start     = reinterpret_cast<uintptr_t>(address) & ~(page_size - 1);
+    const uintptr_t end       = (reinterpret_cast<uintptr_t>(address) + size + page_size - 1) & ~(page_size - 1);
+
+    return mprotect(reinterpret_cast<void*>(start), end - start, static_cast<int>(protection)) == 0;
+#endif
+}
+
+
+
+void PZvend::Memory::FlushInstructionCache(void* address, size_t size) noexcept
+{
+#ifdef PZVEND_IS_WINDOWS
+    ::FlushInstructionCache(GetCurrentProcess(), address, size);
+#else
+    __builtin___clear_cache(static_cast<char*>(address), static_cast<char*>(address) + size);
+#endif
+}
+
+
+
+bool PZvend::Memory::IsWritable(const void* address, Protection* out_protection) noexcept
+{
+    Protection protection = 0;
+    if (!QueryProtection(address, &protection))
+        return false;
+
+    if (out_protection)
+        *out_protection = protection;
+
+#ifdef PZVEND_IS_WINDOWS
+    return (protection & (PAGE_READWRITE | PAGE_WRITECOPY | PAGE_EXECUTE_READWRITE | PAGE_EXECUTE_WRITECOPY)) != 0;
+#else
+    return (protection & PROT_WRITE) != 0;
+#endif
+}
+
+
+
+size_t PZvend::Memory::CountVTableEntries(void** vtable, size_t max_entries) noexcept
+{
+    // The table has to be readable, its region bounds the count.
+    size_t readable = 0;
+    if (!vtable || !QueryProtection(vtable, nullptr, &readable))
+        return 0;
+
+    max_entries = std::min(max_entries, readable / sizeof(void*));
+
+    // Consecutive entries mostly point into the same code region, only query when leaving it.
+    const uint8_t* region_start = nullptr;
+    const uint8_t* region_end   = nullptr;
+    size_t         count        = 0;
+
+    for (; count < max_entries; count++)
     {
-        auto name = reinterpret_cast<char*>(section_header->Name);
+        auto* entry = static_cast<const uint8_t*>(vtable[count]);
+        if (entry >= region_start && entry < region_end)
+            continue;
 
-        uint8_t section = 0xFF;
-        if (memcmp(name, ".text", 5) == 0)
-            section = ScanSection::TEXT;
+        Protection protection = 0;
+        size_t     size       = 0;
 
-        else if (memcmp(name, ".rdata", 6) == 0)
-            section = ScanSection::RDATA;
+        if (!entry || !QueryProtection(entry, &protection, &size))
+            break;
 
-        else if (memcmp(name, ".data", 5) == 0)
-            section = ScanSection::DATA;
+#ifdef PZVEND_IS_WINDOWS
+        if (!(protection & (PAGE_EXECUTE | PAGE_EXECUTE_READ | PAGE_EXECUTE_READWRITE | PAGE_EXECUTE_WRITECOPY)))
+            break;
+#else
+        if (!(protection & PROT_EXEC))
+            break;
+#endif
 
-        else if (memcmp(name, ".idata", 6) == 0)
-            section = ScanSection::IDATA;
+        region_start = entry;
+        region_end   = entry + size;
+    }
 
-        else if (memcmp(name, ".reloc", 6) == 0)
-            section = ScanSection::RELOC;
+    return count;
+}
 
-        else if (memcmp(name, ".pdata", 6) == 0)
-            section = ScanSection::PDATA;
 
-        else if (memcmp(name, ".bss", 4) == 0)
-            section = ScanSection::BSS;
 
-        else if (memcmp(name, ".edata", 6) == 0)
-            section = ScanSection::EDATA;
+PZvend::Memory::Scanner::Scanner(const char* modulename)
+{
+#ifdef PZVEND_IS_WINDOWS
+    m_Module = static_cast<DllModule>(GetModuleHandleA(modulename));
+    auto module_base = reinterpret_cast<uint64_t>(m_Module);
 
-        else if (memcmp(name, ".rsrc", 5) == 0)
-            section = ScanSection::RSRC;
+    IMAGE_NT_HEADERS*     nt_header      = ImageNtHeader(m_Module);
+    IMAGE_SECTION_HEADER* section_header = reinterpret_cast<IMAGE_SECTION_HEADER*>(nt_header + 1);
 
-        else if (memcmp(name, ".tls", 4) == 0)
-            section = ScanSection::TLS;
+    m_ModuleSize = nt_header->OptionalHeader.SizeOfImage;
 
-        else if (memcmp(name, ".debug", 6) == 0)
-            section = ScanSection::DEBUG;
+    for (uint64_t i = 0; i < nt_header->FileHeader.NumberOfSections; i++)
+    {
+        uint8_t section = GetScanSection(GetPESectionName(section_header->Name));
 
         if (section != 0xFF)
         {
@@ -180,13 +422,320 @@ PZvend::Memory::Scanner::Scanner(const char* modulename)
 
         section_header++;
     }
+#else
+    struct SearchData
+    {
+        const char*       Name;
+        Scanner*          Self;
+        bool              Found;
+    } search = { modulename, this, false };
+
+    // Loaded ELF images keep no section headers in memory, their segments' permissions are used instead.
+    dl_iterate_phdr([](dl_phdr_info* info, size_t, void* context) -> int
+    {
+        auto&            search = *static_cast<SearchData*>(context);
+        std::string_view path   = info->dlpi_name ? info->dlpi_name : "";
+        std::string_view name   = path.substr(path.find_last_of('/') + 1);
+
+        // The main executable is reported first and without a name.
+        if (search.Name && *search.Name && name != search.Name && path != search.Name)
+            return 0;
+
+        uint64_t base = UINT64_MAX;
+        uint64_t end  = 0;
+        for (uint16_t i = 0; i < info->dlpi_phnum; i++)
+        {
+            if (info->dlpi_phdr[i].p_type == PT_LOAD)
+            {
+                base = std::min<uint64_t>(base, info->dlpi_phdr[i].p_vaddr & ~0xFFFull);
+                end  = std::max<uint64_t>(end, info->dlpi_phdr[i].p_vaddr + info->dlpi_phdr[i].p_memsz);
+            }
+        }
+
+        if (base == UINT64_MAX)
+            return 0;
+
+        SectionData* sections = search.Self->m_Sections;
+        search.Self->m_Module     = reinterpret_cast<DllModule>(info->dlpi_addr + base);
+        search.Self->m_ModuleSize = end - base;
+
+        for (uint16_t i = 0; i < info->dlpi_phnum; i++)
+        {
+            const ElfW(Phdr)& segment = info->dlpi_phdr[i];
+            if (segment.p_type != PT_LOAD)
+                continue;
+
+            uint8_t access = REGION_UNKNOWN;
+            if (segment.p_flags & PF_R) access |= REGION_READ;
+            if (segment.p_flags & PF_W) access |= REGION_WRITE;
+            if (segment.p_flags & PF_X) access |= REGION_EXECUTE;
+
+            uint16_t section = GetScanSection(access);
+            uint8_t* start   = reinterpret_cast<uint8_t*>(info->dlpi_addr + segment.p_vaddr);
+
+            if (section != ScanSection::MAX && segment.p_memsz > static_cast<size_t>(sections[section].End - sections[section].Start))
+                sections[section] = { start, start + segment.p_memsz };
+        }
+
+        search.Found = true;
+        return 1;
+    }, &search);
+
+    if (!search.Found)
+        PZ_LOG_ERROR(MEMORY, "Module '{}' is not loaded.", modulename ? modulename : "<main>");
+#endif
+}
+
+
+
+PZvend::Memory::Scanner::Scanner(const DumpFile& dump, const char* modulename)
+{
+    const DumpModule* module = dump.FindModule(modulename);
+    if (!module)
+    {
+        PZ_LOG_ERROR(MEMORY, "Module '{}' was not captured in the dump.", modulename);
+        return;
+    }
+
+    const uint64_t module_end = module->Base + module->Size;
+
+    // ELF modules lose their section headers when loaded, so the core's segment permissions rebuild the layout instead.
+    ScanRange best[ScanSection::MAX] = {};
+
+    for (const DumpRegion& region : dump.GetRegions())
+    {
+        uint64_t start = std::max(region.Address, module->Base);
+        uint64_t end   = std::min(region.Address + region.Size, module_end);
+
+        if (start >= end)
+            continue;
+
+        ScanRange range = { start - module->Base, end - start, region.Data + (start - region.Address) };
+        m_Ranges.push_back(range);
+
+        uint16_t section = GetScanSection(region.Access);
+        if (section != ScanSection::MAX && range.Size > best[section].Size)
+            best[section] = range;
+    }
+
+    if (m_Ranges.empty())
+    {
+        PZ_LOG_ERROR(MEMORY, "No memory of module '{}' was captured in the dump.", modulename);
+        return;
+    }
+
+    // Contiguous modules are scanned exactly like live ones.
+    uint64_t available = 0;
+    m_Module = reinterpret_cast<DllModule>(dump.Translate(module->Base, &available));
+    if (m_Module && available >= module->Size)
+    {
+        m_ModuleSize = module->Size;
+        m_Ranges.clear();
+    }
+
+    auto translate = [&](uint64_t rva, uint64_t size) -> SectionData
+    {
+        if (rva >= module->Size)
+            return {};
+
+        const auto range = std::find_if(m_Ranges.begin(), m_Ranges.end(),
+            [&](const ScanRange& other) { return rva >= other.RVA && rva - other.RVA < other.Size; });
+
+        uint8_t* start = (*this)[rva];
+        if (!start)
+            return {};
+
+        uint64_t limit = range != m_Ranges.end() ? range->RVA + range->Size - rva : module->Size - rva;
+        return { start, start + std::min(size, limit) };
+    };
+
+    uint64_t header_size = 0;
+    uint8_t* header      = dump.Translate(module->Base, &header_size);
+
+    if (header && header_size >= 0x40 && header[0] == 'M' && header[1] == 'Z')
+    {
+        uint32_t nt_offset = *reinterpret_cast<uint32_t*>(header + 0x3C);
+        if (header_size < static_cast<uint64_t>(nt_offset) + 0x18 || memcmp(header + nt_offset, "PE\0\0", 4) != 0)
+            return;
+
+        uint16_t section_count   = *reinterpret_cast<uint16_t*>(header + nt_offset + 0x06);
+        uint16_t optional_size   = *reinterpret_cast<uint16_t*>(header + nt_offset + 0x14);
+        uint64_t section_headers = static_cast<uint64_t>(nt_offset) + 0x18 + optional_size;
+
+        for (uint16_t i = 0; i < section_count && section_headers + (i + 1) * 0x28 <= header_size; i++)
+        {
+            uint8_t* section_header = header + section_headers + i * 0x28;
+            uint8_t  section        = GetScanSection(GetPESectionName(section_header));
+
+            if (section != 0xFF)
+            {
+                uint32_t virtual_size    = *reinterpret_cast<uint32_t*>(section_header + 0x08);
+                uint32_t virtual_address = *reinterpret_cast<uint32_t*>(section_header + 0x0C);
+
+                m_Sections[section] = translate(virtual_address, virtual_size);
+            }
+        }
+    }
+    else
+    {
+        for (uint16_t section = 0; section < ScanSection::MAX; section++)
+            if (best[section].Data)
+                m_Sections[section] = { best[section].Data, best[section].Data + best[section].Size };
+    }
+}
+
+
+
+PZvend::Memory::Scanner::Scanner(const MappedFile& image)
+{
+    uint8_t* file = const_cast<uint8_t*>(image.GetData());
+    uint64_t size = image.GetSize();
+
+    auto read = [&](uint64_t offset, auto value) -> decltype(value)
+    {
+        if (offset + sizeof(value) > size)
+            return {};
+
+        memcpy(&value, file + offset, sizeof(value));
+        return value;
+    };
+
+    auto add_section = [&](std::string_view name, uint64_t offset, uint64_t length)
+    {
+        uint8_t section = GetScanSection(name);
+        if (section == 0xFF || m_Sections[section].Start || offset >= size)
+            return;
+
+        m_Sections[section] = { file + offset, file + offset + std::min(length, size - offset) };
+    };
+
+    if (size >= 0x40 && file[0] == 'M' && file[1] == 'Z')
+    {
+        uint32_t nt_offset = read(0x3C, uint32_t());
+        if (read(nt_offset, uint32_t()) != 0x00004550) // "PE\0\0"
+        {
+            PZ_LOG_ERROR(MEMORY, "Image has a DOS header but no PE header.");
+            return;
+        }
+
+        uint16_t section_count   = read(nt_offset + 0x06, uint16_t());
+        uint16_t optional_size   = read(nt_offset + 0x14, uint16_t());
+        uint32_t headers_size    = read(nt_offset + 0x18 + 0x3C, uint32_t()); // OptionalHeader.SizeOfHeaders, same offset for PE32 and PE32+
+        uint64_t section_headers = static_cast<uint64_t>(nt_offset) + 0x18 + optional_size;
+
+        m_Ranges.push_back({ 0, std::min<uint64_t>(headers_size, size), file });
+
+        for (uint16_t i = 0; i < section_count && section_headers + (i + 1) * 0x28 <= size; i++)
+        {
+            uint8_t* section_header  = file + section_headers + i * 0x28;
+            uint32_t virtual_size    = read(section_headers + i * 0x28 + 0x08, uint32_t());
+            uint32_t virtual_address = read(section_headers + i * 0x28 + 0x0C, uint32_t());
+            uint32_t raw_size        = read(section_headers + i * 0x28 + 0x10, uint32_t());
+            uint32_t raw_offset      = read(section_headers + i * 0x28 + 0x14, uint32_t());
+
+            if (raw_size == 0 || raw_offset >= size)
+                continue;
+
+            uint64_t length = std::min<uint64_t>(virtual_size ? std::min(virtual_size, raw_size) : raw_size, size - raw_offset);
+            m_Ranges.push_back({ virtual_address, length, file + raw_offset });
+
+            add_section(GetPESectionName(section_header), raw_offset, length);
+        }
+    }
+    else if (size >= 0x40 && memcmp(file, "\x7F" "ELF", 4) == 0 && file[4] == 2)
+    {
+        // ELF64: RVAs are relative to the lowest loaded segment, which matches the in-memory layout.
+        uint64_t ph_offset = read(0x20, uint64_t());
+        uint64_t sh_offset = read(0x28, uint64_t());
+        uint16_t ph_count  = read(0x38, uint16_t());
+        uint16_t sh_count  = read(0x3C, uint16_t());
+        uint16_t sh_names  = read(0x3E, uint16_t());
+
+        uint64_t base = UINT64_MAX;
+        for (uint16_t i = 0; i < ph_count; i++)
+            if (read(ph_offset + i * 0x38, uint32_t()) == 1) // PT_LOAD
+                base = std::min<uint64_t>(base, read(ph_offset + i * 0x38 + 0x10, uint64_t()) & ~0xFFFull);
+
+        for (uint16_t i = 0; i < ph_count; i++)
+        {
+            uint64_t segment = ph_offset + i * 0x38;
+            if (read(segment, uint32_t()) != 1)
+                continue;
+
+            uint64_t offset    = read(segment + 0x08, uint64_t());
+            uint64_t address   = read(segment + 0x10, uint64_t());
+            uint64_t file_size = read(segment + 0x20, uint64_t());
+
+            if (file_size && offset < size)
+                m_Ranges.push_back({ address - base, std::min(file_size, size - offset), file + offset });
+        }
+
+        uint64_t names = read(sh_offset + sh_names * 0x40 + 0x18, uint64_t());
+
+        for (uint16_t i = 0; i < sh_count; i++)
+        {
+            uint64_t section = sh_offset + i * 0x40;
+            uint32_t name    = read(section + 0x00, uint32_t());
+            uint32_t type    = read(section + 0x04, uint32_t());
+            uint64_t offset  = read(section + 0x18, uint64_t());
+            uint64_t length  = read(section + 0x20, uint64_t());
+
+            if (type == 8 || names + name >= size) // SHT_NOBITS has no file content
+                continue;
+
+            const char* text = reinterpret_cast<char*>(file + names + name);
+            add_section({ text, strnlen(text, size - (names + name)) }, offset, length);
+        }
+    }
+    else
+    {
+        PZ_LOG_ERROR(MEMORY, "Image is neither a PE nor an ELF64 file.");
+    }
+}
+
+
+
+size_t PZvend::Memory::Scanner::GetRVA(const uint8_t* address) const noexcept
+{
+    if (m_Ranges.empty())
+    {
+        auto base = reinterpret_cast<const uint8_t*>(m_Module);
+        if (!base || address < base || static_cast<uint64_t>(address - base) >= m_ModuleSize)
+            return SIZE_MAX;
+
+        return static_cast<size_t>(address - base);
+    }
+
+    for (const ScanRange& range : m_Ranges)
+        if (address >= range.Data && address < range.Data + range.Size)
+            return static_cast<size_t>(range.RVA + (address - range.Data));
+
+    return SIZE_MAX;
+}
+
+
+
+uint8_t* PZvend::Memory::Scanner::ITranslate(size_t RVA) const noexcept
+{
+    for (const ScanRange& range : m_Ranges)
+        if (RVA >= range.RVA && RVA - range.RVA < range.Size)
+            return range.Data + (RVA - range.RVA);
+
+    return nullptr;
 }
 
 
 
 uint8_t* PZvend::Memory::Scanner::IFind(const uint8_t* pattern, const char* mask, uint8_t* start, uint8_t* end) const noexcept
 {
+    PZ_PROFILE_SCOPE("Scanner::Find");
+
     uint64_t len = strlen(mask);
+
+    // Sections the image doesn't have are left as { nullptr, nullptr }.
+    if (!start || !end || static_cast<uint64_t>(start > end ? start - end : end - start) < len)
+        return nullptr;
+
     end -= len;
 
     auto check_pattern = [&](uint8_t* addr) -> bool
@@ -213,9 +762,9 @@ uint8_t* PZvend::Memory::Scanner::IFind(const uint8_t* pattern, const char* mask
             if (check_pattern(address))
                 return address;
     }
-    else             // Scan forwards
+    else             // Scan forwards, end now is the last address a match can start at.
     {
-        for (uint8_t* address = start; address < end; address++)
+        for (uint8_t* address = start; address <= end; address++)
             if (check_pattern(address))
                 return address;
     }
@@ -227,10 +776,17 @@ uint8_t* PZvend::Memory::Scanner::IFind(const uint8_t* pattern, const char* mask
 
 std::vector<uint8_t*> PZvend::Memory::Scanner::IFindAll(const uint8_t* pattern, const char* mask, uint8_t* start, uint8_t* end) const noexcept
 {
+    PZ_PROFILE_SCOPE("Scanner::FindAll");
+
     uint64_t len = strlen(mask);
-    end -= len;
     std::vector<uint8_t*> results;
 
+    // Sections the image doesn't have are left as { nullptr, nullptr }.
+    if (!start || !end || static_cast<uint64_t>(start > end ? start - end : end - start) < len)
+        return results;
+
+    end -= len;
+
     auto check_pattern = [&](uint8_t* addr) -> bool
     {
         if (*reinterpret_cast<uint8_t*>(addr) != pattern[0])
@@ -255,9 +811,9 @@ std::vector<uint8_t*> PZvend::Memory::Scanner::IFindAll(const uint8_t* pattern,
             if (check_pattern(address))
                 results.push_back(address);
     }
-    else             // Scan forwards
+    else             // Scan forwards, end now is the last address a match can start at.
     {
-        for (uint8_t* address = start; address < end; address++)
+        for (uint8_t* address = start; address <= end; address++)
             if (check_pattern(address))
                 results.push_back(address);
     }
@@ -266,3 +822,270 @@ std::vector<uint8_t*> PZvend::Memory::Scanner::IFindAll(const uint8_t* pattern,
 }
 
 
+
+bool PZvend::Memory::PatchSet::Add(void* address, const uint8_t* bytes, size_t size)
+{
+    auto target = static_cast<uint8_t*>(address);
+
+    if (m_Applied)
+    {
+        PZ_LOG_ERROR(MEMORY, "Patch set '{}' is applied, patches can not be added.", m_Name);
+        return false;
+    }
+
+    if (!target || !bytes || !size)
+    {
+        PZ_LOG_ERROR(MEMORY, "Invalid patch at {} for set '{}'.", fmt::ptr(address), m_Name);
+        return false;
+    }
+
+    auto it = std::lower_bound(m_Patches.begin(), m_Patches.end(), target,
+        [](const Patch& patch, uint8_t* value) { return patch.Address < value; });
+
+    bool overlaps_next     = it != m_Patches.end()   && target + size > it->Address;
+    bool overlaps_previous = it != m_Patches.begin() && std::prev(it)->Address + std::prev(it)->Bytes.size() > target;
+
+    if (overlaps_next || overlaps_previous)
+    {
+        PZ_LOG_ERROR(MEMORY, "Patch at {} overlaps another patch of set '{}'.", fmt::ptr(address), m_Name);
+        return false;
+    }
+
+    m_Patches.insert(it, { target, std::vector<uint8_t>(bytes, bytes + size), {} });
+    return true;
+}
+
+
+
+bool PZvend::Memory::PatchSet::AddNop(void* address, size_t size)
+{
+    constexpr uint8_t NOP = 0x90;
+
+    std::vector<uint8_t> nops(size, NOP);
+    return Add(address, nops.data(), nops.size());
+}
+
+
+
+bool PZvend::Memory::PatchSet::Clear()
+{
+    if (m_Applied)
+        return false;
+
+    m_Patches.clear();
+    return true;
+}
+
+
+
+bool PZvend::Memory::PatchSet::Apply()
+{
+    if (m_Applied)
+        return true;
+
+    if (!IWrite(true))
+        return false;
+
+    PZ_LOG_DEBUG(MEMORY, "Applied {} patches of set '{}'.", m_Patches.size(), m_Name);
+    m_Applied = true;
+    return true;
+}
+
+
+
+bool PZvend::Memory::PatchSet::Revert()
+{
+    if (!m_Applied)
+        return true;
+
+    if (!IWrite(false))
+        return false;
+
+    PZ_LOG_DEBUG(MEMORY, "Reverted {} patches of set '{}'.", m_Patches.size(), m_Name);
+    m_Applied = false;
+    return true;
+}
+
+
+
+bool PZvend::Memory::PatchSet::Verify() const noexcept
+{
+    for (const Patch& patch : m_Patches)
+    {
+        const std::vector<uint8_t>& expected = m_Applied ? patch.Bytes : patch.Original;
+
+        // Never applied, there is nothing to compare against yet.
+        if (expected.empty())
+            continue;
+
+        if (memcmp(patch.Address, expected.data(), expected.size()) != 0)
+        {
+            PZ_LOG_WARN(MEMORY, "Patch at {} of set '{}' was modified.", fmt::ptr(patch.Address), m_Name);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+
+bool PZvend::Memory::PatchSet::IWrite(bool apply)
+{
+    PZ_PROFILE_SCOPE("PatchSet::Write");
+
+    struct PageRange
+    {
+        uint8_t*   Start;
+        size_t     Size;
+        Protection Old;
+    };
+
+    const uintptr_t page_size = GetPageSize();
+
+    // Patches are sorted, so neighbouring pages can be merged in one pass.
+    std::vector<PageRange> pages;
+    for (const Patch& patch : m_Patches)
+    {
+        uintptr_t start = reinterpret_cast<uintptr_t>(patch.Address) & ~(page_size - 1);
+        uintptr_t end   = (reinterpret_cast<uintptr_t>(patch.Address) + patch.Bytes.size() + page_size - 1) & ~(page_size - 1);
+
+        if (!pages.empty() && reinterpret_cast<uintptr_t>(pages.back().Start) + pages.back().Size >= start)
+        {
+            pages.back().Size = std::max<size_t>(pages.back().Size, end - reinterpret_cast<uintptr_t>(pages.back().Start));
+            continue;
+        }
+
+        pages.push_back({ reinterpret_cast<uint8_t*>(start), end - start, 0 });
+    }
+
+    // A merged range can span regions with different protections, each one has to be restored on its own.
+    std::vector<PageRange> regions;
+    for (const PageRange& range : pages)
+    {
+        for (uint8_t* address = range.Start; address < range.Start + range.Size;)
+        {
+            Protection protection = 0;
+            size_t     size       = 0;
+
+            if (!QueryProtection(address, &protection, &size))
+            {
+                PZ_LOG_ERROR(MEMORY, "Patch set '{}' touches unmapped memory at {}.", m_Name, fmt::ptr(address));
+                return false;
+            }
+
+            size = std::min<size_t>(size, range.Start + range.Size - address);
+            regions.push_back({ address, size, protection });
+            address += size;
+        }
+    }
+
+    for (size_t i = 0; i < regions.size(); i++)
+    {
+        if (Unprotect(regions[i].Start, regions[i].Size))
+            continue;
+
+        PZ_LOG_ERROR(MEMORY, "Unprotecting {} for patch set '{}' failed.", fmt::ptr(regions[i].Start), m_Name);
+
+        // Nothing has been written yet, restoring the pages leaves memory untouched.
+        while (i-- > 0)
+            Protect(regions[i].Start, regions[i].Size, regions[i].Old);
+
+        return false;
+    }
+
+    // Pointer sized patches (import slots, vtable entries) are stored at once, other threads never see a torn pointer.
+    auto write = [](uint8_t* destination, const uint8_t* source, size_t size)
+    {
+        if (size != sizeof(void*) || reinterpret_cast<uintptr_t>(destination) % alignof(void*) != 0)
+        {
+            memcpy(destination, source, size);
+            return;
+        }
+
+        void* value = nullptr;
+        memcpy(&value, source, sizeof(value));
+        std::atomic_ref<void*>(*reinterpret_cast<void**>(destination)).store(value, std::memory_order_release);
+    };
+
+    for (Patch& patch : m_Patches)
+    {
+        if (apply)
+        {
+            patch.Original.assign(patch.Address, patch.Address + patch.Bytes.size());
+            write(patch.Address, patch.Bytes.data(), patch.Bytes.size());
+        }
+        else
+        {
+            write(patch.Address, patch.Original.data(), patch.Original.size());
+        }
+    }
+
+    for (const PageRange& region : regions)
+    {
+        Protect(region.Start, region.Size, region.Old);
+        FlushInstructionCache(region.Start, region.Size);
+    }
+
+    return true;
+}
+
+
+
+PZvend::Memory::VmtShadow::VmtShadow(void* object, size_t entries)
+    : m_Object(object), m_Original(object ? GetVTable(object) : nullptr)
+{
+    if (!m_Original)
+        return;
+
+    m_Count = entries ? entries : CountVTableEntries(m_Original);
+    m_Table = std::make_unique<void*[]>(PREFIX_ENTRIES + m_Count);
+
+    memcpy(m_Table.get(), m_Original - PREFIX_ENTRIES, (PREFIX_ENTRIES + m_Count) * sizeof(void*));
+}
+
+
+
+PZvend::Memory::VmtShadow::~VmtShadow()
+{
+    Detach();
+}
+
+
+
+bool PZvend::Memory::VmtShadow::Attach() noexcept
+{
+    if (m_Attached)
+        return true;
+
+    if (!m_Count)
+    {
+        PZ_LOG_ERROR(MEMORY, "Attaching vtable shadow to {} failed, the vtable is empty.", fmt::ptr(m_Object));
+        return false;
+    }
+
+    void** expected = m_Original;
+    if (!std::atomic_ref<void**>(*static_cast<void***>(m_Object)).compare_exchange_strong(expected, GetTable(), std::memory_order_acq_rel))
+    {
+        PZ_LOG_ERROR(MEMORY, "Attaching vtable shadow to {} failed, the vtable pointer changed.", fmt::ptr(m_Object));
+        return false;
+    }
+
+    m_Attached = true;
+    return true;
+}
+
+
+
+bool PZvend::Memory::VmtShadow::Detach() noexcept
+{
+    if (!m_Attached)
+        return true;
+
+    // Only restore if nobody else swapped the pointer in the meantime.
+    void** expected = GetTable();
+    std::atomic_ref<void**>(*static_cast<void***>(m_Object)).compare_exchange_strong(expected, m_Original, std::memory_order_acq_rel);
+
+    m_Attached = false;
+    return true;
+}
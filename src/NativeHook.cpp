@@ -0,0 +1,779 @@
+#include "ProjectZvend/NativeHook.hpp"
+
+#include "Disassembler.hpp"
+#include "Macros.hpp"
+
+#ifdef PZVEND_IS_WINDOWS
+    #include <wtypes.h>
+#else
+    #include <cinttypes>
+    #include <sys/mman.h>
+#endif
+
+#include <atomic>
+#include <bitset>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#if defined(__x86_64__) || defined(_M_X64)
+    #define PZVEND_NATIVE_HOOK_SUPPORTED
+#endif
+
+
+
+namespace
+{
+    using namespace PZvend::Memory;
+
+    /*
+    Slot layout, every slot belongs to exactly one hook:
+        +0x00  relay       FF 25 02 00 00 00  jmp [rip + 2]
+        +0x06              CC CC
+        +0x08              detour (8 byte aligned, swapped atomically by SetInlineHookDetour)
+        +0x10  trampoline  relocated prologue + jump back
+    */
+    constexpr size_t SLAB_SIZE         = 0x10000;
+    constexpr size_t SLOT_SIZE         = 0x80;
+    constexpr size_t SLOTS_PER_SLAB    = SLAB_SIZE / SLOT_SIZE;
+    constexpr size_t RELAY_SIZE        = 0x10;
+    constexpr size_t RELAY_ADDRESS     = 0x08;
+    constexpr size_t TRAMPOLINE_SIZE   = SLOT_SIZE - RELAY_SIZE;
+    constexpr size_t PATCH_SIZE        = 5;         // E9 rel32
+    constexpr int64_t MAX_DISTANCE     = 0x7FFF0000; // Keep some headroom below 2GB for the instruction lengths.
+
+    struct Slab
+    {
+        uint8_t*                     Base = nullptr;
+        std::bitset<SLOTS_PER_SLAB>  Used;
+    };
+
+    struct HookEntry
+    {
+        uint8_t* Target   = nullptr;
+        uint8_t* Slot     = nullptr;
+        uint8_t  Backup[PATCH_SIZE] = {};
+        bool     Enabled  = false;
+        bool     Queued   = false; // Wanted state, applied by ApplyQueuedInlineHooks.
+    };
+
+    struct Registry
+    {
+        std::mutex                           Mutex;
+        std::vector<Slab>                    Slabs;
+        std::unordered_map<void*, HookEntry> Hooks;
+    };
+
+
+
+    // Hooks are usually owned by globals of other translation units, the registry has to outlive their destructors.
+    Registry& GetRegistry()
+    {
+        static auto* registry = new Registry();
+        return *registry;
+    }
+
+
+
+    bool IsInRange(const void* from, const void* to) noexcept
+    {
+        int64_t distance = reinterpret_cast<intptr_t>(to) - reinterpret_cast<intptr_t>(from);
+        return distance >= -MAX_DISTANCE && distance <= MAX_DISTANCE;
+    }
+
+
+
+    bool IsExecutable(const void* address) noexcept
+    {
+        Protection protection = 0;
+        if (!QueryProtection(address, &protection))
+            return false;
+
+#ifdef PZVEND_IS_WINDOWS
+        return (protection & (PAGE_EXECUTE | PAGE_EXECUTE_READ | PAGE_EXECUTE_READWRITE | PAGE_EXECUTE_WRITECOPY)) != 0;
+#else
+        return (protection & PROT_EXEC) != 0;
+#endif
+    }
+
+
+
+    bool WriteCode(uint8_t* destination, const uint8_t* source, size_t size) noexcept
+    {
+        Protection old = 0;
+        if (!Unprotect(destination, size, &old))
+            return false;
+
+        memcpy(destination, source, size);
+
+        Protect(destination, size, old);
+        FlushInstructionCache(destination, size);
+        return true;
+    }
+
+
+
+    /*
+    Writes up to 8 bytes with a single store when they share an aligned qword, so a thread running
+    through the prologue sees either the old or the new bytes and never a torn jump.
+    */
+    bool WritePatch(uint8_t* destination, const uint8_t* source, size_t size) noexcept
+    {
+        const uintptr_t offset = reinterpret_cast<uintptr_t>(destination) & 7;
+        if (offset + size > 8)
+            return WriteCode(destination, source, size);
+
+        auto* qword = reinterpret_cast<uint64_t*>(destination - offset);
+
+        Protection old = 0;
+        if (!Unprotect(qword, sizeof(uint64_t), &old))
+            return false;
+
+        std::atomic_ref<uint64_t> ref(*qword);
+        uint64_t value = ref.load(std::memory_order_relaxed);
+        memcpy(reinterpret_cast<uint8_t*>(&value) + offset, source, size);
+        ref.store(value, std::memory_order_release);
+
+        Protect(qword, sizeof(uint64_t), old);
+        FlushInstructionCache(qword, sizeof(uint64_t));
+        return true;
+    }
+
+
+
+#ifdef PZVEND_IS_WINDOWS
+    uint8_t* AllocateSlab(uint8_t* target) noexcept
+    {
+        SYSTEM_INFO info = {};
+        GetSystemInfo(&info);
+
+        const uintptr_t granularity = info.dwAllocationGranularity;
+        const uintptr_t origin      = reinterpret_cast<uintptr_t>(target);
+        const uintptr_t lowest      = std::max<uintptr_t>(reinterpret_cast<uintptr_t>(info.lpMinimumApplicationAddress), origin > MAX_DISTANCE ? origin - MAX_DISTANCE : 0);
+        const uintptr_t highest     = std::min<uintptr_t>(reinterpret_cast<uintptr_t>(info.lpMaximumApplicationAddress), origin + MAX_DISTANCE - SLAB_SIZE);
+
+        // Walk down from the target first, images usually have free space right below them.
+        for (uintptr_t address = (origin & ~(granularity - 1)) - granularity; address >= lowest && address < origin; )
+        {
+            MEMORY_BASIC_INFORMATION region = {};
+            if (!VirtualQuery(reinterpret_cast<void*>(address), &region, sizeof(region)))
+                break;
+
+            if (region.State == MEM_FREE)
+            {
+                void* slab = VirtualAlloc(reinterpret_cast<void*>(address), SLAB_SIZE, MEM_RESERVE | MEM_COMMIT, PAGE_EXECUTE_READ);
+                if (slab)
+                    return static_cast<uint8_t*>(slab);
+            }
+
+            address = (reinterpret_cast<uintptr_t>(region.AllocationBase) & ~(granularity - 1)) - granularity;
+        }
+
+        for (uintptr_t address = (origin & ~(granularity - 1)) + granularity; address <= highest; )
+        {
+            MEMORY_BASIC_INFORMATION region = {};
+            if (!VirtualQuery(reinterpret_cast<void*>(address), &region, sizeof(region)))
+                break;
+
+            if (region.State == MEM_FREE)
+            {
+                void* slab = VirtualAlloc(reinterpret_cast<void*>(address), SLAB_SIZE, MEM_RESERVE | MEM_COMMIT, PAGE_EXECUTE_READ);
+                if (slab)
+                    return static_cast<uint8_t*>(slab);
+            }
+
+            address = (reinterpret_cast<uintptr_t>(region.BaseAddress) + region.RegionSize + granularity - 1) & ~(granularity - 1);
+        }
+
+        return nullptr;
+    }
+
+
+
+    void FreeSlab(uint8_t* slab) noexcept
+    {
+        VirtualFree(slab, 0, MEM_RELEASE);
+    }
+#else
+    uint8_t* AllocateSlab(uint8_t* target) noexcept
+    {
+        // Collect the gaps between existing mappings and try the ones closest to the target first.
+        FILE* maps = fopen("/proc/self/maps", "r");
+        if (!maps)
+            return nullptr;
+
+        const uintptr_t origin     = reinterpret_cast<uintptr_t>(target);
+        uintptr_t       previous   = static_cast<uintptr_t>(GetPageSize()) * 16; // Stay clear of the null page.
+        char            line[512];
+
+        std::vector<uintptr_t> candidates;
+
+        auto add_gap = [&](uintptr_t start, uintptr_t end)
+        {
+            start = (start + SLAB_SIZE - 1) & ~(SLAB_SIZE - 1);
+            if (end < start + SLAB_SIZE)
+                return;
+
+            // The address inside the gap nearest to the target.
+            uintptr_t address = origin < start ? start : std::min(origin & ~(SLAB_SIZE - 1), (end - SLAB_SIZE) & ~(SLAB_SIZE - 1));
+            if (IsInRange(target, reinterpret_cast<void*>(address)) && IsInRange(target, reinterpret_cast<void*>(address + SLAB_SIZE)))
+                candidates.push_back(address);
+        };
+
+        while (fgets(line, sizeof(line), maps))
+        {
+            uintptr_t start = 0, end = 0;
+            if (sscanf(line, "%" SCNxPTR "-%" SCNxPTR, &start, &end) != 2)
+                continue;
+
+            if (start > previous)
+                add_gap(previous, start);
+
+            previous = std::max(previous, end);
+        }
+
+        fclose(maps);
+        add_gap(previous, origin + MAX_DISTANCE);
+
+        std::sort(candidates.begin(), candidates.end(), [origin](uintptr_t lhs, uintptr_t rhs)
+        {
+            return (lhs > origin ? lhs - origin : origin - lhs) < (rhs > origin ? rhs - origin : origin - rhs);
+        });
+
+#ifdef MAP_FIXED_NOREPLACE
+        constexpr int flags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE;
+#else
+        constexpr int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+#endif
+
+        for (uintptr_t address : candidates)
+        {
+            void* slab = mmap(reinterpret_cast<void*>(address), SLAB_SIZE, PROT_READ | PROT_EXEC, flags, -1, 0);
+            if (slab == MAP_FAILED)
+                continue;
+
+            // Without MAP_FIXED_NOREPLACE the hint can be ignored.
+            if (IsInRange(target, slab) && IsInRange(target, static_cast<uint8_t*>(slab) + SLAB_SIZE))
+                return static_cast<uint8_t*>(slab);
+
+            munmap(slab, SLAB_SIZE);
+        }
+
+        return nullptr;
+    }
+
+
+
+    void FreeSlab(uint8_t* slab) noexcept
+    {
+        munmap(slab, SLAB_SIZE);
+    }
+#endif
+
+
+
+    uint8_t* AllocateSlot(uint8_t* target) noexcept
+    {
+        for (Slab& slab : GetRegistry().Slabs)
+        {
+            if (slab.Used.all() || !IsInRange(target, slab.Base) || !IsInRange(target, slab.Base + SLAB_SIZE))
+                continue;
+
+            for (size_t i = 0; i < SLOTS_PER_SLAB; i++)
+            {
+                if (!slab.Used[i])
+                {
+                    slab.Used[i] = true;
+                    return slab.Base + i * SLOT_SIZE;
+                }
+            }
+        }
+
+        uint8_t* base = AllocateSlab(target);
+        if (!base)
+            return nullptr;
+
+        Slab& slab = GetRegistry().Slabs.emplace_back();
+        slab.Base    = base;
+        slab.Used[0] = true;
+        return base;
+    }
+
+
+
+    void FreeSlot(uint8_t* slot) noexcept
+    {
+        for (auto it = GetRegistry().Slabs.begin(); it != GetRegistry().Slabs.end(); ++it)
+        {
+            if (slot < it->Base || slot >= it->Base + SLAB_SIZE)
+                continue;
+
+            it->Used[(slot - it->Base) / SLOT_SIZE] = false;
+
+            if (it->Used.none())
+            {
+                FreeSlab(it->Base);
+                GetRegistry().Slabs.erase(it);
+            }
+
+            return;
+        }
+    }
+
+
+
+    /*
+    Small emitter for the trampoline, knows where the code is going to live so relative
+    operands can be computed against the final address.
+    */
+    class CodeWriter
+    {
+    public:
+        CodeWriter(uint8_t* buffer, uint8_t* address, size_t capacity)
+            : m_Buffer(buffer), m_Address(address), m_Capacity(capacity)
+        {}
+
+        bool Bytes(const uint8_t* bytes, size_t size)
+        {
+            if (m_Size + size > m_Capacity)
+                return false;
+
+            memcpy(m_Buffer + m_Size, bytes, size);
+            m_Size += size;
+            return true;
+        }
+
+        bool Bytes(std::initializer_list<uint8_t> bytes) { return Bytes(bytes.begin(), bytes.size()); }
+
+        bool Int32(int32_t value)  { return Bytes(reinterpret_cast<const uint8_t*>(&value), sizeof(value)); }
+        bool Int64(uint64_t value) { return Bytes(reinterpret_cast<const uint8_t*>(&value), sizeof(value)); }
+
+        // Relative displacement from the end of an instruction of `length` bytes starting at the cursor.
+        bool Relative(const uint8_t* destination, size_t length, int32_t& out_relative) const
+        {
+            int64_t relative = destination - (m_Address + m_Size + length);
+            out_relative = static_cast<int32_t>(relative);
+            return relative == out_relative;
+        }
+
+        bool Jump(const uint8_t* destination)
+        {
+            int32_t relative = 0;
+            if (Relative(destination, 5, relative))
+                return Bytes({ 0xE9 }) && Int32(relative);
+
+            // jmp [rip + 0]; dq destination
+            return Bytes({ 0xFF, 0x25, 0x00, 0x00, 0x00, 0x00 }) && Int64(reinterpret_cast<uint64_t>(destination));
+        }
+
+        bool Call(const uint8_t* destination)
+        {
+            int32_t relative = 0;
+            if (Relative(destination, 5, relative))
+                return Bytes({ 0xE8 }) && Int32(relative);
+
+            // call [rip + 2]; jmp +8; dq destination
+            return Bytes({ 0xFF, 0x15, 0x02, 0x00, 0x00, 0x00, 0xEB, 0x08 }) && Int64(reinterpret_cast<uint64_t>(destination));
+        }
+
+        bool JumpIf(uint8_t condition, const uint8_t* destination)
+        {
+            int32_t relative = 0;
+            if (Relative(destination, 6, relative))
+                return Bytes({ 0x0F, static_cast<uint8_t>(0x80 | condition) }) && Int32(relative);
+
+            // Inverted jcc over an absolute jump.
+            return Bytes({ static_cast<uint8_t>(0x70 | (condition ^ 1)), 0x0E }) &&
+                   Bytes({ 0xFF, 0x25, 0x00, 0x00, 0x00, 0x00 }) && Int64(reinterpret_cast<uint64_t>(destination));
+        }
+
+        uint8_t* Cursor() const { return m_Address + m_Size; }
+        size_t   Size()   const { return m_Size; }
+
+    private:
+        uint8_t* m_Buffer;
+        uint8_t* m_Address;
+        size_t   m_Capacity;
+        size_t   m_Size = 0;
+    };
+
+
+
+    /*
+    Copies whole instructions from the target until the patch fits and relocates them.
+    Branches back into the overwritten bytes can't be supported since those are gone once the hook is enabled.
+    */
+    InlineHookStatus BuildTrampoline(uint8_t* target, uint8_t* trampoline, uint8_t* out_code, size_t& out_size)
+    {
+        CodeWriter writer(out_code, trampoline, TRAMPOLINE_SIZE);
+
+        std::vector<uint8_t*> branch_targets;
+        size_t                copied = 0;
+        bool                  ended  = false;
+
+        while (copied < PATCH_SIZE)
+        {
+            // A return or jmp ended the function before the patch fits.
+            if (ended)
+                return INLINE_UNSUPPORTED_FUNCTION;
+
+            uint8_t*    source = target + copied;
+            Instruction instruction;
+
+            if (!Disassemble(source, instruction))
+                return INLINE_UNSUPPORTED_FUNCTION;
+
+            uint8_t* next = source + instruction.Length;
+            bool     ok   = true;
+
+            if (instruction.IsRipRelative)
+            {
+                int32_t displacement = 0;
+                memcpy(&displacement, source + instruction.DispOffset, sizeof(displacement));
+
+                const uint8_t* address = next + displacement;
+                uint8_t        buffer[16];
+
+                memcpy(buffer, source, instruction.Length);
+
+                // The operand is relative to the end of the copied instruction.
+                if (!writer.Relative(address, instruction.Length, displacement))
+                    return INLINE_UNSUPPORTED_FUNCTION;
+
+                memcpy(buffer + instruction.DispOffset, &displacement, sizeof(displacement));
+                ok = writer.Bytes(buffer, instruction.Length);
+            }
+            else if (instruction.Branch != BRANCH_NONE)
+            {
+                uint8_t* destination = next + instruction.RelTarget;
+                branch_targets.push_back(destination);
+
+                switch (instruction.Branch)
+                {
+                case BRANCH_JMP:
+                    ok    = writer.Jump(destination);
+                    ended = true;
+                    break;
+
+                case BRANCH_CALL:
+                    ok = writer.Call(destination);
+                    break;
+
+                case BRANCH_JCC:
+                    ok = writer.JumpIf(instruction.Opcode & 0x0F, destination);
+                    break;
+
+                default:
+                    return INLINE_UNSUPPORTED_FUNCTION;
+                }
+            }
+            else
+            {
+                ok    = writer.Bytes(source, instruction.Length);
+                ended = instruction.IsReturn;
+            }
+
+            if (!ok)
+                return INLINE_UNSUPPORTED_FUNCTION;
+
+            copied += instruction.Length;
+        }
+
+        for (uint8_t* destination : branch_targets)
+        {
+            if (destination > target && destination < target + copied)
+                return INLINE_UNSUPPORTED_FUNCTION;
+        }
+
+        if (!ended && !writer.Jump(target + copied))
+            return INLINE_UNSUPPORTED_FUNCTION;
+
+        out_size = writer.Size();
+        return INLINE_OK;
+    }
+
+
+
+    void BuildPatch(const HookEntry& entry, bool enable, uint8_t (&out_patch)[PATCH_SIZE]) noexcept
+    {
+        if (!enable)
+        {
+            memcpy(out_patch, entry.Backup, PATCH_SIZE);
+            return;
+        }
+
+        int32_t relative = static_cast<int32_t>(entry.Slot - (entry.Target + PATCH_SIZE));
+        out_patch[0] = 0xE9;
+        memcpy(out_patch + 1, &relative, sizeof(relative));
+    }
+
+
+
+    PZvend::Memory::InlineHookStatus QueueInlineHook(void* target, bool enable)
+    {
+#ifndef PZVEND_NATIVE_HOOK_SUPPORTED
+        return INLINE_UNSUPPORTED_PLATFORM;
+#else
+        std::lock_guard lock(GetRegistry().Mutex);
+
+        auto it = GetRegistry().Hooks.find(target);
+        if (it == GetRegistry().Hooks.end())
+            return INLINE_NOT_CREATED;
+
+        it->second.Queued = enable;
+        return INLINE_OK;
+#endif
+    }
+}
+
+
+
+const char* PZvend::Memory::InlineHookStatusToString(InlineHookStatus status) noexcept
+{
+    switch (status)
+    {
+    case INLINE_OK:                   return "INLINE_OK";
+    case INLINE_ALREADY_CREATED:      return "INLINE_ALREADY_CREATED";
+    case INLINE_NOT_CREATED:          return "INLINE_NOT_CREATED";
+    case INLINE_ENABLED:              return "INLINE_ENABLED";
+    case INLINE_DISABLED:             return "INLINE_DISABLED";
+    case INLINE_NOT_EXECUTABLE:       return "INLINE_NOT_EXECUTABLE";
+    case INLINE_UNSUPPORTED_FUNCTION: return "INLINE_UNSUPPORTED_FUNCTION";
+    case INLINE_MEMORY_ALLOC:         return "INLINE_MEMORY_ALLOC";
+    case INLINE_MEMORY_PROTECT:       return "INLINE_MEMORY_PROTECT";
+    case INLINE_UNSUPPORTED_PLATFORM: return "INLINE_UNSUPPORTED_PLATFORM";
+    }
+
+    return "INLINE_UNKNOWN";
+}
+
+
+
+PZvend::Memory::InlineHookStatus PZvend::Memory::CreateInlineHook(void* target, void* detour, void** out_original)
+{
+#ifndef PZVEND_NATIVE_HOOK_SUPPORTED
+    return INLINE_UNSUPPORTED_PLATFORM;
+#else
+    std::lock_guard lock(GetRegistry().Mutex);
+
+    if (GetRegistry().Hooks.contains(target))
+        return INLINE_ALREADY_CREATED;
+
+    if (!IsExecutable(target) || !IsExecutable(detour))
+        return INLINE_NOT_EXECUTABLE;
+
+    auto* code = static_cast<uint8_t*>(target);
+    auto* slot = AllocateSlot(code);
+    if (!slot)
+        return INLINE_MEMORY_ALLOC;
+
+    uint8_t buffer[SLOT_SIZE];
+    memset(buffer, 0xCC, sizeof(buffer));
+
+    // Relay: jmp [rip + 2] to the 8 byte aligned detour address.
+    const uint8_t relay[] = { 0xFF, 0x25, 0x02, 0x00, 0x00, 0x00 };
+    const auto    address = reinterpret_cast<uint64_t>(detour);
+    memcpy(buffer, relay, sizeof(relay));
+    memcpy(buffer + RELAY_ADDRESS, &address, sizeof(address));
+
+    size_t trampoline_size = 0;
+    auto   status          = BuildTrampoline(code, slot + RELAY_SIZE, buffer + RELAY_SIZE, trampoline_size);
+
+    if (status != INLINE_OK)
+    {
+        FreeSlot(slot);
+        return status;
+    }
+
+    if (!WriteCode(slot, buffer, RELAY_SIZE + trampoline_size))
+    {
+        FreeSlot(slot);
+        return INLINE_MEMORY_PROTECT;
+    }
+
+    HookEntry& entry = GetRegistry().Hooks[target];
+    entry.Target = code;
+    entry.Slot   = slot;
+    memcpy(entry.Backup, code, PATCH_SIZE);
+
+    if (out_original)
+        *out_original = slot + RELAY_SIZE;
+
+    return INLINE_OK;
+#endif
+}
+
+
+
+PZvend::Memory::InlineHookStatus PZvend::Memory::RemoveInlineHook(void* target)
+{
+#ifndef PZVEND_NATIVE_HOOK_SUPPORTED
+    return INLINE_UNSUPPORTED_PLATFORM;
+#else
+    std::lock_guard lock(GetRegistry().Mutex);
+
+    auto it = GetRegistry().Hooks.find(target);
+    if (it == GetRegistry().Hooks.end())
+        return INLINE_NOT_CREATED;
+
+    HookEntry& entry = it->second;
+    if (entry.Enabled && !WritePatch(entry.Target, entry.Backup, PATCH_SIZE))
+        return INLINE_MEMORY_PROTECT;
+
+    // A thread may still be inside the trampoline, the slot is recycled but the slab stays mapped while other hooks use it.
+    FreeSlot(entry.Slot);
+    GetRegistry().Hooks.erase(it);
+    return INLINE_OK;
+#endif
+}
+
+
+
+PZvend::Memory::InlineHookStatus PZvend::Memory::EnableInlineHook(void* target)
+{
+#ifndef PZVEND_NATIVE_HOOK_SUPPORTED
+    return INLINE_UNSUPPORTED_PLATFORM;
+#else
+    std::lock_guard lock(GetRegistry().Mutex);
+
+    auto it = GetRegistry().Hooks.find(target);
+    if (it == GetRegistry().Hooks.end())
+        return INLINE_NOT_CREATED;
+
+    HookEntry& entry = it->second;
+    if (entry.Enabled)
+        return INLINE_ENABLED;
+
+    uint8_t patch[PATCH_SIZE];
+    BuildPatch(entry, true, patch);
+
+    if (!WritePatch(entry.Target, patch, PATCH_SIZE))
+        return INLINE_MEMORY_PROTECT;
+
+    entry.Enabled = true;
+    entry.Queued  = true;
+    return INLINE_OK;
+#endif
+}
+
+
+
+PZvend::Memory::InlineHookStatus PZvend::Memory::DisableInlineHook(void* target)
+{
+#ifndef PZVEND_NATIVE_HOOK_SUPPORTED
+    return INLINE_UNSUPPORTED_PLATFORM;
+#else
+    std::lock_guard lock(GetRegistry().Mutex);
+
+    auto it = GetRegistry().Hooks.find(target);
+    if (it == GetRegistry().Hooks.end())
+        return INLINE_NOT_CREATED;
+
+    HookEntry& entry = it->second;
+    if (!entry.Enabled)
+        return INLINE_DISABLED;
+
+    if (!WritePatch(entry.Target, entry.Backup, PATCH_SIZE))
+        return INLINE_MEMORY_PROTECT;
+
+    entry.Enabled = false;
+    entry.Queued  = false;
+    return INLINE_OK;
+#endif
+}
+
+
+
+PZvend::Memory::InlineHookStatus PZvend::Memory::SetInlineHookDetour(void* target, void* detour)
+{
+#ifndef PZVEND_NATIVE_HOOK_SUPPORTED
+    return INLINE_UNSUPPORTED_PLATFORM;
+#else
+    std::lock_guard lock(GetRegistry().Mutex);
+
+    auto it = GetRegistry().Hooks.find(target);
+    if (it == GetRegistry().Hooks.end())
+        return INLINE_NOT_CREATED;
+
+    if (!IsExecutable(detour))
+        return INLINE_NOT_EXECUTABLE;
+
+    const auto address = reinterpret_cast<uint64_t>(detour);
+    if (!WritePatch(it->second.Slot + RELAY_ADDRESS, reinterpret_cast<const uint8_t*>(&address), sizeof(address)))
+        return INLINE_MEMORY_PROTECT;
+
+    return INLINE_OK;
+#endif
+}
+
+
+
+PZvend::Memory::InlineHookStatus PZvend::Memory::QueueEnableInlineHook(void* target)
+{
+    return QueueInlineHook(target, true);
+}
+
+
+
+PZvend::Memory::InlineHookStatus PZvend::Memory::QueueDisableInlineHook(void* target)
+{
+    return QueueInlineHook(target, false);
+}
+
+
+
+PZvend::Memory::InlineHookStatus PZvend::Memory::ApplyQueuedInlineHooks()
+{
+#ifndef PZVEND_NATIVE_HOOK_SUPPORTED
+    return INLINE_UNSUPPORTED_PLATFORM;
+#else
+    std::lock_guard lock(GetRegistry().Mutex);
+
+    // Patches that fit an aligned qword are widened to it, PatchSet stores those at once like WritePatch does.
+    // Two targets can share a qword, their patches are merged first.
+    std::map<uint8_t*, uint64_t> qwords;
+    std::vector<HookEntry*>      changed;
+    PatchSet                     patches("InlineHooks");
+
+    for (auto& [target, entry] : GetRegistry().Hooks)
+    {
+        if (entry.Queued == entry.Enabled)
+            continue;
+
+        uint8_t patch[PATCH_SIZE];
+        BuildPatch(entry, entry.Queued, patch);
+        changed.push_back(&entry);
+
+        const uintptr_t offset = reinterpret_cast<uintptr_t>(entry.Target) & 7;
+        if (offset + PATCH_SIZE > 8)
+        {
+            if (!patches.Add(entry.Target, patch, PATCH_SIZE))
+                return INLINE_UNSUPPORTED_FUNCTION;
+
+            continue;
+        }
+
+        uint8_t* qword = entry.Target - offset;
+        auto     it    = qwords.try_emplace(qword, std::atomic_ref<uint64_t>(*reinterpret_cast<uint64_t*>(qword)).load(std::memory_order_relaxed)).first;
+        memcpy(reinterpret_cast<uint8_t*>(&it->second) + offset, patch, PATCH_SIZE);
+    }
+
+    if (changed.empty())
+        return INLINE_OK;
+
+    for (const auto& [qword, value] : qwords)
+    {
+        if (!patches.Add(qword, reinterpret_cast<const uint8_t*>(&value), sizeof(value)))
+            return INLINE_UNSUPPORTED_FUNCTION;
+    }
+
+    if (!patches.Apply())
+        return INLINE_MEMORY_PROTECT;
+
+    for (HookEntry* entry : changed)
+        entry->Enabled = entry->Queued;
+
+    return INLINE_OK;
+#endif
+}
@@ -1,5 +1,11 @@
 #include "ProjectZvend/Paths.hpp"
 
+#include "Macros.hpp"
+
+#ifdef PZVEND_IS_LINUX
+    #include <dlfcn.h>
+#endif
+
 bool PZvend::Path::Create(const std::string& path)
 {
     bool result = true;
@@ -39,6 +45,7 @@ bool PZvend::Path::Exist(const std::string& path)
 
 
 
+#ifdef PZVEND_IS_WINDOWS
 std::string PZvend::Path::GetModulePath(HMODULE hModule)
 {
     char path[MAX_PATH];
@@ -50,3 +57,16 @@ std::string PZvend::Path::GetModulePath(HMODULE hModule)
 
     return std::filesystem::path(path).parent_path().string();
 }
+#else
+std::string PZvend::Path::GetModulePath(const void* address)
+{
+    Dl_info info = {};
+
+    if (0 == dladdr(address, &info) || !info.dli_fname)
+    {
+        return "";
+    }
+
+    return std::filesystem::absolute(info.dli_fname).parent_path().string();
+}
+#endif
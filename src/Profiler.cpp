@@ -0,0 +1,406 @@
+#include "ProjectZvend/Profiler.hpp"
+#include "ProjectZvend/Log.hpp"
+
+#include "Macros.hpp"
+
+#ifdef PZVEND_IS_WINDOWS
+    #include <wtypes.h>
+#else
+    #include <sys/syscall.h>
+    #include <unistd.h>
+#endif
+
+#include <spdlog/spdlog.h>
+
+#include <array>
+#include <condition_variable>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+
+
+namespace
+{
+    using namespace PZvend::Profiler;
+
+    constexpr uint64_t RING_MASK = PROFILER_RING_CAPACITY - 1;
+
+    struct Zone
+    {
+        const char* Name  = nullptr;
+        uint64_t    Start = 0;
+        uint64_t    End   = 0;
+    };
+
+    /*
+    Single producer (the owning thread), single consumer (the flusher). The owner only moves Head,
+    the flusher only moves Tail, so neither side ever waits for the other.
+    */
+    struct ThreadRing
+    {
+        uint32_t              Id        = 0;
+        uint64_t              OsId      = 0;
+        bool                  Announced = false; // Flusher only, thread record / metadata written this session.
+        std::atomic<bool>     Retired   = false; // The thread exited, the ring is freed once drained.
+        std::atomic<uint64_t> Dropped   = 0;
+
+        alignas(64) std::atomic<uint64_t> Head = 0;
+        alignas(64) std::atomic<uint64_t> Tail = 0;
+
+        std::array<Zone, PROFILER_RING_CAPACITY> Zones;
+    };
+
+    struct Session
+    {
+        std::mutex                               Control;     // Start / Stop
+        std::mutex                               RingsMutex;
+        std::vector<std::unique_ptr<ThreadRing>> Rings;
+        uint32_t                                 LastThreadId = 0;
+
+        std::mutex                               WakeMutex;
+        std::condition_variable                  Wakeup;
+        bool                                     Stopping     = false;
+        std::thread                              Flusher;
+
+        // Set up by Start, only the flusher touches them while the session runs.
+        bool                                     Running      = false;
+        std::ofstream                            File;
+        ProfilerFormat                           Format       = PROFILER_CHROME_JSON;
+        uint64_t                                 StartTicks   = 0;
+        double                                   TicksPerSecond = 1.0;
+        bool                                     FirstEvent   = true;
+        std::unordered_map<const char*, uint32_t> Names;
+        std::atomic<uint64_t>                    RetiredDropped = 0;
+    };
+
+
+
+    // Threads record until they exit, the session has to outlive every thread_local destructor.
+    Session& GetSession()
+    {
+        static auto* session = new Session();
+        return *session;
+    }
+
+
+
+    uint64_t GetOsThreadId() noexcept
+    {
+#ifdef PZVEND_IS_WINDOWS
+        return GetCurrentThreadId();
+#else
+        return static_cast<uint64_t>(syscall(SYS_gettid));
+#endif
+    }
+
+
+
+    ThreadRing* GetThreadRing()
+    {
+        struct Handle
+        {
+            ThreadRing* Ring = nullptr;
+            ~Handle()
+            {
+                if (Ring)
+                    Ring->Retired.store(true, std::memory_order_release);
+            }
+        };
+
+        thread_local Handle handle;
+        if (handle.Ring)
+            return handle.Ring;
+
+        Session& session = GetSession();
+        auto     ring    = std::make_unique<ThreadRing>();
+        ring->OsId = GetOsThreadId();
+
+        std::lock_guard lock(session.RingsMutex);
+        ring->Id    = ++session.LastThreadId;
+        handle.Ring = ring.get();
+        session.Rings.push_back(std::move(ring));
+        return handle.Ring;
+    }
+
+
+
+    template <class T>
+    void WriteRaw(std::string& out, const T& value)
+    {
+        out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+
+
+    void AppendEscaped(std::string& out, const char* text)
+    {
+        for (; *text; text++)
+        {
+            const char c = *text;
+            if (c == '"' || c == '\\')
+                out += '\\';
+
+            if (static_cast<unsigned char>(c) < 0x20)
+                continue;
+
+            out += c;
+        }
+    }
+
+
+
+    void WriteZone(Session& session, ThreadRing& ring, const Zone& zone, std::string& out)
+    {
+        if (session.Format == PROFILER_BINARY)
+        {
+            if (!ring.Announced)
+            {
+                WriteRaw(out, uint8_t(2));
+                WriteRaw(out, ring.Id);
+                WriteRaw(out, ring.OsId);
+                ring.Announced = true;
+            }
+
+            auto [it, added] = session.Names.try_emplace(zone.Name, static_cast<uint32_t>(session.Names.size() + 1));
+            if (added)
+            {
+                const uint16_t length = static_cast<uint16_t>(std::min<size_t>(strlen(zone.Name), UINT16_MAX));
+
+                WriteRaw(out, uint8_t(1));
+                WriteRaw(out, it->second);
+                WriteRaw(out, length);
+                out.append(zone.Name, length);
+            }
+
+            WriteRaw(out, uint8_t(3));
+            WriteRaw(out, ring.Id);
+            WriteRaw(out, it->second);
+            WriteRaw(out, zone.Start);
+            WriteRaw(out, zone.End);
+            return;
+        }
+
+        auto separate = [&session, &out]()
+        {
+            out += session.FirstEvent ? "\n" : ",\n";
+            session.FirstEvent = false;
+        };
+
+        if (!ring.Announced)
+        {
+            separate();
+            fmt::format_to(std::back_inserter(out), R"({{"name":"thread_name","ph":"M","pid":1,"tid":{},"args":{{"name":"Thread {}"}}}})", ring.Id, ring.OsId);
+            ring.Announced = true;
+        }
+
+        // Trace events are in microseconds, zones that started before the session are clamped to its start.
+        const double to_us    = 1e6 / session.TicksPerSecond;
+        const double start_us = static_cast<double>(static_cast<int64_t>(zone.Start - session.StartTicks)) * to_us;
+        const double dur_us   = static_cast<double>(zone.End - zone.Start) * to_us;
+
+        separate();
+        out += R"({"name":")";
+        AppendEscaped(out, zone.Name);
+        fmt::format_to(std::back_inserter(out), R"(","ph":"X","pid":1,"tid":{},"ts":{:.3f},"dur":{:.3f}}})", ring.Id, std::max(start_us, 0.0), dur_us);
+    }
+
+
+
+    void Flush(Session& session)
+    {
+        std::vector<ThreadRing*> rings;
+        {
+            std::lock_guard lock(session.RingsMutex);
+            for (const auto& ring : session.Rings)
+                rings.push_back(ring.get());
+        }
+
+        std::string out;
+        std::vector<ThreadRing*> retired;
+
+        for (ThreadRing* ring : rings)
+        {
+            // Read before draining, a retired thread can't push anything after the flag.
+            const bool     exited = ring->Retired.load(std::memory_order_acquire);
+            const uint64_t head   = ring->Head.load(std::memory_order_acquire);
+            uint64_t       tail   = ring->Tail.load(std::memory_order_relaxed);
+
+            for (; tail != head; tail++)
+                WriteZone(session, *ring, ring->Zones[tail & RING_MASK], out);
+
+            ring->Tail.store(tail, std::memory_order_release);
+
+            if (exited)
+                retired.push_back(ring);
+        }
+
+        if (!out.empty())
+        {
+            session.File.write(out.data(), static_cast<std::streamsize>(out.size()));
+            session.File.flush();
+        }
+
+        if (retired.empty())
+            return;
+
+        std::lock_guard lock(session.RingsMutex);
+        std::erase_if(session.Rings, [&session, &retired](const std::unique_ptr<ThreadRing>& ring)
+        {
+            if (std::find(retired.begin(), retired.end(), ring.get()) == retired.end())
+                return false;
+
+            session.RetiredDropped.fetch_add(ring->Dropped.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            return true;
+        });
+    }
+
+
+
+    void FlushLoop(std::chrono::milliseconds interval)
+    {
+        Session&         session = GetSession();
+        std::unique_lock lock(session.WakeMutex);
+
+        while (!session.Wakeup.wait_for(lock, interval, [&session]() { return session.Stopping; }))
+        {
+            lock.unlock();
+            Flush(session);
+            lock.lock();
+        }
+    }
+}
+
+
+
+bool PZvend::Profiler::Start(const std::string& path, ProfilerFormat format, std::chrono::milliseconds interval)
+{
+    Session&        session = GetSession();
+    std::lock_guard control(session.Control);
+
+    if (session.Running)
+    {
+        PZ_LOG_ERROR(TIMING, "A profiler session is already running.");
+        return false;
+    }
+
+    session.File.open(path, std::ios::binary | std::ios::trunc);
+    if (!session.File)
+    {
+        PZ_LOG_ERROR(TIMING, "Could not open the profiler trace '{}'.", path);
+        return false;
+    }
+
+    session.Format         = format;
+    session.TicksPerSecond = GetCycleCounterFrequency();
+    session.FirstEvent     = true;
+    session.Stopping       = false;
+    session.Names.clear();
+    session.RetiredDropped.store(0, std::memory_order_relaxed);
+
+    // Zones recorded after the last session are stale, the flusher isn't running so the tails are ours.
+    {
+        std::lock_guard lock(session.RingsMutex);
+        for (const auto& ring : session.Rings)
+        {
+            ring->Tail.store(ring->Head.load(std::memory_order_acquire), std::memory_order_release);
+            ring->Dropped.store(0, std::memory_order_relaxed);
+            ring->Announced = false;
+        }
+    }
+
+    session.StartTicks = ReadCycleCounter();
+
+    std::string header;
+    if (format == PROFILER_BINARY)
+    {
+        header.append("PZTRACE", 8);
+        WriteRaw(header, PROFILER_BINARY_VERSION);
+        WriteRaw(header, uint32_t(0));
+        WriteRaw(header, session.TicksPerSecond);
+        WriteRaw(header, session.StartTicks);
+    }
+    else
+    {
+        header = R"({"displayTimeUnit":"ns","traceEvents":[)";
+    }
+
+    session.File.write(header.data(), static_cast<std::streamsize>(header.size()));
+
+    session.Running = true;
+    session.Flusher = std::thread(FlushLoop, interval);
+    g_Enabled.store(true, std::memory_order_release);
+
+    PZ_LOG_DEBUG(TIMING, "Started profiler session '{}' at {:.0f} ticks/s.", path, session.TicksPerSecond);
+    return true;
+}
+
+
+
+void PZvend::Profiler::Stop()
+{
+    Session&        session = GetSession();
+    std::lock_guard control(session.Control);
+
+    if (!session.Running)
+        return;
+
+    g_Enabled.store(false, std::memory_order_release);
+
+    {
+        std::lock_guard lock(session.WakeMutex);
+        session.Stopping = true;
+    }
+
+    session.Wakeup.notify_all();
+    session.Flusher.join();
+
+    // Zones finished between the last flush and the join.
+    Flush(session);
+
+    if (session.Format == PROFILER_CHROME_JSON)
+        session.File << "\n]}\n";
+
+    session.File.close();
+    session.Running = false;
+
+    const uint64_t dropped = GetDroppedZones();
+    if (dropped)
+        PZ_LOG_WARN(TIMING, "Profiler dropped {} zones, flush more often or raise PROFILER_RING_CAPACITY.", dropped);
+
+    PZ_LOG_DEBUG(TIMING, "Stopped profiler session.");
+}
+
+
+
+uint64_t PZvend::Profiler::GetDroppedZones() noexcept
+{
+    Session& session = GetSession();
+    uint64_t dropped = session.RetiredDropped.load(std::memory_order_relaxed);
+
+    std::lock_guard lock(session.RingsMutex);
+    for (const auto& ring : session.Rings)
+        dropped += ring->Dropped.load(std::memory_order_relaxed);
+
+    return dropped;
+}
+
+
+
+void PZvend::Profiler::Record(const char* name, uint64_t start, uint64_t end) noexcept
+{
+    ThreadRing* ring = GetThreadRing();
+
+    const uint64_t head = ring->Head.load(std::memory_order_relaxed);
+    if (head - ring->Tail.load(std::memory_order_acquire) >= PROFILER_RING_CAPACITY)
+    {
+        ring->Dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    ring->Zones[head & RING_MASK] = { name, start, end };
+    ring->Head.store(head + 1, std::memory_order_release);
+}
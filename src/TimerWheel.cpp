@@ -0,0 +1,486 @@
+#include "ProjectZvend/TimerWheel.hpp"
+#include "ProjectZvend/Log.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <cmath>
+
+
+
+namespace
+{
+    constexpr uint64_t GetLevelSpan(uint32_t level) noexcept
+    {
+        return 1ull << (PZvend::TIMER_WHEEL_BITS * level);
+    }
+}
+
+
+
+PZvend::TimerWheel::TimerWheel(double tick)
+    : m_TickDuration(std::max<std::chrono::steady_clock::duration>(
+          std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(tick)),
+          std::chrono::steady_clock::duration(1))),
+      m_Start(std::chrono::steady_clock::now())
+{
+    m_Lists.fill(NO_NODE);
+}
+
+
+
+PZvend::TimerWheel::~TimerWheel()
+{
+    StopThread();
+}
+
+
+
+PZvend::TimerId PZvend::TimerWheel::Schedule(double delay, TimerCallback callback, CancellationToken token)
+{
+    return ISchedule(delay, 0, std::move(callback), std::move(token));
+}
+
+
+
+PZvend::TimerId PZvend::TimerWheel::SchedulePeriodic(double interval, TimerCallback callback, CancellationToken token)
+{
+    return ISchedule(interval, std::max<uint64_t>(IToTicks(interval), 1), std::move(callback), std::move(token));
+}
+
+
+
+bool PZvend::TimerWheel::Cancel(TimerId id)
+{
+    std::lock_guard lock(m_Mutex);
+
+    Node* node = IResolve(id);
+    if (!node || node->Cancelled)
+        return false;
+
+    // The callback is running right now, a one-shot timer has run by then and a periodic one stops after it.
+    if (node->Firing)
+    {
+        if (!node->Period)
+            return false;
+
+        node->Cancelled = true;
+        return true;
+    }
+
+    const auto index = static_cast<uint32_t>(id) - 1;
+    IUnlink(index);
+    IFree(index);
+    return true;
+}
+
+
+
+bool PZvend::TimerWheel::IsScheduled(TimerId id)
+{
+    std::lock_guard lock(m_Mutex);
+
+    Node* node = IResolve(id);
+    return node && !node->Cancelled && !(node->Firing && !node->Period);
+}
+
+
+
+size_t PZvend::TimerWheel::Tick()
+{
+    return Tick(std::chrono::steady_clock::now());
+}
+
+
+
+size_t PZvend::TimerWheel::Tick(std::chrono::steady_clock::time_point now)
+{
+    std::unique_lock lock(m_Mutex);
+
+    // A callback ticking the wheel again would run timers out of order.
+    if (m_Ticking || now <= m_Start)
+        return 0;
+
+    const auto target = static_cast<uint64_t>((now - m_Start) / m_TickDuration);
+    if (target <= m_Current)
+        return 0;
+
+    m_Ticking = true;
+    size_t fired = 0;
+
+    while (m_Current < target)
+    {
+        // Ticks before the next event neither cascade nor run anything, skip them at once.
+        const uint64_t next = INextEvent();
+        if (next > target)
+        {
+            m_Current = target;
+            break;
+        }
+
+        m_Current = next;
+
+        // Higher levels first, a timer can cascade through several levels within one tick.
+        for (uint32_t level = TIMER_WHEEL_LEVELS - 1; level > 0; level--)
+        {
+            if ((m_Current & (GetLevelSpan(level) - 1)) == 0)
+                ICascade(level);
+        }
+
+        fired += IRunDue(lock);
+    }
+
+    m_Ticking = false;
+    return fired;
+}
+
+
+
+bool PZvend::TimerWheel::StartThread()
+{
+    std::lock_guard lock(m_Mutex);
+
+    if (m_Thread.joinable())
+        return false;
+
+    m_Stopping = false;
+    m_Thread   = std::thread([this]()
+    {
+        std::unique_lock lock(m_Mutex);
+
+        while (!m_Stopping)
+        {
+            // Sleep until the next tick that runs or cascades something, scheduling an earlier timer moves the deadline.
+            const uint64_t deadline = INextEvent();
+            const auto     woken    = [this, deadline]() { return m_Stopping || m_Deadline != deadline; };
+
+            m_Deadline = deadline;
+
+            if (deadline == NO_EVENT)
+                m_Wakeup.wait(lock, woken);
+            else if (!m_Wakeup.wait_until(lock, m_Start + m_TickDuration * static_cast<int64_t>(deadline), woken))
+            {
+                m_Deadline = 0;
+
+                lock.unlock();
+                Tick();
+                lock.lock();
+            }
+        }
+
+        m_Deadline = 0;
+    });
+
+    return true;
+}
+
+
+
+void PZvend::TimerWheel::StopThread()
+{
+    {
+        std::lock_guard lock(m_Mutex);
+        m_Stopping = true;
+    }
+
+    m_Wakeup.notify_all();
+
+    if (m_Thread.joinable())
+        m_Thread.join();
+}
+
+
+
+void PZvend::TimerWheel::Reserve(size_t timers)
+{
+    std::lock_guard lock(m_Mutex);
+    m_Nodes.reserve(timers);
+}
+
+
+
+size_t PZvend::TimerWheel::GetCount()
+{
+    std::lock_guard lock(m_Mutex);
+    return m_Count;
+}
+
+
+
+PZvend::TimerId PZvend::TimerWheel::ISchedule(double delay, uint64_t period, TimerCallback callback, CancellationToken token)
+{
+    if (!callback)
+        return 0;
+
+    std::unique_lock lock(m_Mutex);
+
+    // Delays count from the last tick. An empty wheel may not have been ticked for a while, catch it up first.
+    if (!m_Count && !m_Ticking)
+    {
+        const auto now = std::chrono::steady_clock::now();
+        if (now > m_Start)
+            m_Current = std::max<uint64_t>(m_Current, static_cast<uint64_t>((now - m_Start) / m_TickDuration));
+    }
+
+    uint32_t index = m_FreeList;
+    if (index != NO_NODE)
+    {
+        m_FreeList = m_Nodes[index].Next;
+    }
+    else
+    {
+        index = static_cast<uint32_t>(m_Nodes.size());
+        m_Nodes.emplace_back();
+    }
+
+    Node& node = m_Nodes[index];
+    node.Callback  = std::move(callback);
+    node.Token     = std::move(token);
+    node.Expires   = m_Current + std::max<uint64_t>(IToTicks(delay), 1);
+    node.Period    = period;
+    node.Next      = NO_NODE;
+    node.Firing    = false;
+    node.Cancelled = false;
+
+    IInsert(index);
+    m_Count++;
+
+    const auto id = (static_cast<uint64_t>(node.Generation) << 32) | (index + 1);
+
+    // The thread sleeps until its deadline, wake it if this timer is due earlier.
+    const bool wake = node.Expires < m_Deadline;
+    if (wake)
+        m_Deadline = node.Expires;
+
+    lock.unlock();
+
+    if (wake)
+        m_Wakeup.notify_all();
+
+    return id;
+}
+
+
+
+uint64_t PZvend::TimerWheel::IToTicks(double seconds) const noexcept
+{
+    if (!(seconds > 0.0))
+        return 0;
+
+    return static_cast<uint64_t>(std::ceil(seconds / GetTickDuration()));
+}
+
+
+
+PZvend::TimerWheel::Node* PZvend::TimerWheel::IResolve(TimerId id) noexcept
+{
+    const auto index      = static_cast<uint32_t>(id) - 1;
+    const auto generation = static_cast<uint32_t>(id >> 32);
+
+    if (!id || index >= m_Nodes.size() || m_Nodes[index].Generation != generation)
+        return nullptr;
+
+    return &m_Nodes[index];
+}
+
+
+
+void PZvend::TimerWheel::IInsert(uint32_t index)
+{
+    const Node&    node  = m_Nodes[index];
+    const uint64_t delta = node.Expires > m_Current ? node.Expires - m_Current : 0;
+
+    uint32_t level = 0;
+    while (level < TIMER_WHEEL_LEVELS - 1 && delta >= GetLevelSpan(level + 1))
+        level++;
+
+    // Beyond the last level the timer waits in its farthest slot and gets placed again when that cascades.
+    const uint64_t expires = std::min<uint64_t>(node.Expires, m_Current + GetLevelSpan(TIMER_WHEEL_LEVELS) - 1);
+    const uint32_t slot    = static_cast<uint32_t>(expires >> (TIMER_WHEEL_BITS * level)) & (TIMER_WHEEL_SLOTS - 1);
+
+    ILink(index, level * TIMER_WHEEL_SLOTS + slot);
+}
+
+
+
+void PZvend::TimerWheel::ILink(uint32_t index, uint32_t list)
+{
+    Node& node = m_Nodes[index];
+    node.List = list;
+    node.Prev = NO_NODE;
+    node.Next = m_Lists[list];
+
+    if (node.Next != NO_NODE)
+        m_Nodes[node.Next].Prev = index;
+
+    m_Lists[list] = index;
+}
+
+
+
+void PZvend::TimerWheel::IUnlink(uint32_t index)
+{
+    Node& node = m_Nodes[index];
+    if (node.List == NO_LIST)
+        return;
+
+    if (node.Prev != NO_NODE)
+        m_Nodes[node.Prev].Next = node.Next;
+    else
+        m_Lists[node.List] = node.Next;
+
+    if (node.Next != NO_NODE)
+        m_Nodes[node.Next].Prev = node.Prev;
+
+    node.List = NO_LIST;
+    node.Prev = NO_NODE;
+    node.Next = NO_NODE;
+}
+
+
+
+void PZvend::TimerWheel::IFree(uint32_t index)
+{
+    Node& node = m_Nodes[index];
+    node.Callback  = nullptr;
+    node.Token     = {};
+    node.Firing    = false;
+    node.Cancelled = false;
+    node.Generation++;
+
+    node.Next  = m_FreeList;
+    m_FreeList = index;
+    m_Count--;
+}
+
+
+
+void PZvend::TimerWheel::ICascade(uint32_t level)
+{
+    const uint32_t slot = static_cast<uint32_t>(m_Current >> (TIMER_WHEEL_BITS * level)) & (TIMER_WHEEL_SLOTS - 1);
+    const uint32_t list = level * TIMER_WHEEL_SLOTS + slot;
+
+    uint32_t index = m_Lists[list];
+    m_Lists[list]  = NO_NODE;
+
+    while (index != NO_NODE)
+    {
+        const uint32_t next = m_Nodes[index].Next;
+
+        m_Nodes[index].List = NO_LIST;
+        IInsert(index);
+        index = next;
+    }
+}
+
+
+
+uint64_t PZvend::TimerWheel::INextEvent() const noexcept
+{
+    if (!m_Count)
+        return NO_EVENT;
+
+    uint64_t next = NO_EVENT;
+
+    // Level 0 fires its slots, the first occupied one within a round is the earliest.
+    for (uint64_t tick = m_Current + 1; tick <= m_Current + TIMER_WHEEL_SLOTS; tick++)
+    {
+        if (m_Lists[tick & (TIMER_WHEEL_SLOTS - 1)] != NO_NODE)
+        {
+            next = tick;
+            break;
+        }
+    }
+
+    // Higher levels only matter at their cascade points, the slot of each point is the one that cascades there.
+    for (uint32_t level = 1; level < TIMER_WHEEL_LEVELS; level++)
+    {
+        const uint32_t shift = TIMER_WHEEL_BITS * level;
+        const uint64_t span  = GetLevelSpan(level);
+
+        uint64_t tick = ((m_Current >> shift) + 1) << shift;
+        for (uint32_t i = 0; i < TIMER_WHEEL_SLOTS && tick < next; i++, tick += span)
+        {
+            const uint32_t slot = static_cast<uint32_t>(tick >> shift) & (TIMER_WHEEL_SLOTS - 1);
+            if (m_Lists[level * TIMER_WHEEL_SLOTS + slot] != NO_NODE)
+            {
+                next = tick;
+                break;
+            }
+        }
+    }
+
+    return next;
+}
+
+
+
+size_t PZvend::TimerWheel::IRunDue(std::unique_lock<std::mutex>& lock)
+{
+    const uint32_t list = static_cast<uint32_t>(m_Current) & (TIMER_WHEEL_SLOTS - 1);
+    if (m_Lists[list] == NO_NODE)
+        return 0;
+
+    // Move the slot aside, callbacks can schedule into it (next round) or cancel timers that are still due.
+    m_Lists[RUNNING_LIST] = m_Lists[list];
+    m_Lists[list]         = NO_NODE;
+
+    for (uint32_t index = m_Lists[RUNNING_LIST]; index != NO_NODE; index = m_Nodes[index].Next)
+        m_Nodes[index].List = RUNNING_LIST;
+
+    size_t fired = 0;
+    while (m_Lists[RUNNING_LIST] != NO_NODE)
+    {
+        const uint32_t index = m_Lists[RUNNING_LIST];
+        IUnlink(index);
+
+        Node& node = m_Nodes[index];
+        if (node.Expires > m_Current)
+        {
+            IInsert(index);
+            continue;
+        }
+
+        if (node.Token.IsCancelled())
+        {
+            IFree(index);
+            continue;
+        }
+
+        // Scheduling from the callback can grow the pool, the callback must not live in a node while it runs.
+        TimerCallback callback = std::move(node.Callback);
+        node.Firing = true;
+
+        lock.unlock();
+
+        try
+        {
+            callback();
+        }
+        catch (const std::exception& e)
+        {
+            PZ_LOG_ERROR(TIMING, "Timer callback threw: {}", e.what());
+        }
+        catch (...)
+        {
+            PZ_LOG_ERROR(TIMING, "Timer callback threw an unknown exception.");
+        }
+
+        lock.lock();
+        fired++;
+
+        Node& fired_node = m_Nodes[index];
+        fired_node.Firing = false;
+
+        if (!fired_node.Period || fired_node.Cancelled || fired_node.Token.IsCancelled())
+        {
+            IFree(index);
+            continue;
+        }
+
+        fired_node.Callback = std::move(callback);
+        fired_node.Expires += fired_node.Period;
+        IInsert(index);
+    }
+
+    return fired;
+}
@@ -0,0 +1,88 @@
+#include "ProjectZvend/TimingStats.hpp"
+
+
+
+void PZvend::TimingStats::Merge(const TimingStats& other) noexcept
+{
+    if (!other.m_Count)
+        return;
+
+    if (!m_Count)
+    {
+        *this = other;
+        return;
+    }
+
+    // Chan et al.: combines two Welford states without revisiting the samples.
+    const double count       = static_cast<double>(m_Count);
+    const double other_count = static_cast<double>(other.m_Count);
+    const double total       = count + other_count;
+    const double delta       = other.m_Mean - m_Mean;
+
+    m_Mean  += delta * other_count / total;
+    m_M2    += other.m_M2 + delta * delta * count * other_count / total;
+    m_Count += other.m_Count;
+    m_Min    = std::min(m_Min, other.m_Min);
+    m_Max    = std::max(m_Max, other.m_Max);
+
+    for (uint32_t bucket = 0; bucket < TIMING_BUCKETS; bucket++)
+        m_Buckets[bucket] += other.m_Buckets[bucket];
+}
+
+
+
+void PZvend::TimingStats::Reset() noexcept
+{
+    *this = TimingStats();
+}
+
+
+
+uint64_t PZvend::TimingStats::GetPercentile(double percentile) const noexcept
+{
+    if (!m_Count)
+        return 0;
+
+    const auto target  = static_cast<uint64_t>(std::clamp(percentile, 0.0, 1.0) * static_cast<double>(m_Count - 1)) + 1;
+    uint64_t   reached = 0;
+
+    for (uint32_t bucket = 0; bucket < TIMING_BUCKETS; bucket++)
+    {
+        reached += m_Buckets[bucket];
+        if (reached >= target)
+            return std::clamp(GetBucketLimit(bucket), m_Min, m_Max);
+    }
+
+    return m_Max;
+}
+
+
+
+PZvend::TimingSummary PZvend::TimingStats::GetSummary() const noexcept
+{
+    TimingSummary summary;
+    summary.Count  = m_Count;
+    summary.Min    = GetMin();
+    summary.Max    = GetMax();
+    summary.Mean   = GetMean();
+    summary.StdDev = GetStdDev();
+
+    if (!m_Count)
+        return summary;
+
+    // One pass for all four percentiles instead of walking the buckets per percentile.
+    const double   percentiles[] = { 0.5, 0.9, 0.99, 0.999 };
+    uint64_t*      outputs[]     = { &summary.P50, &summary.P90, &summary.P99, &summary.P999 };
+    size_t         next          = 0;
+    uint64_t       reached       = 0;
+
+    for (uint32_t bucket = 0; bucket < TIMING_BUCKETS && next < std::size(percentiles); bucket++)
+    {
+        reached += m_Buckets[bucket];
+
+        while (next < std::size(percentiles) && reached >= static_cast<uint64_t>(percentiles[next] * static_cast<double>(m_Count - 1)) + 1)
+            *outputs[next++] = std::clamp(GetBucketLimit(bucket), m_Min, m_Max);
+    }
+
+    return summary;
+}
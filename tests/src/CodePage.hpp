@@ -0,0 +1,92 @@
+#pragma once
+
+#include "ProjectZvend/Memory.hpp"
+
+#ifdef _WIN32
+    #include <windows.h>
+#else
+    #include <sys/mman.h>
+#endif
+
+#include <cstring>
+#include <initializer_list>
+
+
+
+namespace Tests
+{
+    /*
+    One page of hand written code per test, written while writable and executed after.
+    Functions take one int and return one, the argument register differs between the ABIs.
+    */
+    class CodePage
+    {
+    public:
+        static constexpr size_t SIZE = 0x1000;
+
+        CodePage()
+        {
+        #ifdef _WIN32
+            m_Code = static_cast<uint8_t*>(VirtualAlloc(nullptr, SIZE, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE));
+        #else
+            void* code = mmap(nullptr, SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            m_Code = code == MAP_FAILED ? nullptr : static_cast<uint8_t*>(code);
+        #endif
+            // int3 everywhere, running off the written code traps instead of sliding.
+            if (m_Code)
+                memset(m_Code, 0xCC, SIZE);
+        }
+
+        ~CodePage()
+        {
+        #ifdef _WIN32
+            VirtualFree(m_Code, 0, MEM_RELEASE);
+        #else
+            munmap(m_Code, SIZE);
+        #endif
+        }
+
+        CodePage(const CodePage&)            = delete;
+        CodePage& operator=(const CodePage&) = delete;
+
+        void Write(size_t offset, std::initializer_list<uint8_t> bytes)
+        {
+            memcpy(m_Code + offset, bytes.begin(), bytes.size());
+        }
+
+        // rel32 of an instruction ending at `next`, pointing at `destination`.
+        void Rel32(size_t offset, size_t next, size_t destination)
+        {
+            int32_t relative = static_cast<int32_t>(destination - next);
+            memcpy(m_Code + offset, &relative, sizeof(relative));
+        }
+
+        bool Seal()
+        {
+        #ifdef _WIN32
+            bool sealed = PZvend::Memory::Protect(m_Code, SIZE, PAGE_EXECUTE_READ);
+        #else
+            bool sealed = PZvend::Memory::Protect(m_Code, SIZE, PROT_READ | PROT_EXEC);
+        #endif
+            PZvend::Memory::FlushInstructionCache(m_Code, SIZE);
+            return sealed;
+        }
+
+        uint8_t* Get() const noexcept { return m_Code; }
+
+    private:
+        uint8_t* m_Code = nullptr;
+    };
+
+
+
+#ifdef _WIN32
+    constexpr uint8_t ARG = 1; // ecx
+#else
+    constexpr uint8_t ARG = 7; // edi
+#endif
+
+    constexpr uint8_t ADD_EAX_ARG  = 0xC0 | (ARG << 3); // 01 /r  add eax, arg
+    constexpr uint8_t LEA_EAX_ARG  = 0x40 | ARG;        // 8D /r  lea eax, [arg + disp8]
+    constexpr uint8_t TEST_ARG_ARG = 0xC0 | (ARG << 3) | ARG;
+}
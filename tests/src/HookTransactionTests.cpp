@@ -0,0 +1,219 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "ProjectZvend/HookTransaction.hpp"
+
+#include "CodePage.hpp"
+
+#include <array>
+#include <cstring>
+#include <memory>
+
+using namespace PZvend::Memory;
+using namespace Tests;
+
+
+// The native backend only exists for x86-64.
+#if defined(__x86_64__) || defined(_M_X64)
+
+namespace
+{
+    using Target_FUNC = int(*)(int);
+
+    constexpr size_t HOOK_COUNT = 3;
+
+    std::array<NativeHook<Target_FUNC>, HOOK_COUNT> g_Hooks;
+
+    template <size_t N>
+    int Detour(int value)
+    {
+        return g_Hooks[N].Call(value) + 1000 * static_cast<int>(N + 1);
+    }
+
+    int CallTarget(Target_FUNC target, int value)
+    {
+        Target_FUNC volatile function = target;
+        return function(value);
+    }
+
+
+
+    /*
+    (value + offset) * 2, long enough to be hooked.
+    */
+    std::unique_ptr<CodePage> MakeTarget(uint8_t offset)
+    {
+        auto page = std::make_unique<CodePage>();
+        REQUIRE(page->Get());
+
+        page->Write(0x00, { 0x8D, LEA_EAX_ARG, offset }); // lea eax, [arg + offset]
+        page->Write(0x03, { 0x8D, 0x04, 0x00 });          // lea eax, [rax + rax]
+        page->Write(0x06, { 0xC3 });
+        REQUIRE(page->Seal());
+        return page;
+    }
+
+
+
+    /*
+    Four bytes, shorter than the patch, creating a hook on it fails.
+    */
+    std::unique_ptr<CodePage> MakeShortTarget()
+    {
+        auto page = std::make_unique<CodePage>();
+        REQUIRE(page->Get());
+
+        page->Write(0x00, { 0x8D, LEA_EAX_ARG, 1, 0xC3 }); // lea eax, [arg + 1]; ret
+        REQUIRE(page->Seal());
+        return page;
+    }
+
+
+
+    struct Targets
+    {
+        std::array<std::unique_ptr<CodePage>, HOOK_COUNT> Pages;
+        std::array<std::array<uint8_t, 8>, HOOK_COUNT>    Original = {};
+
+        Targets()
+        {
+            for (size_t i = 0; i < HOOK_COUNT; i++)
+            {
+                Pages[i] = MakeTarget(static_cast<uint8_t>(i + 1));
+                memcpy(Original[i].data(), Pages[i]->Get(), Original[i].size());
+            }
+
+            g_Hooks[0] = NativeHook<Target_FUNC>("Tests.Transaction.0", Get(0), &Detour<0>);
+            g_Hooks[1] = NativeHook<Target_FUNC>("Tests.Transaction.1", Get(1), &Detour<1>);
+            g_Hooks[2] = NativeHook<Target_FUNC>("Tests.Transaction.2", Get(2), &Detour<2>);
+        }
+
+        ~Targets()
+        {
+            for (auto& hook : g_Hooks)
+                hook.Remove();
+        }
+
+        Target_FUNC Get(size_t index) const { return reinterpret_cast<Target_FUNC>(Pages[index]->Get()); }
+
+        bool IsOriginal(size_t index) const { return memcmp(Pages[index]->Get(), Original[index].data(), Original[index].size()) == 0; }
+    };
+}
+
+
+
+TEST_CASE("HookTransaction commits every hook at once", "[transaction]")
+{
+    Targets targets;
+
+    HookTransaction transaction("Tests.Commit");
+    transaction.Create(g_Hooks[0]).Enable(g_Hooks[0]);
+    transaction.Create(g_Hooks[1]).Enable(g_Hooks[1]);
+    transaction.Create(g_Hooks[2]).Enable(g_Hooks[2]);
+
+    REQUIRE(transaction.Commit());
+    CHECK(transaction.GetCount() == 0);
+    REQUIRE(transaction.GetResults().size() == 6);
+
+    for (const HookOperationResult& result : transaction.GetResults())
+        CHECK(result.Success);
+
+    for (size_t i = 0; i < HOOK_COUNT; i++)
+    {
+        CHECK(g_Hooks[i].IsEnabled());
+        CHECK_FALSE(targets.IsOriginal(i));
+        CHECK(CallTarget(targets.Get(i), 1) == (2 + static_cast<int>(i)) * 2 + 1000 * static_cast<int>(i + 1));
+        CHECK(g_Hooks[i].Call(1) == (2 + static_cast<int>(i)) * 2);
+    }
+
+    transaction.Disable(g_Hooks[0]).Remove(g_Hooks[1]).Remove(g_Hooks[2]);
+    REQUIRE(transaction.Commit());
+
+    CHECK_FALSE(g_Hooks[0].IsEnabled());
+    CHECK(CallTarget(targets.Get(0), 1) == 4);
+
+    for (size_t i = 0; i < HOOK_COUNT; i++)
+        CHECK(targets.IsOriginal(i));
+
+    CHECK(EnableInlineHook(targets.Pages[1]->Get()) == INLINE_NOT_CREATED);
+}
+
+
+
+TEST_CASE("HookTransaction rolls back the hooks it created when a create fails", "[transaction]")
+{
+    Targets targets;
+    auto    short_page = MakeShortTarget();
+
+    NativeHook<Target_FUNC> failing("Tests.Transaction.Short", reinterpret_cast<Target_FUNC>(short_page->Get()), &Detour<0>);
+
+    HookTransaction transaction("Tests.CreateFails");
+    transaction.Create(g_Hooks[0]).Enable(g_Hooks[0]);
+    transaction.Create(g_Hooks[1]).Enable(g_Hooks[1]);
+    transaction.Create(failing).Enable(failing);
+
+    REQUIRE_FALSE(transaction.Commit());
+
+    const auto& results = transaction.GetResults();
+    REQUIRE(results.size() == 6);
+    CHECK(results[0].Status == "ROLLED_BACK");
+    CHECK(results[2].Status == "ROLLED_BACK");
+    CHECK(results[4].Status == "INLINE_UNSUPPORTED_FUNCTION");
+
+    for (size_t i = 0; i < 2; i++)
+    {
+        CHECK_FALSE(g_Hooks[i].IsEnabled());
+        CHECK(targets.IsOriginal(i));
+        CHECK(EnableInlineHook(targets.Pages[i]->Get()) == INLINE_NOT_CREATED);
+        CHECK(CallTarget(targets.Get(i), 1) == (2 + static_cast<int>(i)) * 2);
+    }
+
+    // The hook objects were reset as well, they can be created again.
+    CHECK(g_Hooks[0].Create());
+}
+
+
+
+TEST_CASE("HookTransaction restores enabled hooks when the apply phase fails", "[transaction]")
+{
+    Targets targets;
+
+    // Enabled before the transaction, it queues a disable that has to be undone.
+    REQUIRE(g_Hooks[0].Create());
+    REQUIRE(g_Hooks[0].Enable());
+
+    std::array<uint8_t, 8> enabled_bytes = {};
+    memcpy(enabled_bytes.data(), targets.Pages[0]->Get(), enabled_bytes.size());
+
+    HookTransaction transaction("Tests.EnableFails");
+    transaction.Disable(g_Hooks[0]);
+    transaction.Create(g_Hooks[1]).Enable(g_Hooks[1]);
+    transaction.Enable(g_Hooks[2]); // Never created.
+
+    REQUIRE_FALSE(transaction.Commit());
+
+    const auto& results = transaction.GetResults();
+    REQUIRE(results.size() == 4);
+    CHECK(results[0].Status == "ROLLED_BACK");
+    CHECK(results[1].Status == "ROLLED_BACK");
+    CHECK(results[2].Status == "ROLLED_BACK");
+    CHECK(results[3].Status == "NOT_CREATED");
+
+    // The disable never went through, the hook still runs.
+    CHECK(g_Hooks[0].IsEnabled());
+    CHECK(memcmp(targets.Pages[0]->Get(), enabled_bytes.data(), enabled_bytes.size()) == 0);
+    CHECK(CallTarget(targets.Get(0), 1) == 1004);
+
+    // The created hook was removed again, the never created one is untouched.
+    CHECK_FALSE(g_Hooks[1].IsEnabled());
+    CHECK(targets.IsOriginal(1));
+    CHECK(EnableInlineHook(targets.Pages[1]->Get()) == INLINE_NOT_CREATED);
+    CHECK(targets.IsOriginal(2));
+
+    // Nothing is left queued, the next apply doesn't pick up the rolled back changes.
+    CHECK(ApplyQueuedInlineHooks() == INLINE_OK);
+    CHECK(g_Hooks[0].IsEnabled());
+    CHECK(CallTarget(targets.Get(0), 1) == 1004);
+    CHECK(targets.IsOriginal(1));
+}
+
+#endif
@@ -0,0 +1,157 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "ProjectZvend/ImportHook.hpp"
+
+#ifdef _WIN32
+    #include <windows.h>
+#else
+    #include <unistd.h>
+#endif
+
+using namespace PZvend::Memory;
+
+
+namespace
+{
+    // Two imports of the test executable itself, an empty module name selects it on both platforms.
+#ifdef _WIN32
+    using Id_FUNC = DWORD(WINAPI*)();
+
+    constexpr const char* FIRST_SYMBOL  = "GetCurrentProcessId";
+    constexpr const char* SECOND_SYMBOL = "GetCurrentThreadId";
+
+    DWORD CallFirst()  { return GetCurrentProcessId(); }
+    DWORD CallSecond() { return GetCurrentThreadId(); }
+    #define ID_CALL WINAPI
+#else
+    using Id_FUNC = pid_t(*)();
+
+    constexpr const char* FIRST_SYMBOL  = "getpid";
+    constexpr const char* SECOND_SYMBOL = "getppid";
+
+    pid_t CallFirst()  { return getpid(); }
+    pid_t CallSecond() { return getppid(); }
+    #define ID_CALL
+#endif
+
+    constexpr const char* MAIN_MODULE = "";
+
+    ImportHook<Id_FUNC> g_Hook;
+    int                 g_HookCalls = 0;
+
+    auto ID_CALL FirstDetour()
+    {
+        g_HookCalls++;
+        return g_Hook.Call();
+    }
+
+    Id_FUNC g_OriginalFirst  = nullptr;
+    Id_FUNC g_OriginalSecond = nullptr;
+    int     g_FirstCalls     = 0;
+    int     g_SecondCalls    = 0;
+
+    auto ID_CALL SetFirstDetour()
+    {
+        g_FirstCalls++;
+        return g_OriginalFirst();
+    }
+
+    auto ID_CALL SetSecondDetour()
+    {
+        g_SecondCalls++;
+        return g_OriginalSecond();
+    }
+}
+
+
+
+TEST_CASE("FindImportSlots resolves the executable's imports", "[import]")
+{
+    const auto expected = CallFirst();
+
+    std::vector<ImportSlot> slots = FindImportSlots(FIRST_SYMBOL, MAIN_MODULE);
+    REQUIRE_FALSE(slots.empty());
+
+    for (const ImportSlot& slot : slots)
+    {
+        CHECK(*slot.Address == slot.Original);
+        CHECK(reinterpret_cast<Id_FUNC>(slot.Original)() == expected);
+    }
+
+    CHECK(FindImportSlots("PZvendNotImported", MAIN_MODULE).empty());
+    CHECK(FindImportSlots(FIRST_SYMBOL, "PZvendNoSuchModule").empty());
+    CHECK(FindImportSlots(nullptr).empty());
+    CHECK(FindImportSlots("").empty());
+}
+
+
+
+TEST_CASE("ImportHook redirects and restores an import", "[import]")
+{
+    const auto expected = CallFirst();
+
+    g_Hook      = ImportHook<Id_FUNC>("Tests.First", FIRST_SYMBOL, &FirstDetour, MAIN_MODULE);
+    g_HookCalls = 0;
+
+    REQUIRE(g_Hook.Create());
+    CHECK(CallFirst() == expected);
+    CHECK(g_HookCalls == 0);
+
+    REQUIRE(g_Hook.Enable());
+    CHECK(g_Hook.IsEnabled());
+    CHECK(CallFirst() == expected);
+    CHECK(g_HookCalls == 1);
+
+    // The original stays callable while the slots point at the detour.
+    CHECK(g_Hook.Call() == expected);
+    CHECK(g_HookCalls == 1);
+
+    REQUIRE(g_Hook.Disable());
+    CHECK(CallFirst() == expected);
+    CHECK(g_HookCalls == 1);
+
+    REQUIRE(g_Hook.Enable());
+    REQUIRE(g_Hook.Remove());
+    CHECK_FALSE(g_Hook.IsEnabled());
+    CHECK(CallFirst() == expected);
+    CHECK(g_HookCalls == 1);
+
+    // Import slots may live in RELRO or a read only IAT, they have to be protected again.
+    for (const ImportSlot& slot : FindImportSlots(FIRST_SYMBOL, MAIN_MODULE))
+        CHECK(*slot.Address == slot.Original);
+}
+
+
+
+TEST_CASE("ImportHookSet swaps all of its imports at once", "[import]")
+{
+    const auto first  = CallFirst();
+    const auto second = CallSecond();
+
+    g_FirstCalls  = 0;
+    g_SecondCalls = 0;
+
+    ImportHookSet set("Tests.Set");
+    REQUIRE(set.Add(FIRST_SYMBOL, reinterpret_cast<void*>(&SetFirstDetour), reinterpret_cast<void**>(&g_OriginalFirst), MAIN_MODULE));
+    REQUIRE(set.Add(SECOND_SYMBOL, reinterpret_cast<void*>(&SetSecondDetour), reinterpret_cast<void**>(&g_OriginalSecond), MAIN_MODULE));
+    CHECK_FALSE(set.Add("PZvendNotImported", nullptr, nullptr, MAIN_MODULE));
+    CHECK(set.GetSlotCount() >= 2);
+
+    REQUIRE(set.Enable());
+    CHECK(CallFirst() == first);
+    CHECK(CallSecond() == second);
+    CHECK(g_FirstCalls == 1);
+    CHECK(g_SecondCalls == 1);
+
+    // Hooks can only be queued while the set is disabled.
+    CHECK_FALSE(set.Add(FIRST_SYMBOL, reinterpret_cast<void*>(&SetFirstDetour), nullptr, MAIN_MODULE));
+
+    REQUIRE(set.Disable());
+    CHECK(CallFirst() == first);
+    CHECK(CallSecond() == second);
+    CHECK(g_FirstCalls == 1);
+    CHECK(g_SecondCalls == 1);
+
+    REQUIRE(set.Clear());
+    CHECK(set.GetSlotCount() == 0);
+}
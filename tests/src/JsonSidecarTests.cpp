@@ -0,0 +1,88 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "ProjectZvend/JSON.hpp"
+
+#include <filesystem>
+#include <fstream>
+
+
+
+namespace
+{
+    std::filesystem::path GetTestPath(const char* name)
+    {
+        const auto directory = std::filesystem::temp_directory_path() / "ProjectZvend_tests";
+        std::filesystem::create_directories(directory);
+
+        const auto path = directory / name;
+        std::filesystem::remove(path);
+        std::filesystem::remove(path.string() + ".pzcache");
+        return path;
+    }
+
+    void WriteText(const std::filesystem::path& path, const std::string& text)
+    {
+        std::ofstream(path, std::ios::binary | std::ios::trunc) << text;
+    }
+
+    int LoadValue(const std::filesystem::path& path)
+    {
+        PZvend::JSON json(path.string(), true);
+
+        int value = 0;
+        json.Get(value, "Value");
+        return value;
+    }
+}
+
+
+
+TEST_CASE("JSON sidecar is used while the text is unchanged", "[json]")
+{
+    const auto path = GetTestPath("sidecar_fresh.json");
+    WriteText(path, "{ \"Value\": 1 }");
+
+    CHECK(LoadValue(path) == 1);
+    REQUIRE(std::filesystem::exists(path.string() + ".pzcache"));
+
+    // A hit doesn't rewrite the sidecar.
+    const auto written = std::filesystem::last_write_time(path.string() + ".pzcache");
+    CHECK(LoadValue(path) == 1);
+    CHECK(std::filesystem::last_write_time(path.string() + ".pzcache") == written);
+}
+
+
+
+TEST_CASE("JSON sidecar loses against a same-size edit that keeps the write time", "[json]")
+{
+    const auto path = GetTestPath("sidecar_stale.json");
+    WriteText(path, "{ \"Value\": 1 }");
+
+    CHECK(LoadValue(path) == 1);
+    REQUIRE(std::filesystem::exists(path.string() + ".pzcache"));
+
+    // Like `cp -p` or an edit within the clock's granularity: same size, same write time, other bytes.
+    const auto time = std::filesystem::last_write_time(path);
+    WriteText(path, "{ \"Value\": 2 }");
+    std::filesystem::last_write_time(path, time);
+
+    CHECK(LoadValue(path) == 2);
+    CHECK(LoadValue(path) == 2);
+}
+
+
+
+TEST_CASE("JSON saves write a sidecar of the saved text", "[json]")
+{
+    const auto path = GetTestPath("sidecar_save.json");
+
+    PZvend::JSON json;
+    json.SetSidecar(true);
+    json.Set(3, "Value");
+    REQUIRE(json.SaveTo(path.string()));
+    REQUIRE(std::filesystem::exists(path.string() + ".pzcache"));
+
+    const auto written = std::filesystem::last_write_time(path.string() + ".pzcache");
+    CHECK(LoadValue(path) == 3);
+    CHECK(std::filesystem::last_write_time(path.string() + ".pzcache") == written);
+}
@@ -0,0 +1,337 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "ProjectZvend/NativeHook.hpp"
+
+#include "CodePage.hpp"
+#include "Disassembler.hpp"
+
+#include <vector>
+
+using namespace PZvend::Memory;
+using namespace Tests;
+
+
+// The decoder and the trampolines only exist for x86-64.
+#if defined(__x86_64__) || defined(_M_X64)
+
+namespace
+{
+    struct Encoding
+    {
+        std::vector<uint8_t> Bytes;
+        uint8_t              Length;
+        BranchType           Branch      = BRANCH_NONE;
+        bool                 RipRelative = false;
+        bool                 Return      = false;
+    };
+
+
+
+    using Target_FUNC = int(*)(int);
+
+    NativeHook<Target_FUNC> g_Hook;
+
+    int Detour(int value)
+    {
+        return g_Hook.Call(value) + 1000;
+    }
+
+    int Retour(int value)
+    {
+        return g_Hook.Call(value) + 2000;
+    }
+
+    int CallTarget(Target_FUNC target, int value)
+    {
+        Target_FUNC volatile function = target;
+        return function(value);
+    }
+
+
+
+    /*
+    Hooks the page's function at offset 0 and checks the hooked, original and unhooked results.
+    */
+    void CheckHook(CodePage& page, std::initializer_list<std::pair<int, int>> results)
+    {
+        REQUIRE(page.Seal());
+
+        auto target = reinterpret_cast<Target_FUNC>(page.Get());
+        for (auto [argument, result] : results)
+            REQUIRE(CallTarget(target, argument) == result);
+
+        g_Hook = NativeHook<Target_FUNC>("Tests.Native", target, &Detour);
+        REQUIRE(g_Hook.Create());
+
+        // Creating only builds the trampoline, the target is not patched yet.
+        for (auto [argument, result] : results)
+            CHECK(CallTarget(target, argument) == result);
+
+        REQUIRE(g_Hook.Enable());
+        for (auto [argument, result] : results)
+        {
+            CHECK(CallTarget(target, argument) == result + 1000);
+            CHECK(g_Hook.Call(argument) == result);
+        }
+
+        REQUIRE(g_Hook.Disable());
+        for (auto [argument, result] : results)
+        {
+            CHECK(CallTarget(target, argument) == result);
+            CHECK(g_Hook.Call(argument) == result);
+        }
+
+        REQUIRE(g_Hook.Remove());
+        for (auto [argument, result] : results)
+            CHECK(CallTarget(target, argument) == result);
+    }
+
+
+
+    InlineHookStatus TryHook(CodePage& page)
+    {
+        REQUIRE(page.Seal());
+
+        void* original = nullptr;
+        InlineHookStatus status = CreateInlineHook(page.Get(), reinterpret_cast<void*>(&Detour), &original);
+
+        if (status == INLINE_OK)
+            RemoveInlineHook(page.Get());
+
+        return status;
+    }
+}
+
+
+
+TEST_CASE("Disassemble decodes instruction lengths", "[native]")
+{
+    const std::vector<Encoding> encodings =
+    {
+        { { 0x55 },                                                       1 },                          // push rbp
+        { { 0x48, 0x89, 0xE5 },                                           3 },                          // mov rbp, rsp
+        { { 0x48, 0x83, 0xEC, 0x20 },                                     4 },                          // sub rsp, 0x20
+        { { 0x48, 0x81, 0xEC, 0x00, 0x01, 0x00, 0x00 },                   7 },                          // sub rsp, 0x100
+        { { 0xF3, 0x0F, 0x1E, 0xFA },                                     4 },                          // endbr64
+        { { 0x66, 0x0F, 0x1F, 0x44, 0x00, 0x00 },                         6 },                          // nop word [rax + rax]
+        { { 0x0F, 0x1F, 0x80, 0x00, 0x00, 0x00, 0x00 },                   7 },                          // nop dword [rax + 0]
+        { { 0x48, 0xB8, 1, 2, 3, 4, 5, 6, 7, 8 },                         10 },                         // mov rax, imm64
+        { { 0xB8, 1, 2, 3, 4 },                                           5 },                          // mov eax, imm32
+        { { 0xC7, 0x44, 0x24, 0x08, 1, 2, 3, 4 },                         8 },                          // mov dword [rsp + 8], imm32
+        { { 0x66, 0xC7, 0x45, 0xF0, 1, 2 },                               6 },                          // mov word [rbp - 16], imm16
+        { { 0xF6, 0x07, 0x01 },                                           3 },                          // test byte [rdi], 1
+        { { 0xF7, 0xD8 },                                                 2 },                          // neg eax
+        { { 0x65, 0x48, 0x8B, 0x04, 0x25, 0x28, 0x00, 0x00, 0x00 },       9 },                          // mov rax, gs:[0x28]
+        { { 0x0F, 0x05 },                                                 2 },                          // syscall
+        { { 0xC5, 0xF8, 0x77 },                                           3 },                          // vzeroupper
+        { { 0xC4, 0xE3, 0x79, 0x16, 0xC0, 0x01 },                         6 },                          // vpextrd eax, xmm0, 1
+        { { 0x62, 0xF1, 0x7C, 0x48, 0x10, 0x00 },                         6 },                          // vmovups zmm0, [rax]
+        { { 0x48, 0x8B, 0x05, 0x10, 0x00, 0x00, 0x00 },                   7, BRANCH_NONE, true },       // mov rax, [rip + 0x10]
+        { { 0x48, 0x8D, 0x0D, 0x10, 0x00, 0x00, 0x00 },                   7, BRANCH_NONE, true },       // lea rcx, [rip + 0x10]
+        { { 0xC5, 0xFA, 0x6F, 0x05, 0x10, 0x00, 0x00, 0x00 },             8, BRANCH_NONE, true },       // vmovdqu xmm0, [rip + 0x10]
+        { { 0x83, 0x3D, 0x10, 0x00, 0x00, 0x00, 0x00 },                   7, BRANCH_NONE, true },       // cmp dword [rip + 0x10], 0
+        { { 0xE8, 0x10, 0x00, 0x00, 0x00 },                               5, BRANCH_CALL },             // call rel32
+        { { 0xE9, 0x10, 0x00, 0x00, 0x00 },                               5, BRANCH_JMP },              // jmp rel32
+        { { 0xEB, 0x10 },                                                 2, BRANCH_JMP },              // jmp rel8
+        { { 0x74, 0x10 },                                                 2, BRANCH_JCC },              // je rel8
+        { { 0x0F, 0x85, 0x10, 0x00, 0x00, 0x00 },                         6, BRANCH_JCC },              // jne rel32
+        { { 0xE2, 0xFE },                                                 2, BRANCH_LOOP },             // loop rel8
+        { { 0xC3 },                                                       1, BRANCH_NONE, false, true }, // ret
+        { { 0xC2, 0x08, 0x00 },                                           3, BRANCH_NONE, false, true }, // ret 8
+    };
+
+    for (const Encoding& encoding : encodings)
+    {
+        INFO("Opcode bytes: " << encoding.Bytes.size() << ", first " << int(encoding.Bytes[0]) << ", second " << int(encoding.Bytes.size() > 1 ? encoding.Bytes[1] : 0));
+
+        std::vector<uint8_t> code = encoding.Bytes;
+        code.resize(code.size() + 16, 0xCC);
+
+        Instruction instruction;
+        REQUIRE(Disassemble(code.data(), instruction));
+        CHECK(instruction.Length == encoding.Length);
+        CHECK(instruction.Branch == encoding.Branch);
+        CHECK(instruction.IsRipRelative == encoding.RipRelative);
+        CHECK(instruction.IsReturn == encoding.Return);
+    }
+}
+
+
+
+TEST_CASE("Disassemble decodes relocation offsets", "[native]")
+{
+    const uint8_t call[] = { 0xE8, 0xFB, 0xFF, 0xFF, 0xFF };
+    const uint8_t jcc8[] = { 0x74, 0x80 };
+    const uint8_t load[] = { 0x48, 0x8B, 0x05, 0x44, 0x33, 0x22, 0x11 };
+
+    Instruction instruction;
+
+    REQUIRE(Disassemble(call, instruction));
+    CHECK(instruction.RelOffset == 1);
+    CHECK(instruction.RelSize == 4);
+    CHECK(instruction.RelTarget == -5);
+
+    REQUIRE(Disassemble(jcc8, instruction));
+    CHECK(instruction.RelOffset == 1);
+    CHECK(instruction.RelSize == 1);
+    CHECK(instruction.RelTarget == -128);
+    CHECK((instruction.Opcode & 0x0F) == 0x04);
+
+    REQUIRE(Disassemble(load, instruction));
+    CHECK(instruction.DispOffset == 3);
+}
+
+
+
+TEST_CASE("Disassemble rejects invalid encodings", "[native]")
+{
+    const uint8_t push_es[]    = { 0x06, 0xCC };
+    const uint8_t far_call[]   = { 0x9A, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 };
+    const uint8_t two_byte[]   = { 0x0F, 0xFF, 0x00 };
+    const uint8_t prefixes[16] = { 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x90 };
+
+    Instruction instruction;
+    CHECK_FALSE(Disassemble(push_es, instruction));
+    CHECK_FALSE(Disassemble(far_call, instruction));
+    CHECK_FALSE(Disassemble(two_byte, instruction));
+    CHECK_FALSE(Disassemble(prefixes, instruction));
+}
+
+
+
+TEST_CASE("NativeHook relocates a rel32 call prologue", "[native]")
+{
+    CodePage page;
+    REQUIRE(page.Get());
+
+    page.Write(0x00, { 0xE8, 0, 0, 0, 0 });          // call helper
+    page.Rel32(0x01, 0x05, 0x40);
+    page.Write(0x05, { 0x01, ADD_EAX_ARG, 0xC3 });   // add eax, arg; ret
+    page.Write(0x40, { 0xB8, 7, 0, 0, 0, 0xC3 });    // helper: mov eax, 7; ret
+
+    CheckHook(page, { { 0, 7 }, { 5, 12 } });
+}
+
+
+
+TEST_CASE("NativeHook relocates a rel32 jmp prologue", "[native]")
+{
+    CodePage page;
+    REQUIRE(page.Get());
+
+    page.Write(0x00, { 0xE9, 0, 0, 0, 0 });          // jmp body
+    page.Rel32(0x01, 0x05, 0x40);
+    page.Write(0x40, { 0x8D, LEA_EAX_ARG, 5, 0xC3 }); // body: lea eax, [arg + 5]; ret
+
+    CheckHook(page, { { 0, 5 }, { 3, 8 } });
+}
+
+
+
+TEST_CASE("NativeHook relocates jcc prologues", "[native]")
+{
+    CodePage page;
+    REQUIRE(page.Get());
+
+    SECTION("rel32")
+    {
+        page.Write(0x00, { 0x85, TEST_ARG_ARG });             // test arg, arg
+        page.Write(0x02, { 0x0F, 0x84, 0, 0, 0, 0 });         // je zero
+        page.Rel32(0x04, 0x08, 0x40);
+        page.Write(0x08, { 0x8D, LEA_EAX_ARG, 1, 0xC3 });     // lea eax, [arg + 1]; ret
+        page.Write(0x40, { 0xB8, 42, 0, 0, 0, 0xC3 });        // zero: mov eax, 42; ret
+
+        CheckHook(page, { { 0, 42 }, { 3, 4 } });
+    }
+
+    // The trampoline is too far away for rel8, the branch has to be widened.
+    SECTION("rel8")
+    {
+        page.Write(0x00, { 0x85, TEST_ARG_ARG });             // test arg, arg
+        page.Write(0x02, { 0x74, 0x1C });                     // je zero
+        page.Write(0x04, { 0x8D, LEA_EAX_ARG, 1, 0xC3 });     // lea eax, [arg + 1]; ret
+        page.Write(0x20, { 0xB8, 42, 0, 0, 0, 0xC3 });        // zero: mov eax, 42; ret
+
+        CheckHook(page, { { 0, 42 }, { 3, 4 } });
+    }
+}
+
+
+
+TEST_CASE("NativeHook relocates a RIP-relative prologue", "[native]")
+{
+    CodePage page;
+    REQUIRE(page.Get());
+
+    page.Write(0x00, { 0x8B, 0x05, 0, 0, 0, 0 });    // mov eax, [rip + value]
+    page.Rel32(0x02, 0x06, 0x40);
+    page.Write(0x06, { 0x01, ADD_EAX_ARG, 0xC3 });   // add eax, arg; ret
+    page.Write(0x40, { 100, 0, 0, 0 });              // value: dd 100
+
+    CheckHook(page, { { 0, 100 }, { 7, 107 } });
+}
+
+
+
+TEST_CASE("NativeHook refuses prologues it can't relocate", "[native]")
+{
+    CodePage page;
+    REQUIRE(page.Get());
+
+    SECTION("branch into the patched bytes")
+    {
+        page.Write(0x00, { 0x31, 0xC0 });                  // xor eax, eax
+        page.Write(0x02, { 0xFF, 0xC0 });                  // inc eax
+        page.Write(0x04, { 0x75, 0xFC });                  // jne -> inc eax
+        page.Write(0x06, { 0xC3 });
+
+        CHECK(TryHook(page) == INLINE_UNSUPPORTED_FUNCTION);
+    }
+
+    SECTION("loop")
+    {
+        page.Write(0x00, { 0xE2, 0xFE });                  // loop $
+        page.Write(0x02, { 0x31, 0xC0, 0xC3 });
+
+        CHECK(TryHook(page) == INLINE_UNSUPPORTED_FUNCTION);
+    }
+
+    SECTION("function shorter than the patch")
+    {
+        page.Write(0x00, { 0x31, 0xC0, 0xC3 });            // xor eax, eax; ret
+
+        CHECK(TryHook(page) == INLINE_UNSUPPORTED_FUNCTION);
+    }
+}
+
+
+
+TEST_CASE("NativeHook retours and rejects double creation", "[native]")
+{
+    CodePage page;
+    REQUIRE(page.Get());
+
+    page.Write(0x00, { 0x8D, LEA_EAX_ARG, 5 });      // lea eax, [arg + 5]
+    page.Write(0x03, { 0x8D, 0x04, 0x00 });          // lea eax, [rax + rax]
+    page.Write(0x06, { 0xC3 });
+    REQUIRE(page.Seal());
+
+    auto target = reinterpret_cast<Target_FUNC>(page.Get());
+    g_Hook = NativeHook<Target_FUNC>("Tests.Native", target, &Detour);
+
+    REQUIRE(g_Hook.Create());
+    REQUIRE(g_Hook.Enable());
+    CHECK(CallTarget(target, 1) == 1012);
+
+    void* original = nullptr;
+    CHECK(CreateInlineHook(page.Get(), reinterpret_cast<void*>(&Detour), &original) == INLINE_ALREADY_CREATED);
+
+    REQUIRE(g_Hook.Retour(&Retour));
+    CHECK(CallTarget(target, 1) == 2012);
+
+    REQUIRE(g_Hook.Remove());
+    CHECK(CallTarget(target, 1) == 12);
+    CHECK(EnableInlineHook(page.Get()) == INLINE_NOT_CREATED);
+}
+
+#endif
@@ -0,0 +1,118 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "ProjectZvend/Memory.hpp"
+
+using namespace PZvend::Memory;
+
+
+namespace
+{
+    // Read only data spanning two pages, patches on both ends force a protection change per range.
+    alignas(4096) const uint8_t g_Target[2 * 4096] = { 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88 };
+
+    // The compiler would fold reads of the const array to its initializer.
+    uint8_t Read(size_t offset)
+    {
+        return static_cast<const volatile uint8_t*>(g_Target)[offset];
+    }
+
+    void* At(size_t offset)
+    {
+        return const_cast<uint8_t*>(g_Target + offset);
+    }
+}
+
+
+
+TEST_CASE("PatchSet writes and restores every patch", "[patchset]")
+{
+    PatchSet patches("Tests");
+
+    REQUIRE(patches.Add(At(0), { 0xAA, 0xBB }));
+    REQUIRE(patches.AddNop(At(4), 2));
+    REQUIRE(patches.Add(At(sizeof(g_Target) - 1), { 0xCC }));
+    REQUIRE(patches.GetCount() == 3);
+
+    REQUIRE(patches.Apply());
+    CHECK(patches.IsApplied());
+    CHECK(Read(0) == 0xAA);
+    CHECK(Read(1) == 0xBB);
+    CHECK(Read(2) == 0x33);
+    CHECK(Read(4) == 0x90);
+    CHECK(Read(5) == 0x90);
+    CHECK(Read(6) == 0x77);
+    CHECK(Read(sizeof(g_Target) - 1) == 0xCC);
+    CHECK(patches.Verify());
+
+    // Protections are put back once the bytes are written.
+    CHECK_FALSE(IsWritable(At(0)));
+    CHECK_FALSE(IsWritable(At(sizeof(g_Target) - 1)));
+
+    REQUIRE(patches.Revert());
+    CHECK_FALSE(patches.IsApplied());
+    CHECK(Read(0) == 0x11);
+    CHECK(Read(1) == 0x22);
+    CHECK(Read(4) == 0x55);
+    CHECK(Read(5) == 0x66);
+    CHECK(Read(sizeof(g_Target) - 1) == 0x00);
+    CHECK(patches.Verify());
+    CHECK_FALSE(IsWritable(At(0)));
+}
+
+
+
+TEST_CASE("PatchSet rejects overlapping and invalid patches", "[patchset]")
+{
+    PatchSet patches("Tests");
+
+    REQUIRE(patches.Add(At(16), { 0x01, 0x02, 0x03, 0x04 }));
+
+    CHECK_FALSE(patches.Add(At(14), { 0x01, 0x02, 0x03 }));
+    CHECK_FALSE(patches.Add(At(19), { 0x01 }));
+    CHECK_FALSE(patches.Add(nullptr, { 0x01 }));
+    CHECK_FALSE(patches.Add(At(32), nullptr, 1));
+    CHECK(patches.Add(At(20), { 0x05 }));
+    CHECK(patches.Add(At(15), { 0x06 }));
+    CHECK(patches.GetCount() == 3);
+}
+
+
+
+TEST_CASE("PatchSet is locked while applied", "[patchset]")
+{
+    PatchSet patches("Tests");
+
+    REQUIRE(patches.Add(At(64), { 0xAB }));
+    REQUIRE(patches.Apply());
+
+    CHECK_FALSE(patches.Add(At(128), { 0xCD }));
+    CHECK_FALSE(patches.Clear());
+    CHECK(patches.Apply());
+    CHECK(patches.GetCount() == 1);
+
+    REQUIRE(patches.Revert());
+    CHECK(patches.Revert());
+    CHECK(patches.Clear());
+    CHECK(patches.GetCount() == 0);
+    CHECK(Read(64) == 0x00);
+}
+
+
+
+TEST_CASE("PatchSet reports modified memory", "[patchset]")
+{
+    PatchSet patches("Tests");
+
+    REQUIRE(patches.Add(At(256), { 0x42, 0x43 }));
+    REQUIRE(patches.Apply());
+
+    PatchSet other("Tests.Other");
+    REQUIRE(other.Add(At(257), { 0x99 }));
+    REQUIRE(other.Apply());
+
+    CHECK_FALSE(patches.Verify());
+
+    REQUIRE(other.Revert());
+    CHECK(patches.Verify());
+    REQUIRE(patches.Revert());
+}
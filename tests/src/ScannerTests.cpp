@@ -0,0 +1,117 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "ProjectZvend/MappedFile.hpp"
+#include "ProjectZvend/Memory.hpp"
+
+#include <memory>
+
+#ifdef _WIN32
+    #include <windows.h>
+#endif
+
+using namespace PZvend::Memory;
+
+
+namespace
+{
+    // Lands in the read only data of the test executable.
+    const uint8_t g_Marker[16] = { 0x50, 0x5A, 0x76, 0x65, 0x6E, 0x64, 0x9C, 0x3B, 0xE1, 0x07, 0x5D, 0xA8, 0x2F, 0xC4, 0x61, 0x13 };
+
+    constexpr const char* MARKER = "50 5A 76 65 6E 64 9C 3B E1 07 5D A8 2F C4 61 13";
+
+    std::string GetExecutablePath()
+    {
+#ifdef _WIN32
+        char path[MAX_PATH] = {};
+        GetModuleFileNameA(nullptr, path, MAX_PATH);
+        return path;
+#else
+        return "/proc/self/exe";
+#endif
+    }
+}
+
+
+
+TEST_CASE("Scanner finds patterns in the running executable", "[scanner]")
+{
+    Scanner scanner(nullptr);
+
+    REQUIRE(scanner.HasSection(TEXT));
+    REQUIRE(scanner.HasSection(RDATA));
+
+    std::vector<uint8_t*> found = scanner.FindAll(MARKER, RDATA);
+    REQUIRE_FALSE(found.empty());
+    CHECK(std::find(found.begin(), found.end(), g_Marker) != found.end());
+    CHECK(scanner.GetRVA(scanner.Find(MARKER, RDATA)) != SIZE_MAX);
+}
+
+
+
+TEST_CASE("Scanner resolves only addresses inside the module", "[scanner]")
+{
+    Scanner scanner(nullptr);
+
+    const size_t rva = scanner.GetRVA(g_Marker);
+    REQUIRE(rva != SIZE_MAX);
+    CHECK(scanner[rva] == g_Marker);
+
+    // The heap usually sits right above the executable, addresses past the image must not resolve.
+    auto    heap  = std::make_unique<uint8_t[]>(64);
+    uint8_t stack = 0;
+
+    CHECK(scanner.GetRVA(heap.get()) == SIZE_MAX);
+    CHECK(scanner.GetRVA(&stack) == SIZE_MAX);
+    CHECK(scanner.GetRVA(reinterpret_cast<const uint8_t*>(UINTPTR_MAX)) == SIZE_MAX);
+    CHECK(scanner.GetRVA(nullptr) == SIZE_MAX);
+}
+
+
+
+TEST_CASE("Scanner skips sections the image doesn't have", "[scanner]")
+{
+    // Executables have no export directory, loaded ELF images only keep TEXT, RDATA and DATA.
+    Scanner scanner(nullptr);
+
+    REQUIRE_FALSE(scanner.HasSection(EDATA));
+    CHECK(scanner.Find(MARKER, EDATA) == nullptr);
+    CHECK(scanner.Find(g_Marker, "xxxxxxxxxxxxxxxx", EDATA) == nullptr);
+    CHECK(scanner.Find(MARKER, EDATA, [](uint8_t* address) { return address; }) == nullptr);
+    CHECK(scanner.FindAll(MARKER, EDATA).empty());
+    CHECK(scanner.FindAll(g_Marker, "xxxxxxxxxxxxxxxx", EDATA).empty());
+}
+
+
+
+TEST_CASE("Scanner rejects null and short ranges", "[scanner]")
+{
+    Scanner scanner(nullptr);
+    auto*   marker = const_cast<uint8_t*>(g_Marker);
+
+    CHECK(scanner.Find(MARKER, nullptr, nullptr) == nullptr);
+    CHECK(scanner.Find(MARKER, marker, nullptr) == nullptr);
+    CHECK(scanner.Find(MARKER, nullptr, marker + sizeof(g_Marker)) == nullptr);
+    CHECK(scanner.Find(MARKER, marker, marker + sizeof(g_Marker) - 1) == nullptr);
+    CHECK(scanner.FindAll(MARKER, nullptr, nullptr).empty());
+
+    CHECK(scanner.Find(MARKER, marker, marker + sizeof(g_Marker)) == marker);
+}
+
+
+
+TEST_CASE("Scanner reads sections from an image file", "[scanner]")
+{
+    PZvend::MappedFile image(GetExecutablePath());
+    REQUIRE(image.IsOpen());
+
+    Scanner scanner(image);
+
+    REQUIRE(scanner.HasSection(TEXT));
+    REQUIRE(scanner.HasSection(RDATA));
+    CHECK_FALSE(scanner.HasSection(EDATA));
+    CHECK(scanner.FindAll(MARKER, EDATA).empty());
+
+    uint8_t* found = scanner.Find(MARKER, RDATA);
+    REQUIRE(found != nullptr);
+    CHECK(scanner.GetRVA(found) != SIZE_MAX);
+}
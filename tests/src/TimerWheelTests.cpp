@@ -0,0 +1,170 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "ProjectZvend/TimerWheel.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+
+using namespace PZvend;
+
+
+namespace
+{
+    // Long ticks, the real clock never advances the wheel while a test runs.
+    constexpr double TICK = 10.0;
+
+    using Clock = std::chrono::steady_clock;
+
+    /*
+    Drives a wheel by hand, At(n) is the middle of tick n.
+    */
+    struct ManualClock
+    {
+        Clock::time_point Start = Clock::now();
+
+        Clock::time_point At(uint64_t tick) const
+        {
+            const auto duration = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(TICK));
+            return Start + duration * static_cast<int64_t>(tick) + duration / 2;
+        }
+    };
+
+    bool WaitFor(const std::atomic<int>& value, int expected)
+    {
+        const auto timeout = Clock::now() + std::chrono::seconds(5);
+        while (value.load() != expected && Clock::now() < timeout)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+        return value.load() == expected;
+    }
+}
+
+
+
+TEST_CASE("TimerWheel fires timers in order of their delay", "[timer]")
+{
+    TimerWheel  wheel(TICK);
+    ManualClock clock;
+    std::string order;
+
+    wheel.Schedule(TICK * 3, [&]() { order += 'C'; });
+    wheel.Schedule(TICK * 1, [&]() { order += 'A'; });
+    wheel.Schedule(TICK * 2, [&]() { order += 'B'; });
+    CHECK(wheel.GetCount() == 3);
+
+    CHECK(wheel.Tick(clock.At(1)) == 1);
+    CHECK(order == "A");
+
+    CHECK(wheel.Tick(clock.At(5)) == 2);
+    CHECK(order == "ABC");
+    CHECK(wheel.GetCount() == 0);
+}
+
+
+
+TEST_CASE("TimerWheel rearms periodic timers", "[timer]")
+{
+    TimerWheel  wheel(TICK);
+    ManualClock clock;
+    int         runs = 0;
+
+    const TimerId id = wheel.SchedulePeriodic(TICK * 2, [&]() { runs++; });
+
+    CHECK(wheel.Tick(clock.At(1)) == 0);
+    CHECK(wheel.Tick(clock.At(2)) == 1);
+    CHECK(wheel.Tick(clock.At(7)) == 2);
+    CHECK(runs == 3);
+    CHECK(wheel.IsScheduled(id));
+
+    // A periodic timer cancelling itself runs once more and stops.
+    TimerId self = 0;
+    self = wheel.SchedulePeriodic(TICK, [&]() { CHECK(wheel.Cancel(self)); });
+
+    CHECK(wheel.Tick(clock.At(8)) == 2);
+    CHECK_FALSE(wheel.IsScheduled(self));
+    CHECK(wheel.Tick(clock.At(9)) == 0);
+    CHECK(wheel.GetCount() == 1);
+}
+
+
+
+TEST_CASE("TimerWheel cancels timers by id and token", "[timer]")
+{
+    TimerWheel         wheel(TICK);
+    ManualClock        clock;
+    CancellationSource source;
+    int                runs = 0;
+
+    const TimerId cancelled = wheel.Schedule(TICK, [&]() { runs += 100; });
+    const TimerId kept      = wheel.Schedule(TICK, [&]() { runs += 1; });
+    wheel.Schedule(TICK, [&]() { runs += 10; }, source.GetToken());
+    wheel.SchedulePeriodic(TICK, [&]() { runs += 1000; }, source.GetToken());
+
+    CHECK(wheel.Cancel(cancelled));
+    CHECK_FALSE(wheel.Cancel(cancelled));
+    CHECK_FALSE(wheel.IsScheduled(cancelled));
+    CHECK(wheel.IsScheduled(kept));
+    source.Cancel();
+
+    CHECK(wheel.Tick(clock.At(3)) == 1);
+    CHECK(runs == 1);
+    CHECK(wheel.GetCount() == 0);
+
+    // The node of a finished timer gets recycled, its old id must not cancel the new one.
+    const TimerId recycled = wheel.Schedule(TICK, [&]() { runs++; });
+    CHECK_FALSE(wheel.Cancel(kept));
+    CHECK(wheel.IsScheduled(recycled));
+    CHECK(wheel.Tick(clock.At(4)) == 1);
+    CHECK(runs == 2);
+}
+
+
+
+TEST_CASE("TimerWheel cascades timers across levels", "[timer]")
+{
+    TimerWheel  wheel(TICK);
+    ManualClock clock;
+    int         runs = 0;
+
+    // Past the first level (64 ticks) and past the second one (64^2 ticks).
+    const uint64_t first  = TIMER_WHEEL_SLOTS + 6;
+    const uint64_t second = TIMER_WHEEL_SLOTS * TIMER_WHEEL_SLOTS + 5;
+
+    wheel.Schedule(TICK * first, [&]() { runs += 1; });
+    wheel.Schedule(TICK * second, [&]() { runs += 10; });
+
+    CHECK(wheel.Tick(clock.At(first - 1)) == 0);
+    CHECK(wheel.Tick(clock.At(first)) == 1);
+    CHECK(runs == 1);
+
+    CHECK(wheel.Tick(clock.At(second - 1)) == 0);
+    CHECK(wheel.Tick(clock.At(second)) == 1);
+    CHECK(runs == 11);
+    CHECK(wheel.GetCount() == 0);
+}
+
+
+
+TEST_CASE("TimerWheel thread wakes up for earlier timers", "[timer]")
+{
+    TimerWheel       wheel(0.001);
+    std::atomic<int> runs = 0;
+
+    REQUIRE(wheel.StartThread());
+    CHECK_FALSE(wheel.StartThread());
+
+    // The thread sleeps until the far timer, the near one scheduled afterwards must still fire on time.
+    const TimerId far = wheel.Schedule(60.0, [&]() { runs += 100; });
+    wheel.Schedule(0.02, [&]() { runs += 1; });
+
+    CHECK(WaitFor(runs, 1));
+    CHECK(wheel.IsScheduled(far));
+
+    wheel.Schedule(0.01, [&]() { runs += 1; });
+    CHECK(WaitFor(runs, 2));
+
+    wheel.StopThread();
+    CHECK(wheel.Cancel(far));
+}
@@ -0,0 +1,165 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "ProjectZvend/Memory.hpp"
+
+#include <typeinfo>
+
+using namespace PZvend::Memory;
+
+
+// Detours take an explicit this, which only matches the member calling convention outside of x86 Windows.
+#if !defined(_WIN32) || defined(_WIN64)
+
+// Outside the anonymous namespace, otherwise the compiler sees every override and devirtualizes the calls.
+namespace VmtTests
+{
+    class Shape
+    {
+    public:
+        virtual ~Shape() = default;
+        virtual int Area(int scale) = 0;
+    };
+
+    class Square : public Shape
+    {
+    public:
+        int Area(int scale) override { return m_Side * m_Side * scale; }
+
+        int m_Side = 3;
+    };
+}
+
+using VmtTests::Shape;
+using VmtTests::Square;
+
+
+namespace
+{
+    // Both destructors come first on Itanium, MSVC has one (scalar deleting).
+#if defined(_MSC_VER)
+    constexpr size_t AREA_INDEX = 1;
+#else
+    constexpr size_t AREA_INDEX = 2;
+#endif
+
+    using Area_FUNC = int(*)(Shape* self, int scale);
+
+    VmtHook<Area_FUNC> g_Hook;
+
+    int AreaDetour(Shape* self, int scale)
+    {
+        return g_Hook.Call(self, scale) + 1000;
+    }
+
+    int AreaRetour(Shape* self, int scale)
+    {
+        return g_Hook.Call(self, scale) + 2000;
+    }
+
+    // Virtual calls go through a volatile pointer so the compiler can't devirtualize them.
+    int CallArea(Shape* shape, int scale)
+    {
+        Shape* volatile target = shape;
+        return target->Area(scale);
+    }
+}
+
+
+
+TEST_CASE("VmtHook swaps the class vtable slot", "[vmt]")
+{
+    Square first;
+    Square second;
+    second.m_Side = 4;
+
+    g_Hook = VmtHook<Area_FUNC>("Square::Area", GetVTable(&first), AREA_INDEX, &AreaDetour);
+
+    REQUIRE(g_Hook.Create());
+    REQUIRE(g_Hook.Enable());
+    CHECK(CallArea(&first, 2) == 1018);
+    CHECK(CallArea(&second, 2) == 1032);
+
+    REQUIRE(g_Hook.Retour(&AreaRetour));
+    CHECK(CallArea(&first, 2) == 2018);
+
+    REQUIRE(g_Hook.Disable());
+    CHECK(CallArea(&first, 2) == 18);
+
+    REQUIRE(g_Hook.Enable());
+    REQUIRE(g_Hook.Remove());
+    CHECK_FALSE(g_Hook.IsEnabled());
+    CHECK(CallArea(&first, 2) == 18);
+    CHECK(CallArea(&second, 2) == 32);
+
+    // The class vtable lives in read only data and has to be protected again.
+    CHECK_FALSE(IsWritable(GetVTable(&first) + AREA_INDEX));
+}
+
+
+
+TEST_CASE("VmtShadow only affects its object", "[vmt]")
+{
+    Square shadowed;
+    Square other;
+
+    void** original = GetVTable(&shadowed);
+
+    VmtShadow shadow(&shadowed);
+    REQUIRE(shadow.GetCount() > AREA_INDEX);
+    CHECK(shadow.GetOriginal() == original);
+
+    g_Hook = VmtHook<Area_FUNC>("Square::Area (shadow)", shadow, AREA_INDEX, &AreaDetour);
+    REQUIRE(g_Hook.Create());
+    REQUIRE(g_Hook.Enable());
+
+    // Hooking the copy does nothing until it is attached.
+    CHECK(CallArea(&shadowed, 1) == 9);
+
+    REQUIRE(shadow.Attach());
+    CHECK(GetVTable(&shadowed) == shadow.GetTable());
+    CHECK(GetVTable(&other) == original);
+    CHECK(CallArea(&shadowed, 1) == 1009);
+    CHECK(CallArea(&other, 1) == 9);
+
+    // The copied prefix keeps RTTI working on the shadowed object.
+    Shape* volatile shape = &shadowed;
+    CHECK(typeid(*shape) == typeid(Square));
+    CHECK(dynamic_cast<Square*>(shape) == &shadowed);
+
+    REQUIRE(shadow.Detach());
+    CHECK(GetVTable(&shadowed) == original);
+    CHECK(CallArea(&shadowed, 1) == 9);
+
+    REQUIRE(g_Hook.Remove());
+}
+
+
+
+TEST_CASE("VmtShadow restores the vtable when destroyed", "[vmt]")
+{
+    Square square;
+    void** original = GetVTable(&square);
+
+    {
+        VmtShadow shadow(&square);
+        REQUIRE(shadow.Attach());
+        CHECK(shadow.IsAttached());
+        CHECK(GetVTable(&square) != original);
+    }
+
+    CHECK(GetVTable(&square) == original);
+}
+
+
+
+TEST_CASE("VmtHook rejects slots outside the shadow", "[vmt]")
+{
+    Square square;
+    VmtShadow shadow(&square, AREA_INDEX);
+
+    VmtHook<Area_FUNC> hook("Square::Area (out of range)", shadow, AREA_INDEX, &AreaDetour);
+    CHECK_FALSE(hook.Create());
+    CHECK_FALSE(hook.Enable());
+}
+
+#endif